@@ -23,7 +23,7 @@
 
 	High-performance glow effect plugin for Adobe After Effects.
 	Supports CPU (8/16/32-bit) and GPU (DirectX 12) rendering paths.
-	Uses multi-pass box blur for Gaussian approximation with quality-based
+	Uses multi-pass running-sum box blur for Gaussian approximation with quality-based
 	downsampling for performance optimization.
 
 	Revision History
@@ -39,10 +39,27 @@
 #include "AEFX_SuiteHelper.h"
 #include "AE_EffectPixelFormat.h"
 #include "AE_EffectGPUSuites.h"
+#include "LiteGlow_Capture.h"
+#include "LiteGlow_Core.h"
+#include "LiteGlow_Scheduler.h"
+#include "LiteGlow_ScratchPool.h"
+#include "LiteGlow_GlowCache.h"
+#include "LiteGlow_Governor.h"
+#include "LiteGlow_Simd.h"
+#include "LiteGlow_TemporalCache.h"
+#include "LiteGlow_Trace.h"
 
 #include <math.h>
 #include <cstdlib>
+#include <cstddef>
+#include <cstdint>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
 
 // DirectX support for Windows
 #if defined(_WIN32)
@@ -81,18 +98,16 @@ inline PF_Err DXErrFromHRESULT(HRESULT hr) {
 // - camelCase for local variables
 // - UPPER_SNAKE_CASE for constants and macros
 // - Prefix notation: m for member, g for global, p for pointer (hungarian-adjacent)
-// - Suffix notation: 8/16/F for bit-depth specific variants (e.g., BlurH8, BlurV16, BlurHF)
+// - Suffix notation: 8/16/F for bit-depth specific variants (e.g., the DEPTH_8, DEPTH_16, DEPTH_FLOAT pixel kernels)
 
 // =============================================================================
 // Named Constants for Magic Numbers
 // =============================================================================
 constexpr float BRIGHT_PASS_KNEE_DEFAULT = 0.1f;         // Soft knee range for threshold transition
 constexpr float BRIGHT_PASS_INTENSITY_DEFAULT = 1.5f;    // Intensity multiplier for bright pass
-constexpr float SCREEN_BLEND_STRENGTH_MULTIPLIER = 2.0f; // Strength multiplier for screen blend (compensates for downsampling)
 
 constexpr int THREAD_GROUP_SIZE_X = 16;
 constexpr int THREAD_GROUP_SIZE_Y = 16;
-constexpr int MAX_ADJUSTED_BLUR_RADIUS = 32;
 constexpr A_long BYTES_PER_PIXEL_BGRA128 = 16;
 constexpr float COLOR_PARAM_MAX = 65535.0f;
 
@@ -126,18 +141,88 @@ GlobalSetup(PF_InData* in_data, PF_OutData* out_data, PF_ParamDef* params[], PF_
         PF_OutFlag_PIX_INDEPENDENT |
         PF_OutFlag_DEEP_COLOR_AWARE;
 
-    // SmartRender + Multi-Frame Rendering + 32-bit float + GPU
+    // SmartRender + Multi-Frame Rendering + 32-bit float + GPU; render
+    // threads read the sequence data through PF_EffectSequenceDataSuite1
     out_data->out_flags2 =
         PF_OutFlag2_SUPPORTS_SMART_RENDER |
         PF_OutFlag2_SUPPORTS_THREADED_RENDERING |
         PF_OutFlag2_FLOAT_COLOR_AWARE |
         PF_OutFlag2_SUPPORTS_GPU_RENDER_F32 |
-        PF_OutFlag2_WIDE_TIME_INPUT;
+        PF_OutFlag2_WIDE_TIME_INPUT |
+        PF_OutFlag2_SUPPORTS_GET_FLATTENED_SEQUENCE_DATA;
     
 #if HAS_HLSL
     out_data->out_flags2 |= PF_OutFlag2_SUPPORTS_DIRECTX_RENDERING;
 #endif
 
+    // Opt-in: large glow intermediates on huge pages (needs OS support/privilege)
+    const char* hugePages = std::getenv("LITEGLOW_HUGE_PAGES");
+    LiteGlowMem::SetScratchHugePages(hugePages && hugePages[0] == '1');
+
+    // Widest pixel kernels the CPU supports; LITEGLOW_SIMD caps the choice
+    // ("scalar", "sse4.1", "avx2", "avx512") for comparisons and bug reports
+    LiteGlowSimd::Isa simdLimit = LiteGlowSimd::Isa::AVX512;
+    LiteGlowSimd::ParseIsa(std::getenv("LITEGLOW_SIMD"), simdLimit);
+    LiteGlowSimd::SelectKernels(simdLimit);
+
+    // LITEGLOW_FIXED_POINT=0 renders 8/16-bit Box glows on the float path
+    // for comparisons (see LiteGlowCore::SetFixedPoint)
+    const char* fixedPoint = std::getenv("LITEGLOW_FIXED_POINT");
+    LiteGlowCore::SetFixedPoint(!(fixedPoint && fixedPoint[0] == '0'));
+
+    // LITEGLOW_TRACE=<file.json> records every render pass and writes a
+    // Chrome trace there at GlobalSetdown (LiteGlow_Trace.h)
+    LiteGlowTrace::Start(std::getenv("LITEGLOW_TRACE"));
+
+    // LITEGLOW_PERF_COUNTERS=1 adds the hardware counters of every CPU stage
+    // to its trace span (LiteGlow_PerfCounters.h; Linux only)
+    const char* perfCounters = std::getenv("LITEGLOW_PERF_COUNTERS");
+    LiteGlowCore::SetStageCounters(perfCounters && perfCounters[0] == '1');
+
+    // LITEGLOW_CAPTURE=<directory> writes the input and settings of the first
+    // LITEGLOW_CAPTURE_FRAMES (default 100) CPU renders there, for replay
+    // with bench/GlowReplay (LiteGlow_Capture.h)
+    const char* captureFrames = std::getenv("LITEGLOW_CAPTURE_FRAMES");
+    LiteGlowCapture::Start(std::getenv("LITEGLOW_CAPTURE"),
+                           captureFrames ? std::atoi(captureFrames) : LiteGlowCapture::CAPTURE_DEFAULT_MAX_FRAMES);
+
+    // LITEGLOW_CPU_PIPELINE=hlsl renders on the CPU with the GPU path's
+    // kernels, so farm (CPU) and workstation (GPU) renders match
+    LiteGlowCore::Pipeline pipeline = LiteGlowCore::PIPELINE_CPU;
+    LiteGlowCore::ParsePipeline(std::getenv("LITEGLOW_CPU_PIPELINE"), pipeline);
+    LiteGlowCore::SetPipeline(pipeline);
+
+    // LITEGLOW_STREAM_MB=<MB> moves the size above which Box renders stream
+    // instead of allocating full-frame intermediates (0 streams them all)
+    const char* streamMb = std::getenv("LITEGLOW_STREAM_MB");
+    if (streamMb) LiteGlowCore::SetStreamingThreshold((std::size_t)std::atoll(streamMb) << 20);
+
+    // LITEGLOW_TEMPORAL_MB=<MB> caps the last frames instances keep for
+    // temporal renders (LiteGlow_TemporalCache.h; 0 turns them off)
+    const char* temporalMb = std::getenv("LITEGLOW_TEMPORAL_MB");
+    if (temporalMb) LiteGlowTemporal::SetLimit((std::size_t)std::atoll(temporalMb) << 20);
+
+    return PF_Err_NONE;
+}
+
+static PF_Err
+GlobalSetdown(PF_InData* in_data, PF_OutData* out_data, PF_ParamDef* params[], PF_LayerDef* output)
+{
+    (void)in_data;
+    (void)out_data;
+    (void)params;
+    (void)output;
+    // Write the trace, if one was recorded, with the scratch pool's peaks,
+    // then join the CPU worker pool and free the cached glow stages,
+    // temporal frames, governor models and scratch buffers while the module
+    // is still loaded
+    LiteGlowTrace::RecordScratch("scratch");
+    LiteGlowTrace::Flush();
+    LiteGlowSched::ShutdownPool();
+    LiteGlowCache::Clear();
+    LiteGlowGovernor::Clear();
+    LiteGlowTemporal::Clear();
+    LiteGlowMem::TrimScratch();
     return PF_Err_NONE;
 }
 
@@ -159,7 +244,7 @@ ParamsSetup(PF_InData* in_data, PF_OutData* out_data, PF_ParamDef* params[], PF_
     AEFX_CLR_STRUCT(def);
     PF_ADD_FLOAT_SLIDERX(STR(StrID_Radius_Param_Name),
         RADIUS_MIN, RADIUS_MAX,
-        RADIUS_MIN, RADIUS_MAX,
+        RADIUS_MIN, RADIUS_SLIDER_MAX,
         RADIUS_DFLT,
         PF_Precision_INTEGER,
         0, 0,
@@ -215,666 +300,326 @@ ParamsSetup(PF_InData* in_data, PF_OutData* out_data, PF_ParamDef* params[], PF_
         0xFFFF, 0xFFFF, 0xFFFF,  // Default to white (no tint)
         TINT_COLOR_DISK_ID);
 
-    out_data->num_params = LITEGLOW_NUM_PARAMS;
-    return err;
-}
-
-// =============================================================================
-// Optimized CPU Pixel Processing
-// =============================================================================
-
-inline float Luma8(const PF_Pixel8* const p) noexcept {
-    return (0.2126f * p->red + 0.7152f * p->green + 0.0722f * p->blue) / 255.0f;
-}
-
-inline float Luma16(const PF_Pixel16* const p) noexcept {
-    return (0.2126f * p->red + 0.7152f * p->green + 0.0722f * p->blue) / (float)PF_MAX_CHAN16;
-}
-
-inline float LumaF(const PF_PixelFloat* const p) noexcept {
-    return 0.2126f * p->red + 0.7152f * p->green + 0.0722f * p->blue;
-}
-
-// Soft knee for natural threshold transition
-// FIX 1: Added division by zero protection
-inline float SoftKnee(const float x, const float threshold, const float knee) noexcept {
-    float knee_start = threshold - knee;
-    float knee_end = threshold + knee;
-
-    if (x <= knee_start) return 0.0f;
-    if (x >= knee_end) return x - threshold;
-
-    float knee_range = knee_end - knee_start;
-    if (knee_range <= 0.0001f) return 0.0f;  // Protect against division by zero
-
-    float t = (x - knee_start) / knee_range;
-    return t * t * (3.0f - 2.0f * t) * (x - threshold);
-}
-
-// Screen blend
-inline float ScreenBlend(const float a, const float b) noexcept {
-    return 1.0f - (1.0f - a) * (1.0f - b);
-}
+    // Blur Mode: Box (running-sum box passes) or Gaussian (recursive IIR)
+    AEFX_CLR_STRUCT(def);
+    PF_ADD_POPUP(STR(StrID_Blur_Mode_Param_Name),
+        BLUR_MODE_NUM_CHOICES,
+        BLUR_MODE_DFLT,
+        STR(StrID_Blur_Mode_Param_Choices),
+        BLUR_MODE_DISK_ID);
 
-// Add blend
-inline float AddBlend(const float a, const float b) noexcept {
-    return MIN(1.0f, a + b);
-}
+    // Budget: milliseconds per CPU render that Quality Auto aims for
+    AEFX_CLR_STRUCT(def);
+    PF_ADD_FLOAT_SLIDERX(STR(StrID_Budget_Param_Name),
+        BUDGET_MIN, BUDGET_MAX,
+        BUDGET_MIN, 100,
+        BUDGET_DFLT,
+        PF_Precision_INTEGER,
+        0, 0,
+        BUDGET_DISK_ID);
 
-// Normal blend (alpha compositing)
-inline float NormalBlend(const float a, const float b, const float alpha) noexcept {
-    return a * (1.0f - alpha) + b * alpha;
+    out_data->num_params = LITEGLOW_NUM_PARAMS;
+    return err;
 }
 
 // =============================================================================
-// Bright Pass Functions
+// Sequence Data
 // =============================================================================
+// Every effect instance carries an id, under which the Auto Quality governor
+// (LiteGlow_Governor.h) keeps its cost model and the temporal cache
+// (LiteGlow_TemporalCache.h) its last frame per layout. The data is flat, so
+// it is saved and duplicated as is, and the render-thread copies Multi-Frame
+// Rendering makes keep the id: all renders of an instance teach one model.
+// Ids scramble a counter with the session's start time, so instances of
+// saved projects are unlikely to meet new ones.
+//
+// The host duplicates sequence data with the effect, though: a duplicated
+// layer, or an effect copied and pasted, keeps the id of the one it came
+// from, and Resetup cannot tell the copy from a reloaded project. Such
+// instances share a model, and at the same frame size and output rect a
+// temporal frame. Both stay correct; the model learns from both, and each
+// temporal render diffs against the other layer's input, recomputing most
+// tiles. Applying the effect afresh gives it an id of its own.
 
 typedef struct {
-    float threshold;
-    float knee;
-    float intensity;
-    PF_EffectWorld* src;
-    int factor;
-} BrightPassInfo;
-
-// FIX 3: Added refcon NULL check at start of all iterate functions
-static PF_Err BrightPass8(void* refcon, A_long x, A_long y, PF_Pixel8* inP, PF_Pixel8* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BrightPassInfo* bp = reinterpret_cast<BrightPassInfo*>(refcon);
-    PF_Pixel8* srcP = inP;  // Default to input pixel
-
-    // Only use downsampled source if factor is valid and source exists
-    if (bp->factor > 1 && bp->src) {
-        int sx = MIN(bp->src->width - 1, (int)(x * bp->factor));
-        int sy = MIN(bp->src->height - 1, (int)(y * bp->factor));
-        srcP = (PF_Pixel8*)((char*)bp->src->data + sy * bp->src->rowbytes) + sx;
-    }
-    // else: srcP remains inP (initialized)
+    std::uint64_t instance;
+} LiteGlowSequence;
 
-    float l = Luma8(srcP);
-    float contribution = SoftKnee(l, bp->threshold, bp->knee);
-    
-    if (contribution > 0.0f) {
-        float scale = bp->intensity * (contribution / MAX(0.001f, l - bp->threshold + contribution));
-        outP->red   = (A_u_char)MIN(255.0f, srcP->red   * scale);
-        outP->green = (A_u_char)MIN(255.0f, srcP->green * scale);
-        outP->blue  = (A_u_char)MIN(255.0f, srcP->blue  * scale);
-    } else {
-        outP->red = outP->green = outP->blue = 0;
-    }
-    outP->alpha = srcP->alpha;
-    return PF_Err_NONE;
+static std::uint64_t NewInstanceId()
+{
+    static const std::uint64_t session =
+        (std::uint64_t)std::chrono::system_clock::now().time_since_epoch().count();
+    static std::atomic<std::uint64_t> counter{ 0 };
+    // splitmix64 finalizer
+    std::uint64_t x = session + 0x9E3779B97F4A7C15ull * (counter.fetch_add(1, std::memory_order_relaxed) + 1);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
 }
 
-static PF_Err BrightPass16(void* refcon, A_long x, A_long y, PF_Pixel16* inP, PF_Pixel16* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BrightPassInfo* bp = reinterpret_cast<BrightPassInfo*>(refcon);
-    PF_Pixel16* srcP = inP;  // Default to input pixel
-
-    // Only use downsampled source if factor is valid and source exists
-    if (bp->factor > 1 && bp->src) {
-        int sx = MIN(bp->src->width - 1, (int)(x * bp->factor));
-        int sy = MIN(bp->src->height - 1, (int)(y * bp->factor));
-        srcP = (PF_Pixel16*)((char*)bp->src->data + sy * bp->src->rowbytes) + sx;
-    }
-    // else: srcP remains inP (initialized)
-
-    float l = Luma16(srcP);
-    float contribution = SoftKnee(l, bp->threshold, bp->knee);
-    
-    if (contribution > 0.0f) {
-        float scale = bp->intensity * (contribution / MAX(0.001f, l - bp->threshold + contribution));
-        outP->red   = (A_u_short)MIN((float)PF_MAX_CHAN16, srcP->red   * scale);
-        outP->green = (A_u_short)MIN((float)PF_MAX_CHAN16, srcP->green * scale);
-        outP->blue  = (A_u_short)MIN((float)PF_MAX_CHAN16, srcP->blue  * scale);
-    } else {
-        outP->red = outP->green = outP->blue = 0;
+// A new handle holding `sequence`, or null if out of memory.
+static PF_Handle NewSequenceHandle(const PF_InData* in_data, const LiteGlowSequence& sequence)
+{
+    AEGP_SuiteHandler suites(in_data->pica_basicP);
+    PF_Handle handle = suites.HandleSuite1()->host_new_handle(sizeof(LiteGlowSequence));
+    if (!handle) return nullptr;
+    LiteGlowSequence* data = static_cast<LiteGlowSequence*>(suites.HandleSuite1()->host_lock_handle(handle));
+    if (!data) {
+        suites.HandleSuite1()->host_dispose_handle(handle);
+        return nullptr;
     }
-    outP->alpha = srcP->alpha;
-    return PF_Err_NONE;
+    *data = sequence;
+    suites.HandleSuite1()->host_unlock_handle(handle);
+    return handle;
 }
 
-static PF_Err BrightPassF(void* refcon, A_long x, A_long y, PF_PixelFloat* inP, PF_PixelFloat* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BrightPassInfo* bp = reinterpret_cast<BrightPassInfo*>(refcon);
-    PF_PixelFloat* srcP = inP;  // Default to input pixel
-
-    // Only use downsampled source if factor is valid and source exists
-    if (bp->factor > 1 && bp->src) {
-        int sx = MIN(bp->src->width - 1, (int)(x * bp->factor));
-        int sy = MIN(bp->src->height - 1, (int)(y * bp->factor));
-        srcP = (PF_PixelFloat*)((char*)bp->src->data + sy * bp->src->rowbytes) + sx;
-    }
-    // else: srcP remains inP (initialized)
-
-    float l = LumaF(srcP);
-    float contribution = SoftKnee(l, bp->threshold, bp->knee);
-    
-    if (contribution > 0.0f) {
-        float scale = bp->intensity * (contribution / MAX(0.001f, l - bp->threshold + contribution));
-        outP->red   = srcP->red   * scale;
-        outP->green = srcP->green * scale;
-        outP->blue  = srcP->blue  * scale;
-    } else {
-        outP->red = outP->green = outP->blue = 0.0f;
-    }
-    outP->alpha = srcP->alpha;
-    return PF_Err_NONE;
+// Whether `handle` holds a LiteGlowSequence (saved by this version or later).
+static bool IsSequenceHandle(const PF_InData* in_data, PF_Handle handle)
+{
+    AEGP_SuiteHandler suites(in_data->pica_basicP);
+    return handle && suites.HandleSuite1()->host_get_handle_size(handle) >= sizeof(LiteGlowSequence);
 }
 
-// =============================================================================
-// Blur Functions (Optimized Box Blur for Gaussian Approximation)
-// =============================================================================
-
-typedef struct {
-    PF_EffectWorld* src;
-    int radius_h;  // Horizontal blur radius (may differ from vertical for PAR/field rendering)
-    int radius_v;  // Vertical blur radius
-} BlurInfo;
-
-// FIX 3 & 4: Added refcon NULL check and count > 0 division protection
-static PF_Err BlurH8(void* refcon, A_long x, A_long y, PF_Pixel8* inP, PF_Pixel8* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BlurInfo* bi = reinterpret_cast<BlurInfo*>(refcon);
-    PF_EffectWorld* w = bi->src;
-    int r = bi->radius_h;  // Use horizontal radius
-    int rsum = 0, gsum = 0, bsum = 0, asum = 0;
-    int count = 0;
-
-    PF_Pixel8* row = (PF_Pixel8*)((char*)w->data + y * w->rowbytes);
-    for (int i = -r; i <= r; ++i) {
-        int sx = MAX(0, MIN(w->width - 1, x + i));
-        PF_Pixel8* p = row + sx;
-        rsum += p->red; gsum += p->green; bsum += p->blue; asum += p->alpha;
-        ++count;
-    }
-    // FIX 4: Protect against division by zero
-    if (count > 0) {
-        outP->red = (A_u_char)((rsum + count/2) / count);
-        outP->green = (A_u_char)((gsum + count/2) / count);
-        outP->blue = (A_u_char)((bsum + count/2) / count);
-        outP->alpha = (A_u_char)((asum + count/2) / count);
-    } else {
-        *outP = *inP;  // Fallback to input pixel
-    }
-    return PF_Err_NONE;
+static PF_Err
+SequenceSetup(PF_InData* in_data, PF_OutData* out_data)
+{
+    out_data->sequence_data = NewSequenceHandle(in_data, LiteGlowSequence{ NewInstanceId() });
+    return out_data->sequence_data ? PF_Err_NONE : PF_Err_OUT_OF_MEMORY;
 }
 
-static PF_Err BlurH16(void* refcon, A_long x, A_long y, PF_Pixel16* inP, PF_Pixel16* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BlurInfo* bi = reinterpret_cast<BlurInfo*>(refcon);
-    PF_EffectWorld* w = bi->src;
-    int r = bi->radius_h;  // Use horizontal radius
-    int rsum = 0, gsum = 0, bsum = 0, asum = 0;
-    int count = 0;
-
-    PF_Pixel16* row = (PF_Pixel16*)((char*)w->data + y * w->rowbytes);
-    for (int i = -r; i <= r; ++i) {
-        int sx = MAX(0, MIN(w->width - 1, x + i));
-        PF_Pixel16* p = row + sx;
-        rsum += p->red; gsum += p->green; bsum += p->blue; asum += p->alpha;
-        ++count;
+// Projects saved before the sequence data existed (or by a build with a
+// smaller one) get a fresh id; loaded and copied data keeps its own.
+static PF_Err
+SequenceResetup(PF_InData* in_data, PF_OutData* out_data)
+{
+    if (IsSequenceHandle(in_data, in_data->sequence_data)) {
+        out_data->sequence_data = in_data->sequence_data;
+        return PF_Err_NONE;
     }
-    // Proper rounding to avoid bias from integer division
-    // FIX 4: Protect against division by zero
-    if (count > 0) {
-        outP->red = (A_u_short)((rsum + count/2) / count);
-        outP->green = (A_u_short)((gsum + count/2) / count);
-        outP->blue = (A_u_short)((bsum + count/2) / count);
-        outP->alpha = (A_u_short)((asum + count/2) / count);
-    } else {
-        *outP = *inP;  // Fallback to input pixel
+    if (in_data->sequence_data) {
+        AEGP_SuiteHandler suites(in_data->pica_basicP);
+        suites.HandleSuite1()->host_dispose_handle(in_data->sequence_data);
     }
-    return PF_Err_NONE;
+    return SequenceSetup(in_data, out_data);
 }
 
-static PF_Err BlurHF(void* refcon, A_long x, A_long y, PF_PixelFloat* inP, PF_PixelFloat* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BlurInfo* bi = reinterpret_cast<BlurInfo*>(refcon);
-    PF_EffectWorld* w = bi->src;
-    int r = bi->radius_h;  // Use horizontal radius
-    float rsum = 0, gsum = 0, bsum = 0, asum = 0;
-    int count = 0;
-
-    PF_PixelFloat* row = (PF_PixelFloat*)((char*)w->data + y * w->rowbytes);
-    for (int i = -r; i <= r; ++i) {
-        int sx = MAX(0, MIN(w->width - 1, x + i));
-        PF_PixelFloat* p = row + sx;
-        rsum += p->red; gsum += p->green; bsum += p->blue; asum += p->alpha;
-        ++count;
-    }
-    // FIX 4: Protect against division by zero
-    if (count > 0) {
-        outP->red = rsum / count;
-        outP->green = gsum / count;
-        outP->blue = bsum / count;
-        outP->alpha = asum / count;
-    } else {
-        *outP = *inP;  // Fallback to input pixel
+// The model stays with the governor and the frames with the temporal cache:
+// render-thread copies are set down too, while the instance lives on, so
+// Setdown cannot tell that an instance is gone. Models of deleted instances
+// go when GOVERNOR_MAX_INSTANCES is passed, their frames under the
+// temporal cache's byte limit (LITEGLOW_TEMPORAL_MB); GlobalSetdown drops
+// them all.
+static PF_Err
+SequenceSetdown(PF_InData* in_data, PF_OutData* out_data)
+{
+    if (in_data->sequence_data) {
+        AEGP_SuiteHandler suites(in_data->pica_basicP);
+        suites.HandleSuite1()->host_dispose_handle(in_data->sequence_data);
     }
+    out_data->sequence_data = nullptr;
     return PF_Err_NONE;
 }
 
-static PF_Err BlurV8(void* refcon, A_long x, A_long y, PF_Pixel8* inP, PF_Pixel8* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BlurInfo* bi = reinterpret_cast<BlurInfo*>(refcon);
-    PF_EffectWorld* w = bi->src;
-    int r = bi->radius_v;  // Use vertical radius
-    int rsum = 0, gsum = 0, bsum = 0, asum = 0;
-    int count = 0;
-
-    for (int j = -r; j <= r; ++j) {
-        int sy = MAX(0, MIN(w->height - 1, y + j));
-        PF_Pixel8* p = (PF_Pixel8*)((char*)w->data + sy * w->rowbytes) + x;
-        rsum += p->red; gsum += p->green; bsum += p->blue; asum += p->alpha;
-        ++count;
-    }
-    // Proper rounding to avoid bias from integer division
-    // FIX 4: Protect against division by zero
-    if (count > 0) {
-        outP->red = (A_u_char)((rsum + count/2) / count);
-        outP->green = (A_u_char)((gsum + count/2) / count);
-        outP->blue = (A_u_char)((bsum + count/2) / count);
-        outP->alpha = (A_u_char)((asum + count/2) / count);
-    } else {
-        *outP = *inP;  // Fallback to input pixel
+// A flat copy for the host, leaving the sequence data as it is.
+static PF_Err
+GetFlattenedSequenceData(PF_InData* in_data, PF_OutData* out_data)
+{
+    LiteGlowSequence sequence = { 0 };
+    if (IsSequenceHandle(in_data, in_data->sequence_data)) {
+        AEGP_SuiteHandler suites(in_data->pica_basicP);
+        const void* data = suites.HandleSuite1()->host_lock_handle(in_data->sequence_data);
+        if (data) sequence = *static_cast<const LiteGlowSequence*>(data);
+        suites.HandleSuite1()->host_unlock_handle(in_data->sequence_data);
     }
-    return PF_Err_NONE;
+    out_data->sequence_data = NewSequenceHandle(in_data, sequence);
+    return out_data->sequence_data ? PF_Err_NONE : PF_Err_OUT_OF_MEMORY;
 }
 
-static PF_Err BlurV16(void* refcon, A_long x, A_long y, PF_Pixel16* inP, PF_Pixel16* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BlurInfo* bi = reinterpret_cast<BlurInfo*>(refcon);
-    PF_EffectWorld* w = bi->src;
-    int r = bi->radius_v;  // Use vertical radius
-    int rsum = 0, gsum = 0, bsum = 0, asum = 0;
-    int count = 0;
-
-    for (int j = -r; j <= r; ++j) {
-        int sy = MAX(0, MIN(w->height - 1, y + j));
-        PF_Pixel16* p = (PF_Pixel16*)((char*)w->data + sy * w->rowbytes) + x;
-        rsum += p->red; gsum += p->green; bsum += p->blue; asum += p->alpha;
-        ++count;
+// The instance id of a render, through the read-only access render threads
+// have; 0 when the host has no sequence data for it.
+static std::uint64_t RenderInstanceId(const PF_InData* in_data)
+{
+    const PF_EffectSequenceDataSuite1* suite = nullptr;
+    if (in_data->pica_basicP->AcquireSuite(kPFEffectSequenceDataSuite, kPFEffectSequenceDataSuiteVersion1,
+                                           reinterpret_cast<const void**>(&suite)) != kSPNoError) {
+        return 0;
     }
-    // Proper rounding to avoid bias from integer division
-    // FIX 4: Protect against division by zero
-    if (count > 0) {
-        outP->red = (A_u_short)((rsum + count/2) / count);
-        outP->green = (A_u_short)((gsum + count/2) / count);
-        outP->blue = (A_u_short)((bsum + count/2) / count);
-        outP->alpha = (A_u_short)((asum + count/2) / count);
-    } else {
-        *outP = *inP;  // Fallback to input pixel
+    std::uint64_t instance = 0;
+    PF_ConstHandle handle = nullptr;
+    if (suite && !suite->PF_GetConstSequenceData(in_data->effect_ref, &handle) && handle && *handle) {
+        instance = static_cast<const LiteGlowSequence*>(*handle)->instance;
     }
-    return PF_Err_NONE;
+    in_data->pica_basicP->ReleaseSuite(kPFEffectSequenceDataSuite, kPFEffectSequenceDataSuiteVersion1);
+    return instance;
 }
 
-static PF_Err BlurVF(void* refcon, A_long x, A_long y, PF_PixelFloat* inP, PF_PixelFloat* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BlurInfo* bi = reinterpret_cast<BlurInfo*>(refcon);
-    PF_EffectWorld* w = bi->src;
-    int r = bi->radius_v;  // Use vertical radius
-    float rsum = 0, gsum = 0, bsum = 0, asum = 0;
-    int count = 0;
-
-    for (int j = -r; j <= r; ++j) {
-        int sy = MAX(0, MIN(w->height - 1, y + j));
-        PF_PixelFloat* p = (PF_PixelFloat*)((char*)w->data + sy * w->rowbytes) + x;
-        rsum += p->red; gsum += p->green; bsum += p->blue; asum += p->alpha;
-        ++count;
-    }
-    // FIX 4: Protect against division by zero
-    if (count > 0) {
-        outP->red = rsum / count;
-        outP->green = gsum / count;
-        outP->blue = bsum / count;
-        outP->alpha = asum / count;
-    } else {
-        *outP = *inP;  // Fallback to input pixel
+// =============================================================================
+// CPU Render
+// =============================================================================
+// The CPU pipeline lives in LiteGlow_Core.h; the plugin hands it its worlds
+// as image views and maps the result back to a PF_Err.
+
+typedef LiteGlowCore::Settings LiteGlowSettings;
+
+// ImageView formats the host pixel formats map onto.
+static_assert(sizeof(PF_Pixel8) == 4 && offsetof(PF_Pixel8, red) == 1 && offsetof(PF_Pixel8, blue) == 3,
+              "PF_Pixel8 must be ARGB");
+static_assert(sizeof(PF_Pixel16) == 8 && offsetof(PF_Pixel16, red) == 2 && offsetof(PF_Pixel16, blue) == 6,
+              "PF_Pixel16 must be ARGB");
+static_assert(sizeof(PF_PixelFloat) == 16 && offsetof(PF_PixelFloat, red) == 4 && offsetof(PF_PixelFloat, blue) == 12,
+              "PF_PixelFloat must be ARGB");
+
+// The bright response tables use the SDK's table resolution.
+static_assert(LiteGlowSimd::BRIGHT_RESPONSE_BITS == PF_TABLE_BITS &&
+              (1 << LiteGlowSimd::BRIGHT_RESPONSE_BITS) == PF_TABLE_SZ_16,
+              "Bright response must match PF_TABLE_BITS");
+
+static PF_Err CoreErr(const LiteGlowCore::Status status) {
+    switch (status) {
+        case LiteGlowCore::STATUS_OK:            return PF_Err_NONE;
+        case LiteGlowCore::STATUS_BAD_PARAM:     return PF_Err_BAD_PARAM;
+        case LiteGlowCore::STATUS_BAD_RECT:      return PF_Err_BAD_CALLBACK_PARAM;
+        case LiteGlowCore::STATUS_OUT_OF_MEMORY: return PF_Err_OUT_OF_MEMORY;
     }
-    return PF_Err_NONE;
+    return PF_Err_INTERNAL_STRUCT_DAMAGED;
 }
 
-// =============================================================================
-// Screen Blend Functions
-// =============================================================================
+static PF_Err ValidateSettings(const LiteGlowSettings* settings) {
+    if (!settings) return PF_Err_INTERNAL_STRUCT_DAMAGED;
+    return CoreErr(LiteGlowCore::ValidateSettings(*settings));
+}
 
-typedef struct {
-    PF_EffectWorld* glow;
-    float strength;
-    int factor;
-    int blendMode;
-    float tintR;
-    float tintG;
-    float tintB;
-} BlendInfo;
-
-static PF_Err BlendScreen8(void* refcon, A_long x, A_long y, PF_Pixel8* inP, PF_Pixel8* outP) {
-    if (!refcon) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    BlendInfo* bi = reinterpret_cast<BlendInfo*>(refcon);
-    if (bi->factor <= 0) bi->factor = 1;  // ADD THIS SAFETY CHECK
-
-    int gx = MIN(bi->glow->width - 1, x / bi->factor);
-    int gy = MIN(bi->glow->height - 1, y / bi->factor);
-    PF_Pixel8* g = (PF_Pixel8*)((char*)bi->glow->data + gy * bi->glow->rowbytes) + gx;
-
-    float s = bi->strength;
-    float ir = inP->red / 255.0f;
-    float ig = inP->green / 255.0f;
-    float ib = inP->blue / 255.0f;
-
-    // Apply tint color to glow
-    float gr = g->red / 255.0f * s * bi->tintR;
-    float gg = g->green / 255.0f * s * bi->tintG;
-    float gb = g->blue / 255.0f * s * bi->tintB;
-
-    outP->red   = (A_u_char)(ScreenBlend(ir, gr) * 255.0f);
-    outP->green = (A_u_char)(ScreenBlend(ig, gg) * 255.0f);
-    outP->blue  = (A_u_char)(ScreenBlend(ib, gb) * 255.0f);
-    outP->alpha = inP->alpha;
-    return PF_Err_NONE;
+static float RationalScale(const PF_RationalScale& scale) {
+    return scale.den ? (float)scale.num / (float)scale.den : 1.0f;
 }
 
-static PF_Err BlendScreen16(void* refcon, A_long x, A_long y, PF_Pixel16* inP, PF_Pixel16* outP) {
-    BlendInfo* bi = reinterpret_cast<BlendInfo*>(refcon);
-    
-    int gx = MIN(bi->glow->width - 1, x / bi->factor);
-    int gy = MIN(bi->glow->height - 1, y / bi->factor);
-    PF_Pixel16* g = (PF_Pixel16*)((char*)bi->glow->data + gy * bi->glow->rowbytes) + gx;
-    
-    float s = bi->strength;
-    float ir = inP->red / (float)PF_MAX_CHAN16;
-    float ig = inP->green / (float)PF_MAX_CHAN16;
-    float ib = inP->blue / (float)PF_MAX_CHAN16;
-    // Apply tint color to glow
-    float gr = g->red / (float)PF_MAX_CHAN16 * s * bi->tintR;
-    float gg = g->green / (float)PF_MAX_CHAN16 * s * bi->tintG;
-    float gb = g->blue / (float)PF_MAX_CHAN16 * s * bi->tintB;
-
-    outP->red   = (A_u_short)(ScreenBlend(ir, gr) * (float)PF_MAX_CHAN16);
-    outP->green = (A_u_short)(ScreenBlend(ig, gg) * (float)PF_MAX_CHAN16);
-    outP->blue  = (A_u_short)(ScreenBlend(ib, gb) * (float)PF_MAX_CHAN16);
-    outP->alpha = inP->alpha;
-    return PF_Err_NONE;
+// Pixel aspect ratio, field and preview resolution of the frame being
+// rendered. At Half or Quarter resolution the input is downsampled, so the
+// core scales the radius and its own downsample to match.
+static void SetFrameGeometry(LiteGlowSettings& settings, const PF_RationalScale& par, const PF_InData* in_data) {
+    settings.parNum = (int)par.num;
+    settings.parDen = (int)par.den;
+    settings.field = in_data->field == PF_Field_UPPER ? LiteGlowCore::FIELD_UPPER
+                   : in_data->field == PF_Field_LOWER ? LiteGlowCore::FIELD_LOWER
+                   : LiteGlowCore::FIELD_FRAME;
+    settings.previewScaleX = RationalScale(in_data->downsample_x);
+    settings.previewScaleY = RationalScale(in_data->downsample_y);
 }
 
-static PF_Err BlendScreenF(void* refcon, A_long x, A_long y, PF_PixelFloat* inP, PF_PixelFloat* outP) {
-    BlendInfo* bi = reinterpret_cast<BlendInfo*>(refcon);
-    
-    int gx = MIN(bi->glow->width - 1, x / bi->factor);
-    int gy = MIN(bi->glow->height - 1, y / bi->factor);
-    PF_PixelFloat* g = (PF_PixelFloat*)((char*)bi->glow->data + gy * bi->glow->rowbytes) + gx;
-    
-    float s = bi->strength;
-    // User requirement: clamp to display range. Clamp base first to avoid
-    // HDR (inP>1) producing negative results in screen when glow is strong.
-    const float in_r = MIN(1.0f, MAX(0.0f, inP->red));
-    const float in_g = MIN(1.0f, MAX(0.0f, inP->green));
-    const float in_b = MIN(1.0f, MAX(0.0f, inP->blue));
-
-    // Apply tint color to glow
-    float r = ScreenBlend(in_r, g->red * s * bi->tintR);
-    float g = ScreenBlend(in_g, g->green * s * bi->tintG);
-    float b = ScreenBlend(in_b, g->blue * s * bi->tintB);
-    // Hard clamp to display white.
-    outP->red   = MIN(1.0f, MAX(0.0f, r));
-    outP->green = MIN(1.0f, MAX(0.0f, g));
-    outP->blue  = MIN(1.0f, MAX(0.0f, b));
-    outP->alpha = inP->alpha;
-    return PF_Err_NONE;
+static LiteGlowCore::ImageView WorldView(const PF_EffectWorld* world, LiteGlowCore::PixelFormat format) {
+    return LiteGlowCore::ImageView{ world->data, world->rowbytes, world->width, world->height, format };
 }
 
 // =============================================================================
-// Helper Functions for Field Rendering and Pixel Aspect Ratio
+// Blur Setup and Glow Extent
 // =============================================================================
-
-// Calculate pixel aspect ratio as float from PF_RationalScale
-inline float GetPixelAspectRatioFloat(const PF_RationalScale& par) {
-    if (par.den == 0) return 1.0f;  // Safety: avoid division by zero
-    return (float)par.num / (float)par.den;
-}
-
-// Adjust blur radius for field rendering and pixel aspect ratio
-// For field rendering, vertical radius is halved since only half the lines are processed
-// For non-square pixels, radius is adjusted to maintain circular appearance
-inline void AdjustBlurRadiusForPARAndField(
-    int base_radius,
-    const PF_RationalScale& par,
-    PF_Field field,
-    int& out_radius_h,
-    int& out_radius_v)
+// The blur sizes both renderers derive from the settings, shared with
+// SmartPreRender, which needs the reach of the glow to size the input request:
+// LiteGlowCore::GetBlurSetup for the CPU (whichever pipeline it runs) and
+// LiteGlowCore::GetHlslBlurSetup for the GPU.
+
+// Input margin, in full-resolution pixels, that a rendered pixel depends on:
+// the glow reach of whichever renderer runs plus one sample cell. Auto
+// renders may take any of its plans on the CPU.
+static void GetGlowApron(const LiteGlowSettings* settings, A_long& apronX, A_long& apronY)
 {
-    float par_float = GetPixelAspectRatioFloat(par);
-
-    // Base adjustment for pixel aspect ratio
-    // Wider pixels (par < 1.0, e.g., NTSC 0.9) need larger H radius
-    // Narrower pixels (par > 1.0, e.g., PAL 1.09) need smaller H radius
-    // To maintain visual circularity, adjust proportionally
-    if (par_float > 0.1f && par_float < 10.0f) {  // Sanity check
-        // In AE's coordinate system:
-        // - par = num/den represents horizontal_size / vertical_size
-        // - For square pixels: par = 1/1 = 1.0
-        // - For NTSC D1: par = 10/11 ≈ 0.909 (wider pixels, need more H samples)
-        // - For PAL D1: par = 59/54 ≈ 1.09 (narrower pixels, need fewer H samples)
-
-        // We adjust H radius inversely to PAR to maintain circular blur
-        out_radius_h = (int)(base_radius / par_float + 0.5f);
-        out_radius_v = base_radius;
-    } else {
-        out_radius_h = base_radius;
-        out_radius_v = base_radius;
+    const LiteGlowCore::BlurSetup cpu = LiteGlowCore::GetBlurSetup(*settings);
+    const LiteGlowCore::BlurSetup gpu = LiteGlowCore::GetHlslBlurSetup(*settings);
+    apronX = MAX((LiteGlowCore::BlurReach(cpu, true) + 1) * cpu.factor,
+                 (LiteGlowCore::BlurReach(gpu, true) + 1) * gpu.factor);
+    apronY = MAX((LiteGlowCore::BlurReach(cpu, false) + 1) * cpu.factor,
+                 (LiteGlowCore::BlurReach(gpu, false) + 1) * gpu.factor);
+    for (int i = 0; settings->quality == QUALITY_AUTO && i < LiteGlowCore::AUTO_PLANS; ++i) {
+        LiteGlowCore::BlurSetup plan;
+        if (!LiteGlowCore::GetAutoPlan(*settings, i, plan)) continue;
+        apronX = MAX(apronX, (LiteGlowCore::BlurReach(plan, true) + 1) * plan.factor);
+        apronY = MAX(apronY, (LiteGlowCore::BlurReach(plan, false) + 1) * plan.factor);
     }
+}
 
-    // For field rendering, reduce vertical radius since we're only processing
-    // half the scanlines. This prevents over-blurring in vertical direction.
-    if (field == PF_Field_UPPER || field == PF_Field_LOWER) {
-        out_radius_v = MAX(1, out_radius_v / 2);
-    }
+// Input rects start on multiples of this (see LiteGlowCore::GlowGridStep).
+static A_long GetGlowGridStep(const LiteGlowSettings* settings)
+{
+    return (A_long)LiteGlowCore::GlowGridStep(*settings);
 }
 
-// =============================================================================
-// Main Render Function
-// =============================================================================
+// Time of the frame being rendered, in seconds.
+static double FrameTime(const PF_InData* in_data)
+{
+    return in_data->time_scale ? (double)in_data->current_time / in_data->time_scale : 0.0;
+}
 
-typedef struct {
-    float strength;
-    float radius;
-    float threshold;
-    int quality;
-    float bloomIntensity;  // User parameter (0-400) divided by 100 for actual multiplier
-    float knee;            // User parameter (0-100) divided by 100 for actual knee value
-    int blendMode;         // 1=Screen, 2=Add, 3=Normal
-    float tintR;           // Tint color red (0-1)
-    float tintG;           // Tint color green (0-1)
-    float tintB;           // Tint color blue (0-1)
-    PF_RationalScale pixel_aspect_ratio;  // Pixel aspect ratio for non-square pixel support
-    PF_Field field;        // Field rendering info (FRAME/UPPER/LOWER)
-} LiteGlowSettings;
-
-// FIX 5: Added common ValidateSettings function
-static PF_Err ValidateSettings(const LiteGlowSettings* settings) {
-    if (!settings) return PF_Err_INTERNAL_STRUCT_DAMAGED;
-    if (settings->radius < 0.0f || settings->radius > RADIUS_MAX) {
-        return PF_Err_BAD_PARAM;
-    }
-    if (settings->strength < 0.0f || settings->strength > STRENGTH_MAX) {
-        return PF_Err_BAD_PARAM;
-    }
-    if (settings->threshold < THRESHOLD_MIN || settings->threshold > THRESHOLD_MAX) {
-        return PF_Err_BAD_PARAM;
-    }
-    if (settings->quality < 0 || settings->quality >= QUALITY_NUM_CHOICES) {
-        return PF_Err_BAD_PARAM;
-    }
-    if (settings->bloomIntensity < BLOOM_INTENSITY_MIN || settings->bloomIntensity > BLOOM_INTENSITY_MAX) {
-        return PF_Err_BAD_PARAM;
-    }
-    if (settings->knee < KNEE_MIN || settings->knee > KNEE_MAX) {
-        return PF_Err_BAD_PARAM;
-    }
-    if (settings->blendMode < BLEND_MODE_SCREEN || settings->blendMode > BLEND_MODE_NORMAL) {
-        return PF_Err_BAD_PARAM;
-    }
-    return PF_Err_NONE;
+// Arguments of a frame span in the trace (LiteGlow_Trace.h).
+static LiteGlowTrace::FrameArgs TraceFrame(const PF_InData* in_data, const PF_EffectWorld* inputW,
+                                           int factor, int radiusH, int radiusV)
+{
+    LiteGlowTrace::FrameArgs frame;
+    frame.time = FrameTime(in_data);
+    frame.width = inputW->width;
+    frame.height = inputW->height;
+    frame.factor = factor;
+    frame.radiusH = radiusH;
+    frame.radiusV = radiusV;
+    return frame;
 }
 
+// Quality Auto renders go through the governor with `budgetMs` and the
+// model of `instance` (RenderInstanceId); the others diff against the last
+// frame of `instance` in the temporal cache.
 static PF_Err
 ProcessWorlds(PF_InData* in_data, PF_OutData* out_data,
               const LiteGlowSettings* settings,
-              PF_EffectWorld* inputW, PF_EffectWorld* outputW)
+              PF_EffectWorld* inputW, PF_EffectWorld* outputW,
+              A_long outputX, A_long outputY,
+              double budgetMs, std::uint64_t instance)
 {
     PF_Err err = PF_Err_NONE;
     // Validate in_data and pica_basicP
     if (!in_data || !in_data->pica_basicP) {
         return PF_Err_INTERNAL_STRUCT_DAMAGED;
     }
-    AEGP_SuiteHandler suites(in_data->pica_basicP);
-
-    // FIX 5: Use common ValidateSettings function
-    ERR(ValidateSettings(settings));
-    if (err) return err;
-
-    float strength_norm = settings->strength / 2000.0f;
-    float threshold_norm = settings->threshold / 255.0f;
-    int base_radius = (int)settings->radius;
-
-    // FIX 2: Clamp quality to valid range before array access
-    int quality = settings->quality;
-    if (quality < 0) quality = 0;
-    if (quality >= QUALITY_NUM_CHOICES) quality = QUALITY_NUM_CHOICES - 1;
+    if (!settings) return PF_Err_INTERNAL_STRUCT_DAMAGED;
 
-    if (strength_norm <= 0.0001f || base_radius <= 0) {
-        return PF_COPY(inputW, outputW, NULL, NULL);
+    // The core records the stages under this span
+    LiteGlowTrace::FrameArgs frame = {};
+    if (LiteGlowTrace::Enabled()) {
+        const LiteGlowCore::BlurSetup blur = LiteGlowCore::GetBlurSetup(*settings);
+        frame = TraceFrame(in_data, inputW, blur.factor, blur.radiusH, blur.radiusV);
     }
+    const LiteGlowTrace::Scope frameScope("ProcessWorlds", &frame);
 
     AEFX_SuiteScoper<PF_WorldSuite2> worldSuite = AEFX_SuiteScoper<PF_WorldSuite2>(
         in_data, kPFWorldSuite, kPFWorldSuiteVersion2, out_data);
-    PF_EffectWorld brightW = {}, blur1 = {}, blur2 = {};
-    bool brightW_created = false, blur1_created = false, blur2_created = false;
 
     // Get pixel format
     PF_PixelFormat pixfmt = PF_PixelFormat_INVALID;
     ERR(worldSuite->PF_GetPixelFormat(inputW, &pixfmt));
-    if (err) goto cleanup;
-
-    // Downsample for performance: Low=4x, Medium=2x, High=1x
-    // Quality to downsample factor mapping (lower quality = higher downsample for performance)
-    static const int kQualityToDownsample[] = { 4, 2, 1 };  // Index 0=LOW, 1=MEDIUM, 2=HIGH
-    int ds = kQualityToDownsample[quality];
-    int dsW = MAX(1, outputW->width / ds);
-    int dsH = MAX(1, outputW->height / ds);
-    // Clamp ds_radius after adding quality bonus to prevent overflow beyond 24
-    int ds_radius = MAX(1, base_radius / ds + (quality == QUALITY_HIGH ? 2 : 0));
-    ds_radius = MIN(ds_radius, 24);
-
-    // Calculate separate horizontal and vertical blur radii based on PAR and field rendering
-    int ds_radius_h, ds_radius_v;
-    AdjustBlurRadiusForPARAndField(ds_radius, settings->pixel_aspect_ratio, settings->field, ds_radius_h, ds_radius_v);
-    // Clamp adjusted radii to reasonable limits
-    ds_radius_h = MIN(ds_radius_h, MAX_ADJUSTED_BLUR_RADIUS);
-    ds_radius_v = MIN(ds_radius_v, 32);
-
-    // Allocate temporary worlds for 4-pass blur
-    ERR(worldSuite->PF_NewWorld(in_data->effect_ref, dsW, dsH, TRUE, pixfmt, &brightW));
-    if (err) goto cleanup;
-    brightW_created = true;
-
-    ERR(worldSuite->PF_NewWorld(in_data->effect_ref, dsW, dsH, TRUE, pixfmt, &blur1));
-    if (err) goto cleanup;
-    blur1_created = true;
-
-    ERR(worldSuite->PF_NewWorld(in_data->effect_ref, dsW, dsH, TRUE, pixfmt, &blur2));
-    if (err) goto cleanup;
-    blur2_created = true;
-
-    // 1) Bright pass with soft knee for natural threshold
-    {
-        float knee_norm = settings->knee / 100.0f;
-        float intensity_norm = settings->bloomIntensity / 100.0f;
-        BrightPassInfo bp{ threshold_norm, knee_norm, intensity_norm, inputW, ds };
-        A_long lines = brightW.height;
-        
-        if (pixfmt == PF_PixelFormat_ARGB32)
-            ERR(suites.Iterate8Suite2()->iterate(in_data, 0, lines, &brightW, NULL, &bp, BrightPass8, &brightW));
-        else if (pixfmt == PF_PixelFormat_ARGB64)
-            ERR(suites.Iterate16Suite2()->iterate(in_data, 0, lines, &brightW, NULL, &bp, BrightPass16, &brightW));
-        else if (pixfmt == PF_PixelFormat_ARGB128)
-            ERR(suites.IterateFloatSuite2()->iterate(in_data, 0, lines, &brightW, NULL, &bp, BrightPassF, &brightW));
-    }
-    if (err) goto cleanup;
-
-    // 2) 4-pass blur for smooth Gaussian approximation
-    // Pass 1: Horizontal
-    {
-        BlurInfo bi{ &brightW, ds_radius_h, ds_radius_h };  // Use horizontal radius for H blur
-        A_long lines = brightW.height;
-        if (pixfmt == PF_PixelFormat_ARGB32)
-            ERR(suites.Iterate8Suite2()->iterate(in_data, 0, lines, &brightW, NULL, &bi, BlurH8, &blur1));
-        else if (pixfmt == PF_PixelFormat_ARGB64)
-            ERR(suites.Iterate16Suite2()->iterate(in_data, 0, lines, &brightW, NULL, &bi, BlurH16, &blur1));
-        else if (pixfmt == PF_PixelFormat_ARGB128)
-            ERR(suites.IterateFloatSuite2()->iterate(in_data, 0, lines, &brightW, NULL, &bi, BlurHF, &blur1));
-    }
-    if (err) goto cleanup;
-
-    // Pass 2: Vertical
-    {
-        BlurInfo bi{ &blur1, ds_radius_h, ds_radius_v };  // Use vertical radius for V blur
-        A_long lines = blur1.height;
-        if (pixfmt == PF_PixelFormat_ARGB32)
-            ERR(suites.Iterate8Suite2()->iterate(in_data, 0, lines, &blur1, NULL, &bi, BlurV8, &blur2));
-        else if (pixfmt == PF_PixelFormat_ARGB64)
-            ERR(suites.Iterate16Suite2()->iterate(in_data, 0, lines, &blur1, NULL, &bi, BlurV16, &blur2));
-        else if (pixfmt == PF_PixelFormat_ARGB128)
-            ERR(suites.IterateFloatSuite2()->iterate(in_data, 0, lines, &blur1, NULL, &bi, BlurVF, &blur2));
-    }
-    if (err) goto cleanup;
-
-    // Pass 3: Horizontal
-    {
-        BlurInfo bi{ &blur2, ds_radius_h, ds_radius_h };  // Use horizontal radius for H blur
-        A_long lines = blur2.height;
-        if (pixfmt == PF_PixelFormat_ARGB32)
-            ERR(suites.Iterate8Suite2()->iterate(in_data, 0, lines, &blur2, NULL, &bi, BlurH8, &blur1));
-        else if (pixfmt == PF_PixelFormat_ARGB64)
-            ERR(suites.Iterate16Suite2()->iterate(in_data, 0, lines, &blur2, NULL, &bi, BlurH16, &blur1));
-        else if (pixfmt == PF_PixelFormat_ARGB128)
-            ERR(suites.IterateFloatSuite2()->iterate(in_data, 0, lines, &blur2, NULL, &bi, BlurHF, &blur1));
-    }
-    if (err) goto cleanup;
-
-    // Pass 4: Vertical
-    {
-        BlurInfo bi{ &blur1, ds_radius_h, ds_radius_v };  // Use vertical radius for V blur
-        A_long lines = blur1.height;
-        if (pixfmt == PF_PixelFormat_ARGB32)
-            ERR(suites.Iterate8Suite2()->iterate(in_data, 0, lines, &blur1, NULL, &bi, BlurV8, &blur2));
-        else if (pixfmt == PF_PixelFormat_ARGB64)
-            ERR(suites.Iterate16Suite2()->iterate(in_data, 0, lines, &blur1, NULL, &bi, BlurV16, &blur2));
-        else if (pixfmt == PF_PixelFormat_ARGB128)
-            ERR(suites.IterateFloatSuite2()->iterate(in_data, 0, lines, &blur1, NULL, &bi, BlurVF, &blur2));
-    }
-    if (err) goto cleanup;
-
-    // 3) Screen blend with tint color
-    {
-        BlendInfo bl{ &blur2, strength_norm * SCREEN_BLEND_STRENGTH_MULTIPLIER, ds, settings->blendMode, settings->tintR, settings->tintG, settings->tintB };
-        A_long lines = outputW->height;
-        if (pixfmt == PF_PixelFormat_ARGB32)
-            ERR(suites.Iterate8Suite2()->iterate(in_data, 0, lines, inputW, NULL, &bl, BlendScreen8, outputW));
-        else if (pixfmt == PF_PixelFormat_ARGB64)
-            ERR(suites.Iterate16Suite2()->iterate(in_data, 0, lines, inputW, NULL, &bl, BlendScreen16, outputW));
-        else if (pixfmt == PF_PixelFormat_ARGB128)
-            ERR(suites.IterateFloatSuite2()->iterate(in_data, 0, lines, inputW, NULL, &bl, BlendScreenF, outputW));
+    if (!err) {
+        LiteGlowCore::PixelFormat format = LiteGlowCore::FORMAT_ARGB32;
+        if (pixfmt == PF_PixelFormat_ARGB64) {
+            format = LiteGlowCore::FORMAT_ARGB64;
+        } else if (pixfmt == PF_PixelFormat_ARGB128) {
+            format = LiteGlowCore::FORMAT_ARGB128;
+        } else if (pixfmt != PF_PixelFormat_ARGB32) {
+            err = PF_Err_BAD_PARAM;
+        }
+        if (!err && LiteGlowCapture::Enabled()) {
+            // Best effort: a frame that cannot be written is still rendered
+            const LiteGlowCapture::Frame capture = { WorldView(inputW, format), (int)outputX, (int)outputY,
+                                                     (int)outputW->width, (int)outputW->height, *settings,
+                                                     FrameTime(in_data), budgetMs, instance };
+            LiteGlowCapture::CaptureFrame(capture);
+        }
+        if (!err && settings->quality == QUALITY_AUTO) {
+            err = CoreErr(LiteGlowGovernor::Render(instance, budgetMs, WorldView(inputW, format),
+                                                   WorldView(outputW, format), outputX, outputY, *settings));
+        } else if (!err) {
+            err = CoreErr(LiteGlowCore::RenderGlowTemporal(instance, WorldView(inputW, format),
+                                                           WorldView(outputW, format), outputX, outputY,
+                                                           *settings, LiteGlowCore::GetBlurSetup(*settings)));
+        }
     }
 
-cleanup:
-    // Dispose all allocated worlds (safe to call even if allocation failed)
-    if (brightW_created) worldSuite->PF_DisposeWorld(in_data->effect_ref, &brightW);
-    if (blur1_created) worldSuite->PF_DisposeWorld(in_data->effect_ref, &blur1);
-    if (blur2_created) worldSuite->PF_DisposeWorld(in_data->effect_ref, &blur2);
-
     // Always release the suite, even on error paths
     in_data->pica_basicP->ReleaseSuite(kPFWorldSuite, kPFWorldSuiteVersion2);
 
@@ -932,12 +677,16 @@ typedef struct {
     float mTintG;
     float mTintB;
     int mBlendMode;
+    int mSrcOffsetX;   // Position of the output inside the input
+    int mSrcOffsetY;
+    unsigned int mGlowWidth;
+    unsigned int mGlowHeight;
 } BlendParams;
 
 // Compile-time size validation for GPU param structs
 static_assert(sizeof(BrightPassParams) == 32, "BrightPassParams size mismatch");
 static_assert(sizeof(BlurParams) == 32, "BlurParams size mismatch");
-static_assert(sizeof(BlendParams) == 48, "BlendParams size mismatch");
+static_assert(sizeof(BlendParams) == 64, "BlendParams size mismatch");
 
 // =============================================================================
 // GPU Device Setup/Setdown
@@ -1103,6 +852,7 @@ static PF_Err
 SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
                PF_PixelFormat pixel_format,
                PF_EffectWorld* input_worldP, PF_EffectWorld* output_worldP,
+               A_long outputX, A_long outputY,
                PF_SmartRenderExtra* extraP, const LiteGlowSettings* settings)
 {
     PF_Err err = PF_Err_NONE;
@@ -1134,38 +884,30 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
 
     A_long bytes_per_pixel = BYTES_PER_PIXEL_BGRA128;
 
-    // Calculate downsample factor
-    // FIX 2: Clamp quality to valid range before array access
-    int quality = settings->quality;
-    if (quality < 0) quality = 0;
-    if (quality >= QUALITY_NUM_CHOICES) quality = QUALITY_NUM_CHOICES - 1;
-    // Quality to downsample factor mapping (lower quality = higher downsample for performance)
-    static const int kQualityToDownsample[] = { 4, 2, 1 };  // Index 0=LOW, 1=MEDIUM, 2=HIGH
-    int ds = kQualityToDownsample[quality];
-    unsigned int dsW = MAX(1, (unsigned int)(output_worldP->width / ds));
-    unsigned int dsH = MAX(1, (unsigned int)(output_worldP->height / ds));
-    // Calculate ds_radius with quality bonus, clamp after to prevent overflow beyond 24
-    // Blur iterations: 2 (H+V twice) for high quality, 1 for medium/low.
-    const int blur_iterations = (quality == QUALITY_HIGH) ? 2 : 1;
-    int ds_radius = MAX(1, (int)(settings->radius / ds));
-    if (blur_iterations == 2) {
-        ds_radius += 2;
-    } else {
-        // Compensate for fewer passes (single box blur vs. repeated box blurs).
-        ds_radius = (int)(ds_radius * 1.4f + 0.5f);
+    // The output is the sub-rect of the input at (outputX, outputY); the glow
+    // covers the whole input, apron included (see SmartPreRender)
+    if (outputX < 0 || outputY < 0 ||
+        outputX + output_worldP->width > input_worldP->width ||
+        outputY + output_worldP->height > input_worldP->height) {
+        return PF_Err_BAD_CALLBACK_PARAM;
     }
-    ds_radius = MIN(ds_radius, 24);
 
-    // Calculate separate horizontal and vertical blur radii based on PAR and field rendering
-    int ds_radius_h, ds_radius_v;
-    AdjustBlurRadiusForPARAndField(ds_radius, settings->pixel_aspect_ratio, settings->field, ds_radius_h, ds_radius_v);
-    // Clamp adjusted radii to reasonable limits
-    ds_radius_h = MIN(ds_radius_h, MAX_ADJUSTED_BLUR_RADIUS);
-    ds_radius_v = MIN(ds_radius_v, 32);
+    const LiteGlowCore::BlurSetup blur = LiteGlowCore::GetHlslBlurSetup(*settings);
+    const int ds = blur.factor;
+    unsigned int dsW = MAX(1, (unsigned int)(input_worldP->width / ds));
+    unsigned int dsH = MAX(1, (unsigned int)(input_worldP->height / ds));
+    const int blur_iterations = blur.hlslIterations;
+    const int ds_radius_h = blur.radiusH;
+    const int ds_radius_v = blur.radiusV;
 
     float strength_norm = settings->strength / 2000.0f;
     float threshold_norm = settings->threshold / 255.0f;
 
+    // Passes are traced when they are submitted; the GPU runs them later
+    LiteGlowTrace::FrameArgs frame = {};
+    if (LiteGlowTrace::Enabled()) frame = TraceFrame(in_dataP, input_worldP, ds, ds_radius_h, ds_radius_v);
+    const LiteGlowTrace::Scope frameScope("SmartRenderGPU", &frame);
+
     // Allocate intermediate GPU buffers
     PF_EffectWorld* brightWorld = nullptr;
     PF_EffectWorld* blur1World = nullptr;
@@ -1220,6 +962,7 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
 
         // 1) Bright Pass
         {
+            const LiteGlowTrace::Scope passScope("gpu_bright");
             float knee_norm = settings->knee / 100.0f;
             float intensity_norm = settings->bloomIntensity / 100.0f;
             BrightPassParams params;
@@ -1242,6 +985,7 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
 
         // 2) Blur Pass 1: Horizontal
         {
+            const LiteGlowTrace::Scope passScope("gpu_blur_h1");
             BlurParams params;
             params.mSrcPitch = brightWorld->rowbytes / bytes_per_pixel;
             params.mDstPitch = blur1World->rowbytes / bytes_per_pixel;
@@ -1262,6 +1006,7 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
 
         // 3) Blur Pass 2: Vertical
         {
+            const LiteGlowTrace::Scope passScope("gpu_blur_v1");
             BlurParams params;
             params.mSrcPitch = blur1World->rowbytes / bytes_per_pixel;
             params.mDstPitch = blur2World->rowbytes / bytes_per_pixel;
@@ -1283,6 +1028,7 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
         if (blur_iterations == 2) {
             // 4) Blur Pass 3: Horizontal
             {
+                const LiteGlowTrace::Scope passScope("gpu_blur_h2");
                 BlurParams params;
                 params.mSrcPitch = blur2World->rowbytes / bytes_per_pixel;
                 params.mDstPitch = blur1World->rowbytes / bytes_per_pixel;
@@ -1303,6 +1049,7 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
 
             // 5) Blur Pass 4: Vertical
             {
+                const LiteGlowTrace::Scope passScope("gpu_blur_v2");
                 BlurParams params;
                 params.mSrcPitch = blur1World->rowbytes / bytes_per_pixel;
                 params.mDstPitch = blur2World->rowbytes / bytes_per_pixel;
@@ -1324,6 +1071,7 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
 
         // 6) Screen Blend
         {
+            const LiteGlowTrace::Scope passScope("gpu_blend");
             BlendParams params;
             params.mSrcPitch = input_worldP->rowbytes / bytes_per_pixel;
             params.mGlowPitch = blur2World->rowbytes / bytes_per_pixel;
@@ -1331,12 +1079,16 @@ SmartRenderGPU(PF_InData* in_dataP, PF_OutData* out_dataP,
             params.m16f = 0;
             params.mWidth = output_worldP->width;
             params.mHeight = output_worldP->height;
-            params.mStrength = strength_norm * SCREEN_BLEND_STRENGTH_MULTIPLIER;
+            params.mStrength = strength_norm * LiteGlowCore::SCREEN_BLEND_STRENGTH_MULTIPLIER;
             params.mFactor = ds;
             params.mTintR = settings->tintR;
             params.mTintG = settings->tintG;
             params.mTintB = settings->tintB;
             params.mBlendMode = settings->blendMode;
+            params.mSrcOffsetX = outputX;
+            params.mSrcOffsetY = outputY;
+            params.mGlowWidth = dsW;
+            params.mGlowHeight = dsH;
 
             DXShaderExecution shaderExec(dx_gpu_data->mContext, dx_gpu_data->mBlendShader, 4);
             DX_ERR(shaderExec.SetParamBuffer(&params, sizeof(BlendParams)));
@@ -1371,28 +1123,117 @@ cleanup:
 // Smart Render Handlers
 // =============================================================================
 
+// Passed from SmartPreRender to SmartRender: where the checked-out input and
+// the output sit in layer coordinates.
+typedef struct {
+    PF_LRect inputRect;
+    PF_LRect outputRect;
+} RenderRects;
+
+static void DeleteRenderRects(void* pre_render_data)
+{
+    delete static_cast<RenderRects*>(pre_render_data);
+}
+
+static PF_LRect IntersectRects(const PF_LRect& a, const PF_LRect& b)
+{
+    PF_LRect r;
+    r.left = MAX(a.left, b.left);
+    r.top = MAX(a.top, b.top);
+    r.right = MAX(r.left, MIN(a.right, b.right));
+    r.bottom = MAX(r.top, MIN(a.bottom, b.bottom));
+    return r;
+}
+
+// Rounds down to a multiple of `step`, also for negative values.
+static A_long FloorToMultiple(A_long value, A_long step)
+{
+    const A_long q = value / step;
+    return (q * step > value ? q - 1 : q) * step;
+}
+
+// Rounds up to a multiple of `step`, also for negative values.
+static A_long CeilToMultiple(A_long value, A_long step)
+{
+    return -FloorToMultiple(-value, step);
+}
+
 static PF_Err
 SmartPreRender(PF_InData* in_data, PF_OutData* out_data, PF_PreRenderExtra* pre)
 {
     PF_Err err = PF_Err_NONE;
+    PF_Err err2 = PF_Err_NONE;
     PF_RenderRequest req = pre->input->output_request;
     PF_CheckoutResult in_result;
+    AEFX_CLR_STRUCT(in_result);
 
     // Signal that GPU rendering is possible
     pre->output->flags |= PF_RenderOutputFlag_GPU_RENDER_POSSIBLE;
 
-    ERR(pre->cb->checkout_layer(
-        in_data->effect_ref,
-        LITEGLOW_INPUT,
-        LITEGLOW_INPUT,
-        &req,
-        in_data->current_time,
-        in_data->time_step,
-        in_data->time_scale,
-        &in_result));
+    // Only the blur setup decides how much input a rendered pixel needs
+    PF_ParamDef radius_param, quality_param, blur_mode_param;
+    AEFX_CLR_STRUCT(radius_param);
+    AEFX_CLR_STRUCT(quality_param);
+    AEFX_CLR_STRUCT(blur_mode_param);
+    ERR(PF_CHECKOUT_PARAM(in_data, LITEGLOW_RADIUS, in_data->current_time,
+                          in_data->time_step, in_data->time_scale, &radius_param));
+    ERR(PF_CHECKOUT_PARAM(in_data, LITEGLOW_QUALITY, in_data->current_time,
+                          in_data->time_step, in_data->time_scale, &quality_param));
+    ERR(PF_CHECKOUT_PARAM(in_data, LITEGLOW_BLUR_MODE, in_data->current_time,
+                          in_data->time_step, in_data->time_scale, &blur_mode_param));
+
+    if (!err) {
+        LiteGlowSettings settings;
+        AEFX_CLR_STRUCT(settings);
+        settings.radius = radius_param.u.fs_d.value;
+        settings.quality = quality_param.u.pd.value;
+        settings.blurMode = blur_mode_param.u.pd.value;
+        SetFrameGeometry(settings, in_data->pixel_aspect_ratio, in_data);
+
+        // Grow the request by the glow apron. The edges snap outwards to the
+        // glow grid, so the glow samples the same layer pixels whatever
+        // sub-rect is being rendered, and the last downsampled pixel the
+        // output reads is a whole one (the bilinear upsample reads one past
+        // the output; a partial one would be dropped or averaged short).
+        A_long apronX = 0, apronY = 0;
+        GetGlowApron(&settings, apronX, apronY);
+        const A_long grid = GetGlowGridStep(&settings);
+        PF_RenderRequest in_req = req;
+        in_req.rect.left = FloorToMultiple(req.rect.left - apronX, grid);
+        in_req.rect.top = FloorToMultiple(req.rect.top - apronY, grid);
+        in_req.rect.right = CeilToMultiple(req.rect.right + apronX, grid);
+        in_req.rect.bottom = CeilToMultiple(req.rect.bottom + apronY, grid);
+
+        ERR(pre->cb->checkout_layer(
+            in_data->effect_ref,
+            LITEGLOW_INPUT,
+            LITEGLOW_INPUT,
+            &in_req,
+            in_data->current_time,
+            in_data->time_step,
+            in_data->time_scale,
+            &in_result));
+    }
+
+    ERR2(PF_CHECKIN_PARAM(in_data, &radius_param));
+    ERR2(PF_CHECKIN_PARAM(in_data, &quality_param));
+    ERR2(PF_CHECKIN_PARAM(in_data, &blur_mode_param));
 
-    pre->output->result_rect = in_result.result_rect;
-    pre->output->max_result_rect = in_result.max_result_rect;
+    if (!err) {
+        // Render only what was asked for; the glow stays within the layer bounds.
+        pre->output->result_rect = IntersectRects(req.rect, in_result.result_rect);
+        pre->output->max_result_rect = in_result.max_result_rect;
+
+        RenderRects* rects = new (std::nothrow) RenderRects;
+        if (!rects) {
+            err = PF_Err_OUT_OF_MEMORY;
+        } else {
+            rects->inputRect = in_result.result_rect;
+            rects->outputRect = pre->output->result_rect;
+            pre->output->pre_render_data = rects;
+            pre->output->delete_pre_render_data_func = DeleteRenderRects;
+        }
+    }
 
     return err;
 }
@@ -1407,6 +1248,7 @@ SmartRender(PF_InData* in_data, PF_OutData* out_data, PF_SmartRenderExtra* extra
 
     PF_ParamDef strength_param, radius_param, threshold_param, quality_param;
     PF_ParamDef bloom_intensity_param, knee_param, blend_mode_param, tint_color_param;
+    PF_ParamDef blur_mode_param, budget_param;
     AEFX_CLR_STRUCT(strength_param);
     AEFX_CLR_STRUCT(radius_param);
     AEFX_CLR_STRUCT(threshold_param);
@@ -1415,6 +1257,8 @@ SmartRender(PF_InData* in_data, PF_OutData* out_data, PF_SmartRenderExtra* extra
     AEFX_CLR_STRUCT(knee_param);
     AEFX_CLR_STRUCT(blend_mode_param);
     AEFX_CLR_STRUCT(tint_color_param);
+    AEFX_CLR_STRUCT(blur_mode_param);
+    AEFX_CLR_STRUCT(budget_param);
 
     ERR(extraP->cb->checkout_layer_pixels(in_data->effect_ref, LITEGLOW_INPUT, &input_worldP));
     ERR(extraP->cb->checkout_output(in_data->effect_ref, &output_worldP));
@@ -1435,6 +1279,10 @@ SmartRender(PF_InData* in_data, PF_OutData* out_data, PF_SmartRenderExtra* extra
                           in_data->time_step, in_data->time_scale, &blend_mode_param));
     ERR(PF_CHECKOUT_PARAM(in_data, LITEGLOW_TINT_COLOR, in_data->current_time,
                           in_data->time_step, in_data->time_scale, &tint_color_param));
+    ERR(PF_CHECKOUT_PARAM(in_data, LITEGLOW_BLUR_MODE, in_data->current_time,
+                          in_data->time_step, in_data->time_scale, &blur_mode_param));
+    ERR(PF_CHECKOUT_PARAM(in_data, LITEGLOW_BUDGET, in_data->current_time,
+                          in_data->time_step, in_data->time_scale, &budget_param));
 
     if (!err && input_worldP && output_worldP) {
         LiteGlowSettings settings;
@@ -1445,14 +1293,20 @@ SmartRender(PF_InData* in_data, PF_OutData* out_data, PF_SmartRenderExtra* extra
         settings.bloomIntensity = bloom_intensity_param.u.fs_d.value;
         settings.knee = knee_param.u.fs_d.value;
         settings.blendMode = blend_mode_param.u.pd.value;
+        settings.blurMode = blur_mode_param.u.pd.value;
         // Convert tint color from 0-65535 to 0-1 range
         settings.tintR = tint_color_param.u.cd.value.red / 65535.0f;
         settings.tintG = tint_color_param.u.cd.value.green / 65535.0f;
         settings.tintB = tint_color_param.u.cd.value.blue / 65535.0f;
-        // Get pixel aspect ratio from input world
-        settings.pixel_aspect_ratio = input_worldP->pix_aspect_ratio;
-        // Get field rendering info from in_data
-        settings.field = in_data->field;
+        // Pixel aspect ratio from the input world, field and preview resolution from in_data
+        SetFrameGeometry(settings, input_worldP->pix_aspect_ratio, in_data);
+
+        // Position of the output inside the input, which carries the apron
+        A_long outputX = 0, outputY = 0;
+        if (const RenderRects* rects = static_cast<const RenderRects*>(extraP->input->pre_render_data)) {
+            outputX = rects->outputRect.left - rects->inputRect.left;
+            outputY = rects->outputRect.top - rects->inputRect.top;
+        }
 
         if (isGPU) {
             AEFX_SuiteScoper<PF_WorldSuite2> world_suite = AEFX_SuiteScoper<PF_WorldSuite2>(
@@ -1460,9 +1314,11 @@ SmartRender(PF_InData* in_data, PF_OutData* out_data, PF_SmartRenderExtra* extra
             PF_PixelFormat pixel_format = PF_PixelFormat_INVALID;
             ERR(world_suite->PF_GetPixelFormat(input_worldP, &pixel_format));
 
-            err = SmartRenderGPU(in_data, out_data, pixel_format, input_worldP, output_worldP, extraP, &settings);
+            err = SmartRenderGPU(in_data, out_data, pixel_format, input_worldP, output_worldP,
+                                 outputX, outputY, extraP, &settings);
         } else {
-            err = ProcessWorlds(in_data, out_data, &settings, input_worldP, output_worldP);
+            err = ProcessWorlds(in_data, out_data, &settings, input_worldP, output_worldP, outputX, outputY,
+                                budget_param.u.fs_d.value, RenderInstanceId(in_data));
         }
     }
 
@@ -1474,6 +1330,8 @@ SmartRender(PF_InData* in_data, PF_OutData* out_data, PF_SmartRenderExtra* extra
     ERR2(PF_CHECKIN_PARAM(in_data, &knee_param));
     ERR2(PF_CHECKIN_PARAM(in_data, &blend_mode_param));
     ERR2(PF_CHECKIN_PARAM(in_data, &tint_color_param));
+    ERR2(PF_CHECKIN_PARAM(in_data, &blur_mode_param));
+    ERR2(PF_CHECKIN_PARAM(in_data, &budget_param));
 
     return err;
 }
@@ -1491,15 +1349,15 @@ Render(PF_InData* in_data, PF_OutData* out_data, PF_ParamDef* params[], PF_Layer
     s.bloomIntensity = params[LITEGLOW_BLOOM_INTENSITY]->u.fs_d.value;
     s.knee = params[LITEGLOW_KNEE]->u.fs_d.value;
     s.blendMode = params[LITEGLOW_BLEND_MODE]->u.pd.value;
+    s.blurMode = params[LITEGLOW_BLUR_MODE]->u.pd.value;
     // Convert tint color from 0-65535 to 0-1 range
     s.tintR = params[LITEGLOW_TINT_COLOR]->u.cd.value.red / 65535.0f;
     s.tintG = params[LITEGLOW_TINT_COLOR]->u.cd.value.green / 65535.0f;
     s.tintB = params[LITEGLOW_TINT_COLOR]->u.cd.value.blue / 65535.0f;
-    // Get pixel aspect ratio from input world
-    s.pixel_aspect_ratio = inputW->pix_aspect_ratio;
-    // Get field rendering info from in_data
-    s.field = in_data->field;
-    return ProcessWorlds(in_data, out_data, &s, inputW, outputW);
+    // Pixel aspect ratio from the input world, field and preview resolution from in_data
+    SetFrameGeometry(s, inputW->pix_aspect_ratio, in_data);
+    return ProcessWorlds(in_data, out_data, &s, inputW, outputW, 0, 0,
+                         params[LITEGLOW_BUDGET]->u.fs_d.value, RenderInstanceId(in_data));
 }
 
 // =============================================================================
@@ -1545,9 +1403,28 @@ EffectMain(
         case PF_Cmd_GLOBAL_SETUP:
             err = GlobalSetup(in_data, out_data, params, output);
             break;
+        case PF_Cmd_GLOBAL_SETDOWN:
+            err = GlobalSetdown(in_data, out_data, params, output);
+            break;
         case PF_Cmd_PARAMS_SETUP:
             err = ParamsSetup(in_data, out_data, params, output);
             break;
+        case PF_Cmd_SEQUENCE_SETUP:
+            err = SequenceSetup(in_data, out_data);
+            break;
+        case PF_Cmd_SEQUENCE_RESETUP:
+            err = SequenceResetup(in_data, out_data);
+            break;
+        case PF_Cmd_SEQUENCE_FLATTEN:
+            // Already flat
+            out_data->sequence_data = in_data->sequence_data;
+            break;
+        case PF_Cmd_SEQUENCE_SETDOWN:
+            err = SequenceSetdown(in_data, out_data);
+            break;
+        case PF_Cmd_GET_FLATTENED_SEQUENCE_DATA:
+            err = GetFlattenedSequenceData(in_data, out_data);
+            break;
         case PF_Cmd_GPU_DEVICE_SETUP:
             err = GPUDeviceSetup(in_data, out_data, (PF_GPUDeviceSetupExtra*)extra);
             break;
@@ -9,6 +9,11 @@
 
 #ifdef AE_OS_WIN
     typedef unsigned short PixelType;
+    // The plugin and its core headers call std::min/std::max, which the
+    // min/max macros of <Windows.h> would break
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
     #include <Windows.h>
 #endif
 
@@ -29,6 +34,7 @@
 #include "AEGP_SuiteHandler.h"
 
 #include "LiteGlow_Strings.h"
+#include "LiteGlow_Params.h"
 
 // Version constants
 #define MAJOR_VERSION        1
@@ -38,42 +44,6 @@
 #define BUILD_VERSION        1
 #define LITEGLOW_VERSION_VALUE 528385
 
-#define STRENGTH_MIN       0
-#define STRENGTH_MAX       2000
-#define STRENGTH_DFLT      800
-
-#define RADIUS_MIN         1
-#define RADIUS_MAX         50
-#define RADIUS_DFLT        10
-
-#define THRESHOLD_MIN      0
-#define THRESHOLD_MAX      255
-#define THRESHOLD_DFLT     80
-
-// Quality settings
-#define QUALITY_LOW        1
-#define QUALITY_MEDIUM     2
-#define QUALITY_HIGH       3
-#define QUALITY_NUM_CHOICES 3
-#define QUALITY_DFLT       QUALITY_MEDIUM
-
-// Blend mode settings
-#define BLEND_MODE_SCREEN    1
-#define BLEND_MODE_ADD       2
-#define BLEND_MODE_NORMAL    3
-#define BLEND_MODE_NUM_CHOICES 3
-#define BLEND_MODE_DFLT      BLEND_MODE_SCREEN
-
-// Bloom intensity settings
-#define BLOOM_INTENSITY_MIN   0
-#define BLOOM_INTENSITY_MAX   400
-#define BLOOM_INTENSITY_DFLT  150  // Represents 1.5x when divided by 100
-
-// Threshold softness (knee) settings
-#define KNEE_MIN   0
-#define KNEE_MAX   100
-#define KNEE_DFLT  10  // Represents 0.1 when divided by 100
-
 enum {
     LITEGLOW_INPUT = 0,
     LITEGLOW_STRENGTH,
@@ -84,6 +54,8 @@ enum {
     LITEGLOW_KNEE,
     LITEGLOW_BLEND_MODE,
     LITEGLOW_TINT_COLOR,
+    LITEGLOW_BLUR_MODE,
+    LITEGLOW_BUDGET,
     LITEGLOW_NUM_PARAMS
 };
 
@@ -95,7 +67,9 @@ enum {
     BLOOM_INTENSITY_DISK_ID,
     KNEE_DISK_ID,
     BLEND_MODE_DISK_ID,
-    TINT_COLOR_DISK_ID
+    TINT_COLOR_DISK_ID,
+    BLUR_MODE_DISK_ID,
+    BUDGET_DISK_ID
 };
 
 extern "C" {
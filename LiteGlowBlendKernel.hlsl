@@ -16,6 +16,10 @@ cbuffer BlendParams : register(b0)
     float mTintG;
     float mTintB;
     int mBlendMode;
+    int mSrcOffsetX;
+    int mSrcOffsetY;
+    uint mGlowWidth;
+    uint mGlowHeight;
 };
 
 ByteAddressBuffer inSrc : register(t0);
@@ -42,6 +46,18 @@ static void StoreF4(RWByteAddressBuffer b, uint byteOffset, float4 v)
     b.Store4(byteOffset, asuint(v));
 }
 
+// Glow pixel at or left of (above) the centre of input pixel `s`, and how far
+// past it the centre lies. Both come from the phase of `s` in its glow pixel
+// rather than from its position, so a sub-rect of the input (its origin on
+// the glow grid) samples the glow with the same weights as the whole frame.
+static void GlowTap(uint s, uint factor, out int cell, out float frac)
+{
+    const uint c = s / factor;
+    const float p = ((float)(s - c * factor) + 0.5f) / (float)factor - 0.5f;
+    cell = p < 0.0f ? (int)c - 1 : (int)c;
+    frac = p < 0.0f ? p + 1.0f : p;
+}
+
 [numthreads(16, 16, 1)]
 [RootSignature(LITEGLOW_RS)]
 void main(uint3 dtid : SV_DispatchThreadID)
@@ -53,21 +69,26 @@ void main(uint3 dtid : SV_DispatchThreadID)
     const uint x = dtid.x;
     const uint y = dtid.y;
 
-    float4 original = LoadF4(inSrc, ByteOffset((uint)mSrcPitch, x, y));
+    // The output is a sub-rect of the input; the glow covers the whole input.
+    const uint sx = x + (uint)mSrcOffsetX;
+    const uint sy = y + (uint)mSrcOffsetY;
+    float4 original = LoadF4(inSrc, ByteOffset((uint)mSrcPitch, sx, sy));
 
     const uint factor = (uint)max(1, mFactor);
-    const uint glowW = max(1u, mWidth / factor);
-    const uint glowH = max(1u, mHeight / factor);
+    const uint glowW = max(1u, mGlowWidth);
+    const uint glowH = max(1u, mGlowHeight);
 
     // Bilinear upsample from glow buffer.
-    const float gx = ((float)x + 0.5f) / (float)factor - 0.5f;
-    const float gy = ((float)y + 0.5f) / (float)factor - 0.5f;
-    const int x0 = clamp((int)floor(gx), 0, (int)glowW - 1);
-    const int y0 = clamp((int)floor(gy), 0, (int)glowH - 1);
+    int cx, cy;
+    float gx, gy;
+    GlowTap(sx, factor, cx, gx);
+    GlowTap(sy, factor, cy, gy);
+    const int x0 = clamp(cx, 0, (int)glowW - 1);
+    const int y0 = clamp(cy, 0, (int)glowH - 1);
     const int x1 = min(x0 + 1, (int)glowW - 1);
     const int y1 = min(y0 + 1, (int)glowH - 1);
-    const float fx = saturate(gx - (float)x0);
-    const float fy = saturate(gy - (float)y0);
+    const float fx = cx < 0 ? 0.0f : saturate(gx);
+    const float fy = cy < 0 ? 0.0f : saturate(gy);
 
     float4 g00 = LoadF4(inGlow, ByteOffset((uint)mGlowPitch, (uint)x0, (uint)y0));
     float4 g10 = LoadF4(inGlow, ByteOffset((uint)mGlowPitch, (uint)x1, (uint)y0));
@@ -93,8 +114,18 @@ void main(uint3 dtid : SV_DispatchThreadID)
     // can produce negative values with the screen formula (which then clamp to black).
     const float3 base = saturate(original.xyz);
 
-    // Screen: 1 - (1-a)(1-b)
-    float3 rgb = 1.0f - (1.0f - base) * (1.0f - g);
+    // Blend Mode (uniform per dispatch): 1 = Screen, 2 = Add, 3 = Normal
+    float3 rgb;
+    if (mBlendMode == 2) {
+        // Add: a + b
+        rgb = base + g;
+    } else if (mBlendMode == 3) {
+        // Normal: glow over the base as premultiplied colour, coverage = brightest channel
+        rgb = g + base * (1.0f - saturate(max(g.x, max(g.y, g.z))));
+    } else {
+        // Screen: 1 - (1-a)(1-b)
+        rgb = 1.0f - (1.0f - base) * (1.0f - g);
+    }
 
     // Hard clip to display white (user requirement).
     if (any(isnan(rgb)) || any(isinf(rgb))) {
@@ -0,0 +1,720 @@
+#pragma once
+
+#ifndef LITEGLOW_BLUR_H
+#define LITEGLOW_BLUR_H
+
+// =============================================================================
+// LiteGlow Blur Kernels
+// =============================================================================
+// Line-at-a-time blur kernels used by the CPU render path.
+// This header deliberately has no After Effects SDK dependency: the pixel
+// type is either a plain channel value (one plane of a planar image) or a
+// struct with red/green/blue/alpha members, so PF_Pixel8/16/Float work
+// directly and standalone tools can reuse the same code.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace LiteGlowBlur {
+
+template <typename SumT>
+struct ChannelSums {
+    SumT red;
+    SumT green;
+    SumT blue;
+    SumT alpha;
+};
+
+template <typename SumT, typename PixelT>
+inline void AddPixel(ChannelSums<SumT>& s, const PixelT& p) noexcept {
+    s.red += p.red; s.green += p.green; s.blue += p.blue; s.alpha += p.alpha;
+}
+
+template <typename SumT, typename PixelT>
+inline void SubPixel(ChannelSums<SumT>& s, const PixelT& p) noexcept {
+    s.red -= p.red; s.green -= p.green; s.blue -= p.blue; s.alpha -= p.alpha;
+}
+
+// Divides a running sum by the tap count. Integer sums round to nearest (same
+// result as the old per-pixel kernels) with an exact reciprocal multiply:
+// with l = ceil(log2(taps)) and m = ceil(2^(31 + l) / taps), (n * m) >> (31 + l)
+// equals n / taps for every n < 2^31, so no division runs per pixel. Float
+// sums are scaled by the reciprocal of the tap count.
+template <typename SumT, bool Integral = std::is_integral<SumT>::value>
+struct TapAverage {
+    SumT inv;
+
+    explicit TapAverage(const SumT taps) noexcept : inv((SumT)1 / taps) {}
+    SumT operator()(const SumT s) const noexcept { return s * inv; }
+};
+
+template <typename SumT>
+struct TapAverage<SumT, true> {
+    std::uint64_t mul;
+    int shift;
+    SumT half;
+
+    explicit TapAverage(const SumT taps) noexcept : half(taps / 2) {
+        int bits = 0;
+        while (((std::uint64_t)1 << bits) < (std::uint64_t)taps) ++bits;
+        shift = 31 + bits;
+        mul = (((std::uint64_t)1 << shift) + (std::uint64_t)taps - 1) / (std::uint64_t)taps;
+    }
+    // `s` is a sum of non-negative samples, below 2^31 - taps / 2
+    SumT operator()(const SumT s) const noexcept {
+        return (SumT)(((std::uint64_t)(s + half) * mul) >> shift);
+    }
+};
+
+template <typename PixelT, typename SumT>
+inline void StoreAverage(PixelT* out, const ChannelSums<SumT>& s, const TapAverage<SumT>& avg) noexcept {
+    typedef decltype(out->red) ChannelT;
+    out->red   = (ChannelT)avg(s.red);
+    out->green = (ChannelT)avg(s.green);
+    out->blue  = (ChannelT)avg(s.blue);
+    out->alpha = (ChannelT)avg(s.alpha);
+}
+
+// Planes hold one channel per sample, so their running sum is a single value.
+template <typename SumT, typename ChannelT, typename std::enable_if<std::is_arithmetic<ChannelT>::value, int>::type = 0>
+inline void AddPixel(SumT& s, const ChannelT p) noexcept { s += p; }
+
+template <typename SumT, typename ChannelT, typename std::enable_if<std::is_arithmetic<ChannelT>::value, int>::type = 0>
+inline void SubPixel(SumT& s, const ChannelT p) noexcept { s -= p; }
+
+template <typename ChannelT, typename SumT, typename std::enable_if<std::is_arithmetic<SumT>::value, int>::type = 0>
+inline void StoreAverage(ChannelT* out, const SumT s, const TapAverage<SumT>& avg) noexcept {
+    *out = (ChannelT)avg(s);
+}
+
+// Running-sum state for one pixel: a scalar for plane samples, one sum per
+// channel for interleaved pixels.
+template <typename PixelT, typename SumT>
+using LineSums = typename std::conditional<std::is_arithmetic<PixelT>::value, SumT, ChannelSums<SumT>>::type;
+
+// Box-filters one line of `length` pixels with a running sum: each output
+// adds the entering tap and subtracts the leaving one, so the cost per pixel
+// does not depend on `radius`. Samples outside the line are clamped to the
+// edge pixel, so every output still averages exactly 2r+1 taps.
+// Only outputs [begin, end) are written; the running sum starts at `begin`,
+// so a span reads just the taps it needs.
+// Strides are in bytes, which lets the same kernel walk rows or columns.
+// `src` and `dst` must not alias.
+template <typename PixelT, typename SumT>
+inline void BoxBlurLineRange(
+    const char* src, const std::ptrdiff_t srcStride,
+    char* dst, const std::ptrdiff_t dstStride,
+    const int length, const int radius, int begin, int end) noexcept
+{
+    begin = std::max(begin, 0);
+    end = std::min(end, length);
+    if (!src || !dst || begin >= end) return;
+
+    const int last = length - 1;
+    auto tap = [&](const int i) -> const PixelT& {
+        return *reinterpret_cast<const PixelT*>(src + (std::ptrdiff_t)std::clamp(i, 0, last) * srcStride);
+    };
+
+    if (radius <= 0) {
+        for (int x = begin; x < end; ++x) {
+            *reinterpret_cast<PixelT*>(dst + (std::ptrdiff_t)x * dstStride) = tap(x);
+        }
+        return;
+    }
+
+    const TapAverage<SumT> avg((SumT)(2 * radius + 1));
+
+    LineSums<PixelT, SumT> s = {};
+    for (int i = begin - radius; i <= begin + radius; ++i) {
+        AddPixel(s, tap(i));
+    }
+
+    for (int x = begin; x < end; ++x) {
+        StoreAverage(reinterpret_cast<PixelT*>(dst + (std::ptrdiff_t)x * dstStride), s, avg);
+        AddPixel(s, tap(x + radius + 1));
+        SubPixel(s, tap(x - radius));
+    }
+}
+
+// The whole line.
+template <typename PixelT, typename SumT>
+inline void BoxBlurLine(
+    const char* src, const std::ptrdiff_t srcStride,
+    char* dst, const std::ptrdiff_t dstStride,
+    const int length, const int radius) noexcept
+{
+    BoxBlurLineRange<PixelT, SumT>(src, srcStride, dst, dstStride, length, radius, 0, length);
+}
+
+// =============================================================================
+// Cache-Blocked Vertical Box Blur
+// =============================================================================
+// Walking one column at a time touches a new cache line per row and uses only
+// sizeof(PixelT) bytes of it. Instead, a strip of adjacent columns is blurred
+// together: every step reads the entering and leaving rows and writes the
+// output row as short contiguous runs, keeping one running sum per column.
+
+// Bytes of each row touched per step. Small enough that many strips exist for
+// threading even on downsampled frames, large enough to cover whole cache lines.
+constexpr int BLUR_V_STRIP_BYTES = 256;
+
+template <typename PixelT>
+constexpr int BlurVStripWidth() noexcept {
+    return BLUR_V_STRIP_BYTES / (int)sizeof(PixelT) > 0 ? BLUR_V_STRIP_BYTES / (int)sizeof(PixelT) : 1;
+}
+
+// Number of strips needed to cover `width` columns.
+template <typename PixelT>
+inline int BlurVStripCount(const int width) noexcept {
+    return (width + BlurVStripWidth<PixelT>() - 1) / BlurVStripWidth<PixelT>();
+}
+
+// Vertically box-filters strip `strip` (columns [strip * StripWidth, ...)) of
+// an image, writing rows [yBegin, yEnd). Same clamp-to-edge and rounding as
+// BoxBlurLineRange, so results are identical to filtering each column
+// separately. `src` and `dst` must not alias.
+template <typename PixelT, typename SumT>
+inline void BoxBlurStripVRange(
+    const char* src, const std::ptrdiff_t srcRowBytes,
+    char* dst, const std::ptrdiff_t dstRowBytes,
+    const int width, const int height, const int radius, const int strip,
+    int yBegin, int yEnd) noexcept
+{
+    constexpr int kStripWidth = BlurVStripWidth<PixelT>();
+    const int x0 = strip * kStripWidth;
+    const int n = std::min(kStripWidth, width - x0);
+    yBegin = std::max(yBegin, 0);
+    yEnd = std::min(yEnd, height);
+    if (!src || !dst || n <= 0 || yBegin >= yEnd) return;
+
+    const int last = height - 1;
+    auto row = [&](const int y) -> const PixelT* {
+        return reinterpret_cast<const PixelT*>(src + (std::ptrdiff_t)std::clamp(y, 0, last) * srcRowBytes) + x0;
+    };
+    auto outRow = [&](const int y) -> PixelT* {
+        return reinterpret_cast<PixelT*>(dst + (std::ptrdiff_t)y * dstRowBytes) + x0;
+    };
+
+    if (radius <= 0) {
+        for (int y = yBegin; y < yEnd; ++y) {
+            std::copy(row(y), row(y) + n, outRow(y));
+        }
+        return;
+    }
+
+    const TapAverage<SumT> avg((SumT)(2 * radius + 1));
+
+    LineSums<PixelT, SumT> sums[kStripWidth] = {};
+    for (int j = yBegin - radius; j <= yBegin + radius; ++j) {
+        const PixelT* r = row(j);
+        for (int i = 0; i < n; ++i) AddPixel(sums[i], r[i]);
+    }
+
+    for (int y = yBegin; y < yEnd; ++y) {
+        PixelT* out = outRow(y);
+        const PixelT* entering = row(y + radius + 1);
+        const PixelT* leaving = row(y - radius);
+        for (int i = 0; i < n; ++i) {
+            StoreAverage(out + i, sums[i], avg);
+            AddPixel(sums[i], entering[i]);
+            SubPixel(sums[i], leaving[i]);
+        }
+    }
+}
+
+// The whole strip.
+template <typename PixelT, typename SumT>
+inline void BoxBlurStripV(
+    const char* src, const std::ptrdiff_t srcRowBytes,
+    char* dst, const std::ptrdiff_t dstRowBytes,
+    const int width, const int height, const int radius, const int strip) noexcept
+{
+    BoxBlurStripVRange<PixelT, SumT>(src, srcRowBytes, dst, dstRowBytes, width, height, radius, strip, 0, height);
+}
+
+// =============================================================================
+// Row-Fed Vertical Box Blur
+// =============================================================================
+// The same running sum for passes that only keep a window of their input
+// rows (the streaming render in LiteGlow_Core.cpp): the caller adds the
+// 2r+1 rows around the first output row with AddRowToSums, then every
+// BoxBlurRowV writes one output row and slides the window down a row. Same
+// order and rounding as BoxBlurStripVRange.
+
+template <typename PixelT, typename SumT>
+inline void AddRowToSums(LineSums<PixelT, SumT>* sums, const PixelT* row, const int width) noexcept {
+    for (int i = 0; i < width; ++i) AddPixel(sums[i], row[i]);
+}
+
+// Writes the window average to `out`, then adds `entering` (row y + r + 1)
+// and subtracts `leaving` (row y - r). Null rows are skipped: `out` when the
+// caller knows the row is black, `entering` or `leaving` when they are black
+// (adding zeros changes nothing) or when the pass has written its last row.
+template <typename PixelT, typename SumT>
+inline void BoxBlurRowV(LineSums<PixelT, SumT>* sums, const PixelT* entering, const PixelT* leaving,
+                        PixelT* out, const int width, const TapAverage<SumT>& avg) noexcept
+{
+    if (out && entering && leaving) {
+        for (int i = 0; i < width; ++i) {
+            StoreAverage(out + i, sums[i], avg);
+            AddPixel(sums[i], entering[i]);
+            SubPixel(sums[i], leaving[i]);
+        }
+        return;
+    }
+    if (out) {
+        for (int i = 0; i < width; ++i) StoreAverage(out + i, sums[i], avg);
+    }
+    if (entering) AddRowToSums<PixelT, SumT>(sums, entering, width);
+    if (leaving) {
+        for (int i = 0; i < width; ++i) SubPixel(sums[i], leaving[i]);
+    }
+}
+
+// =============================================================================
+// Recursive Gaussian (Young / van Vliet, 3rd order IIR)
+// =============================================================================
+// A causal pass followed by an anti-causal pass approximates a Gaussian with
+// a fixed 2 x 3 multiply-adds per sample and channel, at any sigma.
+// Works in place on one float plane at a time.
+
+// Below ~0.5 the Young / van Vliet fit breaks down; the blur is invisible anyway.
+constexpr float RECURSIVE_GAUSSIAN_MIN_SIGMA = 0.5f;
+
+// Small DC offset kept in the recursion state so long dark tails decay towards
+// a normal float instead of into the denormal range (which is very slow on x86).
+// The filter has unit DC gain, so the offset is removed exactly on output.
+constexpr float RECURSIVE_GAUSSIAN_DENORMAL_GUARD = 1.0e-10f;
+
+struct RecursiveGaussianCoefs {
+    float B;   // Input gain, 1 - (b1 + b2 + b3) / b0
+    float b1;  // Feedback taps, already divided by b0
+    float b2;
+    float b3;
+};
+
+inline RecursiveGaussianCoefs ComputeRecursiveGaussianCoefs(float sigma) noexcept {
+    sigma = std::max(sigma, RECURSIVE_GAUSSIAN_MIN_SIGMA);
+
+    double q;
+    if (sigma >= 2.5f) {
+        q = 0.98711 * sigma - 0.96330;
+    } else {
+        q = 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+    }
+
+    const double q2 = q * q;
+    const double q3 = q2 * q;
+    const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    const double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    const double b3 = 0.422205 * q3;
+
+    RecursiveGaussianCoefs c;
+    c.b1 = (float)(b1 / b0);
+    c.b2 = (float)(b2 / b0);
+    c.b3 = (float)(b3 / b0);
+    c.B = 1.0f - (c.b1 + c.b2 + c.b3);
+    return c;
+}
+
+// Filters `length` contiguous float samples in place.
+// Both passes start from the steady state of the edge sample, which matches
+// the clamp-to-edge behaviour of the box kernel.
+inline void RecursiveGaussianLine(float* line, const int length, const RecursiveGaussianCoefs& c) noexcept {
+    if (!line || length <= 0) return;
+
+    const float guard = RECURSIVE_GAUSSIAN_DENORMAL_GUARD;
+
+    // Causal pass
+    float s1 = line[0] + guard, s2 = s1, s3 = s1;
+    for (int i = 0; i < length; ++i) {
+        const float w0 = c.B * (line[i] + guard) + c.b1 * s1 + c.b2 * s2 + c.b3 * s3;
+        line[i] = w0;
+        s3 = s2; s2 = s1; s1 = w0;
+    }
+
+    // Anti-causal pass
+    s1 = s2 = s3 = line[length - 1];
+    for (int i = length - 1; i >= 0; --i) {
+        const float y0 = c.B * line[i] + c.b1 * s1 + c.b2 * s2 + c.b3 * s3;
+        line[i] = y0 - guard;
+        s3 = s2; s2 = s1; s1 = y0;
+    }
+}
+
+// Vertical recursive Gaussian over strip `strip` of a float plane (same strip
+// layout as BoxBlurStripV), in place. Both recursions run row by row across
+// all columns of the strip at once, so every step is a contiguous run.
+// `stride` is in floats.
+inline void RecursiveGaussianStripV(
+    float* data, const std::ptrdiff_t stride, const int width, const int height,
+    const RecursiveGaussianCoefs& c, const int strip) noexcept
+{
+    constexpr int kStripWidth = BlurVStripWidth<float>();
+    const int x0 = strip * kStripWidth;
+    const int n = std::min(kStripWidth, width - x0);
+    if (!data || n <= 0 || height <= 0) return;
+
+    const float guard = RECURSIVE_GAUSSIAN_DENORMAL_GUARD;
+    float s1[kStripWidth], s2[kStripWidth], s3[kStripWidth];
+    auto row = [&](const int y) { return data + (std::ptrdiff_t)y * stride + x0; };
+
+    // Causal pass, top to bottom
+    for (int i = 0; i < n; ++i) s1[i] = s2[i] = s3[i] = row(0)[i] + guard;
+    for (int y = 0; y < height; ++y) {
+        float* v = row(y);
+        for (int i = 0; i < n; ++i) {
+            const float w0 = c.B * (v[i] + guard) + c.b1 * s1[i] + c.b2 * s2[i] + c.b3 * s3[i];
+            v[i] = w0;
+            s3[i] = s2[i]; s2[i] = s1[i]; s1[i] = w0;
+        }
+    }
+
+    // Anti-causal pass, bottom to top
+    for (int i = 0; i < n; ++i) s1[i] = s2[i] = s3[i] = row(height - 1)[i];
+    for (int y = height - 1; y >= 0; --y) {
+        float* v = row(y);
+        for (int i = 0; i < n; ++i) {
+            const float y0 = c.B * v[i] + c.b1 * s1[i] + c.b2 * s2[i] + c.b3 * s3[i];
+            v[i] = y0 - guard;
+            s3[i] = s2[i]; s2[i] = s1[i]; s1[i] = y0;
+        }
+    }
+}
+
+// =============================================================================
+// Planar Images
+// =============================================================================
+// The glow is carried between stages as three planes (R, G, B) in normalized
+// units whatever the host bit depth: the bright pass converts once, the blend
+// converts back, and alpha is never touched in between. Samples are floats,
+// or on the fixed-point path for 8/16-bit hosts (Box blur) unsigned 16-bit
+// Q15 values with 1.0 = PLANAR_Q15_ONE. Every intermediate stage is written
+// once over the plane sample type.
+
+constexpr int PLANAR_CHANNELS = 3;
+constexpr int PLANAR_ROW_ALIGN_BYTES = 64;  // Rows start on cache line boundaries
+constexpr int PLANAR_Q15_ONE = 32768;
+
+// Samples per row for a plane `width` samples wide.
+template <typename T = float>
+inline std::ptrdiff_t PlanarStride(const int width) noexcept {
+    constexpr std::ptrdiff_t align = PLANAR_ROW_ALIGN_BYTES / (std::ptrdiff_t)sizeof(T);
+    return ((std::ptrdiff_t)width + align - 1) / align * align;
+}
+
+// One channel of an image.
+template <typename T>
+struct Plane {
+    T* data;
+    int width;
+    int height;
+    std::ptrdiff_t stride;  // Samples per row (>= width)
+
+    T* Row(const int y) const noexcept { return data + (std::ptrdiff_t)y * stride; }
+};
+
+template <typename T>
+struct PlanarRGB {
+    T* plane[PLANAR_CHANNELS];
+    int width;
+    int height;
+    std::ptrdiff_t stride;  // Samples per row, shared by all planes
+
+    T* Row(const int c, const int y) const noexcept { return plane[c] + (std::ptrdiff_t)y * stride; }
+    LiteGlowBlur::Plane<T> Plane(const int c) const noexcept {
+        return LiteGlowBlur::Plane<T>{ plane[c], width, height, stride };
+    }
+};
+
+typedef Plane<float> PlaneF;
+typedef PlanarRGB<float> PlanarRGBF;
+typedef PlanarRGB<std::uint16_t> PlanarRGB16;
+
+// Samples needed by one width x height planar image.
+template <typename T>
+inline std::size_t PlanarRGBSamples(const int width, const int height) noexcept {
+    return (std::size_t)PlanarStride<T>(width) * (std::size_t)height * PLANAR_CHANNELS;
+}
+
+inline std::size_t PlanarRGBFFloats(const int width, const int height) noexcept {
+    return PlanarRGBSamples<float>(width, height);
+}
+
+// Lays a width x height planar image over `storage` (PlanarRGBSamples<T>).
+template <typename T>
+inline PlanarRGB<T> PlanarRGBAt(T* storage, const int width, const int height) noexcept {
+    PlanarRGB<T> img;
+    img.width = width;
+    img.height = height;
+    img.stride = PlanarStride<T>(width);
+    for (int c = 0; c < PLANAR_CHANNELS; ++c) {
+        img.plane[c] = storage + (std::ptrdiff_t)c * img.stride * height;
+    }
+    return img;
+}
+
+inline PlanarRGBF PlanarRGBFAt(float* storage, const int width, const int height) noexcept {
+    return PlanarRGBAt<float>(storage, width, height);
+}
+
+// =============================================================================
+// Tile Occupancy
+// =============================================================================
+// A coarse map of where a planar image can be non-zero: one float per
+// tileW x tileH tile holding an upper bound of |sample| over the tile, so 0
+// means the tile is black. The bright pass fills it exactly and each blur
+// pass grows it by its reach, which lets later stages skip black tiles.
+
+struct TileMap {
+    float* max;
+    int cols;
+    int rows;
+    int tileW;
+    int tileH;
+
+    float& At(const int tx, const int ty) const noexcept { return max[(std::ptrdiff_t)ty * cols + tx]; }
+    bool Lit(const int tx, const int ty) const noexcept { return At(tx, ty) > 0.0f; }
+};
+
+// Tiles needed to cover `size` samples, or to cover a filter reach of `size`.
+inline int TileCount(const int size, const int tile) noexcept {
+    return (size + tile - 1) / tile;
+}
+
+// Floats needed by the map of a width x height image.
+inline std::size_t TileMapFloats(const int width, const int height, const int tileW, const int tileH) noexcept {
+    return (std::size_t)TileCount(width, tileW) * (std::size_t)TileCount(height, tileH);
+}
+
+// Lays the map of a width x height image over `storage` (TileMapFloats floats).
+inline TileMap TileMapAt(float* storage, const int width, const int height, const int tileW, const int tileH) noexcept {
+    return TileMap{ storage, TileCount(width, tileW), TileCount(height, tileH), tileW, tileH };
+}
+
+inline void FillTileMap(const TileMap& map, const float value) noexcept {
+    std::fill(map.max, map.max + (std::ptrdiff_t)map.cols * map.rows, value);
+}
+
+// Largest entry; 0 when the whole image is black.
+inline float TileMapPeak(const TileMap& map) noexcept {
+    float peak = 0.0f;
+    for (std::ptrdiff_t i = 0; i < (std::ptrdiff_t)map.cols * map.rows; ++i) peak = std::max(peak, map.max[i]);
+    return peak;
+}
+
+inline bool TileRowLit(const TileMap& map, const int ty) noexcept {
+    for (int tx = 0; tx < map.cols; ++tx) {
+        if (map.Lit(tx, ty)) return true;
+    }
+    return false;
+}
+
+// Raises tiles [txBegin, txEnd) under row y of `img` to the row's largest
+// |sample| there (in sample units: Q15 planes store Q15 values).
+template <typename T>
+inline void AccumulateTileRow(const PlanarRGB<T>& img, const int y, const TileMap& map,
+                              const int txBegin, const int txEnd) noexcept {
+    const int ty = y / map.tileH;
+    for (int c = 0; c < PLANAR_CHANNELS; ++c) {
+        const T* row = img.Row(c, y);
+        for (int tx = txBegin; tx < txEnd; ++tx) {
+            const int end = std::min(img.width, (tx + 1) * map.tileW);
+            float m = map.At(tx, ty);
+            for (int x = tx * map.tileW; x < end; ++x) m = std::max(m, std::fabs((float)row[x]));
+            map.At(tx, ty) = m;
+        }
+    }
+}
+
+// The whole row.
+template <typename T>
+inline void AccumulateTileRow(const PlanarRGB<T>& img, const int y, const TileMap& map) noexcept {
+    AccumulateTileRow(img, y, map, 0, map.cols);
+}
+
+// `dst` becomes `src` max-filtered over +-dx tile columns and +-dy tile rows:
+// the map after a filter that reaches that far. Both maps have the same shape
+// and must not alias. Only rows [ty0, ty1) of `dst` are written.
+inline void DilateTileRows(const TileMap& src, const TileMap& dst, const int dx, const int dy,
+                           const int ty0, const int ty1) noexcept {
+    for (int ty = ty0; ty < ty1; ++ty) {
+        const int y0 = std::max(0, ty - dy), y1 = std::min(src.rows - 1, ty + dy);
+        for (int tx = 0; tx < dst.cols; ++tx) {
+            const int x0 = std::max(0, tx - dx), x1 = std::min(src.cols - 1, tx + dx);
+            float m = 0.0f;
+            for (int sy = y0; sy <= y1; ++sy) {
+                for (int sx = x0; sx <= x1; ++sx) m = std::max(m, src.At(sx, sy));
+            }
+            dst.At(tx, ty) = m;
+        }
+    }
+}
+
+// The whole map.
+inline void DilateTileMap(const TileMap& src, const TileMap& dst, const int dx, const int dy) noexcept {
+    DilateTileRows(src, dst, dx, dy, 0, dst.rows);
+}
+
+// Calls fn(tx0, tx1, lit) for each run of tiles [tx0, tx1) in tile row `ty`
+// that are all lit or all black, within tiles [txBegin, txEnd).
+template <typename Fn>
+inline void ForEachTileRunX(const TileMap& map, const int ty, const int txBegin, const int txEnd, Fn&& fn) {
+    for (int tx = txBegin; tx < txEnd;) {
+        const bool lit = map.Lit(tx, ty);
+        int end = tx + 1;
+        while (end < txEnd && map.Lit(end, ty) == lit) ++end;
+        fn(tx, end, lit);
+        tx = end;
+    }
+}
+
+template <typename Fn>
+inline void ForEachTileRunX(const TileMap& map, const int ty, Fn&& fn) {
+    ForEachTileRunX(map, ty, 0, map.cols, fn);
+}
+
+// Same down tile column `tx`: fn(ty0, ty1, lit).
+template <typename Fn>
+inline void ForEachTileRunY(const TileMap& map, const int tx, const int tyBegin, const int tyEnd, Fn&& fn) {
+    for (int ty = tyBegin; ty < tyEnd;) {
+        const bool lit = map.Lit(tx, ty);
+        int end = ty + 1;
+        while (end < tyEnd && map.Lit(tx, end) == lit) ++end;
+        fn(ty, end, lit);
+        ty = end;
+    }
+}
+
+template <typename Fn>
+inline void ForEachTileRunY(const TileMap& map, const int tx, Fn&& fn) {
+    ForEachTileRunY(map, tx, 0, map.rows, fn);
+}
+
+// =============================================================================
+// Pyramid Helpers
+// =============================================================================
+// Used by the multi-scale (pyramid) bloom; each call handles one row of one plane.
+// The upsample-accumulate step is a pixel kernel (UpsampleRowFn, LiteGlow_Simd.h).
+
+// Writes row `y` of `dst` as the 2x2 box average of `src` (dst is half size,
+// rounded up; the last odd row/column of src is clamped).
+inline void DownsampleHalfRow(const PlaneF& src, const PlaneF& dst, const int y) noexcept {
+    const float* r0 = src.Row(std::min(2 * y, src.height - 1));
+    const float* r1 = src.Row(std::min(2 * y + 1, src.height - 1));
+    float* out = dst.Row(y);
+    const int lastX = src.width - 1;
+    for (int x = 0; x < dst.width; ++x) {
+        const int x0 = std::min(2 * x, lastX);
+        const int x1 = std::min(2 * x + 1, lastX);
+        out[x] = 0.25f * (r0[x0] + r0[x1] + r1[x0] + r1[x1]);
+    }
+}
+
+// =============================================================================
+// Fractional Resampling
+// =============================================================================
+// Moves planes between the downsampled grid and a coarser one whose step is a
+// ratio of whole samples, `period` source samples per `phases` outputs (the
+// Adaptive Quality blur grid, steps in [1, 2)). The weights of output i only
+// depend on i % phases, so each direction is a small polyphase table; sources
+// past either end are clamped, which repeats the edge sample.
+
+constexpr int RESAMPLE_MAX_PHASES = 16;  // Outputs per period of the upsample (steps up to 15/8)
+constexpr int RESAMPLE_MAX_TAPS = 3;     // An area under 2 samples wide overlaps at most 3
+
+struct ResampleTap {
+    int first;                        // First source sample, from the start of the period
+    float weight[RESAMPLE_MAX_TAPS];  // Unused taps weigh 0
+};
+
+struct ResamplePhases {
+    int phases;    // Outputs per period
+    int period;    // Source samples per period
+    ResampleTap tap[RESAMPLE_MAX_PHASES];
+};
+
+// Area average: output i covers source samples [i, i + 1) * period / phases
+// (period >= phases).
+inline ResamplePhases AreaDownPhases(const int phases, const int period) noexcept {
+    ResamplePhases r = {};
+    r.phases = phases;
+    r.period = period;
+    for (int p = 0; p < phases; ++p) {
+        // In 1/phases of a source sample: the output covers [begin, end)
+        const int begin = p * period;
+        const int end = begin + period;
+        ResampleTap& tap = r.tap[p];
+        tap.first = begin / phases;
+        for (int t = 0; t < RESAMPLE_MAX_TAPS; ++t) {
+            const int s0 = (tap.first + t) * phases;
+            const int overlap = std::max(0, std::min(end, s0 + phases) - std::max(begin, s0));
+            tap.weight[t] = (float)overlap / (float)period;
+        }
+    }
+    return r;
+}
+
+// Linear interpolation of a coarse grid at the sample centers of a finer one:
+// `phases` fine outputs per `period` coarse samples (phases >= period), the
+// inverse of AreaDownPhases(period, phases).
+inline ResamplePhases LinearUpPhases(const int phases, const int period) noexcept {
+    ResamplePhases r = {};
+    r.phases = phases;
+    r.period = period;
+    for (int p = 0; p < phases; ++p) {
+        // Center of fine sample p in coarse samples: (2p + 1 - phases / period) / (2 phases / period)
+        const int num = (2 * p + 1) * period - phases;
+        const int den = 2 * phases;
+        ResampleTap& tap = r.tap[p];
+        tap.first = num >= 0 ? num / den : -((den - 1 - num) / den);
+        const float frac = (float)(num - tap.first * den) / (float)den;
+        tap.weight[0] = 1.0f - frac;
+        tap.weight[1] = frac;
+        tap.weight[2] = 0.0f;
+    }
+    return r;
+}
+
+// Resamples one line of `inLength` samples into `outLength` ones.
+inline void ResampleLine(const float* in, const int inLength, float* out, const int outLength,
+                         const ResamplePhases& r) noexcept {
+    for (int i0 = 0, s0 = 0; i0 < outLength; i0 += r.phases, s0 += r.period) {
+        const int n = std::min(r.phases, outLength - i0);
+        for (int p = 0; p < n; ++p) {
+            const ResampleTap& tap = r.tap[p];
+            const int s = s0 + tap.first;
+            if (s >= 0 && s + RESAMPLE_MAX_TAPS <= inLength) {
+                out[i0 + p] = tap.weight[0] * in[s] + tap.weight[1] * in[s + 1] + tap.weight[2] * in[s + 2];
+            } else {
+                float sum = 0.0f;
+                for (int t = 0; t < RESAMPLE_MAX_TAPS; ++t) {
+                    sum += tap.weight[t] * in[std::max(0, std::min(inLength - 1, s + t))];
+                }
+                out[i0 + p] = sum;
+            }
+        }
+    }
+}
+
+// Writes row `y` of `dst` from the rows of `src` its taps select.
+inline void ResampleRowV(const PlaneF& src, const PlaneF& dst, const int y, const ResamplePhases& r) noexcept {
+    const ResampleTap& tap = r.tap[y % r.phases];
+    const int s = y / r.phases * r.period + tap.first;
+    const float* r0 = src.Row(std::max(0, std::min(src.height - 1, s)));
+    const float* r1 = src.Row(std::max(0, std::min(src.height - 1, s + 1)));
+    const float* r2 = src.Row(std::max(0, std::min(src.height - 1, s + 2)));
+    const float w0 = tap.weight[0];
+    const float w1 = tap.weight[1];
+    const float w2 = tap.weight[2];
+    float* out = dst.Row(y);
+    for (int x = 0; x < dst.width; ++x) out[x] = w0 * r0[x] + w1 * r1[x] + w2 * r2[x];
+}
+
+} // namespace LiteGlowBlur
+
+#endif // LITEGLOW_BLUR_H
@@ -0,0 +1,256 @@
+/*	LiteGlow_Capture.cpp
+
+	Capture files of CPU renders: writing them, and mapping them back.
+	See LiteGlow_Capture.h for the format.
+
+*/
+
+#include "LiteGlow_Capture.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX  // Keep std::min/std::max usable
+    #endif
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace LiteGlowCapture {
+
+namespace {
+
+std::mutex gMutex;                // Guards gDirectory
+std::string gDirectory;
+std::atomic<bool> gEnabled{ false };
+std::atomic<int> gNextFrame{ 0 };
+int gMaxFrames = 0;
+
+CaptureHeader MakeHeader(const Frame& frame) noexcept {
+    CaptureHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, CAPTURE_MAGIC, sizeof(h.magic));
+    h.version = CAPTURE_VERSION;
+    h.dataOffset = (std::uint32_t)CAPTURE_DATA_OFFSET;
+    h.format = frame.input.format;
+    h.width = frame.input.width;
+    h.height = frame.input.height;
+    h.outputX = frame.outputX;
+    h.outputY = frame.outputY;
+    h.outputWidth = frame.outputWidth;
+    h.outputHeight = frame.outputHeight;
+    h.time = frame.time;
+    const LiteGlowCore::Settings& s = frame.settings;
+    h.strength = s.strength;
+    h.radius = s.radius;
+    h.threshold = s.threshold;
+    h.quality = s.quality;
+    h.bloomIntensity = s.bloomIntensity;
+    h.knee = s.knee;
+    h.blendMode = s.blendMode;
+    h.blurMode = s.blurMode;
+    h.tintR = s.tintR;
+    h.tintG = s.tintG;
+    h.tintB = s.tintB;
+    h.parNum = s.parNum;
+    h.parDen = s.parDen;
+    h.field = s.field;
+    h.previewScaleX = s.previewScaleX;
+    h.previewScaleY = s.previewScaleY;
+    h.budgetMs = frame.budgetMs;
+    h.instance = frame.instance;
+    return h;
+}
+
+LiteGlowCore::Settings HeaderSettings(const CaptureHeader& h) noexcept {
+    LiteGlowCore::Settings s;
+    s.strength = h.strength;
+    s.radius = h.radius;
+    s.threshold = h.threshold;
+    s.quality = h.quality;
+    s.bloomIntensity = h.bloomIntensity;
+    s.knee = h.knee;
+    s.blendMode = h.blendMode;
+    s.blurMode = h.blurMode;
+    s.tintR = h.tintR;
+    s.tintG = h.tintG;
+    s.tintB = h.tintB;
+    s.parNum = h.parNum;
+    s.parDen = h.parDen;
+    s.field = (LiteGlowCore::Field)h.field;
+    // Zero in version 1 files, where the header was padded
+    s.previewScaleX = h.previewScaleX;
+    s.previewScaleY = h.previewScaleY;
+    return s;
+}
+
+// Why `h` does not describe a capture of `fileBytes` bytes; null if it does.
+const char* CheckHeader(const CaptureHeader& h, const std::uint64_t fileBytes) noexcept {
+    if (std::memcmp(h.magic, CAPTURE_MAGIC, sizeof(h.magic)) != 0) return "not a LiteGlow capture";
+    if (h.version < 1 || h.version > CAPTURE_VERSION) return "unsupported capture version";
+    if (h.dataOffset < sizeof(CaptureHeader)) return "bad pixel offset";
+    if (h.format < LiteGlowCore::FORMAT_ARGB32 || h.format > LiteGlowCore::FORMAT_BGRA128) return "unknown pixel format";
+    if (h.width <= 0 || h.height <= 0) return "empty input";
+    if (h.outputWidth <= 0 || h.outputHeight <= 0 || h.outputX < 0 || h.outputY < 0 ||
+        h.outputWidth > h.width - h.outputX || h.outputHeight > h.height - h.outputY) {
+        return "output rect outside the input";
+    }
+    const std::uint64_t rowBytes = (std::uint64_t)h.width * LiteGlowCore::PixelBytes((LiteGlowCore::PixelFormat)h.format);
+    if (fileBytes < h.dataOffset + rowBytes * (std::uint64_t)h.height) return "file is truncated";
+    return nullptr;
+}
+
+} // namespace
+
+bool Write(const char* path, const Frame& frame) noexcept {
+    const LiteGlowCore::ImageView& in = frame.input;
+    if (!path || !in.data || in.width <= 0 || in.height <= 0) return false;
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+
+    static const char zeros[CAPTURE_DATA_OFFSET] = {};
+    const CaptureHeader header = MakeHeader(frame);
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+              std::fwrite(zeros, CAPTURE_DATA_OFFSET - sizeof(header), 1, f) == 1;
+    const std::size_t rowBytes = (std::size_t)in.width * LiteGlowCore::PixelBytes(in.format);
+    for (int y = 0; ok && y < in.height; ++y) {
+        ok = std::fwrite(static_cast<const char*>(in.data) + y * in.rowBytes, rowBytes, 1, f) == 1;
+    }
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) std::remove(path);
+    return ok;
+}
+
+void Start(const char* directory, const int maxFrames) noexcept {
+    if (!directory || !directory[0] || maxFrames <= 0) return;
+    std::lock_guard<std::mutex> lock(gMutex);
+    try {
+        gDirectory = directory;
+    } catch (...) {
+        return;
+    }
+    gMaxFrames = maxFrames;
+    gNextFrame.store(0, std::memory_order_relaxed);
+    gEnabled.store(true, std::memory_order_release);
+}
+
+bool Enabled() noexcept {
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+bool CaptureFrame(const Frame& frame) noexcept {
+    if (!gEnabled.load(std::memory_order_acquire)) return false;
+    const int index = gNextFrame.fetch_add(1, std::memory_order_relaxed);
+    if (index >= gMaxFrames) return false;
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "liteglow_%06d.lgcap", index);
+    std::string path;
+    try {
+        std::lock_guard<std::mutex> lock(gMutex);
+        path = gDirectory + "/" + name;
+    } catch (...) {
+        return false;
+    }
+    return Write(path.c_str(), frame);
+}
+
+bool MappedCapture::Open(const char* path) noexcept {
+    Close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        mError = "cannot open file";
+        return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (!mapping) {
+        mError = "cannot map file";
+        return false;
+    }
+    // The view keeps the mapping alive
+    mBase = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!mBase) {
+        mError = "cannot map file";
+        return false;
+    }
+    mBytes = (std::size_t)size.QuadPart;
+#else
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        mError = "cannot open file";
+        return false;
+    }
+    struct stat st;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);  // The mapping keeps the file alive
+    if (base == MAP_FAILED) {
+        mError = "cannot map file";
+        return false;
+    }
+    mBase = base;
+    mBytes = (std::size_t)st.st_size;
+#endif
+
+    if (mBytes < sizeof(CaptureHeader)) {
+        Close();
+        mError = "file is truncated";
+        return false;
+    }
+    CaptureHeader h;
+    std::memcpy(&h, mBase, sizeof(h));
+    if (const char* error = CheckHeader(h, mBytes)) {
+        Close();
+        mError = error;
+        return false;
+    }
+
+    const LiteGlowCore::PixelFormat format = (LiteGlowCore::PixelFormat)h.format;
+    mFrame.input = LiteGlowCore::ImageView{ static_cast<char*>(mBase) + h.dataOffset,
+                                            (std::ptrdiff_t)h.width * LiteGlowCore::PixelBytes(format),
+                                            h.width, h.height, format };
+    mFrame.outputX = h.outputX;
+    mFrame.outputY = h.outputY;
+    mFrame.outputWidth = h.outputWidth;
+    mFrame.outputHeight = h.outputHeight;
+    mFrame.settings = HeaderSettings(h);
+    mFrame.time = h.time;
+    // Not in files before version 3
+    mFrame.budgetMs = h.version >= 3 ? h.budgetMs : (double)BUDGET_DFLT;
+    mFrame.instance = h.version >= 3 ? h.instance : 0;
+    mError = "";
+    return true;
+}
+
+void MappedCapture::Close() noexcept {
+    if (mBase) {
+#if defined(_WIN32)
+        UnmapViewOfFile(mBase);
+#else
+        munmap(mBase, mBytes);
+#endif
+    }
+    mBase = nullptr;
+    mBytes = 0;
+    mFrame = Frame{};
+}
+
+} // namespace LiteGlowCapture
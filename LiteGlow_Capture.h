@@ -0,0 +1,129 @@
+#pragma once
+
+#ifndef LITEGLOW_CAPTURE_H
+#define LITEGLOW_CAPTURE_H
+
+// =============================================================================
+// LiteGlow Capture
+// =============================================================================
+// Production frames for offline profiling. With capture on (LITEGLOW_CAPTURE
+// names a directory, GlobalSetup), every CPU render writes what ProcessWorlds
+// renders - the input pixels, their format, the output rect, the settings,
+// the Auto budget and the instance id - to one file there;
+// bench/GlowReplay.cpp maps such files and renders them again, so a slow
+// shot can be reproduced and profiled without After Effects.
+//
+// File layout (native byte order, little-endian on every supported host):
+//   CaptureHeader, zero-padded to CAPTURE_DATA_OFFSET bytes
+//   input rows, top to bottom, width * PixelBytes(format) bytes each
+// The pixels start on a page boundary, so a read-only mapping of the file is
+// used as the input image as is, without copying.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include "LiteGlow_Core.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LiteGlowCapture {
+
+constexpr char CAPTURE_MAGIC[8] = { 'L', 'G', 'C', 'A', 'P', 'T', 'R', '\0' };
+constexpr std::uint32_t CAPTURE_VERSION = 3;   // 3 added the budget and instance, 2 the preview scale
+constexpr std::size_t CAPTURE_DATA_OFFSET = 4096;
+constexpr int CAPTURE_DEFAULT_MAX_FRAMES = 100;   // An 8K float frame is over 500 MB
+
+// Fixed-size fields only, so the layout is the same for every compiler.
+struct CaptureHeader {
+    char magic[8];               // CAPTURE_MAGIC
+    std::uint32_t version;       // CAPTURE_VERSION
+    std::uint32_t dataOffset;    // CAPTURE_DATA_OFFSET
+    std::int32_t format;         // LiteGlowCore::PixelFormat
+    std::int32_t width;          // Input size
+    std::int32_t height;
+    std::int32_t outputX;        // Output rect within the input
+    std::int32_t outputY;
+    std::int32_t outputWidth;
+    std::int32_t outputHeight;
+    std::int32_t reserved;
+    double time;                 // Frame time in seconds
+    // LiteGlowCore::Settings
+    float strength;
+    float radius;
+    float threshold;
+    std::int32_t quality;
+    float bloomIntensity;
+    float knee;
+    std::int32_t blendMode;
+    std::int32_t blurMode;
+    float tintR;
+    float tintG;
+    float tintB;
+    std::int32_t parNum;
+    std::int32_t parDen;
+    std::int32_t field;
+    float previewScaleX;
+    float previewScaleY;
+    double budgetMs;             // Budget parameter (Quality Auto)
+    std::uint64_t instance;      // Effect instance id (sequence data)
+};
+
+static_assert(sizeof(CaptureHeader) <= CAPTURE_DATA_OFFSET, "Capture header must fit before the pixels");
+
+// One render call, as ProcessWorlds makes it. Captures before version 3
+// read with the default Budget and instance 0 (no temporal cache).
+struct Frame {
+    LiteGlowCore::ImageView input;
+    int outputX;
+    int outputY;
+    int outputWidth;
+    int outputHeight;
+    LiteGlowCore::Settings settings;
+    double time;
+    double budgetMs;
+    std::uint64_t instance;
+};
+
+// Writes `frame` to `path`. Returns false (and leaves no partial file) if it
+// could not be written.
+bool Write(const char* path, const Frame& frame) noexcept;
+
+// Turns capture on: CaptureFrame then writes up to `maxFrames` frames into
+// `directory` (copied). Null or empty leaves capture off. Call before
+// rendering.
+void Start(const char* directory, int maxFrames = CAPTURE_DEFAULT_MAX_FRAMES) noexcept;
+
+bool Enabled() noexcept;
+
+// Writes `frame` as the next "liteglow_NNNNNN.lgcap" of the Start directory.
+// Safe to call from concurrent renders. Returns false once the frame limit
+// is reached or if the file could not be written.
+bool CaptureFrame(const Frame& frame) noexcept;
+
+// Read-only mapping of a capture file. frame.input points into the mapping
+// and stays valid until Close or destruction; it must not be written.
+class MappedCapture {
+public:
+    MappedCapture() noexcept = default;
+    ~MappedCapture() { Close(); }
+    MappedCapture(const MappedCapture&) = delete;
+    MappedCapture& operator=(const MappedCapture&) = delete;
+
+    // Maps `path` and checks its header and size. On failure returns false
+    // with a reason in Error().
+    bool Open(const char* path) noexcept;
+    void Close() noexcept;
+
+    const Frame& Get() const noexcept { return mFrame; }
+    const char* Error() const noexcept { return mError; }
+
+private:
+    void* mBase = nullptr;
+    std::size_t mBytes = 0;
+    Frame mFrame = {};
+    const char* mError = "";
+};
+
+} // namespace LiteGlowCapture
+
+#endif // LITEGLOW_CAPTURE_H
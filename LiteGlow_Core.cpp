@@ -0,0 +1,2395 @@
+/*	LiteGlow_Core.cpp
+
+	The CPU glow pipeline over plain strided images.
+	See LiteGlow_Core.h for the model.
+
+*/
+
+#include "LiteGlow_Core.h"
+
+#include "LiteGlow_Blur.h"
+#include "LiteGlow_GlowCache.h"
+#include "LiteGlow_Scheduler.h"
+#include "LiteGlow_ScratchPool.h"
+#include "LiteGlow_Simd.h"
+#include "LiteGlow_TemporalCache.h"
+#include "LiteGlow_Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+namespace LiteGlowCore {
+
+namespace {
+
+constexpr int PYRAMID_MAX_LEVELS = 8;       // Base level plus up to 7 octaves (2x .. 128x)
+constexpr int PYRAMID_LEVEL_RADIUS = 2;     // Fixed box radius blurred at every pyramid level
+constexpr int PYRAMID_MIN_LEVEL_SIZE = 4;   // Stop halving once a level gets this small
+constexpr int ADAPTIVE_GRID_RADIUS = 12;    // Adaptive Quality: box radius in blur grid pixels
+constexpr int BOX_MAX_RADIUS = 24;          // Low/Medium/High: box radius clamp in blur grid pixels
+constexpr int ADAPTIVE_PHASES = 8;          // Adaptive Quality: fractional grid steps are in 1/8
+
+bool gFixedPoint = true;
+std::size_t gStreamingBytes = STREAMING_DEFAULT_BYTES;
+Pipeline gPipeline = PIPELINE_CPU;
+
+inline const char* RowAt(const ImageView& img, const int y) noexcept {
+    return static_cast<const char*>(img.data) + y * img.rowBytes;
+}
+
+inline char* PixelAt(const ImageView& img, const int x, const int y) noexcept {
+    return static_cast<char*>(img.data) + y * img.rowBytes + (std::ptrdiff_t)x * PixelBytes(img.format);
+}
+
+// =============================================================================
+// Bright Pass Functions
+// =============================================================================
+// The bright pass is the only stage that reads the input format: it
+// converts to normalized R/G/B planes (float, or Q15 on the fixed-point path),
+// and every later stage up to the blend works on those planes (see Planar
+// Images in LiteGlow_Blur.h).
+
+// Kernel table indices for an image format.
+inline LiteGlowSimd::PixelDepth KernelDepth(const PixelFormat format) noexcept {
+    return format == FORMAT_ARGB32 || format == FORMAT_BGRA32 ? LiteGlowSimd::DEPTH_8
+         : format == FORMAT_ARGB64 || format == FORMAT_BGRA64 ? LiteGlowSimd::DEPTH_16
+         : LiteGlowSimd::DEPTH_FLOAT;
+}
+
+inline LiteGlowSimd::PixelLayout KernelLayout(const PixelFormat format) noexcept {
+    return format >= FORMAT_BGRA32 ? LiteGlowSimd::LAYOUT_BGRA : LiteGlowSimd::LAYOUT_ARGB;
+}
+
+typedef struct {
+    LiteGlowSimd::BrightParams params;  // Normalized threshold, knee and intensity
+    LiteGlowSimd::BrightRowFn row;      // Active kernel for the source format
+    const ImageView* src;
+    int factor;
+    LiteGlowBlur::PlanarRGBF dst;
+    // Fixed-point path: rowQ15 is set and writes dstQ15 instead
+    LiteGlowSimd::BrightRowQ15Fn rowQ15;
+    const LiteGlowSimd::BrightResponse* response;  // Knee table of 8/16-bit sources
+    LiteGlowBlur::PlanarRGB16 dstQ15;
+} BrightPassInfo;
+
+// Fills row `dstRow` of the bright planes (row y, except when streaming)
+// from source row y * factor, point-sampling every factor-th pixel.
+// Luma (Rec. 709) goes through a soft knee around the threshold (tabulated
+// for integer depths); integer depths saturate at white, as the old 8/16-bit
+// bright worlds did.
+// Only columns [x0, x1) of the row are written by BrightPassSpan; each
+// reads just its own source pixel, so spans match the whole row.
+void BrightPassSpan(const BrightPassInfo* bp, int y, int dstRow, int x0, int x1) {
+    const int factor = std::max(1, bp->factor);
+    const int sy = std::min(bp->src->height - 1, y * factor);
+    const char* srcRow = RowAt(*bp->src, sy) + (std::ptrdiff_t)x0 * factor * PixelBytes(bp->src->format);
+    const int srcWidth = bp->src->width - x0 * factor;
+    if (bp->rowQ15) {
+        bp->rowQ15(srcRow, srcWidth, factor, *bp->response, bp->dstQ15.Row(0, dstRow) + x0,
+                   bp->dstQ15.Row(1, dstRow) + x0, bp->dstQ15.Row(2, dstRow) + x0, x1 - x0);
+    } else {
+        bp->row(srcRow, srcWidth, factor, bp->params, bp->response,
+                bp->dst.Row(0, dstRow) + x0, bp->dst.Row(1, dstRow) + x0, bp->dst.Row(2, dstRow) + x0, x1 - x0);
+    }
+}
+
+void BrightPassRow(const BrightPassInfo* bp, int y, int dstRow) {
+    BrightPassSpan(bp, y, dstRow, 0, bp->rowQ15 ? bp->dstQ15.width : bp->dst.width);
+}
+
+// =============================================================================
+// CPU Scheduling Helpers
+// =============================================================================
+// CPU stages run on LiteGlow's own worker pool (LiteGlow_Scheduler.h): tasks
+// are whole row bands or column strips, and RenderGlow runs them as one task
+// graph: per-band edges where a stage reads only the bands of the one before,
+// whole-stage edges where it reads across them.
+
+// Rows per task for row-wise stages: enough work to amortize scheduling,
+// small enough to balance across workers on downsampled frames.
+constexpr int TASK_BAND_ROWS = 16;
+
+inline int BandCount(int height) noexcept {
+    return (height + TASK_BAND_ROWS - 1) / TASK_BAND_ROWS;
+}
+
+// Row range [begin, end) of `band`.
+inline int BandBegin(int band) noexcept { return band * TASK_BAND_ROWS; }
+inline int BandEnd(int band, int height) noexcept { return std::min(height, (band + 1) * TASK_BAND_ROWS); }
+
+// Vertical passes are split by columns: one task per (plane, column strip).
+inline int StripItems(int width) noexcept {
+    return LiteGlowBlur::PLANAR_CHANNELS * LiteGlowBlur::BlurVStripCount<float>(width);
+}
+
+// Occupancy tiles (TileMap in LiteGlow_Blur.h) are one row band by one column
+// strip, so every band or strip task owns whole tiles.
+constexpr int GLOW_TILE_W = LiteGlowBlur::BlurVStripWidth<float>();
+constexpr int GLOW_TILE_H = TASK_BAND_ROWS;
+
+bool gStageCounters = false;
+
+// Counter of the stage the calling thread is running, with stage counters on
+// (StageScope).
+thread_local LiteGlowPerf::StageCounter* tStageCounter = nullptr;
+
+// Runs fn(i) for every i in [0, count) on the worker pool.
+// Every call must touch disjoint output (one band, one strip, ...).
+template <typename Fn>
+Status ParallelFor(int count, Fn& fn) {
+    if (LiteGlowPerf::StageCounter* counter = tStageCounter) {
+        auto counted = [&](int i) { LiteGlowPerf::CountCall(*counter, [&] { fn(i); }); };
+        return LiteGlowSched::ParallelFor(count, counted) ? STATUS_OK : STATUS_OUT_OF_MEMORY;
+    }
+    return LiteGlowSched::ParallelFor(count, fn) ? STATUS_OK : STATUS_OUT_OF_MEMORY;
+}
+
+// One stage of a timed or traced render: adds its wall-clock time to *ms,
+// if given, and records it as a `name` span while tracing is on
+// (LiteGlow_Trace.h). With stage counters on and `counts` given, the tasks
+// it runs through ParallelFor meanwhile are counted into *counts (and the
+// span).
+class StageScope {
+public:
+    StageScope(const char* name, double* ms, LiteGlowPerf::Counts* counts) noexcept
+        : mName(LiteGlowTrace::Enabled() ? name : nullptr), mMs(ms),
+          mCounts(gStageCounters ? counts : nullptr), mPrevCounter(tStageCounter)
+    {
+        if (mName) mTraceBegin = LiteGlowTrace::Now();
+        if (mMs) mStart = std::chrono::steady_clock::now();
+        if (mCounts) tStageCounter = &mCounter;
+    }
+    ~StageScope() {
+        if (mMs) *mMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count();
+        tStageCounter = mPrevCounter;
+        if (mCounts) *mCounts = mCounter.Total();
+        if (mName) LiteGlowTrace::Record(mName, mTraceBegin, LiteGlowTrace::Now(), nullptr, mCounts);
+    }
+
+    StageScope(const StageScope&) = delete;
+    StageScope& operator=(const StageScope&) = delete;
+
+private:
+    const char* mName;
+    double* mMs;
+    LiteGlowPerf::Counts* mCounts;
+    LiteGlowPerf::StageCounter* mPrevCounter;
+    LiteGlowPerf::StageCounter mCounter;
+    std::uint64_t mTraceBegin = 0;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+// =============================================================================
+// Blur Functions (Running-Sum Box Blur for Gaussian Approximation)
+// =============================================================================
+// Each task filters one band of rows (H) or one column strip of one plane (V)
+// with the kernels from LiteGlow_Blur.h, so the cost per pixel is independent
+// of radius.
+// Passes given `tiles`, the occupancy of their output, only filter lit tiles
+// and zero-fill the rest; without it every tile is filtered. Passes also
+// given `changed` (temporal renders) leave the tiles it does not mark alone.
+
+// Running sum of the box passes per plane sample type: Q15 sums of up to
+// 2 * 32 + 1 taps fit 32 bits.
+template <typename T> struct BoxSum { typedef double Type; };
+template <> struct BoxSum<std::uint16_t> { typedef std::uint32_t Type; };
+
+// Horizontal box blur of one row band, all three planes. `src` != `dst`.
+template <typename T>
+void BlurBandH(const LiteGlowBlur::PlanarRGB<T>& src, const LiteGlowBlur::PlanarRGB<T>& dst,
+               int radius, int band, const LiteGlowBlur::TileMap* tiles = nullptr,
+               const LiteGlowBlur::TileMap* changed = nullptr)
+{
+    typedef typename BoxSum<T>::Type SumT;
+    const int end = BandEnd(band, src.height);
+    for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+        for (int y = BandBegin(band); y < end; ++y) {
+            const char* in = (const char*)src.Row(c, y);
+            char* out = (char*)dst.Row(c, y);
+            if (!tiles) {
+                LiteGlowBlur::BoxBlurLine<T, SumT>(in, sizeof(T), out, sizeof(T), src.width, radius);
+                continue;
+            }
+            auto filter = [&](int tx0, int tx1, bool lit) {
+                const int x0 = tx0 * GLOW_TILE_W;
+                const int x1 = std::min(src.width, tx1 * GLOW_TILE_W);
+                if (lit) {
+                    LiteGlowBlur::BoxBlurLineRange<T, SumT>(in, sizeof(T), out, sizeof(T), src.width, radius, x0, x1);
+                } else {
+                    std::fill(dst.Row(c, y) + x0, dst.Row(c, y) + x1, (T)0);
+                }
+            };
+            if (!changed) {
+                LiteGlowBlur::ForEachTileRunX(*tiles, band, filter);
+                continue;
+            }
+            LiteGlowBlur::ForEachTileRunX(*changed, band, [&](int cx0, int cx1, bool run) {
+                if (run) LiteGlowBlur::ForEachTileRunX(*tiles, band, cx0, cx1, filter);
+            });
+        }
+    }
+}
+
+// Vertical box blur of task `item` (see StripItems). `src` != `dst`.
+// Strips are GLOW_TILE_W columns for every sample type, so each covers
+// exactly one column of tiles.
+template <typename T>
+void BlurStripV(const LiteGlowBlur::PlanarRGB<T>& src, const LiteGlowBlur::PlanarRGB<T>& dst,
+                int radius, int item, const LiteGlowBlur::TileMap* tiles = nullptr,
+                const LiteGlowBlur::TileMap* changed = nullptr)
+{
+    typedef typename BoxSum<T>::Type SumT;
+    static_assert(GLOW_TILE_W <= LiteGlowBlur::BlurVStripWidth<T>(), "a tile column must fit one blur strip");
+    const int strips = LiteGlowBlur::TileCount(src.width, GLOW_TILE_W);
+    const int c = item / strips;
+    const int x0 = (item % strips) * GLOW_TILE_W;
+    const int n = std::min(GLOW_TILE_W, src.width - x0);
+    const std::ptrdiff_t rowBytes = src.stride * (std::ptrdiff_t)sizeof(T);
+    const char* in = (const char*)(src.plane[c] + x0);
+    char* out = (char*)(dst.plane[c] + x0);
+    if (!tiles) {
+        LiteGlowBlur::BoxBlurStripV<T, SumT>(in, rowBytes, out, rowBytes, n, src.height, radius, 0);
+        return;
+    }
+    const int tx = item % strips;
+    auto filter = [&](int ty0, int ty1, bool lit) {
+        const int y0 = ty0 * GLOW_TILE_H;
+        const int y1 = std::min(src.height, ty1 * GLOW_TILE_H);
+        if (lit) {
+            LiteGlowBlur::BoxBlurStripVRange<T, SumT>(in, rowBytes, out, rowBytes, n, src.height, radius, 0, y0, y1);
+        } else {
+            for (int y = y0; y < y1; ++y) std::fill(dst.Row(c, y) + x0, dst.Row(c, y) + x0 + n, (T)0);
+        }
+    };
+    if (!changed) {
+        LiteGlowBlur::ForEachTileRunY(*tiles, tx, filter);
+        return;
+    }
+    LiteGlowBlur::ForEachTileRunY(*changed, tx, [&](int cy0, int cy1, bool run) {
+        if (run) LiteGlowBlur::ForEachTileRunY(*tiles, tx, cy0, cy1, filter);
+    });
+}
+
+// Copies one row band of all three planes.
+void CopyBand(const LiteGlowBlur::PlanarRGBF& src, const LiteGlowBlur::PlanarRGBF& dst, int band) {
+    const int end = BandEnd(band, src.height);
+    for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+        for (int y = BandBegin(band); y < end; ++y) {
+            std::memcpy(dst.Row(c, y), src.Row(c, y), (size_t)src.width * sizeof(float));
+        }
+    }
+}
+
+// Recursive Gaussian, in place: one row band (H) or one strip task (V).
+// The H pass first copies its rows from `src` unless it is `dst` itself.
+// Its infinite tail lights whole rows, so `srcTiles` (the occupancy of `src`)
+// only lets it zero-fill bands that are black from end to end.
+void GaussianBandH(const LiteGlowBlur::PlanarRGBF& src, const LiteGlowBlur::PlanarRGBF& dst,
+                   const LiteGlowBlur::RecursiveGaussianCoefs& coefs, int band,
+                   const LiteGlowBlur::TileMap* srcTiles = nullptr)
+{
+    const int end = BandEnd(band, dst.height);
+    if (srcTiles && !LiteGlowBlur::TileRowLit(*srcTiles, band)) {
+        for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+            for (int y = BandBegin(band); y < end; ++y) std::fill(dst.Row(c, y), dst.Row(c, y) + dst.width, 0.0f);
+        }
+        return;
+    }
+    for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+        for (int y = BandBegin(band); y < end; ++y) {
+            if (src.plane[c] != dst.plane[c]) {
+                std::memcpy(dst.Row(c, y), src.Row(c, y), (size_t)dst.width * sizeof(float));
+            }
+            LiteGlowBlur::RecursiveGaussianLine(dst.Row(c, y), dst.width, coefs);
+        }
+    }
+}
+
+void GaussianStripV(const LiteGlowBlur::PlanarRGBF& img, const LiteGlowBlur::RecursiveGaussianCoefs& coefs, int item) {
+    const int strips = LiteGlowBlur::BlurVStripCount<float>(img.width);
+    LiteGlowBlur::RecursiveGaussianStripV(img.plane[item / strips], img.stride, img.width, img.height,
+                                          coefs, item % strips);
+}
+
+// Runs one separable box pass over the whole image (used by the pyramid,
+// whose levels are too small to be worth a graph of their own).
+Status RunBlurPass(const LiteGlowBlur::PlanarRGBF& src, const LiteGlowBlur::PlanarRGBF& dst,
+                   bool horizontal, int radius)
+{
+    if (horizontal) {
+        auto blurBand = [&](int band) { BlurBandH(src, dst, radius, band); };
+        return ParallelFor(BandCount(src.height), blurBand);
+    }
+    auto blurStrip = [&](int item) { BlurStripV(src, dst, radius, item); };
+    return ParallelFor(StripItems(src.width), blurStrip);
+}
+
+// Sigma of the Gaussian that matches two box passes of the given radius
+// (variance of one box of width 2r+1 is ((2r+1)^2 - 1) / 12), so switching
+// Blur Mode keeps the apparent glow size.
+inline float BoxPassesToGaussianSigma(int radius) noexcept {
+    return sqrtf(2.0f * (float)radius * (float)(radius + 1) / 3.0f);
+}
+
+// =============================================================================
+// Multi-Scale (Pyramid) Bloom
+// =============================================================================
+// The bright pass is halved repeatedly, every level gets the same small box
+// blur, and the levels are upsampled and accumulated back onto the base with
+// per-level weights. The widest level sets the reach of the glow, yet the
+// total work is bounded by ~4/3 of the base level whatever the radius.
+
+// Turns the bright planes in `img` into the bloom, in place. `tmp` is a
+// scratch image at least as large as `img`.
+Status RunPyramidBloom(const LiteGlowBlur::PlanarRGBF& img, const LiteGlowBlur::PlanarRGBF& tmp,
+                       int radius_h, int radius_v)
+{
+    using namespace LiteGlowBlur;
+    Status err = STATUS_OK;
+
+    // Level count: level i blurs with sigma ~ levelSigma * 2^i (in base pixels),
+    // so enough octaves are added for the widest one to reach the radius. The
+    // fractional part fades the last octave in, keeping the Radius response smooth.
+    const float levelSigma = BoxPassesToGaussianSigma(PYRAMID_LEVEL_RADIUS);
+    const float reach = (float)std::max(1, radius_v);
+    const float levelsF = 1.0f + log2f(std::max(1.0f, reach / levelSigma));
+
+    // Level 0 is the bright pass itself; the coarser levels share one block.
+    PlanarRGBF levels[PYRAMID_MAX_LEVELS];
+    float weights[PYRAMID_MAX_LEVELS];
+    int numLevels = 0;
+    size_t totalFloats = 0;
+    {
+        int w = img.width;
+        int h = img.height;
+        while (numLevels < PYRAMID_MAX_LEVELS && (float)numLevels < levelsF) {
+            if (numLevels > 0 && (w < PYRAMID_MIN_LEVEL_SIZE || h < PYRAMID_MIN_LEVEL_SIZE)) break;
+            levels[numLevels] = PlanarRGBF{ {}, w, h, PlanarStride(w) };
+            weights[numLevels] = std::min(1.0f, levelsF - (float)numLevels);
+            if (numLevels > 0) totalFloats += PlanarRGBFFloats(w, h);
+            ++numLevels;
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+        }
+    }
+
+    LiteGlowMem::ScratchBuffer storage;
+    if (totalFloats > 0) {
+        storage = LiteGlowMem::AcquireScratch(totalFloats * sizeof(float));
+        if (!storage) return STATUS_OUT_OF_MEMORY;
+    }
+
+    levels[0] = img;
+    float* cursor = storage.As<float>();
+    for (int i = 1; i < numLevels; ++i) {
+        levels[i] = PlanarRGBFAt(cursor, levels[i].width, levels[i].height);
+        cursor += PlanarRGBFFloats(levels[i].width, levels[i].height);
+    }
+
+    // 1) Downsample chain (one task per plane and row band)
+    for (int i = 1; i < numLevels && !err; ++i) {
+        const int bands = BandCount(levels[i].height);
+        auto downBand = [&](int k) {
+            const int c = k / bands;
+            const int band = k % bands;
+            for (int y = BandBegin(band); y < BandEnd(band, levels[i].height); ++y) {
+                DownsampleHalfRow(levels[i - 1].Plane(c), levels[i].Plane(c), y);
+            }
+        };
+        err = ParallelFor(PLANAR_CHANNELS * bands, downBand);
+    }
+
+    // 2) Small fixed blur on every level (two H/V box passes, H radius follows PAR/field)
+    const int levelRadiusV = PYRAMID_LEVEL_RADIUS;
+    const int levelRadiusH = std::max(1, (int)(PYRAMID_LEVEL_RADIUS * (float)radius_h / (float)std::max(1, radius_v) + 0.5f));
+    for (int i = 0; i < numLevels && !err; ++i) {
+        const PlanarRGBF& level = levels[i];
+        PlanarRGBF levelTmp = tmp;
+        levelTmp.width = level.width;
+        levelTmp.height = level.height;
+        levelTmp.stride = level.stride;
+        for (int pass = 0; pass < 2 && !err; ++pass) {
+            err = RunBlurPass(level, levelTmp, true, levelRadiusH);
+            if (!err) err = RunBlurPass(levelTmp, level, false, levelRadiusV);
+        }
+    }
+
+    // 3) Upsample-accumulate from the coarsest level back onto the base
+    const LiteGlowSimd::UpsampleRowFn upsample = LiteGlowSimd::Kernels().upsample;
+    for (int i = numLevels - 2; i >= 0 && !err; --i) {
+        const float coarseWeight = (i == numLevels - 2) ? weights[i + 1] : 1.0f;
+        const int bands = BandCount(levels[i].height);
+        auto upBand = [&](int k) {
+            const int c = k / bands;
+            const int band = k % bands;
+            for (int y = BandBegin(band); y < BandEnd(band, levels[i].height); ++y) {
+                upsample(levels[i + 1].Plane(c), coarseWeight, levels[i].Plane(c), weights[i], y);
+            }
+        };
+        err = ParallelFor(PLANAR_CHANNELS * bands, upBand);
+    }
+
+    // 4) Normalize by the total weight
+    if (!err && numLevels > 1) {
+        float weightSum = 0.0f;
+        for (int i = 0; i < numLevels; ++i) weightSum += weights[i];
+        const float norm = (weightSum <= 0.0f) ? 1.0f : 1.0f / weightSum;
+        const int bands = BandCount(img.height);
+        auto normalizeBand = [&](int k) {
+            const int c = k / bands;
+            const int band = k % bands;
+            for (int y = BandBegin(band); y < BandEnd(band, img.height); ++y) {
+                float* row = img.Row(c, y);
+                for (int x = 0; x < img.width; ++x) row[x] *= norm;
+            }
+        };
+        err = ParallelFor(PLANAR_CHANNELS * bands, normalizeBand);
+    }
+
+    return err;
+}
+
+// =============================================================================
+// Blend Functions
+// =============================================================================
+// The only stage besides the bright pass that sees image pixels: each call
+// composites one output row, sampling the glow planes in normalized units
+// (nearest neighbour from the downsampled glow). Runs of the row whose glow
+// tiles are black skip the blend and copy the input instead, which is what
+// every blend mode produces there.
+
+// Kernel table index for a Blend Mode popup value (validated by ValidateSettings).
+constexpr LiteGlowSimd::BlendOp KernelBlendOp(const int blendMode) noexcept {
+    return blendMode == BLEND_MODE_ADD ? LiteGlowSimd::BLEND_ADD
+         : blendMode == BLEND_MODE_NORMAL ? LiteGlowSimd::BLEND_NORMAL
+         : LiteGlowSimd::BLEND_SCREEN;
+}
+
+static_assert(KernelBlendOp(BLEND_MODE_SCREEN) == LiteGlowSimd::BLEND_SCREEN &&
+              KernelBlendOp(BLEND_MODE_ADD) == LiteGlowSimd::BLEND_ADD &&
+              KernelBlendOp(BLEND_MODE_NORMAL) == LiteGlowSimd::BLEND_NORMAL &&
+              BLEND_MODE_NUM_CHOICES == LiteGlowSimd::BLEND_OPS, "Blend Mode choices must map onto BlendOp");
+
+typedef struct {
+    LiteGlowBlur::PlanarRGBF glow;
+    LiteGlowSimd::BlendParams params;   // Strength and tint
+    LiteGlowSimd::BlendRowFn blend;     // Kernel for the blend mode and image format
+    // Fixed-point path: blendQ15 is set and blends glowQ15 instead
+    LiteGlowSimd::BlendRowQ15Fn blendQ15;
+    LiteGlowBlur::PlanarRGB16 glowQ15;
+    int factor;
+    const ImageView* input;
+    const ImageView* output;
+    int offsetX;        // Position of the output inside the input (and the glow grid)
+    int offsetY;
+    LiteGlowBlur::TileMap tiles;  // Occupancy of `glow`
+} BlendInfo;
+
+// Input pixels under output row y.
+inline const char* InputRow(const BlendInfo* bi, int y) noexcept {
+    return PixelAt(*bi->input, bi->offsetX, y + bi->offsetY);
+}
+
+// Glow row under output row y.
+inline int GlowRow(const BlendInfo* bi, int y) noexcept {
+    const int height = bi->blendQ15 ? bi->glowQ15.height : bi->glow.height;
+    return std::min(height - 1, (y + bi->offsetY) / bi->factor);
+}
+
+// Output pixels [x0, x1) of row y.
+void BlendSpan(const BlendInfo* bi, int y, int x0, int x1) {
+    const int gy = GlowRow(bi, y);
+    char* outRow = PixelAt(*bi->output, 0, y);
+    if (bi->blendQ15) {
+        const LiteGlowSimd::GlowRowQ15 glow{ bi->glowQ15.Row(0, gy), bi->glowQ15.Row(1, gy), bi->glowQ15.Row(2, gy),
+                                             bi->glowQ15.width, bi->factor, bi->offsetX };
+        bi->blendQ15(InputRow(bi, y), outRow, x0, x1, glow, bi->params);
+        return;
+    }
+    const LiteGlowSimd::GlowRow glow{ bi->glow.Row(0, gy), bi->glow.Row(1, gy), bi->glow.Row(2, gy),
+                                      bi->glow.width, bi->factor, bi->offsetX };
+    bi->blend(InputRow(bi, y), outRow, x0, x1, glow, bi->params);
+}
+
+// Output pixels [x0, x1) of row y where the glow is black: the input as is,
+// except that float keeps the blend kernels' clamp to display range.
+void CopySpan(const BlendInfo* bi, int y, int x0, int x1) {
+    const PixelFormat format = bi->output->format;
+    const int pixelBytes = PixelBytes(format);
+    const char* inRow = InputRow(bi, y);
+    char* outRow = PixelAt(*bi->output, 0, y);
+    if (KernelDepth(format) == LiteGlowSimd::DEPTH_FLOAT) {
+        const int alpha = KernelLayout(format) == LiteGlowSimd::LAYOUT_BGRA ? 3 : 0;
+        const float* in = (const float*)inRow;
+        float* out = (float*)outRow;
+        for (int i = 4 * x0; i < 4 * x1; ++i) {
+            const float v = (0.0f > in[i]) ? 0.0f : in[i];
+            out[i] = (i & 3) == alpha ? in[i] : ((1.0f < v) ? 1.0f : v);
+        }
+    } else {
+        std::memcpy(outRow + (std::ptrdiff_t)x0 * pixelBytes, inRow + (std::ptrdiff_t)x0 * pixelBytes,
+                    (size_t)(x1 - x0) * pixelBytes);
+    }
+}
+
+// Composites output pixels [begin, end) of row y: runs of lit glow tiles go
+// through the blend kernel, black runs are copied.
+void BlendRowRange(const BlendInfo* bi, int y, int begin, int end) {
+    const int tileColumns = bi->tiles.tileW * bi->factor;  // Output columns per glow tile
+    LiteGlowBlur::ForEachTileRunX(bi->tiles, GlowRow(bi, y) / bi->tiles.tileH, [&](int tx0, int tx1, bool lit) {
+        // The kernel clamps to the last glow column, so the last tile runs to the edge
+        const int x0 = std::max(begin, tx0 * tileColumns - bi->offsetX);
+        const int x1 = tx1 == bi->tiles.cols ? end : std::min(end, tx1 * tileColumns - bi->offsetX);
+        if (x0 >= x1) return;
+        if (lit) {
+            BlendSpan(bi, y, x0, x1);
+        } else {
+            CopySpan(bi, y, x0, x1);
+        }
+    });
+}
+
+void BlendRow(const BlendInfo* bi, int y) {
+    BlendRowRange(bi, y, 0, bi->output->width);
+}
+
+// The input rect under `output`, copied as is.
+void CopyRect(const ImageView& input, const ImageView& output, int outputX, int outputY) {
+    const size_t bytes = (size_t)output.width * PixelBytes(output.format);
+    for (int y = 0; y < output.height; ++y) {
+        std::memcpy(PixelAt(output, 0, y), PixelAt(input, outputX, y + outputY), bytes);
+    }
+}
+
+// =============================================================================
+// Blur Setup Helpers
+// =============================================================================
+
+// Number of octaves RunPyramidBloom builds on top of its base level for a
+// downsampled radius (ignoring the minimum level size, so never too few).
+int PyramidOctaves(int radius)
+{
+    const float levelSigma = BoxPassesToGaussianSigma(PYRAMID_LEVEL_RADIUS);
+    const float levelsF = 1.0f + log2f(std::max(1.0f, (float)std::max(1, radius) / levelSigma));
+    return std::min(PYRAMID_MAX_LEVELS, (int)ceilf(levelsF)) - 1;
+}
+
+// Downsample factor of a preview input for a Quality factor in layer pixels.
+// The finer preview axis decides, so the glow never gets coarser than at
+// full resolution.
+int PreviewFactor(int qualityFactor, const Settings& settings)
+{
+    const float scale = std::max(PreviewScale(settings.previewScaleX), PreviewScale(settings.previewScaleY));
+    return std::max(1, (int)(qualityFactor * scale + 0.5f));
+}
+
+// Previews at Quarter resolution or below: a second blur pair only smooths the
+// falloff, which does not show at that size, so they run one.
+bool LowResPreview(const Settings& settings)
+{
+    return std::max(PreviewScale(settings.previewScaleX), PreviewScale(settings.previewScaleY)) <= 0.25f;
+}
+
+// Vertical radius in pixels of the preview's glow grid (factor `factor`) for
+// `radius` in pixels of the full-resolution one (factor `qualityFactor`).
+// Unchanged at full resolution.
+int PreviewRadius(int radius, int qualityFactor, int factor, const Settings& settings)
+{
+    const float scale = (float)qualityFactor * PreviewScale(settings.previewScaleY) / (float)factor;
+    return std::max(1, (int)(radius * scale + 0.5f));
+}
+
+// Whether a render of `blur` keeps its glow in Q15 integers (SetFixedPoint):
+// 8/16-bit Box renders on the downsampled grid itself.
+bool FixedPointBlur(const BlurSetup& blur, PixelFormat format)
+{
+    return gFixedPoint && blur.hlslIterations == 0 && !blur.pyramid && !blur.gaussian && blur.resample == 1.0f &&
+           KernelDepth(format) != LiteGlowSimd::DEPTH_FLOAT;
+}
+
+// Adaptive Quality grid, in preview pixels: a blur wider than
+// ADAPTIVE_GRID_RADIUS grid pixels moves to a coarser grid. The integer part
+// of the step is the bright pass factor and the rest, in 1/ADAPTIVE_PHASES,
+// is left to the CPU blur's resampling (steps = ADAPTIVE_PHASES: none).
+struct AdaptiveGrid {
+    int factor;
+    int steps;     // Grid step in 1/ADAPTIVE_PHASES of a downsampled pixel, [ADAPTIVE_PHASES, 2 ADAPTIVE_PHASES)
+    int radius;    // Vertical box radius on the grid
+};
+
+AdaptiveGrid GetAdaptiveGrid(const Settings& settings)
+{
+    const float radius = std::max(1.0f, settings.radius * PreviewScale(settings.previewScaleY));
+    AdaptiveGrid grid;
+    grid.factor = std::max(1, (int)(radius / ADAPTIVE_GRID_RADIUS));
+    // Under 2 * ADAPTIVE_GRID_RADIUS pixels of the bright pass grid
+    const float factorRadius = radius / (float)grid.factor;
+    grid.steps = (int)(factorRadius * ADAPTIVE_PHASES / ADAPTIVE_GRID_RADIUS + 0.5f);
+    grid.steps = std::max(ADAPTIVE_PHASES, std::min(2 * ADAPTIVE_PHASES - 1, grid.steps));
+    grid.radius = std::max(1, (int)(factorRadius * ADAPTIVE_PHASES / grid.steps + 0.5f));
+    return grid;
+}
+
+// Step of the resampled blur grid of `setup` in lowest terms: `period`
+// downsampled pixels per `phases` grid pixels.
+void ResampleRatio(const BlurSetup& setup, int& phases, int& period)
+{
+    period = (int)(setup.resample * ADAPTIVE_PHASES + 0.5f);
+    phases = ADAPTIVE_PHASES;
+    const int common = std::gcd(period, phases);
+    period /= common;
+    phases /= common;
+}
+
+// Blur grid pixels covering `length` downsampled ones.
+int ResampledLength(int length, int phases, int period)
+{
+    return (length * phases + period - 1) / period;
+}
+
+// =============================================================================
+// Glow Cache Helpers
+// =============================================================================
+
+// Content hash of exactly the source rows the bright pass samples (every
+// factor-th row, see BrightPassRow), for LiteGlowCache::BrightKey.
+Status HashBrightPassSource(const ImageView& src, int factor, int rows, std::uint64_t& hash)
+{
+    const size_t rowBytes = (size_t)src.width * PixelBytes(src.format);
+    const int bands = BandCount(rows);
+    std::unique_ptr<std::uint64_t[]> bandHashes(new (std::nothrow) std::uint64_t[(size_t)std::max(1, bands)]);
+    if (!bandHashes) return STATUS_OUT_OF_MEMORY;
+
+    auto hashBand = [&](int band) {
+        std::uint64_t h = (std::uint64_t)band;
+        for (int y = BandBegin(band); y < BandEnd(band, rows); ++y) {
+            const int sy = std::min(src.height - 1, y * factor);
+            h = LiteGlowCache::HashBytes(RowAt(src, sy), rowBytes, h);
+        }
+        bandHashes[band] = h;
+    };
+    const Status err = ParallelFor(bands, hashBand);
+    if (err) return err;
+
+    hash = (std::uint64_t)rows;
+    for (int band = 0; band < bands; ++band) hash = LiteGlowCache::HashCombine(hash, bandHashes[band]);
+    return STATUS_OK;
+}
+
+// Planar RGB image from the scratch pool, followed in the same buffer by its
+// tile occupancy map when `tiles` is given. Cached glow planes and temporal
+// frames hold pool buffers too, so on failure both caches are dropped and
+// the request retried.
+template <typename T>
+Status AcquirePlanes(int width, int height, LiteGlowMem::ScratchBuffer& storage, LiteGlowBlur::PlanarRGB<T>& img,
+                     LiteGlowBlur::TileMap* tiles)
+{
+    // Rows are whole cache lines, so the map after the planes is aligned for floats
+    const size_t planeBytes = LiteGlowBlur::PlanarRGBSamples<T>(width, height) * sizeof(T);
+    const size_t tileFloats = tiles ? LiteGlowBlur::TileMapFloats(width, height, GLOW_TILE_W, GLOW_TILE_H) : 0;
+    const size_t bytes = planeBytes + tileFloats * sizeof(float);
+    storage = LiteGlowMem::AcquireScratch(bytes);
+    if (!storage) {
+        LiteGlowCache::Clear();
+        LiteGlowTemporal::Clear();
+        storage = LiteGlowMem::AcquireScratch(bytes);
+    }
+    if (!storage) return STATUS_OUT_OF_MEMORY;
+    img = LiteGlowBlur::PlanarRGBAt<T>(storage.As<T>(), width, height);
+    if (tiles) {
+        *tiles = LiteGlowBlur::TileMapAt((float*)(storage.As<char>() + planeBytes), width, height,
+                                         GLOW_TILE_W, GLOW_TILE_H);
+    }
+    return STATUS_OK;
+}
+
+bool ValidView(const ImageView& view) noexcept {
+    return view.data && view.width > 0 && view.height > 0 &&
+           view.format >= FORMAT_ARGB32 && view.format <= FORMAT_BGRA128 &&
+           view.rowBytes >= (std::ptrdiff_t)view.width * PixelBytes(view.format);
+}
+
+// =============================================================================
+// HLSL Pipeline
+// =============================================================================
+// PIPELINE_HLSL: the passes SmartRenderGPU (LiteGlow.cpp) dispatches, in the
+// same order over the same buffers, with the shaders as row kernels
+// (LiteGlow_Simd.h, HLSL Pipeline Kernels). Like the GPU it runs every pass
+// whatever the settings and keeps nothing in the glow cache. Each pass is
+// one ParallelFor over row bands and waits for the one before.
+
+constexpr int HLSL_PIXEL_BYTES = 4 * sizeof(float);
+constexpr int HLSL_MAX_FACTOR = 8;   // Source rows a bright pass row may average
+
+// Pixels between the taps of a 9-tap pass of `radius` (the shaders' step).
+inline int HlslBlurStep(const int radius) noexcept {
+    return std::max(1, std::max(1, radius) / 3);
+}
+
+// The glow row at or above the centre of input row `s`, and how far below it
+// the centre lies, as GlowTap in LiteGlowBlendKernel.hlsl: from the phase of
+// `s` in its glow row, so a sub-rect weighs the glow as the whole frame does.
+inline void HlslGlowTap(const int s, const int factor, int& cell, float& frac) noexcept {
+    const int c = s / factor;
+    const float p = ((float)(s - c * factor) + 0.5f) / (float)factor - 0.5f;
+    cell = p < 0.0f ? c - 1 : c;
+    frac = p < 0.0f ? p + 1.0f : p;
+}
+
+// One of the GPU's float4 buffers: float ARGB rows, `stride` floats apart.
+struct HlslImage {
+    float* data;
+    std::ptrdiff_t stride;
+    int width;
+    int height;
+
+    float* Row(const int y) const noexcept { return data + y * stride; }
+};
+
+// One 9-tap blur pass of `radius` from `src` to `dst` (LiteGlowBlurH/VKernel.hlsl).
+Status RunHlslBlurPass(const HlslImage& src, const HlslImage& dst, const bool horizontal, const int radius)
+{
+    const LiteGlowSimd::PixelKernels& kernels = LiteGlowSimd::Kernels();
+    const int step = HlslBlurStep(radius);
+    auto blurBand = [&](int band) {
+        for (int y = BandBegin(band); y < BandEnd(band, src.height); ++y) {
+            if (horizontal) {
+                kernels.hlslBlurH(src.Row(y), dst.Row(y), src.width, step);
+                continue;
+            }
+            const float* rows[LiteGlowSimd::HLSL_BLUR_TAPS];
+            for (int k = 0; k < LiteGlowSimd::HLSL_BLUR_TAPS; ++k) {
+                const int sy = y + (k - LiteGlowSimd::HLSL_BLUR_TAPS / 2) * step;
+                rows[k] = src.Row(std::max(0, std::min(src.height - 1, sy)));
+            }
+            kernels.hlslBlurV(rows, dst.Row(y), src.width);
+        }
+    };
+    return ParallelFor(BandCount(src.height), blurBand);
+}
+
+Status RenderHlslPipeline(const ImageView& input, const ImageView& output, const int outputX, const int outputY,
+                          const Settings& settings, const BlurSetup& blur, StageTimes* times)
+{
+    const int ds = blur.factor;
+    if (ds > HLSL_MAX_FACTOR) return STATUS_BAD_PARAM;
+    const int dsW = std::max(1, input.width / ds);
+    const int dsH = std::max(1, input.height / ds);
+    // The shader reads the dsW * ds x dsH * ds grid; clamping to the input
+    // as well only matters for inputs smaller than one factor, where the
+    // GPU would read past the image
+    const int srcW = std::min(input.width, dsW * ds);
+    const int srcH = std::min(input.height, dsH * ds);
+
+    // Bright pass, then the blurs ping-pong between blur1 and blur2 as on the GPU
+    const std::ptrdiff_t stride = LiteGlowBlur::PlanarStride(4 * dsW);
+    const size_t imageFloats = (size_t)stride * dsH;
+    LiteGlowMem::ScratchBuffer storage = LiteGlowMem::AcquireScratch(3 * imageFloats * sizeof(float));
+    if (!storage) {
+        LiteGlowCache::Clear();
+        storage = LiteGlowMem::AcquireScratch(3 * imageFloats * sizeof(float));
+    }
+    if (!storage) return STATUS_OUT_OF_MEMORY;
+    const HlslImage bright{ storage.As<float>(), stride, dsW, dsH };
+    const HlslImage blur1{ bright.data + imageFloats, stride, dsW, dsH };
+    const HlslImage blur2{ blur1.data + imageFloats, stride, dsW, dsH };
+
+    const LiteGlowSimd::PixelKernels& kernels = LiteGlowSimd::Kernels();
+    const LiteGlowSimd::PixelDepth depth = KernelDepth(input.format);
+    const LiteGlowSimd::PixelLayout layout = KernelLayout(input.format);
+    const LiteGlowSimd::HlslBrightParams brightParams{ settings.threshold / 255.0f, settings.bloomIntensity / 100.0f };
+    const LiteGlowSimd::BlendParams blendParams{ settings.strength / 2000.0f * SCREEN_BLEND_STRENGTH_MULTIPLIER,
+                                                 settings.tintR, settings.tintG, settings.tintB };
+    const LiteGlowSimd::HlslBrightRowFn brightRow = kernels.hlslBright[layout][depth];
+    const LiteGlowSimd::HlslBlendRowFn blendRow = kernels.hlslBlend[KernelBlendOp(settings.blendMode)][layout][depth];
+
+    // 1) Bright pass (LiteGlowBrightPassKernel.hlsl)
+    auto brightBand = [&](int band) {
+        const void* rows[HLSL_MAX_FACTOR];
+        for (int y = BandBegin(band); y < BandEnd(band, dsH); ++y) {
+            for (int j = 0; j < ds; ++j) rows[j] = RowAt(input, std::min(y * ds + j, srcH - 1));
+            brightRow(rows, srcW, ds, brightParams, bright.Row(y), dsW);
+        }
+    };
+    // 3) Bilinear upsample and blend (LiteGlowBlendKernel.hlsl); the glow
+    //    covers the whole input, so output row y samples it at input row
+    //    y + outputY
+    auto blendBand = [&](int band) {
+        for (int y = BandBegin(band); y < BandEnd(band, output.height); ++y) {
+            int cy;
+            float gy;
+            HlslGlowTap(y + outputY, ds, cy, gy);
+            const int y0 = std::max(0, std::min(dsH - 1, cy));
+            const int y1 = std::min(y0 + 1, dsH - 1);
+            const float fy = cy < 0 ? 0.0f : std::max(0.0f, std::min(1.0f, gy));
+            const LiteGlowSimd::HlslGlowRows glow{ blur2.Row(y0), blur2.Row(y1), fy, dsW, ds, outputX };
+            blendRow(PixelAt(input, outputX, y + outputY), PixelAt(output, 0, y), 0, output.width, glow, blendParams);
+        }
+    };
+
+    Status err = STATUS_OK;
+    {
+        const StageScope scope(StageName(STAGE_BRIGHT, blur), times ? &times->ms[STAGE_BRIGHT] : nullptr,
+                               times ? &times->counts[STAGE_BRIGHT] : nullptr);
+        err = ParallelFor(BandCount(dsH), brightBand);
+    }
+    // 2) Blur: H then V into blur2, twice for two iterations (LiteGlowBlurH/VKernel.hlsl)
+    const HlslImage* passSrc = &bright;
+    for (int pass = 0; !err && pass < 2 * blur.hlslIterations; ++pass) {
+        const Stage stage = (Stage)(STAGE_BLUR_1 + pass);
+        const bool horizontal = pass % 2 == 0;
+        const HlslImage& passDst = horizontal ? blur1 : blur2;
+        const StageScope scope(StageName(stage, blur), times ? &times->ms[stage] : nullptr,
+                               times ? &times->counts[stage] : nullptr);
+        err = RunHlslBlurPass(*passSrc, passDst, horizontal, horizontal ? blur.radiusH : blur.radiusV);
+        passSrc = &passDst;
+    }
+    if (!err) {
+        const StageScope scope(StageName(STAGE_BLEND, blur), times ? &times->ms[STAGE_BLEND] : nullptr,
+                               times ? &times->counts[STAGE_BLEND] : nullptr);
+        err = ParallelFor(BandCount(output.height), blendBand);
+    }
+    return err;
+}
+
+// =============================================================================
+// Streaming Box Render
+// =============================================================================
+// Box renders too large for full-frame intermediates (SetStreamingThreshold)
+// run the bright pass, the four box passes and the blend in one sweep down
+// the downsampled rows. The bright pass and the H passes work on single
+// rows; each V pass keeps a ring of the 2r + 2 rows its running sum spans
+// (LiteGlowBlur::BoxBlurRowV) and pulls new rows through the passes before
+// it as it slides down, and every glow row is blended as soon as it is done.
+// Each task sweeps its own slab of glow rows with its own rows and rings, so
+// scratch memory grows with width x radius per thread instead of three
+// frames. A slab starts 2 * radiusV rows above its first glow row, so slabs
+// need nothing from each other; those rows' bright and first H passes run
+// twice. Nothing goes to the glow cache and there are no tile maps; instead
+// every ring row is flagged when it is black, black rows are neither blurred
+// nor summed, and glow rows whose windows only saw black rows are copied
+// instead of blended.
+
+constexpr int STREAM_MIN_SLAB_ROWS = 32;  // Glow rows per slab, at least (and 4 * radiusV)
+constexpr int STREAM_PASS_ROWS = 3;       // Single rows of a slab: bright, first V output, glow
+
+// Input rows of one V pass: row j in slot j % slots.height, lit[slot] when
+// it is not all black. Reads clamp to the image like the frame passes.
+template <typename T>
+struct StreamRing {
+    LiteGlowBlur::PlanarRGB<T> slots;
+    bool* lit;
+    int height;
+
+    int Clamp(const int j) const noexcept { return std::max(0, std::min(height - 1, j)); }
+    T* Slot(const int c, const int j) const noexcept { return slots.Row(c, j % slots.height); }
+    const T* Row(const int c, const int j) const noexcept { return Slot(c, Clamp(j)); }
+    bool& Lit(const int j) const noexcept { return lit[j % slots.height]; }
+    bool LitRow(const int j) const noexcept { return Lit(Clamp(j)); }
+};
+
+// One V pass of a sweep: writes rows [y, end), pulling input row `next`
+// into the ring when the window needs it.
+template <typename T>
+struct StreamPassV {
+    StreamRing<T> ring;
+    typename BoxSum<T>::Type* sums;  // PLANAR_CHANNELS runs of `width`
+    int width;
+    int radius;
+    int y;
+    int end;
+    int next;
+    int litRows;  // Lit rows in the window, counted as often as it reads them
+};
+
+// Rows [y0, y0 + rows) of `img`.
+template <typename T>
+LiteGlowBlur::PlanarRGB<T> PlanarRows(const LiteGlowBlur::PlanarRGB<T>& img, int y0, int rows) noexcept {
+    LiteGlowBlur::PlanarRGB<T> sub = img;
+    for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) sub.plane[c] = img.Row(c, y0);
+    sub.height = rows;
+    return sub;
+}
+
+inline void SetBrightRow(BrightPassInfo& bp, const LiteGlowBlur::PlanarRGBF& row) noexcept { bp.dst = row; }
+inline void SetBrightRow(BrightPassInfo& bp, const LiteGlowBlur::PlanarRGB16& row) noexcept { bp.dstQ15 = row; }
+inline void SetGlowRow(BlendInfo& bl, const LiteGlowBlur::PlanarRGBF& row) noexcept { bl.glow = row; }
+inline void SetGlowRow(BlendInfo& bl, const LiteGlowBlur::PlanarRGB16& row) noexcept { bl.glowQ15 = row; }
+
+// Horizontal box blur of row 0 of `src` into ring row `j`, or just its flag
+// when `lit` is false.
+template <typename T>
+void BlurRowH(const LiteGlowBlur::PlanarRGB<T>& src, bool lit, const StreamRing<T>& ring, int j, int radius) {
+    typedef typename BoxSum<T>::Type SumT;
+    ring.Lit(j) = lit;
+    if (!lit) return;
+    for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+        LiteGlowBlur::BoxBlurLine<T, SumT>((const char*)src.Row(c, 0), sizeof(T), (char*)ring.Slot(c, j), sizeof(T),
+                                           src.width, radius);
+    }
+}
+
+// Feeds `pass` its input rows up to `last` (clamped to the image).
+template <typename T, typename Feed>
+void PullRows(StreamPassV<T>& pass, int last, Feed& feed) {
+    last = std::min(last, pass.ring.height - 1);
+    while (pass.next <= last) feed(pass.next++);
+}
+
+// Sums the lit rows of the window around the first output row.
+template <typename T, typename Feed>
+void BeginPassV(StreamPassV<T>& pass, Feed& feed) {
+    PullRows(pass, pass.y + pass.radius, feed);
+    std::fill(pass.sums, pass.sums + LiteGlowBlur::PLANAR_CHANNELS * pass.width, 0);
+    pass.litRows = 0;
+    for (int j = pass.y - pass.radius; j <= pass.y + pass.radius; ++j) {
+        if (!pass.ring.LitRow(j)) continue;
+        ++pass.litRows;
+        for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+            LiteGlowBlur::AddRowToSums<T, typename BoxSum<T>::Type>(pass.sums + c * pass.width, pass.ring.Row(c, j),
+                                                                    pass.width);
+        }
+    }
+}
+
+// Writes output row pass.y into row 0 of `out` and moves on to the next.
+// Returns false, without writing, when the window only holds black rows.
+template <typename T, typename Feed>
+bool StepPassV(StreamPassV<T>& pass, const LiteGlowBlur::PlanarRGB<T>& out, Feed& feed) {
+    typedef typename BoxSum<T>::Type SumT;
+    const int y = pass.y++;
+    if (pass.radius <= 0) {
+        PullRows(pass, y, feed);
+        const bool lit = pass.ring.LitRow(y);
+        for (int c = 0; lit && c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+            std::copy(pass.ring.Row(c, y), pass.ring.Row(c, y) + pass.width, out.Row(c, 0));
+        }
+        return lit;
+    }
+    const bool slide = pass.y < pass.end;
+    if (slide) PullRows(pass, y + pass.radius + 1, feed);
+    const bool lit = pass.litRows > 0;
+    const bool entering = slide && pass.ring.LitRow(y + pass.radius + 1);
+    const bool leaving = slide && pass.ring.LitRow(y - pass.radius);
+    if (lit || entering || leaving) {
+        const LiteGlowBlur::TapAverage<SumT> avg((SumT)(2 * pass.radius + 1));
+        for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+            LiteGlowBlur::BoxBlurRowV<T, SumT>(pass.sums + c * pass.width,
+                                               entering ? pass.ring.Row(c, y + pass.radius + 1) : nullptr,
+                                               leaving ? pass.ring.Row(c, y - pass.radius) : nullptr,
+                                               lit ? out.Row(c, 0) : nullptr, pass.width, avg);
+        }
+    }
+    pass.litRows += (int)entering - (int)leaving;
+    return lit;
+}
+
+template <typename T>
+bool RowIsBlack(const LiteGlowBlur::PlanarRGB<T>& img) noexcept {
+    for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+        const T* row = img.Row(c, 0);
+        for (int x = 0; x < img.width; ++x) {
+            if (row[x] != (T)0) return false;
+        }
+    }
+    return true;
+}
+
+// What every slab of a streamed render shares.
+struct StreamInfo {
+    const BrightPassInfo* bp;
+    const BlendInfo* bl;
+    int width;          // Downsampled frame
+    int height;
+    int radiusH;
+    int radiusV;
+    int ringRows;
+};
+
+// Samples of one slab's rings and single rows.
+template <typename T>
+size_t StreamSlabSamples(const StreamInfo& si) noexcept {
+    return LiteGlowBlur::PlanarRGBSamples<T>(si.width, 2 * si.ringRows + STREAM_PASS_ROWS);
+}
+
+// Scratch of one slab: its rows, the running sums of both V passes, then
+// the lit flags of both rings.
+template <typename T>
+size_t StreamSlabBytes(const StreamInfo& si) noexcept {
+    const size_t bytes = StreamSlabSamples<T>(si) * sizeof(T) +
+                         2 * LiteGlowBlur::PLANAR_CHANNELS * (size_t)si.width * sizeof(typename BoxSum<T>::Type) +
+                         2 * (size_t)si.ringRows * sizeof(bool);
+    return (bytes + LiteGlowBlur::PLANAR_ROW_ALIGN_BYTES - 1) / LiteGlowBlur::PLANAR_ROW_ALIGN_BYTES *
+           LiteGlowBlur::PLANAR_ROW_ALIGN_BYTES;
+}
+
+// Renders the output rows under glow rows [g0, g1) in one sweep, with the
+// slab's scratch at `storage` (StreamSlabBytes).
+template <typename T>
+void StreamSlab(const StreamInfo& si, char* storage, int g0, int g1) {
+    typedef typename BoxSum<T>::Type SumT;
+    const int last = si.height - 1;
+    const LiteGlowBlur::PlanarRGB<T> rows =
+        LiteGlowBlur::PlanarRGBAt<T>((T*)storage, si.width, 2 * si.ringRows + STREAM_PASS_ROWS);
+    SumT* sums = (SumT*)(storage + StreamSlabSamples<T>(si) * sizeof(T));
+    bool* lit = (bool*)(sums + 2 * LiteGlowBlur::PLANAR_CHANNELS * si.width);
+    const LiteGlowBlur::PlanarRGB<T> brightRow = PlanarRows(rows, 2 * si.ringRows, 1);
+    const LiteGlowBlur::PlanarRGB<T> v1Row = PlanarRows(rows, 2 * si.ringRows + 1, 1);
+    const LiteGlowBlur::PlanarRGB<T> glowRow = PlanarRows(rows, 2 * si.ringRows + 2, 1);
+    BrightPassInfo bp = *si.bp;
+    SetBrightRow(bp, brightRow);
+    BlendInfo bl = *si.bl;
+    SetGlowRow(bl, glowRow);
+
+    // Box H1 -> V1 -> H2 -> V2: v2 writes the glow rows of the slab, v1
+    // every row v2's window touches
+    const int rV = si.radiusV;
+    const int start1 = std::max(0, g0 - rV);
+    StreamPassV<T> v1{ { PlanarRows(rows, 0, si.ringRows), lit, si.height }, sums, si.width, rV,
+                       start1, std::min(last, g1 - 1 + rV) + 1, std::max(0, start1 - rV), 0 };
+    StreamPassV<T> v2{ { PlanarRows(rows, si.ringRows, si.ringRows), lit + si.ringRows, si.height },
+                       sums + LiteGlowBlur::PLANAR_CHANNELS * si.width, si.width, rV, g0, g1, start1, 0 };
+    auto feedV1 = [&](int j) {
+        BrightPassRow(&bp, j, 0);
+        BlurRowH(brightRow, !RowIsBlack(brightRow), v1.ring, j, si.radiusH);
+    };
+    auto feedV2 = [&](int j) {
+        const bool lit1 = StepPassV(v1, v1Row, feedV1);
+        BlurRowH(v1Row, lit1, v2.ring, j, si.radiusH);
+    };
+    BeginPassV(v1, feedV1);
+    BeginPassV(v2, feedV2);
+
+    // Blend every output row under each glow row (the last one also covers
+    // the rows below the downsampled grid)
+    const int ds = bl.factor;
+    const int outputHeight = bl.output->height;
+    while (v2.y < v2.end) {
+        const int gy = v2.y;
+        const bool glowLit = StepPassV(v2, glowRow, feedV2);
+        const int y0 = std::max(0, gy * ds - bl.offsetY);
+        const int y1 = gy == last ? outputHeight : std::min(outputHeight, (gy + 1) * ds - bl.offsetY);
+        for (int y = y0; y < y1; ++y) {
+            if (glowLit) {
+                BlendSpan(&bl, y, 0, bl.output->width);
+            } else {
+                CopySpan(&bl, y, 0, bl.output->width);
+            }
+        }
+    }
+}
+
+// Streamed Box render (see above); the settings are validated and the blur is
+// a box blur.
+Status RenderStreamed(const ImageView& input, const ImageView& output, int outputX, int outputY,
+                      const Settings& settings, const BlurSetup& blur, bool fixedPoint, StageTimes* times)
+{
+    const int ds = blur.factor;
+    const int dsW = std::max(1, input.width / ds);
+    const int dsH = std::max(1, input.height / ds);
+    const LiteGlowSimd::PixelDepth depth = KernelDepth(input.format);
+    const LiteGlowSimd::PixelLayout layout = KernelLayout(input.format);
+    const LiteGlowSimd::PixelKernels& kernels = LiteGlowSimd::Kernels();
+    const LiteGlowSimd::BlendOp blendOp = KernelBlendOp(settings.blendMode);
+    const LiteGlowSimd::BrightParams brightParams{ settings.threshold / 255.0f, settings.knee / 100.0f,
+                                                   settings.bloomIntensity / 100.0f };
+    LiteGlowSimd::BrightResponseRef response;
+    if (depth != LiteGlowSimd::DEPTH_FLOAT) {
+        response = LiteGlowSimd::SharedBrightResponse(brightParams, depth);
+        if (!response) return STATUS_OUT_OF_MEMORY;
+    }
+    const BrightPassInfo bp{ brightParams, kernels.bright[layout][depth], &input, ds, {},
+                             fixedPoint ? kernels.brightQ15[layout][depth] : nullptr, response.get(), {} };
+    const BlendInfo bl{ {},
+                        { settings.strength / 2000.0f * SCREEN_BLEND_STRENGTH_MULTIPLIER,
+                          settings.tintR, settings.tintG, settings.tintB },
+                        kernels.blend[blendOp][layout][depth],
+                        fixedPoint ? kernels.blendQ15[blendOp][layout][depth] : nullptr,
+                        {}, ds, &input, &output, outputX, outputY, {} };
+    const StreamInfo si{ &bp, &bl, dsW, dsH, blur.radiusH, blur.radiusV, std::min(dsH, 2 * blur.radiusV + 2) };
+
+    // Only the glow rows under the output, split into one slab per thread
+    const int g0 = std::min(dsH - 1, outputY / ds);
+    const int g1 = std::min(dsH - 1, (outputY + output.height - 1) / ds) + 1;
+    const int minSlabRows = std::max(STREAM_MIN_SLAB_ROWS, 4 * blur.radiusV);
+    const int slabs = std::max(1, std::min(LiteGlowSched::WorkerCount() + 1, (g1 - g0) / minSlabRows));
+
+    const size_t slabBytes = fixedPoint ? StreamSlabBytes<std::uint16_t>(si) : StreamSlabBytes<float>(si);
+    LiteGlowMem::ScratchBuffer storage = LiteGlowMem::AcquireScratch(slabs * slabBytes);
+    if (!storage) {
+        LiteGlowCache::Clear();
+        storage = LiteGlowMem::AcquireScratch(slabs * slabBytes);
+    }
+    if (!storage) return STATUS_OUT_OF_MEMORY;
+
+    auto sweep = [&](int slab) {
+        char* slabStorage = storage.As<char>() + slab * slabBytes;
+        const int begin = g0 + (int)((std::int64_t)(g1 - g0) * slab / slabs);
+        const int end = g0 + (int)((std::int64_t)(g1 - g0) * (slab + 1) / slabs);
+        if (fixedPoint) {
+            StreamSlab<std::uint16_t>(si, slabStorage, begin, end);
+        } else {
+            StreamSlab<float>(si, slabStorage, begin, end);
+        }
+    };
+    const StageScope scope("stream", times ? &times->ms[STAGE_STREAM] : nullptr,
+                           times ? &times->counts[STAGE_STREAM] : nullptr);
+    return ParallelFor(slabs, sweep);
+}
+
+} // namespace
+
+// =============================================================================
+// Settings and Blur Setup
+// =============================================================================
+
+Status ValidateSettings(const Settings& settings) noexcept {
+    if (settings.radius < 0.0f || settings.radius > RADIUS_MAX) {
+        return STATUS_BAD_PARAM;
+    }
+    if (settings.strength < 0.0f || settings.strength > STRENGTH_MAX) {
+        return STATUS_BAD_PARAM;
+    }
+    if (settings.threshold < THRESHOLD_MIN || settings.threshold > THRESHOLD_MAX) {
+        return STATUS_BAD_PARAM;
+    }
+    if (settings.quality < QUALITY_LOW || settings.quality > QUALITY_NUM_CHOICES) {
+        return STATUS_BAD_PARAM;
+    }
+    if (settings.bloomIntensity < BLOOM_INTENSITY_MIN || settings.bloomIntensity > BLOOM_INTENSITY_MAX) {
+        return STATUS_BAD_PARAM;
+    }
+    if (settings.knee < KNEE_MIN || settings.knee > KNEE_MAX) {
+        return STATUS_BAD_PARAM;
+    }
+    if (settings.blendMode < BLEND_MODE_SCREEN || settings.blendMode > BLEND_MODE_NORMAL) {
+        return STATUS_BAD_PARAM;
+    }
+    if (settings.blurMode < BLUR_MODE_BOX || settings.blurMode > BLUR_MODE_GAUSSIAN) {
+        return STATUS_BAD_PARAM;
+    }
+    return STATUS_OK;
+}
+
+// Lower quality = higher downsample for performance; Pyramid builds its
+// octaves on top of a half-resolution base level. Adaptive picks its factor
+// from the radius (GetAdaptiveGrid) and Auto per frame (GetAutoPlan); 1 is
+// where they start.
+int QualityToDownsample(int quality) noexcept {
+    static const int kQualityToDownsample[] = { 4, 2, 1, 2, 1, 1 };  // LOW, MEDIUM, HIGH, PYRAMID, ADAPTIVE, AUTO
+    static_assert(sizeof(kQualityToDownsample) / sizeof(kQualityToDownsample[0]) == QUALITY_NUM_CHOICES,
+                  "kQualityToDownsample must cover every Quality choice");
+    quality = std::max(QUALITY_LOW, std::min(QUALITY_NUM_CHOICES, quality));
+    return kQualityToDownsample[quality - QUALITY_LOW];
+}
+
+float PreviewScale(const float previewScale) noexcept {
+    return previewScale > 0.0f && previewScale < 1.0f ? previewScale : 1.0f;
+}
+
+void AdjustBlurRadiusForPARAndField(int baseRadius, const Settings& settings, int& radiusH, int& radiusV) noexcept
+{
+    // par = num/den is horizontal_size / vertical_size of a pixel: square
+    // pixels are 1.0, NTSC D1 10/11 (wider, needs more H samples), PAL D1
+    // 59/54 (narrower, needs fewer). The H radius scales inversely to keep
+    // the blur circular. A preview pixel covers 1 / previewScale layer
+    // pixels along each axis, which widens or narrows it the same way.
+    // Every blur needs a radius of at least 1, however wide the pixels.
+    const float par = (settings.parDen == 0 ? 1.0f : (float)settings.parNum / (float)settings.parDen) *
+                      PreviewScale(settings.previewScaleY) / PreviewScale(settings.previewScaleX);
+    if (par > 0.1f && par < 10.0f) {  // Sanity check
+        radiusH = std::max(1, (int)(baseRadius / par + 0.5f));
+        radiusV = std::max(1, baseRadius);
+    } else {
+        radiusH = std::max(1, baseRadius);
+        radiusV = std::max(1, baseRadius);
+    }
+
+    // For field rendering, reduce vertical radius since we're only processing
+    // half the scanlines. This prevents over-blurring in vertical direction.
+    if (settings.field == FIELD_UPPER || settings.field == FIELD_LOWER) {
+        radiusV = std::max(1, radiusV / 2);
+    }
+}
+
+BlurSetup GetBlurSetup(const Settings& settings) noexcept
+{
+    BlurSetup setup;
+    if (settings.quality == QUALITY_AUTO) {
+        for (int plan = 0; plan < AUTO_PLANS; ++plan) {
+            if (GetAutoPlan(settings, plan, setup)) return setup;
+        }
+        // Nothing draws the radius unclamped (extreme PAR): the coarsest grid
+        GetAutoPlan(settings, AUTO_PLANS - 2, setup);
+        return setup;
+    }
+    if (gPipeline == PIPELINE_HLSL) return GetHlslBlurSetup(settings);
+    setup.hlslIterations = 0;
+    setup.resample = 1.0f;
+    if (settings.quality == QUALITY_ADAPTIVE) {
+        // Both box pairs (or the Gaussian) at the grid's own radius; the
+        // preview scale is already in the grid
+        const AdaptiveGrid grid = GetAdaptiveGrid(settings);
+        setup.factor = grid.factor;
+        setup.resample = (float)grid.steps / (float)ADAPTIVE_PHASES;
+        setup.pyramid = false;
+        setup.gaussian = (settings.blurMode == BLUR_MODE_GAUSSIAN);
+        setup.boxPasses = setup.gaussian ? 0 : 2;
+        AdjustBlurRadiusForPARAndField(grid.radius, settings, setup.radiusH, setup.radiusV);
+        if (!setup.gaussian) setup.radiusH = std::min(setup.radiusH, MAX_ADJUSTED_BLUR_RADIUS);
+        return setup;
+    }
+    // Downsample for performance: Low=4x, Medium=2x, High=1x, Pyramid=2x base
+    const int qualityFactor = QualityToDownsample(settings.quality);
+    setup.factor = PreviewFactor(qualityFactor, settings);
+    // The recursive Gaussian and the pyramid cost the same at any radius,
+    // so the radius clamps below only apply to the box passes.
+    setup.pyramid = (settings.quality == QUALITY_PYRAMID);
+    setup.gaussian = !setup.pyramid && (settings.blurMode == BLUR_MODE_GAUSSIAN);
+    const bool clampRadius = !setup.pyramid && !setup.gaussian;
+    setup.boxPasses = clampRadius ? (LowResPreview(settings) ? 1 : 2) : 0;
+
+    // Clamp ds_radius after adding quality bonus to prevent overflow beyond 24.
+    // Radii typed in past the slider that the clamp would cut render through
+    // the Pyramid instead, so they still widen the glow; the slider's range
+    // keeps the box look it always had.
+    int ds_radius = std::max(1, (int)settings.radius / qualityFactor + (settings.quality == QUALITY_HIGH ? 2 : 0));
+    if (clampRadius && ds_radius > BOX_MAX_RADIUS && settings.radius > RADIUS_SLIDER_MAX) {
+        Settings pyramid = settings;
+        pyramid.quality = QUALITY_PYRAMID;
+        return GetBlurSetup(pyramid);
+    }
+    if (clampRadius) ds_radius = std::min(ds_radius, BOX_MAX_RADIUS);
+    // Previews blur the same layer distance on their own grid; one box pair
+    // spreads as far as two with ~1.4x the radius (the HLSL blur's compensation)
+    ds_radius = PreviewRadius(ds_radius, qualityFactor, setup.factor, settings);
+    if (setup.boxPasses == 1) ds_radius = (int)(ds_radius * 1.4f + 0.5f);
+
+    // Separate horizontal and vertical blur radii based on PAR and field rendering
+    AdjustBlurRadiusForPARAndField(ds_radius, settings, setup.radiusH, setup.radiusV);
+    // Clamp adjusted radii to reasonable limits
+    if (clampRadius) {
+        setup.radiusH = std::min(setup.radiusH, MAX_ADJUSTED_BLUR_RADIUS);
+        setup.radiusV = std::min(setup.radiusV, 32);
+    }
+    return setup;
+}
+
+BlurSetup GetHlslBlurSetup(const Settings& settings) noexcept
+{
+    BlurSetup setup;
+    const int qualityFactor = QualityToDownsample(settings.quality);
+    setup.factor = PreviewFactor(qualityFactor, settings);
+    setup.pyramid = false;
+    setup.gaussian = false;
+    setup.boxPasses = 0;
+    setup.resample = 1.0f;
+    if (settings.quality == QUALITY_ADAPTIVE || settings.quality == QUALITY_AUTO) {
+        // The grid's integer factor, two pairs at the radius left on it
+        // (under 2 * ADAPTIVE_GRID_RADIUS; only the PAR can reach the clamps).
+        // The bright pass averages at most HLSL_MAX_FACTOR rows, so past
+        // radius ~100 the grid stops growing and the box radius clamp
+        // (MAX_ADJUSTED_BLUR_RADIUS) is reached at ~256.
+        const AdaptiveGrid grid = GetAdaptiveGrid(settings);
+        setup.factor = std::min(grid.factor, HLSL_MAX_FACTOR);
+        setup.hlslIterations = 2;
+        const float radius = std::max(1.0f, settings.radius * PreviewScale(settings.previewScaleY));
+        const int ds_radius = std::max(1, (int)(radius / (float)setup.factor + 0.5f));
+        AdjustBlurRadiusForPARAndField(ds_radius, settings, setup.radiusH, setup.radiusV);
+        setup.radiusH = std::min(setup.radiusH, MAX_ADJUSTED_BLUR_RADIUS);
+        setup.radiusV = std::min(setup.radiusV, 32);
+        return setup;
+    }
+    // Blur iterations: 2 (H+V twice) for high quality, 1 for medium/low and
+    // for previews at Quarter or below. There is no GPU pyramid yet; Pyramid
+    // renders as High at its half-res base.
+    const bool twoPairs = settings.quality == QUALITY_HIGH || settings.quality == QUALITY_PYRAMID;
+    setup.hlslIterations = twoPairs && !LowResPreview(settings) ? 2 : 1;
+    // ds_radius with quality bonus, clamped after to prevent overflow beyond 24
+    int ds_radius = std::max(1, (int)(settings.radius / qualityFactor));
+    if (twoPairs) {
+        ds_radius += 2;
+    } else {
+        // Compensate for fewer passes (single box blur vs. repeated box blurs).
+        ds_radius = (int)(ds_radius * 1.4f + 0.5f);
+    }
+    // There is no GPU pyramid; radii typed in past the slider that the clamp
+    // would cut take the Adaptive grid instead, which draws them up to
+    // radius ~256 on its coarsest (HLSL_MAX_FACTOR) grid
+    if (ds_radius > BOX_MAX_RADIUS && settings.radius > RADIUS_SLIDER_MAX) {
+        Settings adaptive = settings;
+        adaptive.quality = QUALITY_ADAPTIVE;
+        return GetHlslBlurSetup(adaptive);
+    }
+    ds_radius = std::min(ds_radius, BOX_MAX_RADIUS);
+    // Previews: the same layer distance on their grid, and the same
+    // compensation when they drop the second pair
+    ds_radius = PreviewRadius(ds_radius, qualityFactor, setup.factor, settings);
+    if (twoPairs && setup.hlslIterations == 1) ds_radius = (int)(ds_radius * 1.4f + 0.5f);
+
+    AdjustBlurRadiusForPARAndField(ds_radius, settings, setup.radiusH, setup.radiusV);
+    setup.radiusH = std::min(setup.radiusH, MAX_ADJUSTED_BLUR_RADIUS);
+    setup.radiusV = std::min(setup.radiusV, 32);
+    return setup;
+}
+
+int BlurReach(const BlurSetup& setup, bool horizontal) noexcept
+{
+    const int radius = horizontal ? setup.radiusH : setup.radiusV;
+    if (setup.hlslIterations > 0) {
+        // Four taps of max(1, radius / 3) pixels on each side per pass
+        return setup.hlslIterations * (LiteGlowSimd::HLSL_BLUR_TAPS / 2) * HlslBlurStep(radius);
+    }
+    if (setup.pyramid) {
+        // Coarsest level: two box passes of the (PAR-scaled) level radius plus
+        // one level pixel for the down/upsampling, scaled up by its octave.
+        const int levelRadius = horizontal
+            ? std::max(1, (int)(PYRAMID_LEVEL_RADIUS * (float)setup.radiusH / (float)std::max(1, setup.radiusV) + 0.5f))
+            : PYRAMID_LEVEL_RADIUS;
+        return (2 * levelRadius + 2) << PyramidOctaves(setup.radiusV);
+    }
+    int reach = setup.boxPasses * radius;
+    if (setup.gaussian) {
+        // The recursive filter has an infinite tail; 3.5 sigma holds all but
+        // 0.05% of it, which keeps sub-rects within an 8-bit code of the
+        // whole frame (GlowBench --rect-parity)
+        reach = (int)ceilf(3.5f * BoxPassesToGaussianSigma(radius));
+    }
+    // A resampled blur reaches two grid pixels further (area average and
+    // interpolation), in grid pixels of `resample` downsampled ones
+    if (setup.resample > 1.0f) reach = (int)ceilf(setup.resample * (float)(reach + 2));
+    return reach;
+}
+
+int GlowGridStep(const Settings& settings) noexcept
+{
+    const BlurSetup blur = GetBlurSetup(settings);
+    if (settings.quality == QUALITY_AUTO) {
+        // Every plan's grid repeats on the common multiple of their factors
+        int step = blur.factor;
+        BlurSetup plan;
+        for (int i = 0; i < AUTO_PLANS; ++i) {
+            if (GetAutoPlan(settings, i, plan)) step = std::lcm(step, plan.factor);
+        }
+        return step;
+    }
+    if (blur.resample > 1.0f) {
+        // The resampling repeats every `period` downsampled pixels
+        int phases, period;
+        ResampleRatio(blur, phases, period);
+        return blur.factor * period;
+    }
+    return blur.pyramid ? blur.factor << PyramidOctaves(blur.radiusV) : blur.factor;
+}
+
+bool GetAutoPlan(const Settings& settings, const int plan, BlurSetup& setup) noexcept
+{
+    const int index = std::max(0, std::min(AUTO_PLANS - 1, plan));
+    const bool onePair = (index & 1) != 0;
+    const bool hlsl = gPipeline == PIPELINE_HLSL;
+    setup.factor = PreviewFactor(AUTO_FACTORS[index / 2], settings);
+    setup.pyramid = false;
+    setup.gaussian = !hlsl && !onePair && settings.blurMode == BLUR_MODE_GAUSSIAN;
+    setup.hlslIterations = hlsl ? (onePair ? 1 : 2) : 0;
+    setup.boxPasses = hlsl || setup.gaussian ? 0 : (onePair ? 1 : 2);
+    setup.resample = 1.0f;
+
+    // The layer radius on the plan's grid, so every plan draws the same glow
+    // size; one pair spreads as far as two with ~1.4x the radius
+    const float radius = settings.radius * PreviewScale(settings.previewScaleY) / (float)setup.factor;
+    int ds_radius = std::max(1, (int)(radius + 0.5f));
+    if (onePair) ds_radius = (int)(ds_radius * 1.4f + 0.5f);
+    AdjustBlurRadiusForPARAndField(ds_radius, settings, setup.radiusH, setup.radiusV);
+
+    bool valid = index == plan && (setup.factor == 1 || radius >= 1.0f);
+    if (index >= 2 && setup.factor == PreviewFactor(AUTO_FACTORS[index / 2 - 1], settings)) valid = false;
+    if (!setup.gaussian &&
+        (setup.radiusH > MAX_ADJUSTED_BLUR_RADIUS || setup.radiusV > MAX_ADJUSTED_BLUR_RADIUS)) {
+        setup.radiusH = std::min(setup.radiusH, MAX_ADJUSTED_BLUR_RADIUS);
+        setup.radiusV = std::min(setup.radiusV, MAX_ADJUSTED_BLUR_RADIUS);
+        valid = false;
+    }
+    return valid;
+}
+
+void SetFixedPoint(bool enabled) noexcept {
+    gFixedPoint = enabled;
+}
+
+void SetStreamingThreshold(std::size_t bytes) noexcept {
+    gStreamingBytes = bytes;
+}
+
+bool StreamsRender(const BlurSetup& blur, const PixelFormat format, const int width, const int height) noexcept
+{
+    // Box renders with both pairs (previews run one and are smaller anyway)
+    if (blur.hlslIterations > 0 || blur.boxPasses != 2 || blur.resample > 1.0f) return false;
+    const int dsW = std::max(1, width / blur.factor);
+    const int dsH = std::max(1, height / blur.factor);
+    const size_t planeBytes = FixedPointBlur(blur, format)
+        ? LiteGlowBlur::PlanarRGBSamples<std::uint16_t>(dsW, dsH) * sizeof(std::uint16_t)
+        : LiteGlowBlur::PlanarRGBSamples<float>(dsW, dsH) * sizeof(float);
+    return 3 * planeBytes > gStreamingBytes;
+}
+
+void SetStageCounters(bool enabled) noexcept {
+    gStageCounters = enabled;
+}
+
+void SetPipeline(Pipeline pipeline) noexcept {
+    gPipeline = pipeline;
+}
+
+Pipeline GetPipeline() noexcept {
+    return gPipeline;
+}
+
+const char* PipelineName(const Pipeline pipeline) noexcept {
+    return pipeline == PIPELINE_HLSL ? "hlsl" : "cpu";
+}
+
+bool ParsePipeline(const char* name, Pipeline& pipeline) noexcept {
+    if (!name) return false;
+    for (const Pipeline p : { PIPELINE_CPU, PIPELINE_HLSL }) {
+        if (std::strcmp(name, PipelineName(p)) == 0) {
+            pipeline = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* StageName(const Stage stage, const BlurSetup& setup) noexcept
+{
+    static const char* const box[] = { "blur_h1", "blur_v1", "blur_h2", "blur_v2" };
+    static const char* const gaussian[] = { "blur_h", "blur_v", nullptr, nullptr };
+    static const char* const pyramid[] = { "blur_copy", "bloom", nullptr, nullptr };
+    if (setup.hlslIterations > 0) {
+        // No cache lookup; H, V per iteration
+        const bool blur = stage >= STAGE_BLUR_1 && stage <= STAGE_BLUR_4;
+        if (stage == STAGE_HASH || (blur && stage - STAGE_BLUR_1 >= 2 * setup.hlslIterations)) return nullptr;
+    }
+    switch (stage) {
+    case STAGE_HASH:   return "hash";
+    case STAGE_BRIGHT: return "bright";
+    case STAGE_STREAM: return setup.boxPasses == 2 && setup.resample == 1.0f ? "stream" : nullptr;
+    case STAGE_BLEND:  return "blend";
+    case STAGE_RESAMPLE_DOWN: return setup.resample > 1.0f ? "resample_down" : nullptr;
+    case STAGE_RESAMPLE_UP:   return setup.resample > 1.0f ? "resample_up" : nullptr;
+    case STAGE_BLUR_1:
+    case STAGE_BLUR_2:
+    case STAGE_BLUR_3:
+    case STAGE_BLUR_4: {
+        const int pass = stage - STAGE_BLUR_1;
+        if (setup.boxPasses > 0 && pass >= 2 * setup.boxPasses) return nullptr;
+        return setup.pyramid ? pyramid[pass] : setup.gaussian ? gaussian[pass] : box[pass];
+    }
+    default:           return nullptr;
+    }
+}
+
+double StageMinBytes(const Stage stage, const Settings& settings, const PixelFormat format,
+                     const int width, const int height) noexcept
+{
+    const BlurSetup blur = GetBlurSetup(settings);
+    if (!StageName(stage, blur)) return 0.0;
+    const int ds = blur.factor;
+    const double dsPixels = (double)std::max(1, width / ds) * std::max(1, height / ds);
+    if (blur.hlslIterations > 0) {
+        // Float ARGB buffers; the bright pass reads every input pixel it averages
+        const double bufferBytes = dsPixels * HLSL_PIXEL_BYTES;
+        switch (stage) {
+        case STAGE_BRIGHT: return dsPixels * ds * ds * PixelBytes(format) + bufferBytes;
+        case STAGE_BLEND:  return 2.0 * width * height * PixelBytes(format) + bufferBytes;
+        default:           return 2.0 * bufferBytes;
+        }
+    }
+    const bool fixedPoint = FixedPointBlur(blur, format);
+    // One pixel of the three glow planes
+    const double planeBytes = LiteGlowBlur::PLANAR_CHANNELS * (fixedPoint ? sizeof(std::uint16_t) : sizeof(float));
+    if (blur.resample > 1.0f && stage != STAGE_HASH && stage != STAGE_BRIGHT && stage != STAGE_BLEND) {
+        // Resampling: each direction goes through the blur grid's width at the
+        // downsampled height; the blur passes read and write the grid
+        int phases, period;
+        ResampleRatio(blur, phases, period);
+        const int dsW = std::max(1, width / ds);
+        const int dsH = std::max(1, height / ds);
+        const double midPixels = (double)ResampledLength(dsW, phases, period) * dsH;
+        const double gridPixels = (double)ResampledLength(dsW, phases, period) * ResampledLength(dsH, phases, period);
+        if (stage == STAGE_RESAMPLE_DOWN || stage == STAGE_RESAMPLE_UP) {
+            return (dsPixels + 2.0 * midPixels + gridPixels) * planeBytes;
+        }
+        return 2.0 * gridPixels * planeBytes;
+    }
+    // The sampled input rows (every factor-th) are read whole
+    const double sampledRows = (double)std::max(1, height / ds) * width * PixelBytes(format);
+
+    switch (stage) {
+    case STAGE_HASH:
+        return sampledRows;
+    case STAGE_BRIGHT:
+        return sampledRows + dsPixels * planeBytes;
+    case STAGE_STREAM:
+        // The intermediates stay in the slabs' rows
+        return sampledRows + 2.0 * width * height * PixelBytes(format);
+    case STAGE_BLEND:
+        // Input and output pixels once, the glow planes once
+        return 2.0 * width * height * PixelBytes(format) + dsPixels * planeBytes;
+    default:
+        break;
+    }
+    if (!blur.pyramid) return 2.0 * dsPixels * planeBytes;  // Each pass reads and writes every plane pixel once
+    if (stage == STAGE_BLUR_1) return 2.0 * dsPixels * planeBytes;  // Copy
+
+    // Bloom: per level, the downsample writes it from the 2x2 finer pixels,
+    // four box passes read and write it, and every level but the coarsest
+    // takes the upsampled coarser one; the base is normalized in place
+    const int octaves = PyramidOctaves(blur.radiusV);
+    double bytes = 2.0 * dsPixels * planeBytes;
+    double levelPixels = dsPixels;
+    for (int level = 0; level <= octaves; ++level) {
+        if (level > 0) bytes += 5.0 * levelPixels * planeBytes;
+        bytes += 4 * 2.0 * levelPixels * planeBytes;
+        if (level < octaves) bytes += 2.25 * levelPixels * planeBytes;
+        levelPixels /= 4.0;
+    }
+    return bytes;
+}
+
+// =============================================================================
+// Render
+// =============================================================================
+
+namespace {
+
+// Whether a render of `blur` can go ahead with these images and settings.
+Status CheckRender(const ImageView& input, const ImageView& output, int outputX, int outputY,
+                   const Settings& settings, const BlurSetup& blur) noexcept
+{
+    Status err = ValidateSettings(settings);
+    if (err) return err;
+    if (!ValidView(input) || !ValidView(output) || input.format != output.format) {
+        return STATUS_BAD_PARAM;
+    }
+
+    // The output is the sub-rect of the input at (outputX, outputY): the input
+    // carries the glow apron around it
+    if (outputX < 0 || outputY < 0 ||
+        outputX + output.width > input.width || outputY + output.height > input.height) {
+        return STATUS_BAD_RECT;
+    }
+
+    if (blur.factor < 1 || blur.radiusH < 1 || blur.radiusV < 1 || blur.boxPasses < 0 || blur.boxPasses > 2 ||
+        blur.hlslIterations < 0 || blur.hlslIterations > 2 || (blur.hlslIterations > 0 && blur.factor > HLSL_MAX_FACTOR) ||
+        !(blur.resample >= 1.0f && blur.resample < 2.0f)) {
+        return STATUS_BAD_PARAM;
+    }
+    return STATUS_OK;
+}
+
+} // namespace
+
+Status RenderGlow(const ImageView& input, const ImageView& output, int outputX, int outputY,
+                  const Settings& settings, StageTimes* times) noexcept
+{
+    return RenderGlowWithBlur(input, output, outputX, outputY, settings, GetBlurSetup(settings), times);
+}
+
+Status RenderGlowWithBlur(const ImageView& input, const ImageView& output, int outputX, int outputY,
+                          const Settings& settings, const BlurSetup& blur, StageTimes* times) noexcept
+{
+    // Traced renders are timed too, to see each stage
+    StageTimes traceTimes;
+    if (!times && LiteGlowTrace::Enabled()) times = &traceTimes;
+    if (times) *times = StageTimes{};
+    const StageScope totalScope("render_glow", times ? &times->total : nullptr, nullptr);
+
+    Status err = CheckRender(input, output, outputX, outputY, settings, blur);
+    if (err) return err;
+
+    // The glow is computed over the whole input, on a grid anchored at its origin
+    if (blur.hlslIterations > 0) return RenderHlslPipeline(input, output, outputX, outputY, settings, blur, times);
+
+    float strength_norm = settings.strength / 2000.0f;
+    float threshold_norm = settings.threshold / 255.0f;
+    int base_radius = (int)settings.radius;
+
+    if (strength_norm <= 0.0001f || base_radius <= 0) {
+        CopyRect(input, output, outputX, outputY);
+        return STATUS_OK;
+    }
+
+    const int ds = blur.factor;
+    const int dsW = std::max(1, input.width / ds);
+    const int dsH = std::max(1, input.height / ds);
+    const bool pyramid = blur.pyramid;
+    const bool gaussian = blur.gaussian;
+    const int ds_radius_h = blur.radiusH;
+    const int ds_radius_v = blur.radiusV;
+    const LiteGlowSimd::PixelDepth depth = KernelDepth(input.format);
+    const LiteGlowSimd::PixelLayout layout = KernelLayout(input.format);
+    // Adaptive renders on a fractional grid blur resampled float planes
+    const bool resample = blur.resample > 1.0f;
+    const bool fixedPoint = FixedPointBlur(blur, input.format);
+    int gridPhases = 1, gridPeriod = 1;
+    if (resample) ResampleRatio(blur, gridPhases, gridPeriod);
+    const int gridW = resample ? ResampledLength(dsW, gridPhases, gridPeriod) : dsW;
+    const int gridH = resample ? ResampledLength(dsH, gridPhases, gridPeriod) : dsH;
+
+    // Box renders too large for full-frame intermediates stream instead
+    if (StreamsRender(blur, input.format, input.width, input.height)) {
+        return RenderStreamed(input, output, outputX, outputY, settings, blur, fixedPoint, times);
+    }
+
+    // Glow intermediates: planar float RGB at the downsampled size whatever the
+    // image depth. `bright` holds the bright pass, `glow` the blurred result and
+    // `scratch` is the second buffer of the box and pyramid passes (the
+    // recursive Gaussian filters in place and does not need it). They come
+    // from the scratch pool, so they are recycled across frames and threads
+    // and start out with stale contents: every stage writes all it reads.
+    // Afterwards `bright` and `glow` go to the glow cache, and a render that
+    // finds its stage there starts after it (only the blend, or only the blur).
+    // Both carry a tile occupancy map, so later stages skip black tiles.
+    // 8/16-bit Box renders use the Q15 planes (`...Q15`) in their place.
+    // Resampled renders blur `grid` (gridW x gridH) instead, and `scratch` is
+    // gridW x dsH: the resampling's middle step and the grid's second buffer.
+    LiteGlowBlur::PlanarRGBF bright = {}, glow = {}, scratch = {}, grid = {};
+    LiteGlowBlur::PlanarRGB16 brightQ15 = {}, glowQ15 = {}, scratchQ15 = {};
+    LiteGlowBlur::TileMap brightTiles = {}, glowTiles = {};
+    LiteGlowMem::ScratchBuffer brightStorage, glowStorage, scratchStorage, gridStorage;
+    LiteGlowCache::BrightKey brightKey = {};
+    LiteGlowCache::BlurKey blurKey = {};
+    LiteGlowCache::EntryRef cachedBright, cachedGlow;
+    bool runBright = true, runBlur = true;
+
+    // Look up the latest cached stage for this input and these settings
+    {
+        const StageScope scope("hash", times ? &times->ms[STAGE_HASH] : nullptr,
+                               times ? &times->counts[STAGE_HASH] : nullptr);
+        err = HashBrightPassSource(input, ds, dsH, brightKey.content);
+    }
+    if (err) return err;
+    brightKey.format = (int)input.format;
+    brightKey.srcWidth = input.width;
+    brightKey.srcHeight = input.height;
+    brightKey.factor = ds;
+    brightKey.width = dsW;
+    brightKey.height = dsH;
+    brightKey.threshold = threshold_norm;
+    brightKey.knee = settings.knee;
+    brightKey.intensity = settings.bloomIntensity;
+    brightKey.fixedPoint = fixedPoint;
+    blurKey.bright = brightKey;
+    blurKey.method = pyramid ? 0 : (gaussian ? BLUR_MODE_GAUSSIAN : BLUR_MODE_BOX);  // 0 = pyramid
+    blurKey.boxPasses = blur.boxPasses;
+    blurKey.resample = blur.resample;
+    blurKey.radiusH = ds_radius_h;
+    blurKey.radiusV = ds_radius_v;
+
+    cachedGlow = LiteGlowCache::FindBlur(blurKey);
+    if (cachedGlow) {
+        glow = cachedGlow->image;
+        glowQ15 = cachedGlow->imageQ15;
+        glowTiles = cachedGlow->tiles;
+        runBright = runBlur = false;
+    } else {
+        cachedBright = LiteGlowCache::FindBright(brightKey);
+        if (cachedBright) {
+            bright = cachedBright->image;
+            brightQ15 = cachedBright->imageQ15;
+            brightTiles = cachedBright->tiles;
+            runBright = false;
+        } else if (fixedPoint) {
+            err = AcquirePlanes(dsW, dsH, brightStorage, brightQ15, &brightTiles);
+        } else {
+            err = AcquirePlanes(dsW, dsH, brightStorage, bright, &brightTiles);
+        }
+        if (fixedPoint) {
+            if (!err) err = AcquirePlanes(dsW, dsH, glowStorage, glowQ15, &glowTiles);
+            if (!err) err = AcquirePlanes(dsW, dsH, scratchStorage, scratchQ15, nullptr);
+        } else if (resample) {
+            if (!err) err = AcquirePlanes(dsW, dsH, glowStorage, glow, &glowTiles);
+            if (!err) err = AcquirePlanes(gridW, dsH, scratchStorage, scratch, nullptr);
+            if (!err) err = AcquirePlanes(gridW, gridH, gridStorage, grid, nullptr);
+        } else {
+            if (!err) err = AcquirePlanes(dsW, dsH, glowStorage, glow, &glowTiles);
+            if (!err && !gaussian) err = AcquirePlanes(dsW, dsH, scratchStorage, scratch, nullptr);
+        }
+        if (err) return err;
+    }
+
+    // 1-3) Bright pass, blur and blend as one task graph on the worker pool,
+    //      starting after the last cached stage. The first blur stage works
+    //      on the bright pass's own row bands, so each of its bands starts
+    //      as soon as that bright band is done, and so does the resampling's
+    //      horizontal upsample after its vertical one. Every other stage
+    //      reads across bands or strips and waits for the whole stage before.
+    //      After the first blur stage, a one-item tile stage checks whether
+    //      anything passed the threshold and grows the occupancy maps of the
+    //      later passes.
+    //      Pyramid: the graph ends with the copy of the bright planes, the
+    //      bloom runs its own per-level passes, and the blend follows as a
+    //      single stage.
+    //      Resampled: the blur passes run on the grid, between the area
+    //      downsample of the bright planes and the interpolation back.
+    //      When nothing passed the threshold, the blur stages after the tile
+    //      stage do nothing and the blend copies the input, clamping float.
+    {
+        using LiteGlowSched::Dependency;
+        using LiteGlowSched::TaskGraph;
+
+        const float knee_norm = settings.knee / 100.0f;
+        const float intensity_norm = settings.bloomIntensity / 100.0f;
+        const LiteGlowSimd::PixelKernels& kernels = LiteGlowSimd::Kernels();
+        const LiteGlowSimd::BlendOp blendOp = KernelBlendOp(settings.blendMode);
+        const LiteGlowSimd::BrightParams brightParams{ threshold_norm, knee_norm, intensity_norm };
+        // 8/16-bit bright passes read the knee from a table shared by every
+        // render with the same settings
+        LiteGlowSimd::BrightResponseRef response;
+        if (runBright && depth != LiteGlowSimd::DEPTH_FLOAT) {
+            response = LiteGlowSimd::SharedBrightResponse(brightParams, depth);
+            if (!response) err = STATUS_OUT_OF_MEMORY;
+        }
+        const BrightPassInfo bp{ brightParams, kernels.bright[layout][depth], &input, ds, bright,
+                                 fixedPoint ? kernels.brightQ15[layout][depth] : nullptr, response.get(), brightQ15 };
+        const BlendInfo bl{ glow,
+                            { strength_norm * SCREEN_BLEND_STRENGTH_MULTIPLIER,
+                              settings.tintR, settings.tintG, settings.tintB },
+                            kernels.blend[blendOp][layout][depth],
+                            fixedPoint ? kernels.blendQ15[blendOp][layout][depth] : nullptr,
+                            glowQ15, ds, &input, &output, outputX, outputY, glowTiles };
+        const LiteGlowBlur::RecursiveGaussianCoefs coefsH =
+            LiteGlowBlur::ComputeRecursiveGaussianCoefs(BoxPassesToGaussianSigma(ds_radius_h));
+        const LiteGlowBlur::RecursiveGaussianCoefs coefsV =
+            LiteGlowBlur::ComputeRecursiveGaussianCoefs(BoxPassesToGaussianSigma(ds_radius_v));
+        const int bands = BandCount(dsH);
+        const int strips = StripItems(dsW);
+
+        // Occupancy after each intermediate box pass (the last one is glowTiles)
+        const size_t tileFloats = LiteGlowBlur::TileMapFloats(dsW, dsH, GLOW_TILE_W, GLOW_TILE_H);
+        std::unique_ptr<float[]> passTileStorage;
+        LiteGlowBlur::TileMap passTiles[3] = {};
+        if (!err && runBlur && !gaussian && !pyramid && !resample) {
+            passTileStorage.reset(new (std::nothrow) float[3 * tileFloats]);
+            if (!passTileStorage) err = STATUS_OUT_OF_MEMORY;
+            for (int i = 0; !err && i < 3; ++i) {
+                passTiles[i] = LiteGlowBlur::TileMapAt(passTileStorage.get() + i * tileFloats, dsW, dsH,
+                                                       GLOW_TILE_W, GLOW_TILE_H);
+            }
+        }
+
+        // 1) Bright pass with soft knee for natural threshold (image pixels -> planes)
+        auto brightBand = [&](int band) {
+            std::fill(&brightTiles.At(0, band), &brightTiles.At(0, band) + brightTiles.cols, 0.0f);
+            for (int y = BandBegin(band); y < BandEnd(band, dsH); ++y) {
+                BrightPassRow(&bp, y, y);
+                if (fixedPoint) {
+                    LiteGlowBlur::AccumulateTileRow(brightQ15, y, brightTiles);
+                } else {
+                    LiteGlowBlur::AccumulateTileRow(bright, y, brightTiles);
+                }
+            }
+        };
+        // 2) Blur, leaving the bright planes intact for the cache.
+        //    Gaussian: one recursive H and V pass into `glow`.
+        //    Box: 4 passes (H, V, H, V) for a smooth Gaussian approximation,
+        //    or one H+V pair for low-resolution previews.
+        auto gaussianH = [&](int band) { GaussianBandH(bright, glow, coefsH, band, &brightTiles); };
+        auto gaussianV = [&](int item) { GaussianStripV(glow, coefsV, item); };
+        //    The fixed-point path runs the same box passes over its Q15 planes.
+        const int reachH = LiteGlowBlur::TileCount(ds_radius_h, GLOW_TILE_W);
+        const int reachV = LiteGlowBlur::TileCount(ds_radius_v, GLOW_TILE_H);
+        auto boxH1 = [&](int band) {
+            // Tile rows are bands, so the band's row of the map is its own
+            LiteGlowBlur::DilateTileRows(brightTiles, passTiles[0], reachH, 0, band, band + 1);
+            if (fixedPoint) BlurBandH(brightQ15, scratchQ15, ds_radius_h, band, &passTiles[0]);
+            else BlurBandH(bright, scratch, ds_radius_h, band, &passTiles[0]);
+        };
+        LiteGlowBlur::TileMap* const v1Tiles = blur.boxPasses == 1 ? &glowTiles : &passTiles[1];
+        auto boxV1 = [&](int item) {
+            if (fixedPoint) BlurStripV(scratchQ15, glowQ15, ds_radius_v, item, v1Tiles);
+            else BlurStripV(scratch, glow, ds_radius_v, item, v1Tiles);
+        };
+        auto boxH2 = [&](int band) {
+            if (fixedPoint) BlurBandH(glowQ15, scratchQ15, ds_radius_h, band, &passTiles[2]);
+            else BlurBandH(glow, scratch, ds_radius_h, band, &passTiles[2]);
+        };
+        auto boxV2 = [&](int item) {
+            if (fixedPoint) BlurStripV(scratchQ15, glowQ15, ds_radius_v, item, &glowTiles);
+            else BlurStripV(scratch, glow, ds_radius_v, item, &glowTiles);
+        };
+        auto copyBand = [&](int band) { CopyBand(bright, glow, band); };
+        //    Resampled: each direction is two passes through `scratch`, the
+        //    narrow direction first; the grid blurs through `scratch` too.
+        const LiteGlowBlur::ResamplePhases down = LiteGlowBlur::AreaDownPhases(gridPhases, gridPeriod);
+        const LiteGlowBlur::ResamplePhases up = LiteGlowBlur::LinearUpPhases(gridPeriod, gridPhases);
+        const LiteGlowBlur::PlanarRGBF gridTmp = { { scratch.plane[0], scratch.plane[1], scratch.plane[2] },
+                                                   gridW, gridH, scratch.stride };
+        auto downH = [&](int band) {
+            for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+                for (int y = BandBegin(band); y < BandEnd(band, dsH); ++y) {
+                    LiteGlowBlur::ResampleLine(bright.Row(c, y), dsW, scratch.Row(c, y), gridW, down);
+                }
+            }
+        };
+        auto downV = [&](int band) {
+            for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+                for (int y = BandBegin(band); y < BandEnd(band, gridH); ++y) {
+                    LiteGlowBlur::ResampleRowV(scratch.Plane(c), grid.Plane(c), y, down);
+                }
+            }
+        };
+        auto gridBoxH = [&](int band) { BlurBandH(grid, gridTmp, ds_radius_h, band); };
+        auto gridBoxV = [&](int item) { BlurStripV(gridTmp, grid, ds_radius_v, item); };
+        auto gridGaussianH = [&](int band) { GaussianBandH(grid, grid, coefsH, band); };
+        auto gridGaussianV = [&](int item) { GaussianStripV(grid, coefsV, item); };
+        auto upV = [&](int band) {
+            for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+                for (int y = BandBegin(band); y < BandEnd(band, dsH); ++y) {
+                    LiteGlowBlur::ResampleRowV(grid.Plane(c), scratch.Plane(c), y, up);
+                }
+            }
+        };
+        auto upH = [&](int band) {
+            for (int c = 0; c < LiteGlowBlur::PLANAR_CHANNELS; ++c) {
+                for (int y = BandBegin(band); y < BandEnd(band, dsH); ++y) {
+                    LiteGlowBlur::ResampleLine(scratch.Row(c, y), gridW, glow.Row(c, y), dsW, up);
+                }
+            }
+        };
+        // Set when nothing passed the threshold, before the graph when the
+        // bright planes are cached or else by the tile stage
+        bool dark = false;
+        // The tile stage: once the first blur stage is done (and with it the
+        // bright pass), grow the lit tiles by the reach of each later pass
+        auto tileStage = [&](int) {
+            if (runBright && LiteGlowBlur::TileMapPeak(brightTiles) <= 0.0f) {
+                dark = true;
+            } else if (gaussian) {
+                LiteGlowBlur::FillTileMap(glowTiles, LiteGlowBlur::TileMapPeak(brightTiles));
+            } else if (pyramid || resample) {
+                LiteGlowBlur::DilateTileMap(brightTiles, glowTiles,
+                                            LiteGlowBlur::TileCount(BlurReach(blur, true), GLOW_TILE_W),
+                                            LiteGlowBlur::TileCount(BlurReach(blur, false), GLOW_TILE_H));
+            } else {
+                // The first H pass grew its own rows
+                LiteGlowBlur::DilateTileMap(passTiles[0], *v1Tiles, 0, reachV);
+                if (blur.boxPasses == 2) {
+                    LiteGlowBlur::DilateTileMap(passTiles[1], passTiles[2], reachH, 0);
+                    LiteGlowBlur::DilateTileMap(passTiles[2], glowTiles, 0, reachV);
+                }
+            }
+        };
+        // 3) Blend with tint color (planes -> image pixels). A dark frame is
+        //    copied as a blend over black tiles would: float still clamps, so
+        //    a highlight elsewhere does not change these pixels
+        auto blendBand = [&](int band) {
+            for (int y = BandBegin(band); y < BandEnd(band, output.height); ++y) {
+                if (dark) {
+                    CopySpan(&bl, y, 0, output.width);
+                } else {
+                    BlendRow(&bl, y);
+                }
+            }
+        };
+
+        // Cached stages already know their occupancy
+        if (!runBright) {
+            const LiteGlowBlur::TileMap& litTiles = runBlur ? brightTiles : glowTiles;
+            if (LiteGlowBlur::TileMapPeak(litTiles) <= 0.0f) {
+                dark = true;
+                runBlur = false;
+            }
+        }
+
+        // The stages in order, each with its edge from the one before. The
+        // stages after the tile stage are gated: they do nothing in a dark frame.
+        struct GraphStage {
+            int items;
+            LiteGlowSched::TaskFn fn;
+            Stage stage;
+            Dependency after;
+            bool gated;
+        };
+        struct DarkGate {
+            LiteGlowSched::TaskFn fn;
+            const bool* dark;
+            void operator()(int item) const {
+                if (!*dark) fn.invoke(fn.context, item);
+            }
+        };
+        GraphStage stages[12];
+        DarkGate gates[12];
+        int stageCount = 0;
+        bool pastTiles = false;
+        auto addStage = [&](int items, auto& fn, Stage stage, Dependency after = Dependency::ALL) {
+            GraphStage& entry = stages[stageCount];
+            entry = GraphStage{ items, LiteGlowSched::MakeTaskFn(fn), stage, after, pastTiles };
+            if (pastTiles) {
+                gates[stageCount] = DarkGate{ entry.fn, &dark };
+                entry.fn = LiteGlowSched::MakeTaskFn(gates[stageCount]);
+            }
+            ++stageCount;
+        };
+        // The bright bands feed the first blur stage band for band
+        const Dependency afterBright = runBright ? Dependency::PER_ITEM : Dependency::ALL;
+        auto addTileStage = [&](Stage stage) {
+            addStage(1, tileStage, stage);
+            pastTiles = true;
+        };
+        const int gridBands = BandCount(gridH);
+        const int gridStrips = StripItems(gridW);
+        if (runBright) addStage(bands, brightBand, STAGE_BRIGHT);
+        if (runBlur && resample) {
+            addStage(bands, downH, STAGE_RESAMPLE_DOWN, afterBright);
+            addTileStage(STAGE_RESAMPLE_DOWN);
+            addStage(gridBands, downV, STAGE_RESAMPLE_DOWN);
+            if (gaussian) {
+                addStage(gridBands, gridGaussianH, STAGE_BLUR_1);
+                addStage(gridStrips, gridGaussianV, STAGE_BLUR_2);
+            } else {
+                addStage(gridBands, gridBoxH, STAGE_BLUR_1);
+                addStage(gridStrips, gridBoxV, STAGE_BLUR_2);
+                addStage(gridBands, gridBoxH, STAGE_BLUR_3);
+                addStage(gridStrips, gridBoxV, STAGE_BLUR_4);
+            }
+            addStage(bands, upV, STAGE_RESAMPLE_UP);
+            // Each band of the horizontal pass reads only its own rows
+            addStage(bands, upH, STAGE_RESAMPLE_UP, Dependency::PER_ITEM);
+        } else if (runBlur && gaussian) {
+            addStage(bands, gaussianH, STAGE_BLUR_1, afterBright);
+            addTileStage(STAGE_BLUR_1);
+            addStage(strips, gaussianV, STAGE_BLUR_2);
+        } else if (runBlur && !pyramid) {
+            addStage(bands, boxH1, STAGE_BLUR_1, afterBright);
+            addTileStage(STAGE_BLUR_1);
+            addStage(strips, boxV1, STAGE_BLUR_2);
+            if (blur.boxPasses == 2) {
+                addStage(bands, boxH2, STAGE_BLUR_3);
+                addStage(strips, boxV2, STAGE_BLUR_4);
+            }
+        } else if (runBlur) {
+            addStage(bands, copyBand, STAGE_BLUR_1, afterBright);
+            addTileStage(STAGE_BLUR_1);
+        }
+        const bool blendInGraph = !(runBlur && pyramid);
+        pastTiles = false;
+        if (blendInGraph) addStage(BandCount(output.height), blendBand, STAGE_BLEND);
+
+        // Timed renders run the stages one by one to see each
+        if (!err && !times) {
+            TaskGraph graph;
+            TaskGraph::NodeId last = -1;
+            for (int i = 0; i < stageCount; ++i) {
+                const TaskGraph::NodeId node = graph.AddNode(stages[i].items, stages[i].fn);
+                if (last >= 0) graph.AddEdge(last, node, stages[i].after);
+                last = node;
+            }
+            if (!graph.Run()) err = STATUS_OUT_OF_MEMORY;
+        } else if (!err) {
+            // Consecutive entries of one stage (the resampling's two passes,
+            // the tile stage) are timed together; gated stages of a dark
+            // frame are not timed at all
+            for (int i = 0; !err && i < stageCount;) {
+                const Stage stage = stages[i].stage;
+                if (dark && stages[i].gated) {
+                    ++i;
+                    continue;
+                }
+                const StageScope scope(StageName(stage, blur), &times->ms[stage], &times->counts[stage]);
+                for (; !err && i < stageCount && stages[i].stage == stage; ++i) {
+                    const GraphStage& s = stages[i];
+                    auto run = [&](int item) { s.fn.invoke(s.fn.context, item); };
+                    err = ParallelFor(s.items, run);
+                }
+            }
+        }
+
+        if (!err && !blendInGraph) {
+            if (!dark) {
+                const StageScope scope("bloom", times ? &times->ms[STAGE_BLUR_2] : nullptr,
+                                       times ? &times->counts[STAGE_BLUR_2] : nullptr);
+                err = RunPyramidBloom(glow, scratch, ds_radius_h, ds_radius_v);
+            }
+            const StageScope scope("blend", times ? &times->ms[STAGE_BLEND] : nullptr,
+                                   times ? &times->counts[STAGE_BLEND] : nullptr);
+            if (!err) err = ParallelFor(BandCount(output.height), blendBand);
+        }
+        // A dark frame leaves the glow planes unwritten
+        if (dark) runBlur = false;
+    }
+
+    // Hand the freshly computed stages to the cache
+    if (!err && runBright) {
+        LiteGlowCache::StoreBright(brightKey, fixedPoint
+            ? LiteGlowCache::MakeEntry(std::move(brightStorage), brightQ15, brightTiles)
+            : LiteGlowCache::MakeEntry(std::move(brightStorage), bright, brightTiles));
+    }
+    if (!err && runBlur) {
+        LiteGlowCache::StoreBlur(blurKey, fixedPoint
+            ? LiteGlowCache::MakeEntry(std::move(glowStorage), glowQ15, glowTiles)
+            : LiteGlowCache::MakeEntry(std::move(glowStorage), glow, glowTiles));
+    }
+    return err;
+}
+
+// =============================================================================
+// Temporal Render
+// =============================================================================
+// RenderGlowTemporal keeps each instance's last Box render in the temporal
+// cache (LiteGlow_TemporalCache.h) and redoes only what changed since:
+//   - every input tile (a glow tile times the factor) is hashed and compared
+//     with its hash in the last frame;
+//   - the bright pass reruns over the glow tiles of changed input tiles;
+//   - each box pass reruns over the tiles whose input changed within its
+//     radius, reading the rest of its input from the last frame;
+//   - the blend reruns where the input or the glow changed, into the frame's
+//     copy of the output, which is then copied out whole.
+// A changed threshold, knee or intensity reruns every stage, a changed
+// radius the blur and blend, a changed Strength, Tint or Blend Mode the
+// blend. Stages run one after another, each as one ParallelFor.
+
+namespace {
+
+using LiteGlowTemporal::FrameKey;
+using LiteGlowTemporal::TEMPORAL_PLANES;
+
+inline bool SameBits(const float a, const float b) noexcept {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool SameBright(const FrameKey& a, const FrameKey& b) noexcept {
+    return SameBits(a.threshold, b.threshold) && SameBits(a.knee, b.knee) && SameBits(a.intensity, b.intensity);
+}
+
+bool SameBlur(const FrameKey& a, const FrameKey& b) noexcept {
+    return a.radiusH == b.radiusH && a.radiusV == b.radiusV;
+}
+
+bool SameBlend(const FrameKey& a, const FrameKey& b) noexcept {
+    return SameBits(a.strength, b.strength) && SameBits(a.tintR, b.tintR) && SameBits(a.tintG, b.tintG) &&
+           SameBits(a.tintB, b.tintB) && a.blendMode == b.blendMode;
+}
+
+FrameKey TemporalKey(const ImageView& input, const ImageView& output, int outputX, int outputY,
+                     const Settings& settings, const BlurSetup& blur) noexcept
+{
+    FrameKey key = {};
+    key.format = (int)input.format;
+    key.srcWidth = input.width;
+    key.srcHeight = input.height;
+    key.factor = blur.factor;
+    key.width = std::max(1, input.width / blur.factor);
+    key.height = std::max(1, input.height / blur.factor);
+    key.fixedPoint = FixedPointBlur(blur, input.format);
+    key.boxPasses = blur.boxPasses;
+    key.outputX = outputX;
+    key.outputY = outputY;
+    key.outputWidth = output.width;
+    key.outputHeight = output.height;
+    key.threshold = settings.threshold / 255.0f;
+    key.knee = settings.knee;
+    key.intensity = settings.bloomIntensity;
+    key.radiusH = blur.radiusH;
+    key.radiusV = blur.radiusV;
+    key.strength = settings.strength;
+    key.tintR = settings.tintR;
+    key.tintG = settings.tintG;
+    key.tintB = settings.tintB;
+    key.blendMode = settings.blendMode;
+    return key;
+}
+
+// Input tiles are the glow tiles at the input resolution, so each glow tile
+// reads exactly one of them.
+inline LiteGlowBlur::TileMap InputTileMap(float* storage, const FrameKey& key) noexcept {
+    return LiteGlowBlur::TileMapAt(storage, key.srcWidth, key.srcHeight, GLOW_TILE_W * key.factor,
+                                   GLOW_TILE_H * key.factor);
+}
+
+inline std::size_t AlignScratch(const std::size_t bytes) noexcept {
+    return (bytes + LiteGlowMem::SCRATCH_ALIGNMENT - 1) / LiteGlowMem::SCRATCH_ALIGNMENT * LiteGlowMem::SCRATCH_ALIGNMENT;
+}
+
+// Where the parts of a frame sit in its storage: per plane the planes and
+// their tile map, then the input tile hashes and the output pixels.
+struct TemporalLayout {
+    std::size_t planeBytes;
+    std::size_t tileBytes;
+    std::size_t hashBytes;
+    std::size_t outputRowBytes;
+    std::size_t bytes;
+};
+
+TemporalLayout GetTemporalLayout(const FrameKey& key) noexcept {
+    TemporalLayout layout;
+    layout.planeBytes = key.fixedPoint
+        ? LiteGlowBlur::PlanarRGBSamples<std::uint16_t>(key.width, key.height) * sizeof(std::uint16_t)
+        : LiteGlowBlur::PlanarRGBSamples<float>(key.width, key.height) * sizeof(float);
+    layout.tileBytes = AlignScratch(
+        LiteGlowBlur::TileMapFloats(key.width, key.height, GLOW_TILE_W, GLOW_TILE_H) * sizeof(float));
+    const LiteGlowBlur::TileMap inputTiles = InputTileMap(nullptr, key);
+    layout.hashBytes = AlignScratch((std::size_t)inputTiles.cols * inputTiles.rows * sizeof(std::uint64_t));
+    layout.outputRowBytes = AlignScratch((std::size_t)key.outputWidth * PixelBytes((PixelFormat)key.format));
+    layout.bytes = (std::size_t)(2 * key.boxPasses + 1) * (layout.planeBytes + layout.tileBytes) +
+                   layout.hashBytes + layout.outputRowBytes * key.outputHeight;
+    return layout;
+}
+
+// A frame for `key` from the scratch pool, or null. Its contents are stale
+// until a render marks everything changed and fills them.
+LiteGlowTemporal::FrameRef NewTemporalFrame(const FrameKey& key) noexcept {
+    const TemporalLayout layout = GetTemporalLayout(key);
+    LiteGlowTemporal::FrameRef frame(new (std::nothrow) LiteGlowTemporal::Frame{});
+    if (!frame) return nullptr;
+    frame->storage = LiteGlowMem::AcquireScratch(layout.bytes);
+    if (!frame->storage) return nullptr;
+    frame->key = key;
+    char* p = frame->storage.As<char>();
+    for (int k = 0; k <= 2 * key.boxPasses; ++k) {
+        if (key.fixedPoint) {
+            frame->planesQ15[k] = LiteGlowBlur::PlanarRGBAt<std::uint16_t>((std::uint16_t*)p, key.width, key.height);
+        } else {
+            frame->planes[k] = LiteGlowBlur::PlanarRGBAt<float>((float*)p, key.width, key.height);
+        }
+        p += layout.planeBytes;
+        frame->tiles[k] = LiteGlowBlur::TileMapAt((float*)p, key.width, key.height, GLOW_TILE_W, GLOW_TILE_H);
+        p += layout.tileBytes;
+    }
+    frame->tileHashes = (std::uint64_t*)p;
+    frame->output = p + layout.hashBytes;
+    frame->outputRowBytes = (std::ptrdiff_t)layout.outputRowBytes;
+    return frame;
+}
+
+template <typename T>
+LiteGlowBlur::PlanarRGB<T>* FramePlanes(LiteGlowTemporal::Frame& frame) noexcept {
+    if constexpr (std::is_same<T, float>::value) {
+        return frame.planes;
+    } else {
+        return frame.planesQ15;
+    }
+}
+
+// Renders into `frame` (its layout matches `key`; all of it is stale when
+// `fresh`) and copies the result to `output`.
+template <typename T>
+Status RenderTemporalFrame(LiteGlowTemporal::Frame& frame, const bool fresh, const FrameKey& key,
+                           const ImageView& input, const ImageView& output, int outputX, int outputY,
+                           const Settings& settings, const BlurSetup& blur, StageTimes* times) noexcept
+{
+    // Traced renders are timed too, to see each stage
+    StageTimes traceTimes;
+    if (!times && LiteGlowTrace::Enabled()) times = &traceTimes;
+    if (times) *times = StageTimes{};
+    const StageScope totalScope("render_glow", times ? &times->total : nullptr, nullptr);
+
+    const LiteGlowBlur::PlanarRGB<T>* const planes = FramePlanes<T>(frame);
+    const LiteGlowBlur::TileMap* const tiles = frame.tiles;
+    const int passes = 2 * blur.boxPasses;
+    const int ds = blur.factor;
+    const int dsW = key.width;
+    const int dsH = key.height;
+
+    // Stages whose settings changed rerun over the whole frame
+    const bool brightAll = fresh || !SameBright(frame.key, key);
+    const bool blurAll = brightAll || !SameBlur(frame.key, key);
+    const bool blendAll = fresh || !SameBlend(frame.key, key);
+    frame.key = key;
+
+    // Maps of the tiles each stage reruns (1) or keeps (0): input tiles,
+    // output tiles (on the input tile grid) and every plane
+    const size_t inputTileFloats = LiteGlowBlur::TileMapFloats(input.width, input.height, GLOW_TILE_W * ds,
+                                                               GLOW_TILE_H * ds);
+    const size_t planeTileFloats = LiteGlowBlur::TileMapFloats(dsW, dsH, GLOW_TILE_W, GLOW_TILE_H);
+    std::unique_ptr<float[]> changeStorage(
+        new (std::nothrow) float[2 * inputTileFloats + (size_t)(passes + 1) * planeTileFloats]);
+    std::unique_ptr<std::uint64_t[]> hashes(new (std::nothrow) std::uint64_t[inputTileFloats]);
+    if (!changeStorage || !hashes) return STATUS_OUT_OF_MEMORY;
+    const LiteGlowBlur::TileMap inputChanged = InputTileMap(changeStorage.get(), key);
+    const LiteGlowBlur::TileMap outputChanged = InputTileMap(changeStorage.get() + inputTileFloats, key);
+    LiteGlowBlur::TileMap changed[TEMPORAL_PLANES] = {};
+    for (int k = 0; k <= passes; ++k) {
+        changed[k] = LiteGlowBlur::TileMapAt(changeStorage.get() + 2 * inputTileFloats + k * planeTileFloats,
+                                             dsW, dsH, GLOW_TILE_W, GLOW_TILE_H);
+    }
+
+    // 1) Hash the input tiles, one task per row of them, and mark the ones
+    //    that differ from the last frame
+    Status err;
+    {
+        const StageScope scope("hash", times ? &times->ms[STAGE_HASH] : nullptr,
+                               times ? &times->counts[STAGE_HASH] : nullptr);
+        const int pixelBytes = PixelBytes(input.format);
+        auto hashTileRow = [&](int ty) {
+            const std::ptrdiff_t first = (std::ptrdiff_t)ty * inputChanged.cols;
+            std::uint64_t* h = hashes.get() + first;
+            std::fill(h, h + inputChanged.cols, (std::uint64_t)0);
+            const int y1 = std::min(input.height, (ty + 1) * inputChanged.tileH);
+            for (int y = ty * inputChanged.tileH; y < y1; ++y) {
+                const char* row = RowAt(input, y);
+                for (int tx = 0; tx < inputChanged.cols; ++tx) {
+                    const int x0 = tx * inputChanged.tileW;
+                    const int x1 = std::min(input.width, x0 + inputChanged.tileW);
+                    h[tx] = LiteGlowCache::HashBytes(row + (std::ptrdiff_t)x0 * pixelBytes,
+                                                     (size_t)(x1 - x0) * pixelBytes, h[tx]);
+                }
+            }
+            for (int tx = 0; tx < inputChanged.cols; ++tx) {
+                inputChanged.At(tx, ty) = fresh || h[tx] != frame.tileHashes[first + tx] ? 1.0f : 0.0f;
+                frame.tileHashes[first + tx] = h[tx];
+            }
+        };
+        err = ParallelFor(inputChanged.rows, hashTileRow);
+    }
+    if (err) return err;
+
+    // 2) What reruns: the bright pass under changed input tiles, each box
+    //    pass wherever its input changed within its radius, and the blend
+    //    where the input or the glow under it changed
+    for (int ty = 0; ty < changed[0].rows; ++ty) {
+        for (int tx = 0; tx < changed[0].cols; ++tx) {
+            changed[0].At(tx, ty) = brightAll ? 1.0f : inputChanged.At(tx, ty);
+        }
+    }
+    const int reachH = LiteGlowBlur::TileCount(blur.radiusH, GLOW_TILE_W);
+    const int reachV = LiteGlowBlur::TileCount(blur.radiusV, GLOW_TILE_H);
+    for (int k = 1; k <= passes; ++k) {
+        const bool horizontal = (k & 1) != 0;
+        if (blurAll) {
+            LiteGlowBlur::FillTileMap(changed[k], 1.0f);
+        } else {
+            LiteGlowBlur::DilateTileMap(changed[k - 1], changed[k], horizontal ? reachH : 0, horizontal ? 0 : reachV);
+        }
+    }
+    // Input tiles past the glow planes' last tile read its last row/column
+    const LiteGlowBlur::TileMap& glowChanged = changed[passes];
+    for (int ty = 0; ty < outputChanged.rows; ++ty) {
+        for (int tx = 0; tx < outputChanged.cols; ++tx) {
+            const bool rerun = blendAll || inputChanged.Lit(tx, ty) ||
+                               glowChanged.Lit(std::min(tx, glowChanged.cols - 1), std::min(ty, glowChanged.rows - 1));
+            outputChanged.At(tx, ty) = rerun ? 1.0f : 0.0f;
+        }
+    }
+
+    // 3) Bright pass over its changed tiles, refreshing their occupancy
+    const LiteGlowSimd::PixelDepth depth = KernelDepth(input.format);
+    const LiteGlowSimd::PixelLayout layout = KernelLayout(input.format);
+    const LiteGlowSimd::PixelKernels& kernels = LiteGlowSimd::Kernels();
+    const LiteGlowSimd::BrightParams brightParams{ key.threshold, settings.knee / 100.0f,
+                                                   settings.bloomIntensity / 100.0f };
+    LiteGlowSimd::BrightResponseRef response;
+    if (depth != LiteGlowSimd::DEPTH_FLOAT && LiteGlowBlur::TileMapPeak(changed[0]) > 0.0f) {
+        response = LiteGlowSimd::SharedBrightResponse(brightParams, depth);
+        if (!response) return STATUS_OUT_OF_MEMORY;
+    }
+    BrightPassInfo bp{ brightParams, kernels.bright[layout][depth], &input, ds, {},
+                       key.fixedPoint ? kernels.brightQ15[layout][depth] : nullptr, response.get(), {} };
+    SetBrightRow(bp, planes[0]);
+    auto brightBand = [&](int band) {
+        LiteGlowBlur::ForEachTileRunX(changed[0], band, [&](int tx0, int tx1, bool rerun) {
+            if (!rerun) return;
+            std::fill(&tiles[0].At(tx0, band), &tiles[0].At(tx0, band) + (tx1 - tx0), 0.0f);
+            const int x0 = tx0 * GLOW_TILE_W;
+            const int x1 = std::min(dsW, tx1 * GLOW_TILE_W);
+            for (int y = BandBegin(band); y < BandEnd(band, dsH); ++y) {
+                BrightPassSpan(&bp, y, y, x0, x1);
+                LiteGlowBlur::AccumulateTileRow(planes[0], y, tiles[0], tx0, tx1);
+            }
+        });
+    };
+    {
+        const StageScope scope("bright", times ? &times->ms[STAGE_BRIGHT] : nullptr,
+                               times ? &times->counts[STAGE_BRIGHT] : nullptr);
+        err = ParallelFor(BandCount(dsH), brightBand);
+    }
+    if (err) return err;
+
+    // 4) Box passes over their changed tiles, with the occupancy of every
+    //    pass grown from the bright pass's as in a full render
+    for (int k = 1; k <= passes; ++k) {
+        const bool horizontal = (k & 1) != 0;
+        LiteGlowBlur::DilateTileMap(tiles[k - 1], tiles[k], horizontal ? reachH : 0, horizontal ? 0 : reachV);
+    }
+    for (int k = 1; !err && k <= passes; ++k) {
+        const Stage stage = (Stage)(STAGE_BLUR_1 + k - 1);
+        const StageScope scope(StageName(stage, blur), times ? &times->ms[stage] : nullptr,
+                               times ? &times->counts[stage] : nullptr);
+        if (k & 1) {
+            auto boxH = [&](int band) { BlurBandH(planes[k - 1], planes[k], blur.radiusH, band, &tiles[k], &changed[k]); };
+            err = ParallelFor(BandCount(dsH), boxH);
+        } else {
+            auto boxV = [&](int item) { BlurStripV(planes[k - 1], planes[k], blur.radiusV, item, &tiles[k], &changed[k]); };
+            err = ParallelFor(StripItems(dsW), boxV);
+        }
+    }
+    if (err) return err;
+
+    // 5) Blend the changed tiles into the last output, then copy it out
+    const ImageView last = { frame.output, frame.outputRowBytes, output.width, output.height, output.format };
+    const LiteGlowSimd::BlendOp blendOp = KernelBlendOp(settings.blendMode);
+    BlendInfo bl{ {},
+                  { settings.strength / 2000.0f * SCREEN_BLEND_STRENGTH_MULTIPLIER,
+                    settings.tintR, settings.tintG, settings.tintB },
+                  kernels.blend[blendOp][layout][depth],
+                  key.fixedPoint ? kernels.blendQ15[blendOp][layout][depth] : nullptr,
+                  {}, ds, &input, &last, outputX, outputY, tiles[passes] };
+    SetGlowRow(bl, planes[passes]);
+    const size_t rowBytes = (size_t)output.width * PixelBytes(output.format);
+    auto blendBand = [&](int band) {
+        for (int y = BandBegin(band); y < BandEnd(band, output.height); ++y) {
+            const int ty = (y + outputY) / outputChanged.tileH;
+            LiteGlowBlur::ForEachTileRunX(outputChanged, ty, [&](int tx0, int tx1, bool rerun) {
+                const int x0 = std::max(0, tx0 * outputChanged.tileW - outputX);
+                const int x1 = std::min(output.width, tx1 * outputChanged.tileW - outputX);
+                if (rerun && x0 < x1) BlendRowRange(&bl, y, x0, x1);
+            });
+            std::memcpy(PixelAt(output, 0, y), PixelAt(last, 0, y), rowBytes);
+        }
+    };
+    const StageScope scope("blend", times ? &times->ms[STAGE_BLEND] : nullptr,
+                           times ? &times->counts[STAGE_BLEND] : nullptr);
+    return ParallelFor(BandCount(output.height), blendBand);
+}
+
+} // namespace
+
+Status RenderGlowTemporal(const std::uint64_t instance, const ImageView& input, const ImageView& output,
+                          const int outputX, const int outputY, const Settings& settings, const BlurSetup& blur,
+                          StageTimes* times) noexcept
+{
+    // Only full-frame Box renders that draw a glow keep frames; the rest
+    // render as usual (which also reports bad parameters)
+    const bool temporal = instance != 0 && LiteGlowTemporal::Limit() > 0 &&
+                          CheckRender(input, output, outputX, outputY, settings, blur) == STATUS_OK &&
+                          !blur.pyramid && !blur.gaussian && blur.hlslIterations == 0 && blur.boxPasses > 0 &&
+                          blur.resample == 1.0f && settings.strength / 2000.0f > 0.0001f && (int)settings.radius > 0 &&
+                          !StreamsRender(blur, input.format, input.width, input.height);
+    const FrameKey key = temporal ? TemporalKey(input, output, outputX, outputY, settings, blur) : FrameKey{};
+    if (!temporal || GetTemporalLayout(key).bytes > LiteGlowTemporal::Limit()) {
+        return RenderGlowWithBlur(input, output, outputX, outputY, settings, blur, times);
+    }
+
+    LiteGlowTemporal::FrameRef frame = LiteGlowTemporal::Take(instance, key);
+    const bool fresh = !frame;
+    if (fresh) {
+        frame = NewTemporalFrame(key);
+        if (!frame) return RenderGlowWithBlur(input, output, outputX, outputY, settings, blur, times);
+    }
+
+    const Status err = key.fixedPoint
+        ? RenderTemporalFrame<std::uint16_t>(*frame, fresh, key, input, output, outputX, outputY, settings, blur, times)
+        : RenderTemporalFrame<float>(*frame, fresh, key, input, output, outputX, outputY, settings, blur, times);
+    if (!err) LiteGlowTemporal::Put(instance, std::move(frame));
+    return err;
+}
+
+} // namespace LiteGlowCore
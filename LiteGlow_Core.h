@@ -0,0 +1,275 @@
+#pragma once
+
+#ifndef LITEGLOW_CORE_H
+#define LITEGLOW_CORE_H
+
+// =============================================================================
+// LiteGlow Core
+// =============================================================================
+// The CPU glow pipeline (bright pass, blur, blend) over plain strided images,
+// independent of any host: the After Effects plugin (LiteGlow.cpp) wraps its
+// worlds in ImageViews and calls RenderGlow, and the same code builds on its
+// own (CMakeLists.txt, target liteglow_core) for benchmarks and regression
+// runs on machines without the SDK.
+//
+// Images are 8-bit, 16-bit (0..32768, the After Effects range) or float
+// pixels with four interleaved channels, in ARGB or BGRA order. Input and
+// output share one format.
+//
+// Renders run on the worker pool (LiteGlow_Scheduler.h), take their
+// intermediates from the scratch pool (LiteGlow_ScratchPool.h) and keep them
+// in the glow cache (LiteGlow_GlowCache.h), or per effect instance in the
+// temporal cache (LiteGlow_TemporalCache.h); any number of threads may
+// render at once.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include "LiteGlow_Params.h"
+#include "LiteGlow_PerfCounters.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LiteGlowCore {
+
+enum PixelFormat {
+    FORMAT_ARGB32,      // PF_Pixel8
+    FORMAT_ARGB64,      // PF_Pixel16
+    FORMAT_ARGB128,     // PF_PixelFloat
+    FORMAT_BGRA32,
+    FORMAT_BGRA64,
+    FORMAT_BGRA128
+};
+
+// Bytes per pixel of `format`.
+constexpr int PixelBytes(const PixelFormat format) noexcept {
+    return format == FORMAT_ARGB32 || format == FORMAT_BGRA32 ? 4
+         : format == FORMAT_ARGB64 || format == FORMAT_BGRA64 ? 8
+         : 16;
+}
+
+// `height` rows of `width` pixels; row y starts rowBytes * y bytes after
+// `data` (rowBytes may exceed the pixels, but not be negative).
+struct ImageView {
+    void* data;
+    std::ptrdiff_t rowBytes;
+    int width;
+    int height;
+    PixelFormat format;
+};
+
+// Which lines of an interlaced frame are being rendered.
+enum Field {
+    FIELD_FRAME,
+    FIELD_UPPER,
+    FIELD_LOWER
+};
+
+// Effect parameters in their user units (LiteGlow_Params.h ranges), plus the
+// frame geometry the blur adapts to. Radius is in layer pixels; previews at
+// a reduced resolution scale it down (previewScaleX/Y).
+struct Settings {
+    float strength;
+    float radius;
+    float threshold;
+    int quality;
+    float bloomIntensity;  // User parameter (0-400) divided by 100 for actual multiplier
+    float knee;            // User parameter (0-100) divided by 100 for actual knee value
+    int blendMode;         // 1=Screen, 2=Add, 3=Normal
+    int blurMode;          // 1=Box, 2=Gaussian
+    float tintR;           // Tint color red (0-1)
+    float tintG;           // Tint color green (0-1)
+    float tintB;           // Tint color blue (0-1)
+    int parNum;            // Pixel aspect ratio (width / height of a pixel)
+    int parDen;
+    Field field;
+    float previewScaleX;   // Preview resolution (in_data downsample_x/y): 1 at Full,
+    float previewScaleY;   // 0.5 at Half, 0.25 at Quarter; 0 counts as 1
+};
+
+enum Status {
+    STATUS_OK,
+    STATUS_BAD_PARAM,       // Settings out of range, empty images, unknown or mismatched formats
+    STATUS_BAD_RECT,        // The output is not inside the input
+    STATUS_OUT_OF_MEMORY    // Also when the worker pool cannot run
+};
+
+constexpr float SCREEN_BLEND_STRENGTH_MULTIPLIER = 2.0f; // Strength multiplier for screen blend (compensates for downsampling)
+constexpr int MAX_ADJUSTED_BLUR_RADIUS = 32;
+
+Status ValidateSettings(const Settings& settings) noexcept;
+
+// Quality popup value (1-based) to internal downsample factor.
+int QualityToDownsample(int quality) noexcept;
+
+// Preview scale of `settings` along one axis, in (0, 1]: 1 at full
+// resolution (and for 0 or out-of-range values).
+float PreviewScale(float previewScale) noexcept;
+
+// Splits a blur radius into horizontal and vertical radii that keep the glow
+// round on non-square pixels (including previews downsampled more along one
+// axis; `baseRadius` is vertical) and halve it vertically for field renders.
+void AdjustBlurRadiusForPARAndField(int baseRadius, const Settings& settings, int& radiusH, int& radiusV) noexcept;
+
+// Which passes RenderGlow runs.
+enum Pipeline {
+    PIPELINE_CPU,      // This library's bright pass, box/Gaussian/pyramid blur and blend
+    PIPELINE_HLSL      // The GPU path's compute shaders (LiteGlow*Kernel.hlsl), emulated
+};
+
+// Selects the pipeline of every later render; PIPELINE_HLSL makes CPU renders
+// match GPU ones (to the rounding noted in LiteGlow_Simd.h, HLSL Pipeline
+// Kernels). Set it before rendering; it is not synchronized with renders.
+void SetPipeline(Pipeline pipeline) noexcept;
+Pipeline GetPipeline() noexcept;
+
+// "cpu", "hlsl"; ParsePipeline accepts the same names.
+const char* PipelineName(Pipeline pipeline) noexcept;
+bool ParsePipeline(const char* name, Pipeline& pipeline) noexcept;
+
+// What the blur runs for `settings`. The Quality downsample is in layer
+// pixels, so previews use a smaller factor on their already reduced input
+// and the glow grid stays the same size in the layer.
+// Adaptive Quality picks the grid from the radius instead: the blur runs at
+// a fixed radius of about 12 grid pixels, so its cost per pixel is the same
+// at any Radius. Its step splits into the integer factor of the bright pass
+// and, for the CPU blurs, a fractional `resample` of the bright planes.
+struct BlurSetup {
+    int factor;        // Downsample factor of the (preview) input
+    bool pyramid;
+    bool gaussian;
+    int radiusH;       // Downsampled radii after the Quality bonus, PAR/field
+    int radiusV;       // adjustment and (box passes only) the clamps
+    int hlslIterations;  // HLSL blur: H+V pairs of the 9-tap pass; 0 for the CPU blurs
+    int boxPasses;     // CPU Box blur: H+V pairs, 2 (1 for previews at Quarter or below); 0 otherwise
+    float resample;    // Adaptive: blur grid step in downsampled pixels, in [1, 2) by eighths
+                       // (radii are on that grid); 1 = none
+};
+
+// The blur of the active pipeline (GetHlslBlurSetup for PIPELINE_HLSL).
+BlurSetup GetBlurSetup(const Settings& settings) noexcept;
+
+// What the GPU path (and PIPELINE_HLSL) runs: one H+V pair of the 9-tap blur
+// for Low and Medium, two for High, Pyramid (there is no GPU pyramid),
+// Adaptive (integer factors only) and Auto (the GPU is not governed; it
+// renders Adaptive's grid). Previews at Quarter resolution or below
+// run one pair for Low to Pyramid, as their CPU Box blurs do.
+BlurSetup GetHlslBlurSetup(const Settings& settings) noexcept;
+
+// How far, in downsampled pixels, the blur carries a bright pixel.
+int BlurReach(const BlurSetup& setup, bool horizontal) noexcept;
+
+// Input rects should start on multiples of this, so every downsampled pixel
+// (and every pyramid level pixel) covers the same input pixels whatever
+// sub-rect is rendered. For Auto, whichever plan renders.
+int GlowGridStep(const Settings& settings) noexcept;
+
+// Auto Quality: the blurs a render may pick from, best looking first; the
+// frame-time governor (LiteGlow_Governor.h) takes the first one its cost
+// model expects to fit the budget. Plan p runs on the grid of
+// AUTO_FACTORS[p / 2], in layer pixels like the Quality downsample, with the
+// layer radius on that grid: the Blur Mode's own blur for even p, one box
+// pair at 1.4x the radius for odd p. PIPELINE_HLSL plans run two and one
+// pairs of the 9-tap blur instead.
+// Returns false for plans that cannot draw the radius (box radii past the
+// clamps, a grid coarser than the radius, or at preview resolution the same
+// grid as the plan before); `setup` is still filled, clamped. GetBlurSetup
+// returns the first valid plan.
+constexpr int AUTO_FACTORS[] = { 1, 2, 3, 4, 6, 8 };
+constexpr int AUTO_PLANS = 2 * (int)(sizeof(AUTO_FACTORS) / sizeof(AUTO_FACTORS[0]));
+bool GetAutoPlan(const Settings& settings, int plan, BlurSetup& setup) noexcept;
+
+// 8/16-bit Box renders keep the glow in Q15 integers (LiteGlow_Simd.h,
+// Fixed-Point Kernels) unless this is turned off, for comparisons against the
+// float path. Set it before rendering; it is not synchronized with renders.
+void SetFixedPoint(bool enabled) noexcept;
+
+// Box renders whose full-frame intermediates (bright, glow and scratch
+// planes at the downsampled size) would take more than `bytes` stream
+// instead: the bright pass, the four box passes and the blend advance
+// together down the frame, holding O(width x radius) rows per thread (see
+// RenderGlow). 0 streams every Box render. Set it before rendering; it is
+// not synchronized with renders.
+constexpr std::size_t STREAMING_DEFAULT_BYTES = (std::size_t)256 << 20;
+void SetStreamingThreshold(std::size_t bytes) noexcept;
+
+// Whether a render of `blur` over a `width` x `height` input streams.
+bool StreamsRender(const BlurSetup& blur, PixelFormat format, int width, int height) noexcept;
+
+// Pipeline stages, in the order they run (StageTimes).
+enum Stage {
+    STAGE_HASH,        // Content hash of the bright pass source (cache lookup; CPU pipeline)
+    STAGE_BRIGHT,
+    STAGE_RESAMPLE_DOWN,  // Adaptive: bright planes to the blur grid (when it is fractional)
+    STAGE_BLUR_1,      // Box and HLSL: H, V, H, V. Gaussian: H, V. Pyramid: copy, bloom
+    STAGE_BLUR_2,
+    STAGE_BLUR_3,
+    STAGE_BLUR_4,
+    STAGE_RESAMPLE_UP,    // Adaptive: blur grid back to the glow planes
+    STAGE_STREAM,      // Streamed Box renders: bright pass, blur and blend in one sweep
+    STAGE_BLEND,
+    STAGES
+};
+
+// "hash", "bright", "resample_down", "blur_h1" .. "blur_v2", "blur_h",
+// "blur_v", "blur_copy", "bloom", "resample_up", "stream" or "blend"; the
+// blur names follow the method of `setup`.
+// Null for stages the method does not have.
+const char* StageName(Stage stage, const BlurSetup& setup) noexcept;
+
+// Least bytes `stage` has to read and write to render a `width` x `height`
+// input in `format` with `settings`: every byte it touches once, whole
+// cache lines for the sampled input rows. The bloom is an estimate (its
+// level sizes are rounded).
+double StageMinBytes(Stage stage, const Settings& settings, PixelFormat format, int width, int height) noexcept;
+
+// What one render spent per stage. Stages that did not run (found in the
+// glow cache, or not part of the blur method) stay zero.
+struct StageTimes {
+    double ms[STAGES];                    // Wall-clock milliseconds
+    double total;                         // Whole call, including setup
+    LiteGlowPerf::Counts counts[STAGES];  // Summed over the threads that ran the stage, with stage counters on
+};
+
+// Profiling: with this on, timed and traced renders also read the hardware
+// counters of every stage (LiteGlow_PerfCounters.h) into StageTimes::counts
+// and the trace spans. It costs two counter reads per task. Set it before
+// rendering; it is not synchronized with renders.
+void SetStageCounters(bool enabled) noexcept;
+
+// Renders the glow of `input` into `output`, which shows the input rect at
+// (outputX, outputY) of the same size: the input carries the apron the glow
+// needs around the output (see BlurReach). The glow grid is anchored at the
+// input origin (see GlowGridStep). `input` is only read; `output` must not
+// overlap it.
+// With `times`, or while tracing (LiteGlow_Trace.h, one span per stage), the
+// blur and blend stages run one after another rather than as one task graph,
+// so each can be timed; the output is the same. Streamed renders
+// (SetStreamingThreshold) have a single stage, STAGE_STREAM, and skip the
+// glow cache.
+Status RenderGlow(const ImageView& input, const ImageView& output, int outputX, int outputY,
+                  const Settings& settings, StageTimes* times = nullptr) noexcept;
+
+// RenderGlow with `blur` in place of GetBlurSetup(settings), such as an Auto
+// plan (GetAutoPlan). The input apron and grid must suit it.
+Status RenderGlowWithBlur(const ImageView& input, const ImageView& output, int outputX, int outputY,
+                          const Settings& settings, const BlurSetup& blur, StageTimes* times = nullptr) noexcept;
+
+// RenderGlowWithBlur for the successive frames of one effect instance (any
+// non-zero id; the plugin keeps one in its sequence data). Box renders keep
+// their planes and output in the temporal cache, and the next render of the
+// instance recomputes only the input tiles that changed since, grown by the
+// reach of each box pass, reusing the last frame's glow and output elsewhere.
+// Other blurs, streamed renders, frames larger than the cache limit and
+// instance 0 render as RenderGlowWithBlur. The output is meant to match
+// RenderGlowWithBlur: exactly for 8/16-bit, and for float up to the rounding
+// of a box pass that restarts its running sum at a changed tile.
+// `GlowBench --parity` checks both over clips of moving and vanishing
+// highlights, setting edits, glowless frames and output sub-rects.
+Status RenderGlowTemporal(std::uint64_t instance, const ImageView& input, const ImageView& output,
+                          int outputX, int outputY, const Settings& settings, const BlurSetup& blur,
+                          StageTimes* times = nullptr) noexcept;
+
+} // namespace LiteGlowCore
+
+#endif // LITEGLOW_CORE_H
@@ -0,0 +1,182 @@
+/*	LiteGlow_GlowCache.cpp
+
+	Stage-wise cache of glow intermediates.
+	See LiteGlow_GlowCache.h for the model.
+
+*/
+
+#include "LiteGlow_GlowCache.h"
+#include "LiteGlow_LruCache.h"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace LiteGlowCache {
+
+namespace {
+
+inline bool SameBits(const float a, const float b) noexcept {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool SameKey(const BrightKey& a, const BrightKey& b) noexcept {
+    return a.content == b.content && a.format == b.format &&
+           a.srcWidth == b.srcWidth && a.srcHeight == b.srcHeight && a.factor == b.factor &&
+           a.width == b.width && a.height == b.height &&
+           SameBits(a.threshold, b.threshold) && SameBits(a.knee, b.knee) &&
+           SameBits(a.intensity, b.intensity) && a.fixedPoint == b.fixedPoint;
+}
+
+bool SameKey(const BlurKey& a, const BlurKey& b) noexcept {
+    return SameKey(a.bright, b.bright) && a.method == b.method && a.boxPasses == b.boxPasses &&
+           SameBits(a.resample, b.resample) && a.radiusH == b.radiusH && a.radiusV == b.radiusV;
+}
+
+enum class Stage { BRIGHT, BLUR };
+
+struct SlotKey {
+    Stage stage;
+    BlurKey key;          // Only key.bright is used for BRIGHT slots
+};
+
+struct SameSlot {
+    bool operator()(const SlotKey& a, const SlotKey& b) const noexcept {
+        if (a.stage != b.stage) return false;
+        return a.stage == Stage::BRIGHT ? SameKey(a.key.bright, b.key.bright) : SameKey(a.key, b.key);
+    }
+};
+
+typedef LiteGlowLru::LruCache<SlotKey, EntryRef, SameSlot> Cache;
+
+// Never destroyed, like the scratch pool it holds buffers of: GlobalSetdown
+// clears it instead.
+Cache* Instance() noexcept {
+    static Cache* cache = new (std::nothrow) Cache(GLOW_CACHE_DEFAULT_LIMIT);
+    return cache;
+}
+
+inline SlotKey BrightOnly(const BrightKey& key) noexcept {
+    SlotKey slot = { Stage::BRIGHT, {} };
+    slot.key.bright = key;
+    return slot;
+}
+
+inline std::uint64_t Load64(const unsigned char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t Round(std::uint64_t h, const std::uint64_t v) noexcept {
+    h ^= v * 0x9E3779B97F4A7C15ull;
+    h = (h << 31) | (h >> 33);
+    return h * 0xC2B2AE3D27D4EB4Full;
+}
+
+inline std::uint64_t Finalize(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace
+
+// =============================================================================
+// Entries
+// =============================================================================
+
+namespace {
+
+template <typename T>
+EntryRef MakeEntryOf(LiteGlowMem::ScratchBuffer&& storage, const LiteGlowBlur::PlanarRGB<T>& image,
+                     const LiteGlowBlur::TileMap& tiles) noexcept {
+    Entry* entry = new (std::nothrow) Entry{};
+    if (!entry) return nullptr;
+    entry->storage = std::move(storage);
+    if constexpr (std::is_same<T, float>::value) {
+        entry->image = image;
+    } else {
+        entry->imageQ15 = image;
+    }
+    entry->tiles = tiles;
+    try {
+        return EntryRef(entry);
+    } catch (...) {
+        // shared_ptr deletes `entry` itself when its control block cannot be allocated
+        return nullptr;
+    }
+}
+
+} // namespace
+
+EntryRef MakeEntry(LiteGlowMem::ScratchBuffer&& storage, const LiteGlowBlur::PlanarRGBF& image,
+                   const LiteGlowBlur::TileMap& tiles) noexcept {
+    return MakeEntryOf(std::move(storage), image, tiles);
+}
+
+EntryRef MakeEntry(LiteGlowMem::ScratchBuffer&& storage, const LiteGlowBlur::PlanarRGB16& image,
+                   const LiteGlowBlur::TileMap& tiles) noexcept {
+    return MakeEntryOf(std::move(storage), image, tiles);
+}
+
+EntryRef FindBright(const BrightKey& key) noexcept {
+    Cache* cache = Instance();
+    return cache ? cache->Find(BrightOnly(key)) : nullptr;
+}
+
+EntryRef FindBlur(const BlurKey& key) noexcept {
+    Cache* cache = Instance();
+    return cache ? cache->Find(SlotKey{ Stage::BLUR, key }) : nullptr;
+}
+
+void StoreBright(const BrightKey& key, const EntryRef& entry) noexcept {
+    Cache* cache = Instance();
+    if (cache && entry) cache->Store(BrightOnly(key), entry, entry->storage.Size());
+}
+
+void StoreBlur(const BlurKey& key, const EntryRef& entry) noexcept {
+    Cache* cache = Instance();
+    if (cache && entry) cache->Store(SlotKey{ Stage::BLUR, key }, entry, entry->storage.Size());
+}
+
+void Clear() noexcept {
+    if (Cache* cache = Instance()) cache->Clear();
+}
+
+void SetLimit(const std::size_t bytes) noexcept {
+    if (Cache* cache = Instance()) cache->SetLimit(bytes);
+}
+
+// =============================================================================
+// Content Hash
+// =============================================================================
+
+// Four independent lanes over 32-byte blocks keep the multiplies off one
+// dependency chain, so hashing runs near memory speed.
+std::uint64_t HashBytes(const void* data, const std::size_t bytes, const std::uint64_t seed) noexcept {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t lane[4] = { seed, seed ^ 0x6A09E667F3BCC908ull, seed ^ 0xBB67AE8584CAA73Bull,
+                              seed ^ 0x3C6EF372FE94F82Bull };
+    std::size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        lane[0] = Round(lane[0], Load64(p + i));
+        lane[1] = Round(lane[1], Load64(p + i + 8));
+        lane[2] = Round(lane[2], Load64(p + i + 16));
+        lane[3] = Round(lane[3], Load64(p + i + 24));
+    }
+    std::uint64_t h = Round(Round(Round(lane[0], lane[1]), lane[2]), lane[3]);
+    for (; i + 8 <= bytes; i += 8) h = Round(h, Load64(p + i));
+    if (i < bytes) {
+        unsigned char tail[8] = {};
+        std::memcpy(tail, p + i, bytes - i);
+        h = Round(h, Load64(tail));
+    }
+    return Finalize(h ^ (std::uint64_t)bytes);
+}
+
+} // namespace LiteGlowCache
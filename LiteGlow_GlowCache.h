@@ -0,0 +1,100 @@
+#pragma once
+
+#ifndef LITEGLOW_GLOWCACHE_H
+#define LITEGLOW_GLOWCACHE_H
+
+// =============================================================================
+// LiteGlow Glow Cache
+// =============================================================================
+// Keeps the intermediate planes of recent CPU renders so that an edit which
+// only affects a later stage reruns just that stage:
+//   - bright planes, keyed by the input content and threshold/knee/intensity
+//   - blurred glow, keyed additionally by the blur setup (method and the
+//     H/V radii, which already fold in Radius, Quality, PAR and field)
+// Dragging Strength, Tint or Blend Mode then only reblends, and dragging
+// Radius skips the bright pass.
+//
+// Entries are immutable once stored and handed out as shared references, so
+// concurrent (MFR) renders can read an entry while another thread evicts it.
+// Least recently used entries are dropped above a byte limit.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include "LiteGlow_Blur.h"
+#include "LiteGlow_ScratchPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace LiteGlowCache {
+
+constexpr std::size_t GLOW_CACHE_DEFAULT_LIMIT = (std::size_t)256 * 1024 * 1024;
+
+// Everything the bright planes depend on. Floats are compared bitwise.
+struct BrightKey {
+    std::uint64_t content;  // Hash of the source pixels the bright pass reads
+    int format;             // Host pixel format
+    int srcWidth;
+    int srcHeight;
+    int factor;             // Downsample factor
+    int width;              // Size of the planes
+    int height;
+    float threshold;
+    float knee;
+    float intensity;
+    bool fixedPoint;        // Q15 planes (fixed-point path) rather than float
+};
+
+// Everything the blurred glow depends on on top of the bright planes.
+struct BlurKey {
+    BrightKey bright;
+    int method;             // Box, Gaussian or Pyramid
+    int boxPasses;          // BlurSetup::boxPasses
+    float resample;         // BlurSetup::resample
+    int radiusH;            // Downsampled radii after PAR/field adjustment
+    int radiusV;
+};
+
+// Planes and their tile occupancy, plus the pooled buffer that holds both.
+// Exactly one of `image` and `imageQ15` is set, as BrightKey::fixedPoint says.
+struct Entry {
+    LiteGlowMem::ScratchBuffer storage;
+    LiteGlowBlur::PlanarRGBF image;
+    LiteGlowBlur::PlanarRGB16 imageQ15;
+    LiteGlowBlur::TileMap tiles;
+};
+
+typedef std::shared_ptr<const Entry> EntryRef;
+
+// Takes ownership of `storage`. Returns null (and frees it) on allocation failure.
+EntryRef MakeEntry(LiteGlowMem::ScratchBuffer&& storage, const LiteGlowBlur::PlanarRGBF& image,
+                   const LiteGlowBlur::TileMap& tiles) noexcept;
+EntryRef MakeEntry(LiteGlowMem::ScratchBuffer&& storage, const LiteGlowBlur::PlanarRGB16& image,
+                   const LiteGlowBlur::TileMap& tiles) noexcept;
+
+EntryRef FindBright(const BrightKey& key) noexcept;
+EntryRef FindBlur(const BlurKey& key) noexcept;
+
+// Stores `entry` (replacing an entry with the same key) and evicts down to
+// the limit. Entries larger than the limit are not kept.
+void StoreBright(const BrightKey& key, const EntryRef& entry) noexcept;
+void StoreBlur(const BlurKey& key, const EntryRef& entry) noexcept;
+
+// Drops every entry (readers keep theirs alive until they let go).
+void Clear() noexcept;
+
+void SetLimit(std::size_t bytes) noexcept;
+
+// Content hash for BrightKey::content: hash each run of bytes with
+// HashBytes, then fold the results in a fixed order with HashCombine.
+std::uint64_t HashBytes(const void* data, std::size_t bytes, std::uint64_t seed) noexcept;
+
+inline std::uint64_t HashCombine(std::uint64_t h, std::uint64_t v) noexcept {
+    h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+} // namespace LiteGlowCache
+
+#endif // LITEGLOW_GLOWCACHE_H
@@ -0,0 +1,246 @@
+/*	LiteGlow_Governor.cpp
+
+	Per-instance cost models and plan choice of Auto Quality renders.
+	See LiteGlow_Governor.h for the model.
+
+*/
+
+#include "LiteGlow_Governor.h"
+#include "LiteGlow_Scheduler.h"
+#include "LiteGlow_Trace.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace LiteGlowGovernor {
+
+namespace {
+
+using LiteGlowCore::BlurSetup;
+using LiteGlowCore::StageTimes;
+
+// Work the model prices separately
+enum CostKind {
+    COST_BRIGHT,     // Hash and bright pass, per sampled input pixel (every input pixel for HLSL)
+    COST_BOX,        // One box pass, per downsampled pixel
+    COST_GAUSSIAN,   // One recursive Gaussian pass, per downsampled pixel
+    COST_HLSL,       // One 9-tap HLSL pass, per downsampled pixel
+    COST_STREAM,     // A whole streamed render, per input pixel
+    COST_BLEND,      // Per output pixel
+    COST_KINDS
+};
+
+// Nanoseconds per unit on one thread before anything is measured
+constexpr double SEED_NS[COST_KINDS] = { 3.0, 3.0, 8.0, 6.0, 25.0, 4.0 };
+constexpr double SEED_OVERHEAD_MS = 0.2;
+constexpr double LEARNING_RATE = 0.3;  // Weight of the newest measurement
+constexpr int RADIUS_BUCKETS = 6;      // Radius octaves: <= 2, 4, 8, 16, 32, more
+
+// Box passes skip black tiles within their reach, and the HLSL taps spread
+// with the radius, so those cost more at larger radii
+constexpr bool ByRadius(const CostKind kind) noexcept {
+    return kind == COST_BOX || kind == COST_HLSL || kind == COST_STREAM;
+}
+
+int RadiusBucket(const int radius) noexcept {
+    int bucket = 0;
+    while (bucket < RADIUS_BUCKETS - 1 && radius > (2 << bucket)) ++bucket;
+    return bucket;
+}
+
+struct Cell {
+    double ns;
+    bool seen;
+};
+
+struct Model {
+    Cell cost[COST_KINDS][RADIUS_BUCKETS] = {};
+    double speed = 1.0;              // Measured cost over the seed, over every measurement
+    double overheadMs = SEED_OVERHEAD_MS;
+    int lastPlan = -1;
+    std::uint64_t lastUse = 0;
+};
+
+std::mutex gMutex;  // Guards gModels and gUses
+std::unordered_map<std::uint64_t, Model> gModels;
+std::uint64_t gUses = 0;
+
+// Seeds are per thread; a render runs on the workers and the caller
+double SeedNs(const CostKind kind) noexcept {
+    return SEED_NS[kind] / (double)(LiteGlowSched::WorkerCount() + 1);
+}
+
+// Nanoseconds per unit of `kind` at `radius`: measured, else the nearest
+// measured radius octave, else the seed at the measured speed.
+double CostNs(const Model& model, const CostKind kind, const int radius) noexcept {
+    const int bucket = ByRadius(kind) ? RadiusBucket(radius) : 0;
+    for (int d = 0; d < RADIUS_BUCKETS; ++d) {
+        if (bucket - d >= 0 && model.cost[kind][bucket - d].seen) return model.cost[kind][bucket - d].ns;
+        if (bucket + d < RADIUS_BUCKETS && model.cost[kind][bucket + d].seen) return model.cost[kind][bucket + d].ns;
+        if (!ByRadius(kind)) break;
+    }
+    return SeedNs(kind) * model.speed;
+}
+
+void Learn(Model& model, const CostKind kind, const int radius, const double ms, const double units) noexcept {
+    if (ms <= 0.0 || units <= 0.0) return;
+    const double ns = ms * 1e6 / units;
+    Cell& cell = model.cost[kind][ByRadius(kind) ? RadiusBucket(radius) : 0];
+    cell.ns = cell.seen ? cell.ns + LEARNING_RATE * (ns - cell.ns) : ns;
+    cell.seen = true;
+    model.speed += LEARNING_RATE * (ns / SeedNs(kind) - model.speed);
+}
+
+// The units of work of a render of `blur`, as the model prices them.
+struct Work {
+    bool streamed;
+    CostKind blurKind;
+    int blurPasses;
+    int radius;
+    double brightUnits;
+    double passUnits;
+    double streamUnits;
+    double blendUnits;
+};
+
+Work GetWork(const BlurSetup& blur, const LiteGlowCore::ImageView& input,
+             const LiteGlowCore::ImageView& output) noexcept {
+    const int dsW = std::max(1, input.width / blur.factor);
+    const int dsH = std::max(1, input.height / blur.factor);
+    Work work;
+    work.streamed = LiteGlowCore::StreamsRender(blur, input.format, input.width, input.height);
+    work.blurKind = blur.hlslIterations > 0 ? COST_HLSL : blur.gaussian ? COST_GAUSSIAN : COST_BOX;
+    work.blurPasses = blur.hlslIterations > 0 ? 2 * blur.hlslIterations : blur.gaussian ? 2 : 2 * blur.boxPasses;
+    work.radius = std::max(blur.radiusH, blur.radiusV);
+    // The CPU bright pass samples every factor-th row; the HLSL one averages every pixel
+    work.brightUnits = blur.hlslIterations > 0 ? (double)input.width * input.height : (double)input.width * dsH;
+    work.passUnits = (double)dsW * dsH;
+    work.streamUnits = (double)input.width * input.height;
+    work.blendUnits = (double)output.width * output.height;
+    return work;
+}
+
+double PredictMs(const Model& model, const Work& work) noexcept {
+    double ns;
+    if (work.streamed) {
+        ns = CostNs(model, COST_STREAM, work.radius) * work.streamUnits;
+    } else {
+        ns = CostNs(model, COST_BRIGHT, work.radius) * work.brightUnits +
+             CostNs(model, work.blurKind, work.radius) * work.blurPasses * work.passUnits +
+             CostNs(model, COST_BLEND, work.radius) * work.blendUnits;
+    }
+    return ns * 1e-6 + model.overheadMs;
+}
+
+// Moves the model towards what one render of `work` took. Renders that
+// found nothing to blend (copies) say nothing about the plan.
+void LearnRender(Model& model, const Work& work, const StageTimes& t) noexcept {
+    using namespace LiteGlowCore;
+    if (t.ms[STAGE_BLEND] <= 0.0 && t.ms[STAGE_STREAM] <= 0.0) return;
+    double stagesMs = 0.0;
+    for (int stage = 0; stage < STAGES; ++stage) stagesMs += t.ms[stage];
+    if (work.streamed) {
+        Learn(model, COST_STREAM, work.radius, t.ms[STAGE_STREAM], work.streamUnits);
+    } else {
+        // Bright and blur are zero when the glow cache had them
+        if (t.ms[STAGE_BRIGHT] > 0.0) {
+            Learn(model, COST_BRIGHT, work.radius, t.ms[STAGE_HASH] + t.ms[STAGE_BRIGHT], work.brightUnits);
+        }
+        const double blurMs = t.ms[STAGE_BLUR_1] + t.ms[STAGE_BLUR_2] + t.ms[STAGE_BLUR_3] + t.ms[STAGE_BLUR_4];
+        if (work.blurPasses > 0) Learn(model, work.blurKind, work.radius, blurMs / work.blurPasses, work.passUnits);
+        Learn(model, COST_BLEND, work.radius, t.ms[STAGE_BLEND], work.blendUnits);
+    }
+    const double overheadMs = std::max(0.0, t.total - stagesMs);
+    model.overheadMs += LEARNING_RATE * (overheadMs - model.overheadMs);
+}
+
+// The instance's model, created (evicting the least recently used beyond
+// GOVERNOR_MAX_INSTANCES) if needed; null if out of memory. Call locked.
+Model* FindModel(const std::uint64_t instance) noexcept {
+    try {
+        auto it = gModels.find(instance);
+        if (it == gModels.end()) {
+            if ((int)gModels.size() >= GOVERNOR_MAX_INSTANCES) {
+                gModels.erase(std::min_element(gModels.begin(), gModels.end(), [](const auto& a, const auto& b) {
+                    return a.second.lastUse < b.second.lastUse;
+                }));
+            }
+            it = gModels.emplace(instance, Model()).first;
+        }
+        it->second.lastUse = ++gUses;
+        return &it->second;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+LiteGlowCore::Status Render(const std::uint64_t instance, const double budgetMs, const LiteGlowCore::ImageView& input,
+                            const LiteGlowCore::ImageView& output, const int outputX, const int outputY,
+                            const LiteGlowCore::Settings& settings, Choice* choice,
+                            LiteGlowCore::StageTimes* times) noexcept
+{
+    const bool traced = LiteGlowTrace::Enabled();
+    const std::uint64_t traceBegin = traced ? LiteGlowTrace::Now() : 0;
+
+    // The first plan expected to fit, else the cheapest; with no model, the
+    // finest (what RenderGlow renders)
+    Choice chosen{ -1, LiteGlowCore::GetBlurSetup(settings), 0.0, 0.0 };
+    Work work = GetWork(chosen.blur, input, output);
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        if (const Model* model = FindModel(instance)) {
+            double cheapestMs = 0.0;
+            for (int plan = 0; plan < LiteGlowCore::AUTO_PLANS; ++plan) {
+                BlurSetup blur;
+                if (!LiteGlowCore::GetAutoPlan(settings, plan, blur)) continue;
+                const Work planWork = GetWork(blur, input, output);
+                const double ms = PredictMs(*model, planWork);
+                const double limit = plan < model->lastPlan ? budgetMs * GOVERNOR_UPGRADE_MARGIN : budgetMs;
+                if (ms <= limit || chosen.plan < 0 || ms < cheapestMs) {
+                    chosen = Choice{ plan, blur, ms, 0.0 };
+                    work = planWork;
+                    cheapestMs = ms;
+                }
+                if (ms <= limit) break;
+            }
+        }
+    }
+
+    LiteGlowCore::StageTimes localTimes;
+    LiteGlowCore::StageTimes& t = times ? *times : localTimes;
+    const LiteGlowCore::Status err =
+        LiteGlowCore::RenderGlowWithBlur(input, output, outputX, outputY, settings, chosen.blur, &t);
+    chosen.measuredMs = t.total;
+    if (!err && chosen.plan >= 0) {
+        std::lock_guard<std::mutex> lock(gMutex);
+        if (Model* model = FindModel(instance)) {
+            LearnRender(*model, work, t);
+            model->lastPlan = chosen.plan;
+        }
+    }
+
+    if (traced) {
+        const LiteGlowTrace::PlanArgs plan{ budgetMs, chosen.predictedMs, chosen.measuredMs, chosen.plan,
+                                            chosen.blur.factor, chosen.blur.radiusV,
+                                            chosen.blur.hlslIterations > 0 ? chosen.blur.hlslIterations
+                                                                           : chosen.blur.boxPasses };
+        LiteGlowTrace::RecordPlan("governor", traceBegin, LiteGlowTrace::Now(), plan);
+    }
+    if (choice) *choice = chosen;
+    return err;
+}
+
+void Forget(const std::uint64_t instance) noexcept {
+    std::lock_guard<std::mutex> lock(gMutex);
+    gModels.erase(instance);
+}
+
+void Clear() noexcept {
+    std::lock_guard<std::mutex> lock(gMutex);
+    gModels.clear();
+}
+
+} // namespace LiteGlowGovernor
@@ -0,0 +1,70 @@
+#pragma once
+
+#ifndef LITEGLOW_GOVERNOR_H
+#define LITEGLOW_GOVERNOR_H
+
+// =============================================================================
+// LiteGlow Frame-Time Governor
+// =============================================================================
+// Renders Auto Quality: every frame picks one of the Auto plans
+// (LiteGlowCore::GetAutoPlan, best looking first) so the CPU render stays
+// within a budget in milliseconds, the plugin's Budget parameter.
+//
+// Each effect instance keeps its own cost model, learned from its renders:
+// nanoseconds per unit of work for the bright pass (per sampled input
+// pixel), each blur pass (per downsampled pixel, by blur kind and by radius
+// octave), streamed renders and the blend (per output pixel), plus a fixed
+// overhead. Every render is timed (StageTimes) and moves the costs of the
+// stages it ran towards what they took. Costs not measured yet come from
+// built-in per-thread estimates scaled by how fast the measured ones turned
+// out, or from the nearest radius octave measured. Stages found in the glow
+// cache are not learned from.
+//
+// A frame takes the first plan predicted to fit the budget, or the cheapest
+// if none does. Moving to a finer plan than the instance's last one needs
+// GOVERNOR_UPGRADE_MARGIN of headroom, so a frame near the budget does not
+// flip between two plans. Governed renders run their stages one after
+// another, as timed renders do (LiteGlowCore::RenderGlow).
+//
+// Instances are told apart by a caller-chosen id (the plugin keeps one in
+// its sequence data); 0 is as good as any. Models are shared by the renders
+// of an instance on any thread; the least recently used are dropped beyond
+// GOVERNOR_MAX_INSTANCES. While tracing (LiteGlow_Trace.h), every governed
+// render records a "governor" span with the plan, budget, prediction and
+// measured time.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include "LiteGlow_Core.h"
+
+#include <cstdint>
+
+namespace LiteGlowGovernor {
+
+constexpr double GOVERNOR_UPGRADE_MARGIN = 0.85;  // A finer plan than the last must fit in this share of the budget
+constexpr int GOVERNOR_MAX_INSTANCES = 256;
+
+// What a governed render chose and took.
+struct Choice {
+    int plan;                        // LiteGlowCore::GetAutoPlan index
+    LiteGlowCore::BlurSetup blur;
+    double predictedMs;
+    double measuredMs;               // StageTimes::total of the render
+};
+
+// Renders as LiteGlowCore::RenderGlow does, with the Auto plan this
+// instance's model expects to fit `budgetMs`, then learns from the stage
+// times. The input apron and grid must suit every plan (GlowGridStep and the
+// largest BlurReach of the valid plans). `choice` and `times` may be null.
+LiteGlowCore::Status Render(std::uint64_t instance, double budgetMs, const LiteGlowCore::ImageView& input,
+                            const LiteGlowCore::ImageView& output, int outputX, int outputY,
+                            const LiteGlowCore::Settings& settings, Choice* choice = nullptr,
+                            LiteGlowCore::StageTimes* times = nullptr) noexcept;
+
+// Drops the model of one instance, or of all (GlobalSetdown).
+void Forget(std::uint64_t instance) noexcept;
+void Clear() noexcept;
+
+} // namespace LiteGlowGovernor
+
+#endif // LITEGLOW_GOVERNOR_H
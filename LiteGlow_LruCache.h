@@ -0,0 +1,167 @@
+#pragma once
+
+#ifndef LITEGLOW_LRUCACHE_H
+#define LITEGLOW_LRUCACHE_H
+
+// =============================================================================
+// LiteGlow LRU Cache
+// =============================================================================
+// A thread-safe map from keys to values that each hold some bytes (buffers
+// from the scratch pool), dropping the least recently used values while the
+// bytes stored pass a limit. The glow cache (LiteGlow_GlowCache.h) and the
+// temporal cache (LiteGlow_TemporalCache.h) are built on it.
+//
+// `Value` is a smart pointer: empty means "none", and destroying the last
+// one returns its buffers to the pool. Values leave the cache (evicted,
+// replaced, cleared or refused) only after its lock is released, so no
+// other render waits while they are freed.
+//
+// Entries are kept in a plain vector: each cache holds a few entries per
+// render in flight, few enough that a linear scan beats any index.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace LiteGlowLru {
+
+// `Same(a, b)` tells whether two keys name the same entry.
+template <typename Key, typename Value, typename Same>
+class LruCache {
+public:
+    explicit LruCache(const std::size_t limit) noexcept : mLimit(limit) {}
+
+    // The value stored under `key` (now the most recently used), or empty.
+    Value Find(const Key& key) noexcept {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Slot* slot = Lookup(key);
+        if (!slot) return Value();
+        slot->lastUse = ++mClock;
+        return slot->value;
+    }
+
+    // Removes and returns the value stored under `key`, or empty.
+    Value Take(const Key& key) noexcept {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Slot* slot = Lookup(key);
+        if (!slot) return Value();
+        Value value = std::move(slot->value);
+        Remove(slot);
+        return value;
+    }
+
+    // Stores `value` (`bytes` large) under `key`, replacing what was there,
+    // and evicts down to the limit. Values larger than the limit are not kept.
+    void Store(const Key& key, Value value, const std::size_t bytes) noexcept {
+        std::vector<Value> dropped;
+        Value replaced;
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!value || bytes > Limit()) return;
+        if (Slot* slot = Lookup(key)) {
+            replaced = std::move(slot->value);
+            mBytes -= slot->bytes;
+            slot->value = std::move(value);
+            slot->bytes = bytes;
+            slot->lastUse = ++mClock;
+        } else {
+            try {
+                mSlots.push_back(Slot{ key, std::move(value), bytes, ++mClock });
+            } catch (...) {
+                return;
+            }
+        }
+        mBytes += bytes;
+        EvictTo(Limit(), dropped);
+    }
+
+    // Drops every entry whose key satisfies `pred`.
+    template <typename Pred>
+    void RemoveIf(const Pred& pred) noexcept {
+        std::vector<Slot> dropped;
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (std::size_t i = 0; i < mSlots.size();) {
+            if (!pred(mSlots[i].key)) {
+                ++i;
+                continue;
+            }
+            try {
+                dropped.push_back(std::move(mSlots[i]));
+            } catch (...) {
+                // Released under the lock instead; still correct
+            }
+            Remove(&mSlots[i]);
+        }
+    }
+
+    void Clear() noexcept {
+        std::vector<Slot> dropped;
+        std::lock_guard<std::mutex> lock(mMutex);
+        dropped.swap(mSlots);
+        mBytes = 0;
+    }
+
+    void SetLimit(const std::size_t bytes) noexcept {
+        std::vector<Value> dropped;
+        std::lock_guard<std::mutex> lock(mMutex);
+        mLimit.store(bytes, std::memory_order_relaxed);
+        EvictTo(bytes, dropped);
+    }
+
+    // Readable without the lock, so callers can skip work that would not fit
+    std::size_t Limit() const noexcept { return mLimit.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        Key key;
+        Value value;
+        std::size_t bytes;
+        std::uint64_t lastUse;
+    };
+
+    // Caller holds mMutex.
+    Slot* Lookup(const Key& key) noexcept {
+        for (Slot& slot : mSlots) {
+            if (Same()(slot.key, key)) return &slot;
+        }
+        return nullptr;
+    }
+
+    // Caller holds mMutex. Swaps the last slot into `slot`'s place.
+    void Remove(Slot* slot) noexcept {
+        mBytes -= slot->bytes;
+        if (slot != &mSlots.back()) *slot = std::move(mSlots.back());
+        mSlots.pop_back();
+    }
+
+    // Caller holds mMutex. Moves the victims into `dropped` when it can, so
+    // they are freed after the lock is released.
+    void EvictTo(const std::size_t limit, std::vector<Value>& dropped) noexcept {
+        while (mBytes > limit && !mSlots.empty()) {
+            Slot* oldest = &mSlots[0];
+            for (Slot& slot : mSlots) {
+                if (slot.lastUse < oldest->lastUse) oldest = &slot;
+            }
+            try {
+                dropped.push_back(std::move(oldest->value));
+            } catch (...) {
+                // Released under the lock instead; still correct
+            }
+            Remove(oldest);
+        }
+    }
+
+    std::mutex mMutex;
+    std::vector<Slot> mSlots;
+    std::size_t mBytes = 0;
+    std::atomic<std::size_t> mLimit;
+    std::uint64_t mClock = 0;
+};
+
+} // namespace LiteGlowLru
+
+#endif // LITEGLOW_LRUCACHE_H
@@ -0,0 +1,71 @@
+#pragma once
+
+#ifndef LITEGLOW_PARAMS_H
+#define LITEGLOW_PARAMS_H
+
+// =============================================================================
+// LiteGlow Parameter Ranges
+// =============================================================================
+// Ranges, defaults and popup values of the effect parameters, shared by the
+// plugin (LiteGlow.h) and the host-independent core (LiteGlow_Core.h).
+// No After Effects SDK dependency.
+
+#define STRENGTH_MIN       0
+#define STRENGTH_MAX       2000
+#define STRENGTH_DFLT      800
+
+// Radius: typed values reach RADIUS_MAX, for glows a few hundred pixels wide
+// on 4K plates; Pyramid and Gaussian blur them at the cost of radius 10. The
+// box passes (Low/Medium/High, the GPU) clamp at about 24 grid pixels: radius
+// ~24 on High's full-resolution grid, ~96 on Low's 4x one. Up to
+// RADIUS_SLIDER_MAX they keep that clamp; typed radii past the slider that
+// it would cut render through the Pyramid on the CPU and the Adaptive grid
+// on the GPU (up to radius ~256), so every Quality widens with them.
+#define RADIUS_MIN         1
+#define RADIUS_MAX         500
+#define RADIUS_SLIDER_MAX  50
+#define RADIUS_DFLT        10
+
+#define THRESHOLD_MIN      0
+#define THRESHOLD_MAX      255
+#define THRESHOLD_DFLT     80
+
+// Quality settings
+#define QUALITY_LOW        1
+#define QUALITY_MEDIUM     2
+#define QUALITY_HIGH       3
+#define QUALITY_PYRAMID    4  // Multi-scale bloom (CPU); GPU renders it like High
+#define QUALITY_ADAPTIVE   5  // Glow grid chosen from the radius (fractional steps on the CPU)
+#define QUALITY_AUTO       6  // Grid and blur chosen per frame to fit the Budget (CPU); GPU renders it like Adaptive
+#define QUALITY_NUM_CHOICES 6
+#define QUALITY_DFLT       QUALITY_MEDIUM
+
+// Blend mode settings
+#define BLEND_MODE_SCREEN    1
+#define BLEND_MODE_ADD       2
+#define BLEND_MODE_NORMAL    3
+#define BLEND_MODE_NUM_CHOICES 3
+#define BLEND_MODE_DFLT      BLEND_MODE_SCREEN
+
+// Blur mode settings (CPU path; the GPU path always uses its shader blur)
+#define BLUR_MODE_BOX         1
+#define BLUR_MODE_GAUSSIAN    2
+#define BLUR_MODE_NUM_CHOICES 2
+#define BLUR_MODE_DFLT        BLUR_MODE_BOX
+
+// Bloom intensity settings
+#define BLOOM_INTENSITY_MIN   0
+#define BLOOM_INTENSITY_MAX   400
+#define BLOOM_INTENSITY_DFLT  150  // Represents 1.5x when divided by 100
+
+// Threshold softness (knee) settings
+#define KNEE_MIN   0
+#define KNEE_MAX   100
+#define KNEE_DFLT  10  // Represents 0.1 when divided by 100
+
+// Frame-time budget of Quality Auto, in milliseconds per CPU render
+#define BUDGET_MIN   1
+#define BUDGET_MAX   1000
+#define BUDGET_DFLT  30
+
+#endif // LITEGLOW_PARAMS_H
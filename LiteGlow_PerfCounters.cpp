@@ -0,0 +1,154 @@
+/*	LiteGlow_PerfCounters.cpp
+
+	Per-thread perf event groups (Linux) and their per-stage sums.
+	See LiteGlow_PerfCounters.h for the model.
+
+*/
+
+#include "LiteGlow_PerfCounters.h"
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <cstring>
+#endif
+
+namespace LiteGlowPerf {
+
+namespace {
+
+#if defined(__linux__)
+
+// One group per thread, led by the CPU clock so the hardware counters that
+// open join it and are read in one call.
+struct ThreadCounters {
+    bool opened = false;
+    int leader = -1;
+    int fds[COUNTERS] = { -1, -1, -1, -1, -1 };
+    int slot[COUNTERS] = {};    // Position in the group read
+    int members = 0;
+    unsigned available = 0;
+
+    ~ThreadCounters() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+};
+
+thread_local ThreadCounters tCounters;
+
+int OpenCounter(Counter counter, int group) noexcept {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    switch (counter) {
+    case COUNTER_CPU_NS:
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_TASK_CLOCK;
+        break;
+    case COUNTER_CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case COUNTER_INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case COUNTER_L1D_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    default:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    }
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+ThreadCounters& OpenThread() noexcept {
+    ThreadCounters& t = tCounters;
+    if (t.opened) return t;
+    t.opened = true;
+    for (int c = 0; c < COUNTERS; ++c) {
+        const int fd = OpenCounter((Counter)c, t.leader);
+        if (fd < 0) continue;
+        if (t.leader < 0) t.leader = fd;
+        t.fds[c] = fd;
+        t.slot[c] = t.members++;
+        t.available |= 1u << c;
+    }
+    return t;
+}
+
+#endif
+
+} // namespace
+
+Counts Delta(const Counts& before, const Counts& after) noexcept {
+    Counts d = {};
+    d.available = before.available & after.available;
+    for (int c = 0; c < COUNTERS; ++c) {
+        if (d.available & (1u << c)) d.value[c] = after.value[c] - before.value[c];
+    }
+    return d;
+}
+
+bool Read(Counts& counts) noexcept {
+    counts = Counts{};
+#if defined(__linux__)
+    ThreadCounters& t = OpenThread();
+    if (t.leader < 0) return false;
+    // { nr, time_enabled, time_running, value[nr] }
+    std::uint64_t data[3 + COUNTERS];
+    const ssize_t bytes = read(t.leader, data, sizeof(data));
+    if (bytes < (ssize_t)(3 * sizeof(std::uint64_t)) || data[0] != (std::uint64_t)t.members) return false;
+    const double scale = data[2] ? (double)data[1] / (double)data[2] : 1.0;
+    for (int c = 0; c < COUNTERS; ++c) {
+        if (t.available & (1u << c)) counts.value[c] = (std::uint64_t)((double)data[3 + t.slot[c]] * scale);
+    }
+    counts.available = t.available;
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned Available() noexcept {
+#if defined(__linux__)
+    return OpenThread().available;
+#else
+    return 0;
+#endif
+}
+
+const char* CounterName(const Counter counter) noexcept {
+    static const char* const names[COUNTERS] = { "cpu_ns", "cycles", "instructions", "l1d_misses", "llc_misses" };
+    return counter >= 0 && counter < COUNTERS ? names[counter] : "";
+}
+
+StageCounter::StageCounter() noexcept : mAvailable(~0u) {
+    for (std::atomic<std::uint64_t>& sum : mSum) sum.store(0, std::memory_order_relaxed);
+}
+
+void StageCounter::Add(const Counts& delta) noexcept {
+    for (int c = 0; c < COUNTERS; ++c) mSum[c].fetch_add(delta.value[c], std::memory_order_relaxed);
+    mAvailable.fetch_and(delta.available, std::memory_order_relaxed);
+}
+
+Counts StageCounter::Total() const noexcept {
+    Counts total = {};
+    for (int c = 0; c < COUNTERS; ++c) total.value[c] = mSum[c].load(std::memory_order_relaxed);
+    // Nothing added: nothing known
+    const unsigned available = mAvailable.load(std::memory_order_relaxed);
+    total.available = available == ~0u ? 0 : available;
+    return total;
+}
+
+} // namespace LiteGlowPerf
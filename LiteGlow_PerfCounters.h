@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef LITEGLOW_PERFCOUNTERS_H
+#define LITEGLOW_PERFCOUNTERS_H
+
+// =============================================================================
+// LiteGlow Perf Counters
+// =============================================================================
+// Per-thread hardware counters for profiling the CPU stages: Linux perf
+// events (perf_event_open) counting user-space cycles, instructions, L1D read
+// misses and last-level cache misses, plus the thread's CPU time. Elsewhere,
+// or when the kernel refuses (perf_event_paranoid, VMs without a PMU),
+// counters read as unavailable and every count stays zero.
+//
+// A thread opens its counters on its first Read and keeps them until it
+// exits. A StageCounter sums the counts of every thread that runs part of a
+// stage: each task reads its thread's counters around the work it does
+// (CountCall), so idle workers count nothing.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include <atomic>
+#include <cstdint>
+
+namespace LiteGlowPerf {
+
+enum Counter {
+    COUNTER_CPU_NS,         // Thread CPU time (software event, the group leader)
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_L1D_MISSES,     // L1D read misses
+    COUNTER_LLC_MISSES,     // Last-level cache misses (DRAM traffic, in lines)
+    COUNTERS
+};
+
+constexpr int CACHE_LINE_BYTES = 64;
+
+struct Counts {
+    std::uint64_t value[COUNTERS];
+    unsigned available;     // Bit per Counter that could be read
+};
+
+// Counts from `before` to `after` of the same thread.
+Counts Delta(const Counts& before, const Counts& after) noexcept;
+
+// Reads the calling thread's counters, opening them on first use. Returns
+// false if none is available. Counts are scaled up when the kernel
+// multiplexed them.
+bool Read(Counts& counts) noexcept;
+
+// Bit mask of the counters the calling thread can read (opens them).
+unsigned Available() noexcept;
+
+// "cpu_ns", "cycles", "instructions", "l1d_misses", "llc_misses".
+const char* CounterName(Counter counter) noexcept;
+
+// Sums the counts of every thread that runs part of one stage.
+class StageCounter {
+public:
+    StageCounter() noexcept;
+
+    void Add(const Counts& delta) noexcept;
+    Counts Total() const noexcept;
+
+private:
+    std::atomic<std::uint64_t> mSum[COUNTERS];
+    std::atomic<unsigned> mAvailable;
+};
+
+// Runs fn() and adds the calling thread's counts over it to `counter`.
+template <typename Fn>
+inline void CountCall(StageCounter& counter, Fn&& fn) noexcept {
+    Counts before, after;
+    const bool counted = Read(before);
+    fn();
+    if (counted && Read(after)) counter.Add(Delta(before, after));
+}
+
+} // namespace LiteGlowPerf
+
+#endif // LITEGLOW_PERFCOUNTERS_H
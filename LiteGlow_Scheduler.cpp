@@ -0,0 +1,354 @@
+/*	LiteGlow_Scheduler.cpp
+
+	Persistent work-stealing pool behind LiteGlowSched::TaskGraph.
+	See LiteGlow_Scheduler.h for the model.
+
+*/
+
+#include "LiteGlow_Scheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace LiteGlowSched {
+
+// Upper bound on pool threads, whatever the machine reports.
+constexpr int MAX_WORKERS = 64;
+
+namespace {
+
+struct Task {
+    TaskGraph* graph;
+    TaskGraph::NodeId node;
+    int item;
+};
+
+// The owning worker pushes and pops at the back (the most recently readied
+// item, whose inputs are still warm in its cache); thieves take from the front.
+class WorkerDeque {
+public:
+    bool Push(const Task& task) noexcept {
+        std::lock_guard<std::mutex> lock(mMutex);
+        try {
+            mTasks.push_back(task);
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    bool PopBack(Task& out) noexcept {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mTasks.empty()) return false;
+        out = mTasks.back();
+        mTasks.pop_back();
+        return true;
+    }
+
+    bool StealFront(Task& out) noexcept {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mTasks.empty()) return false;
+        out = mTasks.front();
+        mTasks.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mMutex;
+    std::deque<Task> mTasks;
+};
+
+// Index of the current thread's deque, or -1 for threads outside the pool
+// (the host's render threads calling TaskGraph::Run).
+thread_local int tWorkerIndex = -1;
+
+} // namespace
+
+class Pool {
+public:
+    // Intentionally never destroyed: joining threads from a static destructor
+    // during module unload can deadlock. GlobalSetdown calls Shutdown() instead.
+    // Returns nullptr only if the pool object itself could not be allocated.
+    static Pool* Instance() noexcept {
+        static Pool* pool = new (std::nothrow) Pool;
+        return pool;
+    }
+
+    // Spawns the workers on first use. Returns false if not even the deques
+    // could be allocated; fewer threads than requested is not an error.
+    bool EnsureStarted() noexcept {
+        if (mStarted.load(std::memory_order_acquire)) return true;
+        std::lock_guard<std::mutex> lock(mStartMutex);
+        if (mStarted.load(std::memory_order_relaxed)) return true;
+
+        const unsigned hardware = std::thread::hardware_concurrency();
+        const int wanted = std::clamp((int)hardware - 1, 0, MAX_WORKERS);
+        try {
+            mDeques.clear();
+            for (int i = 0; i < std::max(1, wanted); ++i) {
+                mDeques.push_back(std::make_unique<WorkerDeque>());
+            }
+        } catch (...) {
+            mDeques.clear();
+            return false;
+        }
+
+        mStopping.store(false);
+        for (int i = 0; i < wanted; ++i) {
+            try {
+                mThreads.emplace_back([this, i] { WorkerMain(i); });
+            } catch (...) {
+                break;  // Run with the threads we have; callers always help
+            }
+        }
+        mStarted.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void Shutdown() noexcept {
+        std::lock_guard<std::mutex> lock(mStartMutex);
+        if (!mStarted.load()) return;
+        {
+            std::lock_guard<std::mutex> sleepLock(mSleepMutex);
+            mStopping.store(true);
+        }
+        mWake.notify_all();
+        for (std::thread& t : mThreads) {
+            if (t.joinable()) t.join();
+        }
+        mThreads.clear();
+        mDeques.clear();
+        mStarted.store(false, std::memory_order_release);
+    }
+
+    int Workers() noexcept {
+        std::lock_guard<std::mutex> lock(mStartMutex);
+        return (int)mThreads.size();
+    }
+
+    // Queues a ready item. If the deque cannot grow, the item runs right here
+    // so the graph still completes. Returns true if the item was queued.
+    bool Push(const Task& task) noexcept {
+        const int count = (int)mDeques.size();
+        const int index = tWorkerIndex >= 0
+            ? tWorkerIndex
+            : (int)(mNextDeque.fetch_add(1, std::memory_order_relaxed) % (unsigned)count);
+        if (mDeques[index]->Push(task)) {
+            mQueued.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+        task.graph->Execute(task.node, task.item);
+        return false;
+    }
+
+    // Wakes sleepers after `pushed` items were queued. A worker that queued a
+    // single item onto its own deque runs it next, so nobody needs waking.
+    void Wake(const int pushed) noexcept {
+        if (pushed <= 0) return;
+        if (pushed == 1 && tWorkerIndex >= 0) return;
+        { std::lock_guard<std::mutex> lock(mSleepMutex); }
+        if (pushed - (tWorkerIndex >= 0 ? 1 : 0) == 1) {
+            mWake.notify_one();
+        } else {
+            mWake.notify_all();
+        }
+    }
+
+    void NotifyFinished() noexcept {
+        { std::lock_guard<std::mutex> lock(mSleepMutex); }
+        mWake.notify_all();
+    }
+
+    // Executes queued items (of any graph) until `graph` has finished.
+    void Help(const TaskGraph& graph) noexcept {
+        while (!graph.Finished()) {
+            Task task;
+            if (TryTake(task)) {
+                task.graph->Execute(task.node, task.item);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mWake.wait(lock, [&] {
+                return graph.Finished() || mQueued.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+
+private:
+    // Own deque first (newest item), then the other deques oldest-first.
+    bool TryTake(Task& out) noexcept {
+        const int count = (int)mDeques.size();
+        const int self = tWorkerIndex;
+        bool found = self >= 0 && mDeques[self]->PopBack(out);
+        for (int k = 1; !found && k <= count; ++k) {
+            const int victim = ((self >= 0 ? self : 0) + k) % count;
+            found = mDeques[victim]->StealFront(out);
+        }
+        if (found) mQueued.fetch_sub(1, std::memory_order_acq_rel);
+        return found;
+    }
+
+    void WorkerMain(const int index) noexcept {
+        tWorkerIndex = index;
+        for (;;) {
+            Task task;
+            if (TryTake(task)) {
+                task.graph->Execute(task.node, task.item);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mWake.wait(lock, [&] {
+                return mStopping.load() || mQueued.load(std::memory_order_acquire) > 0;
+            });
+            if (mStopping.load() && mQueued.load(std::memory_order_acquire) == 0) break;
+        }
+        tWorkerIndex = -1;
+    }
+
+    std::mutex mStartMutex;
+    std::atomic<bool> mStarted{ false };
+    std::vector<std::unique_ptr<WorkerDeque>> mDeques;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mSleepMutex;
+    std::condition_variable mWake;
+    std::atomic<int> mQueued{ 0 };
+    std::atomic<bool> mStopping{ false };
+    std::atomic<unsigned> mNextDeque{ 0 };
+};
+
+// =============================================================================
+// TaskGraph
+// =============================================================================
+
+TaskGraph::NodeId TaskGraph::AddNode(int itemCount, TaskFn fn) noexcept {
+    if (!mValid) return -1;
+    itemCount = std::max(0, itemCount);
+    try {
+        std::unique_ptr<Node> node(new Node);
+        node->fn = fn;
+        node->itemCount = itemCount;
+        node->allPredecessors = 0;
+        node->perItemPredecessors = 0;
+        node->pending.reset(new std::atomic<int>[(size_t)std::max(1, itemCount)]);
+        mNodes.push_back(std::move(node));
+    } catch (...) {
+        mValid = false;
+        return -1;
+    }
+    return (NodeId)mNodes.size() - 1;
+}
+
+bool TaskGraph::AddEdge(NodeId from, NodeId to, Dependency kind) noexcept {
+    const NodeId count = (NodeId)mNodes.size();
+    if (!mValid || from < 0 || to <= from || to >= count ||
+        (kind == Dependency::PER_ITEM && mNodes[from]->itemCount != mNodes[to]->itemCount)) {
+        mValid = false;
+        return false;
+    }
+    try {
+        mNodes[from]->successors.push_back(Edge{ to, kind });
+    } catch (...) {
+        mValid = false;
+        return false;
+    }
+    if (kind == Dependency::ALL) {
+        ++mNodes[to]->allPredecessors;
+    } else {
+        ++mNodes[to]->perItemPredecessors;
+    }
+    return true;
+}
+
+bool TaskGraph::Run() noexcept {
+    if (!mValid) return false;
+    Pool* pool = Pool::Instance();
+    if (!pool || !pool->EnsureStarted()) return false;
+
+    int total = 0;
+    for (const std::unique_ptr<Node>& node : mNodes) {
+        const int deps = node->allPredecessors + node->perItemPredecessors;
+        for (int i = 0; i < node->itemCount; ++i) {
+            node->pending[i].store(deps, std::memory_order_relaxed);
+        }
+        node->remaining.store(node->itemCount, std::memory_order_relaxed);
+        total += node->itemCount;
+    }
+    mItemsLeft.store(total, std::memory_order_release);
+    if (total == 0) return true;
+
+    // Empty stages are complete from the start.
+    int pushed = 0;
+    for (const std::unique_ptr<Node>& node : mNodes) {
+        if (node->itemCount == 0) pushed += ReleaseAllSuccessors(*node);
+    }
+    for (NodeId id = 0; id < (NodeId)mNodes.size(); ++id) {
+        const Node& node = *mNodes[id];
+        if (node.allPredecessors + node.perItemPredecessors > 0) continue;
+        for (int i = 0; i < node.itemCount; ++i) {
+            pushed += pool->Push(Task{ this, id, i }) ? 1 : 0;
+        }
+    }
+    pool->Wake(pushed);
+    pool->Help(*this);
+    return true;
+}
+
+void TaskGraph::Execute(NodeId id, int item) noexcept {
+    Node& node = *mNodes[id];
+    node.fn.invoke(node.fn.context, item);
+
+    // Run() succeeded, so the pool exists.
+    Pool& pool = *Pool::Instance();
+    int pushed = 0;
+    for (const Edge& edge : node.successors) {
+        if (edge.kind != Dependency::PER_ITEM) continue;
+        if (mNodes[edge.to]->pending[item].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pushed += pool.Push(Task{ this, edge.to, item }) ? 1 : 0;
+        }
+    }
+    if (node.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pushed += ReleaseAllSuccessors(node);
+    }
+    pool.Wake(pushed);
+
+    // Last access to the graph: once this reaches zero, Run() may return.
+    if (mItemsLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pool.NotifyFinished();
+    }
+}
+
+int TaskGraph::ReleaseAllSuccessors(const Node& node) noexcept {
+    Pool& pool = *Pool::Instance();
+    int pushed = 0;
+    for (const Edge& edge : node.successors) {
+        if (edge.kind != Dependency::ALL) continue;
+        const NodeId to = edge.to;
+        for (int i = 0; i < mNodes[to]->itemCount; ++i) {
+            if (mNodes[to]->pending[i].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pushed += pool.Push(Task{ this, to, i }) ? 1 : 0;
+            }
+        }
+    }
+    return pushed;
+}
+
+// =============================================================================
+// Pool control
+// =============================================================================
+
+int WorkerCount() noexcept {
+    Pool* pool = Pool::Instance();
+    return pool ? pool->Workers() : 0;
+}
+
+void ShutdownPool() noexcept {
+    Pool* pool = Pool::Instance();
+    if (pool) pool->Shutdown();
+}
+
+} // namespace LiteGlowSched
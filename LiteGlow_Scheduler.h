@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef LITEGLOW_SCHEDULER_H
+#define LITEGLOW_SCHEDULER_H
+
+// =============================================================================
+// LiteGlow Task Scheduler
+// =============================================================================
+// Persistent worker pool for the CPU render path. Work is submitted as a
+// TaskGraph: every node is a stage split into items (a band of rows, a strip
+// of columns, ...), and edges say whether a stage waits for the whole
+// previous stage or only for the matching item. Ready items go onto
+// per-worker deques; an idle worker steals from the others, and the thread
+// that calls Run() executes items too instead of just blocking.
+//
+// No After Effects SDK dependency. Nothing here throws: failures (thread or
+// memory allocation) are reported through return values.
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace LiteGlowSched {
+
+class Pool;
+
+// Type-erased per-item callable: invoke(context, item).
+struct TaskFn {
+    void* context;
+    void (*invoke)(void* context, int item);
+};
+
+// Wraps a callable taking one int. `fn` must outlive the graph run.
+template <typename Fn>
+inline TaskFn MakeTaskFn(Fn& fn) noexcept {
+    return TaskFn{ &fn, [](void* context, int item) { (*static_cast<Fn*>(context))(item); } };
+}
+
+enum class Dependency {
+    ALL,       // Every item of the successor waits for the whole predecessor
+    PER_ITEM   // Item i of the successor waits for item i of the predecessor only
+};
+
+class TaskGraph {
+public:
+    typedef int NodeId;
+
+    // Adds a stage of `itemCount` items. Returns -1 on allocation failure.
+    NodeId AddNode(int itemCount, TaskFn fn) noexcept;
+
+    template <typename Fn>
+    NodeId AddNode(int itemCount, Fn& fn) noexcept { return AddNode(itemCount, MakeTaskFn(fn)); }
+
+    // `from` must have been added before `to`. PER_ITEM needs equal item counts.
+    // Returns false (and marks the graph invalid) otherwise.
+    bool AddEdge(NodeId from, NodeId to, Dependency kind) noexcept;
+
+    // Runs every item once, respecting the edges, and returns when all are done.
+    // Returns false if the graph is invalid or could not be scheduled; in that
+    // case no item has run.
+    bool Run() noexcept;
+
+    bool Finished() const noexcept { return mItemsLeft.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class Pool;
+
+    struct Edge {
+        NodeId to;
+        Dependency kind;
+    };
+
+    struct Node {
+        TaskFn fn;
+        int itemCount;
+        int allPredecessors;      // Incoming ALL edges
+        int perItemPredecessors;  // Incoming PER_ITEM edges
+        std::vector<Edge> successors;
+        std::unique_ptr<std::atomic<int>[]> pending;  // Unfinished dependencies per item
+        std::atomic<int> remaining;                   // Items of this node not yet done
+    };
+
+    // Runs item `item` of `node`, then releases the items that depended on it.
+    void Execute(NodeId node, int item) noexcept;
+    int ReleaseAllSuccessors(const Node& node) noexcept;
+
+    std::vector<std::unique_ptr<Node>> mNodes;
+    std::atomic<int> mItemsLeft{ 0 };
+    bool mValid = true;
+};
+
+// Runs fn(i) for every i in [0, count) on the pool and waits for completion.
+template <typename Fn>
+inline bool ParallelFor(int count, Fn& fn) noexcept {
+    if (count <= 0) return true;
+    TaskGraph graph;
+    if (graph.AddNode(count, fn) < 0) return false;
+    return graph.Run();
+}
+
+// Number of pool threads (the calling thread works in addition to these).
+int WorkerCount() noexcept;
+
+// Stops and joins the pool threads. Call when no graph is running (GlobalSetdown);
+// the pool starts again on the next Run().
+void ShutdownPool() noexcept;
+
+} // namespace LiteGlowSched
+
+#endif // LITEGLOW_SCHEDULER_H
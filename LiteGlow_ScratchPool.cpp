@@ -0,0 +1,304 @@
+/*	LiteGlow_ScratchPool.cpp
+
+	Size-class cache of aligned scratch buffers.
+	See LiteGlow_ScratchPool.h for the model.
+
+*/
+
+#include "LiteGlow_ScratchPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX  // Keep std::min/std::max usable
+    #endif
+    #include <Windows.h>
+    #include <malloc.h>
+#elif defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace LiteGlowMem {
+
+constexpr std::size_t HUGE_PAGE_BYTES = (std::size_t)2 * 1024 * 1024;
+
+struct ScratchBlock {
+    void* data;
+    std::size_t size;  // Class size
+    bool hugePages;
+};
+
+namespace {
+
+// Rounds up to the next class: SCRATCH_MIN_CLASS_BYTES, then 5/4, 6/4, 7/4
+// and 8/4 of every power of two above it.
+std::size_t ClassSize(const std::size_t bytes) noexcept {
+    if (bytes <= SCRATCH_MIN_CLASS_BYTES) return SCRATCH_MIN_CLASS_BYTES;
+    std::size_t octave = SCRATCH_MIN_CLASS_BYTES;
+    while (octave * 2 < bytes) octave *= 2;
+    const std::size_t step = octave / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+// Huge-page mappings cover whole pages; the class size stays the pool key.
+std::size_t HugePageRound(const std::size_t size) noexcept {
+    return (size + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+}
+
+void* SystemAlloc(const std::size_t size, const bool wantHugePages, bool& gotHugePages) noexcept {
+    gotHugePages = false;
+#if defined(_WIN32)
+    if (wantHugePages) {
+        const SIZE_T large = GetLargePageMinimum();
+        if (large != 0 && size % large == 0) {
+            // Needs SeLockMemoryPrivilege; fails cleanly without it.
+            void* p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p) {
+                gotHugePages = true;
+                return p;
+            }
+        }
+    }
+    return _aligned_malloc(size, SCRATCH_ALIGNMENT);
+#else
+  #if defined(__linux__)
+    if (wantHugePages && size % HUGE_PAGE_BYTES == 0) {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            // Transparent huge pages: advisory, the mapping is usable either way.
+            gotHugePages = madvise(p, size, MADV_HUGEPAGE) == 0;
+            if (gotHugePages) return p;
+            munmap(p, size);
+        }
+    }
+  #else
+    (void)wantHugePages;
+  #endif
+    void* p = nullptr;
+    return posix_memalign(&p, SCRATCH_ALIGNMENT, size) == 0 ? p : nullptr;
+#endif
+}
+
+void SystemFree(void* p, const std::size_t size, const bool hugePages) noexcept {
+#if defined(_WIN32)
+    (void)size;
+    if (hugePages) {
+        VirtualFree(p, 0, MEM_RELEASE);
+    } else {
+        _aligned_free(p);
+    }
+#else
+  #if defined(__linux__)
+    if (hugePages) {
+        munmap(p, size);
+        return;
+    }
+  #endif
+    (void)size;
+    (void)hugePages;
+    std::free(p);
+#endif
+}
+
+class Pool {
+public:
+    ScratchBlock* Acquire(const std::size_t bytes) noexcept {
+        const std::size_t size = ClassSize(bytes);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mFree.find(size);
+            if (it != mFree.end() && !it->second.empty()) {
+                ScratchBlock* block = it->second.back();
+                it->second.pop_back();
+                mStats.bytesCached -= size;
+                mStats.reuses++;
+                NoteAcquired(size);
+                return block;
+            }
+        }
+
+        // Allocate outside the lock; on failure drop the idle cache and retry once.
+        ScratchBlock* block = NewBlock(size);
+        if (!block) {
+            TrimTo(0);
+            block = NewBlock(size);
+        }
+        if (!block) return nullptr;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats.systemAllocs++;
+        if (block->hugePages) mStats.hugePageAllocs++;
+        NoteAcquired(size);
+        return block;
+    }
+
+    void Release(ScratchBlock* block) noexcept {
+        if (!block) return;
+        bool keep = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStats.bytesInUse -= block->size;
+            if (mStats.bytesCached + block->size <= mCacheLimit) {
+                try {
+                    mFree[block->size].push_back(block);
+                    mStats.bytesCached += block->size;
+                    keep = true;
+                } catch (...) {
+                    keep = false;
+                }
+            }
+            if (!keep) mStats.systemFrees++;
+        }
+        if (!keep) DeleteBlock(block);
+    }
+
+    void TrimTo(const std::size_t keepBytes) noexcept {
+        std::vector<ScratchBlock*> victims;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            // Largest classes first: they free the most for the fewest calls.
+            for (auto it = mFree.rbegin(); it != mFree.rend() && mStats.bytesCached > keepBytes; ++it) {
+                std::vector<ScratchBlock*>& list = it->second;
+                while (!list.empty() && mStats.bytesCached > keepBytes) {
+                    try {
+                        victims.push_back(list.back());
+                    } catch (...) {
+                        break;
+                    }
+                    mStats.bytesCached -= list.back()->size;
+                    mStats.systemFrees++;
+                    list.pop_back();
+                }
+            }
+        }
+        for (ScratchBlock* block : victims) DeleteBlock(block);
+    }
+
+    void SetCacheLimit(const std::size_t bytes) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCacheLimit = bytes;
+        }
+        TrimTo(bytes);
+    }
+
+    void SetHugePages(const bool enable) noexcept {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mHugePages = enable;
+    }
+
+    ScratchStats Stats() noexcept {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+private:
+    // Caller holds mMutex.
+    void NoteAcquired(const std::size_t size) noexcept {
+        mStats.acquires++;
+        mStats.bytesInUse += size;
+        mStats.peakBytesInUse = std::max(mStats.peakBytesInUse, mStats.bytesInUse);
+        mStats.peakBytesTotal = std::max(mStats.peakBytesTotal, mStats.bytesInUse + mStats.bytesCached);
+    }
+
+    ScratchBlock* NewBlock(const std::size_t size) noexcept {
+        bool wantHugePages;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            wantHugePages = mHugePages && size >= HUGE_PAGE_BYTES;
+        }
+        ScratchBlock* block = new (std::nothrow) ScratchBlock;
+        if (!block) return nullptr;
+        // SystemAlloc falls back to ordinary pages by itself.
+        bool gotHugePages = false;
+        block->data = SystemAlloc(wantHugePages ? HugePageRound(size) : size, wantHugePages, gotHugePages);
+        if (!block->data) {
+            delete block;
+            return nullptr;
+        }
+        block->size = size;
+        block->hugePages = gotHugePages;
+        return block;
+    }
+
+    static void DeleteBlock(ScratchBlock* block) noexcept {
+        SystemFree(block->data, block->hugePages ? HugePageRound(block->size) : block->size, block->hugePages);
+        delete block;
+    }
+
+    std::mutex mMutex;
+    std::map<std::size_t, std::vector<ScratchBlock*>> mFree;  // Idle blocks by class size
+    std::size_t mCacheLimit = SCRATCH_DEFAULT_CACHE_LIMIT;
+    bool mHugePages = false;
+    ScratchStats mStats = {};
+};
+
+// Never destroyed: buffers may still be returned by threads finishing
+// after static destruction has started. GlobalSetdown trims it instead.
+Pool* Instance() noexcept {
+    static Pool* pool = new (std::nothrow) Pool;
+    return pool;
+}
+
+} // namespace
+
+// =============================================================================
+// ScratchBuffer
+// =============================================================================
+
+ScratchBuffer& ScratchBuffer::operator=(ScratchBuffer&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        mBlock = other.mBlock;
+        other.mBlock = nullptr;
+    }
+    return *this;
+}
+
+void* ScratchBuffer::Data() const noexcept {
+    return mBlock ? mBlock->data : nullptr;
+}
+
+std::size_t ScratchBuffer::Size() const noexcept {
+    return mBlock ? mBlock->size : 0;
+}
+
+void ScratchBuffer::Reset() noexcept {
+    if (!mBlock) return;
+    if (Pool* pool = Instance()) pool->Release(mBlock);
+    mBlock = nullptr;
+}
+
+// =============================================================================
+// Pool control
+// =============================================================================
+
+ScratchBuffer AcquireScratch(const std::size_t bytes) noexcept {
+    Pool* pool = Instance();
+    return ScratchBuffer(pool ? pool->Acquire(bytes) : nullptr);
+}
+
+void TrimScratch(const std::size_t keepBytes) noexcept {
+    if (Pool* pool = Instance()) pool->TrimTo(keepBytes);
+}
+
+void SetScratchCacheLimit(const std::size_t bytes) noexcept {
+    if (Pool* pool = Instance()) pool->SetCacheLimit(bytes);
+}
+
+void SetScratchHugePages(const bool enable) noexcept {
+    if (Pool* pool = Instance()) pool->SetHugePages(enable);
+}
+
+ScratchStats GetScratchStats() noexcept {
+    Pool* pool = Instance();
+    return pool ? pool->Stats() : ScratchStats{};
+}
+
+} // namespace LiteGlowMem
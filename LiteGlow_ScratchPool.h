@@ -0,0 +1,85 @@
+#pragma once
+
+#ifndef LITEGLOW_SCRATCHPOOL_H
+#define LITEGLOW_SCRATCHPOOL_H
+
+// =============================================================================
+// LiteGlow Scratch Pool
+// =============================================================================
+// Process-wide cache of scratch buffers for the CPU render path. Buffers are
+// grouped in size classes (four per power of two, so at most 25% slack) and
+// handed back to the pool instead of the system when a render finishes, so
+// steady-state frames do not allocate at all. Safe to use from concurrent
+// (MFR) render threads.
+//
+// Buffers are 64-byte aligned and NOT zeroed. With huge pages enabled, large
+// buffers are requested from the OS on huge pages when it allows it.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LiteGlowMem {
+
+constexpr std::size_t SCRATCH_ALIGNMENT = 64;
+constexpr std::size_t SCRATCH_MIN_CLASS_BYTES = 64 * 1024;
+constexpr std::size_t SCRATCH_DEFAULT_CACHE_LIMIT = (std::size_t)512 * 1024 * 1024;
+
+struct ScratchBlock;
+
+// Owning handle to a pooled buffer; returns it to the pool on destruction.
+class ScratchBuffer {
+public:
+    ScratchBuffer() noexcept = default;
+    ~ScratchBuffer() { Reset(); }
+    ScratchBuffer(ScratchBuffer&& other) noexcept : mBlock(other.mBlock) { other.mBlock = nullptr; }
+    ScratchBuffer& operator=(ScratchBuffer&& other) noexcept;
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    void* Data() const noexcept;
+    std::size_t Size() const noexcept;  // Usable bytes (the class size, >= requested)
+    template <typename T> T* As() const noexcept { return static_cast<T*>(Data()); }
+    explicit operator bool() const noexcept { return mBlock != nullptr; }
+
+    // Returns the buffer to the pool early.
+    void Reset() noexcept;
+
+private:
+    friend ScratchBuffer AcquireScratch(std::size_t bytes) noexcept;
+    explicit ScratchBuffer(ScratchBlock* block) noexcept : mBlock(block) {}
+    ScratchBlock* mBlock = nullptr;
+};
+
+// Returns a buffer of at least `bytes` bytes, or an empty handle if the
+// system is out of memory even after the idle cache was dropped.
+ScratchBuffer AcquireScratch(std::size_t bytes) noexcept;
+
+// Frees idle buffers until at most `keepBytes` stay cached (0 = all).
+void TrimScratch(std::size_t keepBytes = 0) noexcept;
+
+// Idle bytes above this limit are freed as soon as a buffer is returned.
+void SetScratchCacheLimit(std::size_t bytes) noexcept;
+
+// Requests huge pages for buffers of at least one huge page. Only affects
+// buffers allocated after the call.
+void SetScratchHugePages(bool enable) noexcept;
+
+struct ScratchStats {
+    std::size_t bytesInUse;        // Handed out right now
+    std::size_t bytesCached;       // Idle in the pool
+    std::size_t peakBytesInUse;    // High-water mark of bytesInUse
+    std::size_t peakBytesTotal;    // High-water mark of bytesInUse + bytesCached
+    std::uint64_t acquires;        // AcquireScratch calls that succeeded
+    std::uint64_t reuses;          // ... served from the cache
+    std::uint64_t systemAllocs;    // Buffers allocated from the system
+    std::uint64_t systemFrees;     // Buffers given back to the system
+    std::uint64_t hugePageAllocs;  // systemAllocs that got huge pages
+};
+
+ScratchStats GetScratchStats() noexcept;
+
+} // namespace LiteGlowMem
+
+#endif // LITEGLOW_SCRATCHPOOL_H
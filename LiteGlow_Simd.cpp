@@ -0,0 +1,366 @@
+/*	LiteGlow_Simd.cpp
+
+	CPU feature detection, kernel dispatch and the scalar kernels.
+	See LiteGlow_Simd.h for the model.
+
+*/
+
+#include "LiteGlow_Simd.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define LITEGLOW_SIMD_X86 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#else
+    #define LITEGLOW_SIMD_X86 0
+#endif
+
+#include "LiteGlow_SimdKernels.h"
+
+namespace LiteGlowSimd {
+
+// Defined in LiteGlow_Simd_<isa>.cpp; null when not built for this target.
+const PixelKernels* GetKernelsSSE41() noexcept;
+const PixelKernels* GetKernelsAVX2() noexcept;
+const PixelKernels* GetKernelsAVX512() noexcept;
+
+namespace {
+
+// =============================================================================
+// Scalar Kernels
+// =============================================================================
+// One pixel per step through the shared kernels: the reference every vector
+// set is measured against, and what runs on other CPUs.
+
+struct ScalarOps {
+    typedef float F;
+    typedef int I;
+    typedef bool M;
+    static constexpr int LANES = 1;
+
+    static F Set1(const float v) { return v; }
+    static F Load(const float* p) { return *p; }
+    static void Store(float* p, const F v) { *p = v; }
+    static F Add(const F a, const F b) { return a + b; }
+    static F Sub(const F a, const F b) { return a - b; }
+    static F Mul(const F a, const F b) { return a * b; }
+    static F Div(const F a, const F b) { return a / b; }
+    static F Min(const F a, const F b) { return a < b ? a : b; }
+    static F Max(const F a, const F b) { return a > b ? a : b; }
+    static M CmpLE(const F a, const F b) { return a <= b; }
+    static M CmpGE(const F a, const F b) { return a >= b; }
+    static M CmpGT(const F a, const F b) { return a > b; }
+    static F Select(const M m, const F a, const F b) { return m ? a : b; }
+
+    static I Ramp(const int start) { return start; }
+    static I LoadI(const int* p) { return *p; }
+    static I AddI(const I a, const int b) { return a + b; }
+    static I MinI(const I a, const int b) { return a < b ? a : b; }
+    static I MulI(const I a, const int b) { return a * b; }
+    static I ShrI(const I a, const int shift) { return a >> shift; }
+    static F ToFloat(const I a) { return (float)a; }
+    static I Truncate(const F a) { return (int)a; }
+
+    static I Set1I(const int v) { return v; }
+    static I AddII(const I a, const I b) { return a + b; }
+    static I SubII(const I a, const I b) { return a - b; }
+    static I MulII(const I a, const I b) { return a * b; }
+    static I MaxII(const I a, const I b) { return a > b ? a : b; }
+    static F Pow2(const I n) {
+        const std::int32_t bits = (std::int32_t)((n + 127) << 23);
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    template <int Depth>
+    static void LoadPixelsI(const void* p, I& a, I& r, I& g, I& b) {
+        if constexpr (Depth == DEPTH_8) {
+            const unsigned char* c = static_cast<const unsigned char*>(p);
+            a = c[0]; r = c[1]; g = c[2]; b = c[3];
+        } else {
+            unsigned short c[4];
+            std::memcpy(c, p, sizeof(c));
+            a = c[0]; r = c[1]; g = c[2]; b = c[3];
+        }
+    }
+
+    template <int Depth>
+    static void GatherPixelsI(const void* row, const I idx, I& a, I& r, I& g, I& b) {
+        LoadPixelsI<Depth>(PixelAt<Depth>(row, idx), a, r, g, b);
+    }
+
+    template <int Depth>
+    static void StorePixelsI(void* p, const I a, const I r, const I g, const I b) {
+        if constexpr (Depth == DEPTH_8) {
+            const unsigned char c[4] = { (unsigned char)a, (unsigned char)r, (unsigned char)g, (unsigned char)b };
+            std::memcpy(p, c, sizeof(c));
+        } else {
+            const unsigned short c[4] = { (unsigned short)a, (unsigned short)r, (unsigned short)g, (unsigned short)b };
+            std::memcpy(p, c, sizeof(c));
+        }
+    }
+
+    template <int Depth>
+    static void LoadPixels(const void* p, F& a, F& r, F& g, F& b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            float c[4];
+            std::memcpy(c, p, sizeof(c));
+            a = c[0]; r = c[1]; g = c[2]; b = c[3];
+        } else {
+            I ia, ir, ig, ib;
+            LoadPixelsI<Depth>(p, ia, ir, ig, ib);
+            a = (F)ia; r = (F)ir; g = (F)ig; b = (F)ib;
+        }
+    }
+
+    template <int Depth>
+    static void GatherPixels(const void* row, const I idx, F& a, F& r, F& g, F& b) {
+        LoadPixels<Depth>(PixelAt<Depth>(row, idx), a, r, g, b);
+    }
+
+    template <int Depth>
+    static void StorePixels(void* p, const F a, const F r, const F g, const F b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            const float c[4] = { a, r, g, b };
+            std::memcpy(p, c, sizeof(c));
+        } else {
+            StorePixelsI<Depth>(p, (I)a, (I)r, (I)g, (I)b);
+        }
+    }
+
+    static F Gather(const float* base, const I idx, const int start, const bool window) {
+        (void)start;
+        (void)window;
+        return base[idx];
+    }
+
+    static I GatherU16(const std::uint16_t* base, const I idx, const int start, const bool window) {
+        (void)start;
+        (void)window;
+        return base[idx];
+    }
+
+    static I GatherI(const std::int32_t* table, const I idx) { return table[idx]; }
+    static void StoreU16(std::uint16_t* p, const I v) { *p = (std::uint16_t)v; }
+};
+
+constexpr PixelKernels kScalarKernels = MakeKernels<ScalarOps>(Isa::SCALAR);
+
+std::atomic<const PixelKernels*> gActive{ &kScalarKernels };
+
+// =============================================================================
+// CPU Features
+// =============================================================================
+
+#if LITEGLOW_SIMD_X86
+void CpuId(const unsigned leaf, const unsigned subleaf, unsigned regs[4]) noexcept {
+  #if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; ++i) regs[i] = (unsigned)r[i];
+  #else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+  #endif
+}
+
+// Register state the OS saves on context switches (XCR0).
+unsigned long long OsSavedState() noexcept {
+  #if defined(_MSC_VER)
+    return _xgetbv(0);
+  #else
+    unsigned lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long)hi << 32) | lo;
+  #endif
+}
+#endif
+
+Isa Detect() noexcept {
+#if LITEGLOW_SIMD_X86
+    unsigned regs[4];
+    CpuId(0, 0, regs);
+    const unsigned maxLeaf = regs[0];
+    CpuId(1, 0, regs);
+    const unsigned ecx1 = regs[2];
+    if (!(ecx1 & (1u << 19))) return Isa::SCALAR;  // SSE4.1
+
+    const bool osxsave = (ecx1 & (1u << 27)) != 0;
+    const bool avx = (ecx1 & (1u << 28)) != 0;
+    if (!osxsave || !avx || maxLeaf < 7) return Isa::SSE41;
+    const unsigned long long xcr0 = OsSavedState();
+    if ((xcr0 & 0x6) != 0x6) return Isa::SSE41;  // XMM and YMM state
+
+    CpuId(7, 0, regs);
+    const unsigned ebx7 = regs[1];
+    if (!(ebx7 & (1u << 5))) return Isa::SSE41;  // AVX2
+    const bool avx512f = (ebx7 & (1u << 16)) != 0;
+    if (!avx512f || (xcr0 & 0xE0) != 0xE0) return Isa::AVX2;  // Opmask and ZMM state
+    return Isa::AVX512;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+} // namespace
+
+// =============================================================================
+// Dispatch
+// =============================================================================
+
+Isa DetectIsa() noexcept {
+    static const Isa isa = Detect();
+    return isa;
+}
+
+const PixelKernels* KernelsFor(const Isa isa) noexcept {
+    if ((int)isa > (int)DetectIsa()) return nullptr;
+    switch (isa) {
+        case Isa::SCALAR: return &kScalarKernels;
+        case Isa::SSE41: return GetKernelsSSE41();
+        case Isa::AVX2: return GetKernelsAVX2();
+        case Isa::AVX512: return GetKernelsAVX512();
+    }
+    return nullptr;
+}
+
+void SelectKernels(const Isa limit) noexcept {
+    const PixelKernels* kernels = &kScalarKernels;
+    for (int i = (int)Isa::SCALAR; i <= (int)limit; ++i) {
+        if (const PixelKernels* k = KernelsFor((Isa)i)) kernels = k;
+    }
+    gActive.store(kernels, std::memory_order_release);
+}
+
+const PixelKernels& Kernels() noexcept {
+    return *gActive.load(std::memory_order_acquire);
+}
+
+const char* IsaName(const Isa isa) noexcept {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::SSE41: return "sse4.1";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool ParseIsa(const char* name, Isa& isa) noexcept {
+    if (!name) return false;
+    for (int i = (int)Isa::SCALAR; i <= (int)Isa::AVX512; ++i) {
+        if (std::strcmp(name, IsaName((Isa)i)) == 0) {
+            isa = (Isa)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// =============================================================================
+// Bright Response Tables
+// =============================================================================
+
+void BuildBrightResponse(const BrightParams& params, const PixelDepth depth, BrightResponse& response) noexcept {
+    // Weighted sums reach 255 or 32768 times 2^15; both map onto 4096 entries
+    const bool is8 = depth == DEPTH_8;
+    const float channelMax = is8 ? 255.0f : 32768.0f;
+    const int entryShift = is8 ? 11 : 18;
+    response.lumaShift = entryShift - BRIGHT_RESPONSE_FRACTION_BITS;
+    const float lumaStep = (float)(1 << entryShift) / (32768.0f * channelMax);
+    // Q15 output per host code value, in FIXED_GAIN_SHIFT fixed point
+    const float toGain = 32768.0f / channelMax * (float)(1 << FIXED_GAIN_SHIFT);
+    const float gainMax = (float)(((1u << 31) - (1u << FIXED_GAIN_SHIFT)) / (unsigned)channelMax);
+
+    // The soft knee of BrightRow, evaluated once per entry
+    const float kneeStart = params.threshold - params.knee;
+    const float kneeEnd = params.threshold + params.knee;
+    const float kneeRange = kneeEnd - kneeStart;
+    const bool hardKnee = kneeRange <= 0.0001f;
+    for (int i = 0; i < BRIGHT_RESPONSE_SIZE - 1; ++i) {
+        const float luma = (float)i * lumaStep;
+        const float excess = luma - params.threshold;
+        float contribution = 0.0f;
+        if (luma >= kneeEnd) {
+            contribution = excess;
+        } else if (luma > kneeStart && !hardKnee) {
+            const float t = (luma - kneeStart) / kneeRange;
+            contribution = t * t * (3.0f - 2.0f * t) * excess;
+        }
+        float scale = 0.0f;
+        if (contribution > 0.0f) {
+            const float denom = excess + contribution;
+            scale = params.intensity * (contribution / (denom > 0.001f ? denom : 0.001f));
+        }
+        // Scale is at most intensity / 2 (2.0), well inside the cap that keeps
+        // channel * gain + rounding below 2^31
+        const float gain = scale * toGain + 0.5f;
+        response.gain[i] = (std::int32_t)(gain < gainMax ? gain : gainMax);
+    }
+    response.gain[BRIGHT_RESPONSE_SIZE - 1] = response.gain[BRIGHT_RESPONSE_SIZE - 2];
+}
+
+namespace {
+
+// Parameter sets kept: an edit session alternates between a handful at most.
+constexpr int RESPONSE_CACHE_SLOTS = 4;
+
+struct ResponseSlot {
+    BrightParams params;
+    PixelDepth depth;
+    BrightResponseRef response;
+    std::uint64_t lastUse;
+};
+
+inline bool SameBits(const float a, const float b) noexcept {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+inline bool SameParams(const BrightParams& a, const BrightParams& b) noexcept {
+    return SameBits(a.threshold, b.threshold) && SameBits(a.knee, b.knee) && SameBits(a.intensity, b.intensity);
+}
+
+std::mutex gResponseMutex;
+ResponseSlot gResponseSlots[RESPONSE_CACHE_SLOTS];
+std::uint64_t gResponseClock = 0;
+
+} // namespace
+
+BrightResponseRef SharedBrightResponse(const BrightParams& params, const PixelDepth depth) noexcept {
+    // Building under the lock costs a few microseconds once per parameter
+    // set, and makes racing render threads share the first table
+    std::lock_guard<std::mutex> lock(gResponseMutex);
+    ResponseSlot* victim = &gResponseSlots[0];
+    for (ResponseSlot& slot : gResponseSlots) {
+        if (slot.response && slot.depth == depth && SameParams(slot.params, params)) {
+            slot.lastUse = ++gResponseClock;
+            return slot.response;
+        }
+        if (slot.lastUse < victim->lastUse) victim = &slot;
+    }
+
+    BrightResponse* response = new (std::nothrow) BrightResponse;
+    if (!response) return nullptr;
+    BuildBrightResponse(params, depth, *response);
+    try {
+        victim->response = BrightResponseRef(response);
+    } catch (...) {
+        // shared_ptr deletes `response` itself when its control block cannot be allocated
+        return nullptr;
+    }
+    victim->params = params;
+    victim->depth = depth;
+    victim->lastUse = ++gResponseClock;
+    return victim->response;
+}
+
+} // namespace LiteGlowSimd
@@ -0,0 +1,290 @@
+#pragma once
+
+#ifndef LITEGLOW_SIMD_H
+#define LITEGLOW_SIMD_H
+
+// =============================================================================
+// LiteGlow Pixel Kernels
+// =============================================================================
+// Row kernels for the per-pixel stages of the CPU path: the bright pass, the
+// blend and the pyramid upsample, plus fixed-point versions of the first two
+// for 8/16-bit hosts (see Fixed-Point Kernels below). The bright pass of
+// 8/16-bit hosts reads its soft knee from a response table (see Bright
+// Response Tables below). Each kernel is written once against a small vector
+// interface (LiteGlow_SimdKernels.h) and instantiated per host depth and
+// channel order and, for the blend, per blend operation, so a render picks
+// one specialized row function up front and no per-pixel branch is left on
+// depth, order or mode. Every kernel is built for
+//   - Scalar (one pixel per step, the reference and the fallback)
+//   - SSE4.1 (4 pixels), AVX2 (8 pixels), AVX-512F (16 pixels) on x86-64.
+// SelectKernels picks the widest set the CPU and OS support once, at
+// GlobalSetup; the render reads the active table through Kernels().
+//
+// Tolerance: every instruction set runs the same operation sequence as the
+// scalar kernels (exact division, no fused multiply-add, min/max with the
+// operand order of the scalar comparisons), so for finite inputs results are
+// bit-identical. The documented bound, checked by bench/PixelKernelsBench.cpp,
+// is PIXEL_KERNEL_TOLERANCE_FLOAT for float outputs and one code value for
+// 8/16-bit outputs. NaN inputs may produce different (still clamped) values.
+//
+// The fixed-point kernels use integer arithmetic only, so every instruction
+// set produces exactly the scalar result.
+//
+// Host pixels are four interleaved channels of 8-bit, 16-bit (0..32768) or
+// float values, in alpha, red, green, blue order (LAYOUT_ARGB, the
+// PF_Pixel8/16/Float layout) or the reverse (LAYOUT_BGRA).
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include "LiteGlow_Blur.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace LiteGlowSimd {
+
+enum class Isa {
+    SCALAR,
+    SSE41,
+    AVX2,
+    AVX512
+};
+
+enum PixelDepth {
+    DEPTH_8,
+    DEPTH_16,
+    DEPTH_FLOAT,
+    PIXEL_DEPTHS
+};
+
+enum PixelLayout {
+    LAYOUT_ARGB,
+    LAYOUT_BGRA,
+    PIXEL_LAYOUTS
+};
+
+constexpr float PIXEL_KERNEL_TOLERANCE_FLOAT = 1.0e-6f;
+
+// Bright pass settings, in normalized units (see BrightPassRow in LiteGlow_Core.cpp).
+struct BrightParams {
+    float threshold;
+    float knee;
+    float intensity;
+};
+
+struct BrightResponse;
+
+// Writes outR/G/B[x] for x in [0, width) from source pixel
+// min(srcWidth - 1, x * factor) of `srcRow`. Integer depths read the knee
+// from `response` (built from the same params); float evaluates `params`
+// per pixel and ignores it.
+typedef void (*BrightRowFn)(const void* srcRow, int srcWidth, int factor, const BrightParams& params,
+                            const BrightResponse* response, float* outR, float* outG, float* outB, int width);
+
+// One row of the glow planes as seen from the output: output column x
+// samples glow column min(width - 1, (x + offsetX) / factor).
+template <typename T>
+struct GlowRowOf {
+    const T* r;
+    const T* g;
+    const T* b;
+    int width;
+    int factor;
+    int offsetX;
+};
+
+typedef GlowRowOf<float> GlowRow;
+typedef GlowRowOf<std::uint16_t> GlowRowQ15;
+
+// How the glow is composited over the input (the Blend Mode popup, in order).
+enum BlendOp {
+    BLEND_SCREEN,
+    BLEND_ADD,
+    BLEND_NORMAL,
+    BLEND_OPS
+};
+
+struct BlendParams {
+    float strength;
+    float tintR;
+    float tintG;
+    float tintB;
+};
+
+// Blends output pixels [x0, x1) with g = glow * strength * tint:
+//   Screen   out = 1 - (1 - in) * (1 - g)
+//   Add      out = in + g
+//   Normal   out = g + in * (1 - min(1, max(g.r, g.g, g.b))), the glow
+//            composited over the input as premultiplied colour
+// clamped to [0, 1]; float input is clamped to [0, 1] first, so black glow
+// leaves every mode at the (clamped) input. Alpha is copied. `inRow` and
+// `outRow` may be the same row.
+typedef void (*BlendRowFn)(const void* inRow, void* outRow, int x0, int x1, const GlowRow& glow,
+                           const BlendParams& params);
+
+// Row y of `fine` becomes fineWeight * fine + coarseWeight * bilinear
+// upsample of `coarse` (the half-size level below; sample centres aligned).
+typedef void (*UpsampleRowFn)(const LiteGlowBlur::PlaneF& coarse, float coarseWeight,
+                              const LiteGlowBlur::PlaneF& fine, float fineWeight, int y);
+
+// =============================================================================
+// Bright Response Tables
+// =============================================================================
+// Integer hosts have bounded luma, so the soft knee is tabulated once per
+// parameter set instead of evaluated per pixel: luma is a Q15-weighted sum
+// of the channels, the table samples it every 1/4096 of white (1/16 of an
+// 8-bit code; 2^BRIGHT_RESPONSE_BITS entries, PF_TABLE_SZ_16 in LiteGlow.h)
+// and each entry holds the knee's scale at that luma, pre-multiplied into
+// Q15 output units. Lookups interpolate linearly between entries, which
+// follows the steep start of the knee just above the threshold. Against the
+// per-pixel knee the output differs by a few Q15 units of rounding, except
+// for lumas within about 0.001 above the threshold, where the knee bends too
+// sharply for the table (up to ~4% of the pixel there; 0.03% of 8-bit
+// colours differ by more than one 8-bit code before the blur).
+
+// Rec. 709 luma weights in Q15 (they sum to exactly 1.0)
+constexpr int LUMA_WEIGHT_R_Q15 = 6966;
+constexpr int LUMA_WEIGHT_G_Q15 = 23436;
+constexpr int LUMA_WEIGHT_B_Q15 = 2366;
+
+// Gains (response entries, strength x tint) carry this many fraction bits.
+constexpr int FIXED_GAIN_SHIFT = 14;
+
+// Entries 0..4096 span black to white; one more repeats the last so the
+// interpolation at white stays inside the table.
+constexpr int BRIGHT_RESPONSE_BITS = 12;
+constexpr int BRIGHT_RESPONSE_SIZE = (1 << BRIGHT_RESPONSE_BITS) + 2;
+constexpr int BRIGHT_RESPONSE_FRACTION_BITS = 8;
+
+struct BrightResponse {
+    // Weighted channel sum >> lumaShift is the entry index in units of
+    // 2^-BRIGHT_RESPONSE_FRACTION_BITS entries
+    int lumaShift;
+    // Host channel value * gain >> FIXED_GAIN_SHIFT is the Q15 output
+    std::int32_t gain[BRIGHT_RESPONSE_SIZE];
+};
+
+typedef std::shared_ptr<const BrightResponse> BrightResponseRef;
+
+// Fills `response` for an integer depth (DEPTH_8 or DEPTH_16).
+void BuildBrightResponse(const BrightParams& params, PixelDepth depth, BrightResponse& response) noexcept;
+
+// The table for (params, depth), built on first use and then shared
+// read-only: the last few parameter sets stay cached, so the render threads
+// of a frame, concurrent frames and scrubbing with unchanged bright settings
+// all read one copy. Null when out of memory.
+BrightResponseRef SharedBrightResponse(const BrightParams& params, PixelDepth depth) noexcept;
+
+// =============================================================================
+// Fixed-Point Kernels
+// =============================================================================
+// For 8/16-bit hosts the box-blurred glow can stay in integers end to end:
+// the bright pass writes Q15 planes (LiteGlowBlur::PlanarRGB16), the box
+// blur averages them with integer sums, and the blend reads them back.
+// All arithmetic is 32-bit integer lanes; no channel is converted to float.
+// The bright pass uses the response table like the float one, so both paths
+// agree to rounding.
+//
+// 16-bit lanes would only pay off in the bright pass and the blend: the box
+// sums and Q15 products need 32 bits. Those two stages are about a fifth of
+// an 8-bit render and the box passes about three quarters, so the path is
+// 1.3-1.5x the float one rather than 2x.
+
+// As BrightRowFn, writing Q15 samples (saturated at PLANAR_Q15_ONE).
+typedef void (*BrightRowQ15Fn)(const void* srcRow, int srcWidth, int factor, const BrightResponse& response,
+                               std::uint16_t* outR, std::uint16_t* outG, std::uint16_t* outB, int width);
+
+// As BlendRowFn over Q15 glow, with g = min(1, glow * strength * tint) per
+// channel; Screen is out = in + (max - in) * g. Glow terms are truncated
+// like the float kernel's conversion back.
+typedef void (*BlendRowQ15Fn)(const void* inRow, void* outRow, int x0, int x1, const GlowRowQ15& glow,
+                              const BlendParams& params);
+
+// =============================================================================
+// HLSL Pipeline Kernels
+// =============================================================================
+// The four compute shaders of the GPU path (LiteGlowBrightPassKernel.hlsl,
+// LiteGlowBlurH/VKernel.hlsl, LiteGlowBlendKernel.hlsl) as row kernels, for
+// the CPU emulation of that pipeline (LiteGlowCore::PIPELINE_HLSL). They
+// keep the shaders' formulas and operation order; intermediates are float
+// pixels in ARGB order (16 bytes), like the GPU's float4 buffers. Where a
+// shader turns a non-finite float4 into (0, 0, 0, 1) as it loads it, the
+// kernel writing that buffer does it as it stores instead, which is the
+// same for every reader.
+// exp() in the blend is a polynomial (relative error ~2e-7), and the
+// kernels never fuse a multiply-add, so CPU and GPU results differ by the
+// rounding of those; every instruction set gives the scalar result.
+
+constexpr int HLSL_BLUR_TAPS = 9;
+
+struct HlslBrightParams {
+    float threshold;   // Normalized; the knee is the shader's fixed 0.1
+    float intensity;
+};
+
+// Writes pixels [0, width) of a bright buffer row: pixel x averages the
+// factor x factor source block at column x * factor of `srcRows` (`factor`
+// rows), columns clamped to srcWidth - 1, then passes the Rec. 601 luma
+// (0.299, 0.587, 0.114) through the soft knee.
+typedef void (*HlslBrightRowFn)(const void* const* srcRows, int srcWidth, int factor,
+                                const HlslBrightParams& params, float* out, int width);
+
+// Horizontal 9-tap blur of one row: taps every `step` pixels, clamped to
+// the row.
+typedef void (*HlslBlurRowHFn)(const float* in, float* out, int width, int step);
+
+// Vertical 9-tap blur: `inRows` are the HLSL_BLUR_TAPS rows under the
+// output row, already clamped to the image.
+typedef void (*HlslBlurRowVFn)(const float* const* inRows, float* out, int width);
+
+// The two glow rows around an output row, as the blend sees them: output
+// column x samples the glow bilinearly at ((x + offsetX + 0.5) / factor - 0.5,
+// row0 + fy).
+struct HlslGlowRows {
+    const float* row0;
+    const float* row1;
+    float fy;
+    int width;
+    int factor;
+    int offsetX;
+};
+
+// Blends output pixels [x0, x1) with g = (1 - exp(-glow * strength)) * tint
+// (Screen, Add or Normal as BlendRowFn, then clamped to [0, 1]); alpha is
+// copied (clamped to [0, 1] for float). `inRow` and `outRow` may be the same
+// row.
+typedef void (*HlslBlendRowFn)(const void* inRow, void* outRow, int x0, int x1, const HlslGlowRows& glow,
+                               const BlendParams& params);
+
+struct PixelKernels {
+    Isa isa;
+    BrightRowFn bright[PIXEL_LAYOUTS][PIXEL_DEPTHS];
+    BlendRowFn blend[BLEND_OPS][PIXEL_LAYOUTS][PIXEL_DEPTHS];
+    UpsampleRowFn upsample;
+    BrightRowQ15Fn brightQ15[PIXEL_LAYOUTS][DEPTH_FLOAT];  // Integer depths only
+    BlendRowQ15Fn blendQ15[BLEND_OPS][PIXEL_LAYOUTS][DEPTH_FLOAT];
+    HlslBrightRowFn hlslBright[PIXEL_LAYOUTS][PIXEL_DEPTHS];
+    HlslBlurRowHFn hlslBlurH;
+    HlslBlurRowVFn hlslBlurV;
+    HlslBlendRowFn hlslBlend[BLEND_OPS][PIXEL_LAYOUTS][PIXEL_DEPTHS];
+};
+
+// Widest instruction set this CPU and OS support.
+Isa DetectIsa() noexcept;
+
+// Kernels for `isa`, or null when this build or CPU cannot run them.
+const PixelKernels* KernelsFor(Isa isa) noexcept;
+
+// Makes the widest supported set at or below `limit` the active one.
+void SelectKernels(Isa limit) noexcept;
+
+// Active set; scalar until SelectKernels runs.
+const PixelKernels& Kernels() noexcept;
+
+// "scalar", "sse4.1", "avx2", "avx512"; ParseIsa accepts the same names.
+const char* IsaName(Isa isa) noexcept;
+bool ParseIsa(const char* name, Isa& isa) noexcept;
+
+} // namespace LiteGlowSimd
+
+#endif // LITEGLOW_SIMD_H
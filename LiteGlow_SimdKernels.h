@@ -0,0 +1,981 @@
+#pragma once
+
+#ifndef LITEGLOW_SIMDKERNELS_H
+#define LITEGLOW_SIMDKERNELS_H
+
+// =============================================================================
+// LiteGlow Pixel Kernels - shared implementation
+// =============================================================================
+// Private to LiteGlow_Simd*.cpp: each of those defines a vector interface `V`
+// and includes this file to instantiate the kernels for it, inside the region
+// where the compiler may use that instruction set. Everything here therefore
+// has internal linkage (an unnamed namespace) and uses only `V` and builtins:
+// an inline function shared with other translation units could otherwise be
+// merged with its AVX copy by the linker and run on a CPU without AVX.
+//
+// `V` provides, for LANES pixels at a time:
+//   F / I / M                 float vector, int32 vector, comparison mask
+//   Set1, Load, Store         float vectors (unaligned)
+//   Add Sub Mul Div           IEEE single precision, never fused
+//   Min(a, b) / Max(a, b)     a < b ? a : b / a > b ? a : b
+//   CmpLE CmpGE CmpGT, Select(m, a, b) = m ? a : b
+//   Ramp(i) = {i, i+1, ...}, LoadI, AddI, MinI, MulI, ShrI, ToFloat, Truncate
+//                             (the int operand of AddI/MinI/MulI is broadcast)
+//   Set1I, AddII, SubII, MulII, MaxII   int32 lanes, vector operands (low
+//                             32 bits)
+//   Pow2(n)                   2^n as floats, for n in [-126, 127]
+//   LoadPixels<Depth>(p, a, r, g, b)        LANES contiguous host pixels,
+//   GatherPixels<Depth>(row, idx, a, r, g, b)   or pixels row[idx[i]],
+//   StorePixels<Depth>(p, a, r, g, b)       channel values as floats; integer
+//                                           depths truncate (values in range)
+//   LoadPixelsI / GatherPixelsI / StorePixelsI<Depth>   the same for integer
+//                                           depths with int32 channel values
+//                             (all of these in ARGB order; see HostPixels
+//                             below for BGRA)
+//   Gather(base, idx, start, window)  base[idx[i]]; when `window` is true every
+//                                     idx[i] - start is in [0, LANES) and
+//                                     base[start .. start + LANES) is readable
+//   GatherU16(base, idx, start, window)   the same over uint16 samples
+//   GatherI(table, idx)       table[idx[i]] over int32 entries
+//   StoreU16(p, v)            LANES uint16 samples (values in [0, 65535])
+
+#include "LiteGlow_Simd.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace LiteGlowSimd {
+namespace {
+
+template <int Depth> struct DepthTraits;
+template <> struct DepthTraits<DEPTH_8> {
+    static constexpr int PIXEL_BYTES = 4;
+    static constexpr float CHANNEL_MAX = 255.0f;
+};
+template <> struct DepthTraits<DEPTH_16> {
+    static constexpr int PIXEL_BYTES = 8;
+    static constexpr float CHANNEL_MAX = 32768.0f;
+};
+template <> struct DepthTraits<DEPTH_FLOAT> {
+    static constexpr int PIXEL_BYTES = 16;
+    static constexpr float CHANNEL_MAX = 1.0f;
+};
+
+template <int Depth>
+inline const void* PixelAt(const void* row, const int x) {
+    return static_cast<const char*>(row) + (std::ptrdiff_t)x * DepthTraits<Depth>::PIXEL_BYTES;
+}
+
+template <int Depth>
+inline void* PixelAt(void* row, const int x) {
+    return static_cast<char*>(row) + (std::ptrdiff_t)x * DepthTraits<Depth>::PIXEL_BYTES;
+}
+
+// Pixel access in `Layout` order on top of the ARGB accessors of `V`: a
+// BGRA pixel is an ARGB one with its channels named back to front.
+template <class V, int Depth, int Layout>
+struct HostPixels {
+    typedef typename V::F F;
+    typedef typename V::I I;
+
+    static void Load(const void* p, F& a, F& r, F& g, F& b) {
+        if constexpr (Layout == LAYOUT_BGRA) V::template LoadPixels<Depth>(p, b, g, r, a);
+        else V::template LoadPixels<Depth>(p, a, r, g, b);
+    }
+    static void Gather(const void* row, const I idx, F& a, F& r, F& g, F& b) {
+        if constexpr (Layout == LAYOUT_BGRA) V::template GatherPixels<Depth>(row, idx, b, g, r, a);
+        else V::template GatherPixels<Depth>(row, idx, a, r, g, b);
+    }
+    static void Store(void* p, const F a, const F r, const F g, const F b) {
+        if constexpr (Layout == LAYOUT_BGRA) V::template StorePixels<Depth>(p, b, g, r, a);
+        else V::template StorePixels<Depth>(p, a, r, g, b);
+    }
+    static void LoadI(const void* p, I& a, I& r, I& g, I& b) {
+        if constexpr (Layout == LAYOUT_BGRA) V::template LoadPixelsI<Depth>(p, b, g, r, a);
+        else V::template LoadPixelsI<Depth>(p, a, r, g, b);
+    }
+    static void GatherI(const void* row, const I idx, I& a, I& r, I& g, I& b) {
+        if constexpr (Layout == LAYOUT_BGRA) V::template GatherPixelsI<Depth>(row, idx, b, g, r, a);
+        else V::template GatherPixelsI<Depth>(row, idx, a, r, g, b);
+    }
+    static void StoreI(void* p, const I a, const I r, const I g, const I b) {
+        if constexpr (Layout == LAYOUT_BGRA) V::template StorePixelsI<Depth>(p, b, g, r, a);
+        else V::template StorePixelsI<Depth>(p, a, r, g, b);
+    }
+};
+
+// log2(factor) for powers of two, else -1.
+inline int FactorShift(const int factor) {
+    for (int shift = 0; shift < 31; ++shift) {
+        if ((1 << shift) == factor) return shift;
+    }
+    return -1;
+}
+
+// =============================================================================
+// Bright Pass
+// =============================================================================
+// Luma (Rec. 709) through a soft knee around the threshold; pixels that pass
+// keep their colour, scaled so the luma excess becomes the knee output.
+// Float input evaluates the knee per pixel. Integer input reads the scale
+// from the response table (BuildBrightResponse), so each pixel costs one
+// interpolated lookup and three multiplies.
+
+// Writes one step of the float planes; the last step of a row may be short.
+template <class V>
+inline void StoreBrightStep(float* outR, float* outG, float* outB, const int x, const int width,
+                            const typename V::F r, const typename V::F g, const typename V::F b)
+{
+    constexpr int L = V::LANES;
+    if (x + L <= width) {
+        V::Store(outR + x, r);
+        V::Store(outG + x, g);
+        V::Store(outB + x, b);
+    } else {
+        float tail[3][L];
+        V::Store(tail[0], r);
+        V::Store(tail[1], g);
+        V::Store(tail[2], b);
+        const std::size_t bytes = (std::size_t)(width - x) * sizeof(float);
+        std::memcpy(outR + x, tail[0], bytes);
+        std::memcpy(outG + x, tail[1], bytes);
+        std::memcpy(outB + x, tail[2], bytes);
+    }
+}
+
+template <class V, int Layout>
+void BrightRow(const void* srcRow, const int srcWidth, const int factor, const BrightParams& params,
+               const BrightResponse*, float* outR, float* outG, float* outB, const int width)
+{
+    typedef typename V::F F;
+    typedef typename V::I I;
+    typedef typename V::M M;
+    constexpr int L = V::LANES;
+
+    const F zero = V::Set1(0.0f);
+    const F two = V::Set1(2.0f);
+    const F three = V::Set1(3.0f);
+    const F minExcess = V::Set1(0.001f);
+    const F threshold = V::Set1(params.threshold);
+    const F intensity = V::Set1(params.intensity);
+    const float kneeStartS = params.threshold - params.knee;
+    const float kneeEndS = params.threshold + params.knee;
+    const float kneeRangeS = kneeEndS - kneeStartS;
+    const bool hardKnee = kneeRangeS <= 0.0001f;  // Division by zero protection
+    const F kneeStart = V::Set1(kneeStartS);
+    const F kneeEnd = V::Set1(kneeEndS);
+    const F kneeRange = V::Set1(kneeRangeS);
+    typedef HostPixels<V, DEPTH_FLOAT, Layout> Pixels;
+
+    for (int x = 0; x < width; x += L) {
+        F a, r, g, b;
+        if (factor == 1 && x + L <= srcWidth) {
+            Pixels::Load(PixelAt<DEPTH_FLOAT>(srcRow, x), a, r, g, b);
+        } else {
+            const I idx = V::MinI(V::MulI(V::Ramp(x), factor), srcWidth - 1);
+            Pixels::Gather(srcRow, idx, a, r, g, b);
+        }
+
+        const F luma = V::Add(V::Add(V::Mul(V::Set1(0.2126f), r), V::Mul(V::Set1(0.7152f), g)),
+                              V::Mul(V::Set1(0.0722f), b));
+        const F excess = V::Sub(luma, threshold);
+        F contribution = zero;
+        if (!hardKnee) {
+            const F t = V::Div(V::Sub(luma, kneeStart), kneeRange);
+            contribution = V::Mul(V::Mul(V::Mul(t, t), V::Sub(three, V::Mul(two, t))), excess);
+        }
+        contribution = V::Select(V::CmpGE(luma, kneeEnd), excess, contribution);
+        contribution = V::Select(V::CmpLE(luma, kneeStart), zero, contribution);
+
+        const M lit = V::CmpGT(contribution, zero);
+        const F scale = V::Mul(intensity, V::Div(contribution, V::Max(minExcess, V::Add(excess, contribution))));
+        StoreBrightStep<V>(outR, outG, outB, x, width, V::Select(lit, V::Mul(r, scale), zero),
+                           V::Select(lit, V::Mul(g, scale), zero), V::Select(lit, V::Mul(b, scale), zero));
+    }
+}
+
+// Source pixels x .. x + LANES - 1 of a bright pass row (every factor-th
+// pixel) as int32 channels. 16-bit channels above white are clamped, which
+// keeps the luma inside the response table.
+template <class V, int Depth, int Layout>
+inline void LoadBrightSource(const void* srcRow, const int srcWidth, const int factor, const int x,
+                             typename V::I& r, typename V::I& g, typename V::I& b)
+{
+    typedef HostPixels<V, Depth, Layout> Pixels;
+    typename V::I a;
+    if (factor == 1 && x + V::LANES <= srcWidth) {
+        Pixels::LoadI(PixelAt<Depth>(srcRow, x), a, r, g, b);
+    } else {
+        const typename V::I idx = V::MinI(V::MulI(V::Ramp(x), factor), srcWidth - 1);
+        Pixels::GatherI(srcRow, idx, a, r, g, b);
+    }
+    if constexpr (Depth == DEPTH_16) {
+        constexpr int kChannelMax = (int)DepthTraits<Depth>::CHANNEL_MAX;
+        r = V::MinI(r, kChannelMax);
+        g = V::MinI(g, kChannelMax);
+        b = V::MinI(b, kChannelMax);
+    }
+}
+
+// Response gain at the luma of (r, g, b): the entry and fraction of the
+// weighted sum, then a linear blend of the two nearest entries.
+template <class V>
+inline typename V::I ResponseGain(const BrightResponse& response, const typename V::I r, const typename V::I g,
+                                  const typename V::I b)
+{
+    typedef typename V::I I;
+    constexpr int kFractionBits = BRIGHT_RESPONSE_FRACTION_BITS;
+    const I luma = V::AddII(V::AddII(V::MulI(r, LUMA_WEIGHT_R_Q15), V::MulI(g, LUMA_WEIGHT_G_Q15)),
+                            V::MulI(b, LUMA_WEIGHT_B_Q15));
+    const I position = V::ShrI(luma, response.lumaShift);
+    const I entry = V::ShrI(position, kFractionBits);
+    const I fraction = V::SubII(position, V::MulI(entry, 1 << kFractionBits));
+    const I g0 = V::GatherI(response.gain, entry);
+    const I g1 = V::GatherI(response.gain + 1, entry);
+    return V::AddII(g0, V::ShrI(V::MulII(V::SubII(g1, g0), fraction), kFractionBits));
+}
+
+// Integer depths saturate at white, as the old 8/16-bit bright worlds did.
+template <class V, int Depth, int Layout>
+void BrightRowTable(const void* srcRow, const int srcWidth, const int factor, const BrightParams&,
+                    const BrightResponse* response, float* outR, float* outG, float* outB, const int width)
+{
+    typedef typename V::F F;
+    typedef typename V::I I;
+    constexpr int L = V::LANES;
+
+    // Channel * gain is the output in Q15 with FIXED_GAIN_SHIFT fraction bits
+    const F toUnit = V::Set1(1.0f / (float)(1 << (15 + FIXED_GAIN_SHIFT)));
+    const F one = V::Set1(1.0f);
+
+    for (int x = 0; x < width; x += L) {
+        I r, g, b;
+        LoadBrightSource<V, Depth, Layout>(srcRow, srcWidth, factor, x, r, g, b);
+        const F scale = V::Mul(V::ToFloat(ResponseGain<V>(*response, r, g, b)), toUnit);
+        StoreBrightStep<V>(outR, outG, outB, x, width, V::Min(one, V::Mul(V::ToFloat(r), scale)),
+                           V::Min(one, V::Mul(V::ToFloat(g), scale)), V::Min(one, V::Mul(V::ToFloat(b), scale)));
+    }
+}
+
+// =============================================================================
+// Blend
+// =============================================================================
+// One instantiation per (depth, layout, blend operation): the operation is a
+// template argument, so each kernel contains only its own formula.
+
+template <class V, int Depth, int Layout, int Op>
+void BlendRow(const void* inRow, void* outRow, const int x0, const int x1, const GlowRow& glow,
+              const BlendParams& params)
+{
+    typedef typename V::F F;
+    typedef typename V::I I;
+    constexpr int L = V::LANES;
+    constexpr int kPixelBytes = DepthTraits<Depth>::PIXEL_BYTES;
+    constexpr bool kIntegral = Depth != DEPTH_FLOAT;
+    typedef HostPixels<V, Depth, Layout> Pixels;
+
+    const F toUnit = V::Set1(1.0f / DepthTraits<Depth>::CHANNEL_MAX);
+    const F fromUnit = V::Set1(DepthTraits<Depth>::CHANNEL_MAX);
+    const F zero = V::Set1(0.0f);
+    const F one = V::Set1(1.0f);
+    const F strength = V::Set1(params.strength);
+    const F tintR = V::Set1(params.tintR);
+    const F tintG = V::Set1(params.tintG);
+    const F tintB = V::Set1(params.tintB);
+    const int shift = FactorShift(glow.factor);
+    const int lastColumn = glow.width - 1;
+
+    for (int x = x0; x < x1; x += L) {
+        // A short last run goes through a full-width copy. Unsigned and
+        // clamped to L, so the copy sizes below are provably in range.
+        const std::size_t n = std::min((std::size_t)(x1 - x), (std::size_t)L);
+        alignas(64) unsigned char tail[L * kPixelBytes];
+        const void* in = PixelAt<Depth>(inRow, x);
+        void* out = PixelAt<Depth>(outRow, x);
+        if (n < L) {
+            std::memcpy(tail, in, n * kPixelBytes);
+            std::memset(tail + n * kPixelBytes, 0, (L - n) * kPixelBytes);
+            in = out = tail;
+        }
+
+        F a, r, g, b;
+        Pixels::Load(in, a, r, g, b);
+        r = V::Mul(r, toUnit);
+        g = V::Mul(g, toUnit);
+        b = V::Mul(b, toUnit);
+        if (!kIntegral) {
+            // Clamp the base first so HDR input (> 1) cannot turn the screen negative
+            // (and every mode leaves the input as is under black glow)
+            r = V::Min(one, V::Max(zero, r));
+            g = V::Min(one, V::Max(zero, g));
+            b = V::Min(one, V::Max(zero, b));
+        }
+
+        I gx;
+        if (shift >= 0) {
+            gx = V::ShrI(V::Ramp(x + glow.offsetX), shift);
+        } else {
+            alignas(64) int columns[L];
+            for (int i = 0; i < L; ++i) columns[i] = (x + i + glow.offsetX) / glow.factor;
+            gx = V::LoadI(columns);
+        }
+        gx = V::MinI(gx, lastColumn);
+        const int start = (x + glow.offsetX) / glow.factor;
+        const bool window = start + L <= glow.width;
+
+        const F gR = V::Mul(V::Mul(V::Gather(glow.r, gx, start, window), strength), tintR);
+        const F gG = V::Mul(V::Mul(V::Gather(glow.g, gx, start, window), strength), tintG);
+        const F gB = V::Mul(V::Mul(V::Gather(glow.b, gx, start, window), strength), tintB);
+
+        F oR, oG, oB;
+        if constexpr (Op == BLEND_SCREEN) {
+            oR = V::Sub(one, V::Mul(V::Sub(one, r), V::Sub(one, gR)));
+            oG = V::Sub(one, V::Mul(V::Sub(one, g), V::Sub(one, gG)));
+            oB = V::Sub(one, V::Mul(V::Sub(one, b), V::Sub(one, gB)));
+        } else if constexpr (Op == BLEND_ADD) {
+            oR = V::Add(r, gR);
+            oG = V::Add(g, gG);
+            oB = V::Add(b, gB);
+        } else {
+            // Premultiplied over: the brightest channel is the glow's coverage
+            const F keep = V::Sub(one, V::Min(one, V::Max(V::Max(gR, gG), gB)));
+            oR = V::Add(gR, V::Mul(r, keep));
+            oG = V::Add(gG, V::Mul(g, keep));
+            oB = V::Add(gB, V::Mul(b, keep));
+        }
+        // Hard clamp to display white (and keep integer depths in range)
+        oR = V::Min(one, V::Max(zero, oR));
+        oG = V::Min(one, V::Max(zero, oG));
+        oB = V::Min(one, V::Max(zero, oB));
+        if (kIntegral) {
+            oR = V::Mul(oR, fromUnit);
+            oG = V::Mul(oG, fromUnit);
+            oB = V::Mul(oB, fromUnit);
+        }
+        Pixels::Store(out, a, oR, oG, oB);
+
+        if (n < L) std::memcpy(PixelAt<Depth>(outRow, x), tail, n * kPixelBytes);
+    }
+}
+
+// =============================================================================
+// Pyramid Upsample
+// =============================================================================
+
+template <class V>
+void UpsampleRow(const LiteGlowBlur::PlaneF& coarse, const float coarseWeight,
+                 const LiteGlowBlur::PlaneF& fine, const float fineWeight, const int y)
+{
+    typedef typename V::F F;
+    typedef typename V::I I;
+    constexpr int L = V::LANES;
+
+    // Row terms are the same for every column
+    float cyS = (y + 0.5f) * 0.5f - 0.5f;
+    const float maxY = (float)(coarse.height - 1);
+    cyS = cyS < 0.0f ? 0.0f : (maxY < cyS ? maxY : cyS);
+    const int y0 = (int)cyS;
+    const int y1 = y0 + 1 < coarse.height ? y0 + 1 : coarse.height - 1;
+    const F fy = V::Set1(cyS - (float)y0);
+    const float* c0 = coarse.data + (std::ptrdiff_t)y0 * coarse.stride;
+    const float* c1 = coarse.data + (std::ptrdiff_t)y1 * coarse.stride;
+    float* out = fine.data + (std::ptrdiff_t)y * fine.stride;
+
+    const F half = V::Set1(0.5f);
+    const F zero = V::Set1(0.0f);
+    const F maxX = V::Set1((float)(coarse.width - 1));
+    const F wCoarse = V::Set1(coarseWeight);
+    const F wFine = V::Set1(fineWeight);
+
+    for (int x = 0; x < fine.width; x += L) {
+        const F cx = V::Min(maxX, V::Max(V::Sub(V::Mul(V::Add(V::ToFloat(V::Ramp(x)), half), half), half), zero));
+        const I x0 = V::Truncate(cx);
+        const I x1 = V::MinI(V::AddI(x0, 1), coarse.width - 1);
+        const F fx = V::Sub(cx, V::ToFloat(x0));
+
+        // Lanes cover coarse columns [start, start + L / 2 + 1]
+        const float cxStart = ((float)x + 0.5f) * 0.5f - 0.5f;
+        const int start = cxStart < 0.0f ? 0 : (int)cxStart;
+        const bool window = start + L <= coarse.width;
+
+        const F tl = V::Gather(c0, x0, start, window);
+        const F tr = V::Gather(c0, x1, start, window);
+        const F bl = V::Gather(c1, x0, start, window);
+        const F br = V::Gather(c1, x1, start, window);
+        const F top = V::Add(tl, V::Mul(fx, V::Sub(tr, tl)));
+        const F bottom = V::Add(bl, V::Mul(fx, V::Sub(br, bl)));
+
+        if (x + L <= fine.width) {
+            const F prev = V::Load(out + x);
+            V::Store(out + x, V::Add(V::Mul(wFine, prev), V::Mul(wCoarse, V::Add(top, V::Mul(fy, V::Sub(bottom, top))))));
+        } else {
+            float tail[L] = {};
+            std::memcpy(tail, out + x, (std::size_t)(fine.width - x) * sizeof(float));
+            const F prev = V::Load(tail);
+            V::Store(tail, V::Add(V::Mul(wFine, prev), V::Mul(wCoarse, V::Add(top, V::Mul(fy, V::Sub(bottom, top))))));
+            std::memcpy(out + x, tail, (std::size_t)(fine.width - x) * sizeof(float));
+        }
+    }
+}
+
+// =============================================================================
+// Fixed-Point Bright Pass and Blend
+// =============================================================================
+// Integer versions of the two kernels above (see Fixed-Point Kernels in
+// LiteGlow_Simd.h). Every product stays below 2^31: channels are at most
+// 32768, and BuildBrightResponse and GlowGain bound the gains to match.
+
+template <class V, int Depth, int Layout>
+void BrightRowQ15(const void* srcRow, const int srcWidth, const int factor, const BrightResponse& response,
+                  std::uint16_t* outR, std::uint16_t* outG, std::uint16_t* outB, const int width)
+{
+    typedef typename V::I I;
+    constexpr int L = V::LANES;
+    constexpr int kRound = 1 << (FIXED_GAIN_SHIFT - 1);
+
+    for (int x = 0; x < width; x += L) {
+        I r, g, b;
+        LoadBrightSource<V, Depth, Layout>(srcRow, srcWidth, factor, x, r, g, b);
+        const I gain = ResponseGain<V>(response, r, g, b);
+        const I oR = V::MinI(V::ShrI(V::AddI(V::MulII(r, gain), kRound), FIXED_GAIN_SHIFT), LiteGlowBlur::PLANAR_Q15_ONE);
+        const I oG = V::MinI(V::ShrI(V::AddI(V::MulII(g, gain), kRound), FIXED_GAIN_SHIFT), LiteGlowBlur::PLANAR_Q15_ONE);
+        const I oB = V::MinI(V::ShrI(V::AddI(V::MulII(b, gain), kRound), FIXED_GAIN_SHIFT), LiteGlowBlur::PLANAR_Q15_ONE);
+
+        if (x + L <= width) {
+            V::StoreU16(outR + x, oR);
+            V::StoreU16(outG + x, oG);
+            V::StoreU16(outB + x, oB);
+        } else {
+            std::uint16_t tail[3][L];
+            V::StoreU16(tail[0], oR);
+            V::StoreU16(tail[1], oG);
+            V::StoreU16(tail[2], oB);
+            const std::size_t bytes = (std::size_t)(width - x) * sizeof(std::uint16_t);
+            std::memcpy(outR + x, tail[0], bytes);
+            std::memcpy(outG + x, tail[1], bytes);
+            std::memcpy(outB + x, tail[2], bytes);
+        }
+    }
+}
+
+// Strength x tint with FIXED_GAIN_SHIFT fraction bits, capped so that
+// glow * gain fits in 31 bits.
+inline int GlowGain(const float strength, const float tint) {
+    const float gain = strength * tint * (float)(1 << FIXED_GAIN_SHIFT) + 0.5f;
+    return gain <= 0.0f ? 0 : (gain >= 65535.0f ? 65535 : (int)gain);
+}
+
+template <class V, int Depth, int Layout, int Op>
+void BlendRowQ15(const void* inRow, void* outRow, const int x0, const int x1, const GlowRowQ15& glow,
+                 const BlendParams& params)
+{
+    typedef typename V::I I;
+    constexpr int L = V::LANES;
+    constexpr int kPixelBytes = DepthTraits<Depth>::PIXEL_BYTES;
+    constexpr int kChannelMax = (int)DepthTraits<Depth>::CHANNEL_MAX;
+    constexpr int kRound = 1 << (FIXED_GAIN_SHIFT - 1);
+    typedef HostPixels<V, Depth, Layout> Pixels;
+
+    const int gainR = GlowGain(params.strength, params.tintR);
+    const int gainG = GlowGain(params.strength, params.tintG);
+    const int gainB = GlowGain(params.strength, params.tintB);
+    const I channelMax = V::Set1I(kChannelMax);
+    const int shift = FactorShift(glow.factor);
+    const int lastColumn = glow.width - 1;
+
+    for (int x = x0; x < x1; x += L) {
+        // A short last run goes through a full-width copy. Unsigned and
+        // clamped to L, so the copy sizes below are provably in range.
+        const std::size_t n = std::min((std::size_t)(x1 - x), (std::size_t)L);
+        alignas(64) unsigned char tail[L * kPixelBytes];
+        const void* in = PixelAt<Depth>(inRow, x);
+        void* out = PixelAt<Depth>(outRow, x);
+        if (n < L) {
+            std::memcpy(tail, in, n * kPixelBytes);
+            std::memset(tail + n * kPixelBytes, 0, (L - n) * kPixelBytes);
+            in = out = tail;
+        }
+
+        I a, r, g, b;
+        Pixels::LoadI(in, a, r, g, b);
+
+        I gx;
+        if (shift >= 0) {
+            gx = V::ShrI(V::Ramp(x + glow.offsetX), shift);
+        } else {
+            alignas(64) int columns[L];
+            for (int i = 0; i < L; ++i) columns[i] = (x + i + glow.offsetX) / glow.factor;
+            gx = V::LoadI(columns);
+        }
+        gx = V::MinI(gx, lastColumn);
+        const int start = (x + glow.offsetX) / glow.factor;
+        const bool window = start + L <= glow.width;
+
+        // Glow times strength and tint, saturated at white (Q15)
+        const I gR = V::MinI(V::ShrI(V::AddI(V::MulI(V::GatherU16(glow.r, gx, start, window), gainR), kRound),
+                                     FIXED_GAIN_SHIFT), LiteGlowBlur::PLANAR_Q15_ONE);
+        const I gG = V::MinI(V::ShrI(V::AddI(V::MulI(V::GatherU16(glow.g, gx, start, window), gainG), kRound),
+                                     FIXED_GAIN_SHIFT), LiteGlowBlur::PLANAR_Q15_ONE);
+        const I gB = V::MinI(V::ShrI(V::AddI(V::MulI(V::GatherU16(glow.b, gx, start, window), gainB), kRound),
+                                     FIXED_GAIN_SHIFT), LiteGlowBlur::PLANAR_Q15_ONE);
+
+        // Clamped to white like the float kernel
+        I oR, oG, oB;
+        if constexpr (Op == BLEND_SCREEN) {
+            // in + (max - in) * glow
+            oR = V::AddII(r, V::ShrI(V::MulII(V::SubII(channelMax, r), gR), 15));
+            oG = V::AddII(g, V::ShrI(V::MulII(V::SubII(channelMax, g), gG), 15));
+            oB = V::AddII(b, V::ShrI(V::MulII(V::SubII(channelMax, b), gB), 15));
+        } else if constexpr (Op == BLEND_ADD) {
+            // in + max * glow
+            oR = V::AddII(r, V::ShrI(V::MulI(gR, kChannelMax), 15));
+            oG = V::AddII(g, V::ShrI(V::MulI(gG, kChannelMax), 15));
+            oB = V::AddII(b, V::ShrI(V::MulI(gB, kChannelMax), 15));
+        } else {
+            // max * glow + in * (1 - coverage)
+            const I keep = V::SubII(V::Set1I(LiteGlowBlur::PLANAR_Q15_ONE), V::MaxII(V::MaxII(gR, gG), gB));
+            oR = V::AddII(V::ShrI(V::MulI(gR, kChannelMax), 15), V::ShrI(V::MulII(r, keep), 15));
+            oG = V::AddII(V::ShrI(V::MulI(gG, kChannelMax), 15), V::ShrI(V::MulII(g, keep), 15));
+            oB = V::AddII(V::ShrI(V::MulI(gB, kChannelMax), 15), V::ShrI(V::MulII(b, keep), 15));
+        }
+        Pixels::StoreI(out, a, V::MinI(oR, kChannelMax), V::MinI(oG, kChannelMax), V::MinI(oB, kChannelMax));
+
+        if (n < L) std::memcpy(PixelAt<Depth>(outRow, x), tail, n * kPixelBytes);
+    }
+}
+
+// =============================================================================
+// HLSL Pipeline Kernels
+// =============================================================================
+// The GPU shaders, pixel for pixel (see HLSL Pipeline Kernels in
+// LiteGlow_Simd.h). Their buffers are rows of float pixels, ARGB here;
+// the blurs treat a row as 4 * width floats, since every channel gets the
+// same filter.
+
+constexpr float HLSL_KNEE = 0.1f;
+constexpr float HLSL_BLUR_WEIGHTS[HLSL_BLUR_TAPS] = { 0.050f, 0.090f, 0.120f, 0.150f, 0.180f,
+                                                      0.150f, 0.120f, 0.090f, 0.050f };
+
+// Lanes whose four channels are all finite: x - x is 0 for finite x and NaN
+// otherwise, and NaN fails every comparison.
+template <class V>
+inline typename V::M AllFinite(const typename V::F a, const typename V::F r, const typename V::F g,
+                               const typename V::F b)
+{
+    const typename V::F sum = V::Add(V::Add(V::Sub(a, a), V::Sub(r, r)), V::Add(V::Sub(g, g), V::Sub(b, b)));
+    return V::CmpLE(sum, V::Set1(0.0f));
+}
+
+// The shaders' LoadF4: a pixel with a non-finite channel reads as (0, 0, 0, 1).
+template <class V>
+inline void FiniteOrBlack(typename V::F& a, typename V::F& r, typename V::F& g, typename V::F& b)
+{
+    const typename V::M finite = AllFinite<V>(a, r, g, b);
+    const typename V::F zero = V::Set1(0.0f);
+    a = V::Select(finite, a, V::Set1(1.0f));
+    r = V::Select(finite, r, zero);
+    g = V::Select(finite, g, zero);
+    b = V::Select(finite, b, zero);
+}
+
+// Pixels [x, x + LANES) of an intermediate row, as every later pass will
+// load them; the last step of a row may be short.
+template <class V>
+inline void StoreHlslPixels(float* row, const int x, const int width, typename V::F a, typename V::F r,
+                            typename V::F g, typename V::F b)
+{
+    constexpr int L = V::LANES;
+    FiniteOrBlack<V>(a, r, g, b);
+    if (x + L <= width) {
+        V::template StorePixels<DEPTH_FLOAT>(row + 4 * (std::ptrdiff_t)x, a, r, g, b);
+    } else {
+        float tail[4 * L];
+        V::template StorePixels<DEPTH_FLOAT>(tail, a, r, g, b);
+        std::memcpy(row + 4 * (std::ptrdiff_t)x, tail, (std::size_t)(width - x) * 4 * sizeof(float));
+    }
+}
+
+// After a blur row: pixels the sums overflowed in read as (0, 0, 0, 1).
+// Rare (the weights sum to 1), so the blurs only note that it happened.
+inline void FixNonFinitePixels(float* row, const int width)
+{
+    for (int x = 0; x < width; ++x) {
+        float* p = row + 4 * (std::ptrdiff_t)x;
+        if (!(p[0] - p[0] == 0.0f && p[1] - p[1] == 0.0f && p[2] - p[2] == 0.0f && p[3] - p[3] == 0.0f)) {
+            p[0] = 1.0f;
+            p[1] = p[2] = p[3] = 0.0f;
+        }
+    }
+}
+
+// Whether any lane of `check` (sums of x - x) saw a non-finite value.
+template <class V>
+inline bool AnyNonFinite(const typename V::F check)
+{
+    float lanes[V::LANES];
+    V::Store(lanes, check);
+    for (int i = 0; i < V::LANES; ++i) {
+        if (!(lanes[i] == 0.0f)) return true;
+    }
+    return false;
+}
+
+template <class V, int Depth, int Layout>
+void HlslBrightRow(const void* const* srcRows, const int srcWidth, const int factor, const HlslBrightParams& params,
+                   float* out, const int width)
+{
+    typedef typename V::F F;
+    typedef typename V::I I;
+    constexpr int L = V::LANES;
+    typedef HostPixels<V, Depth, Layout> Pixels;
+
+    const F toUnit = V::Set1(1.0f / DepthTraits<Depth>::CHANNEL_MAX);
+    const F zero = V::Set1(0.0f);
+    const F one = V::Set1(1.0f);
+    const F two = V::Set1(2.0f);
+    const F three = V::Set1(3.0f);
+    const F invCount = V::Set1(1.0f / (float)(factor * factor));
+    const F threshold = V::Set1(params.threshold);
+    const F intensity = V::Set1(params.intensity);
+    const float t0S = params.threshold - HLSL_KNEE;
+    const float t1S = params.threshold + HLSL_KNEE;
+    const F t0 = V::Set1(t0S);
+    const F t1 = V::Set1(t1S);
+    const F kneeRange = V::Set1(t1S - t0S);
+
+    for (int x = 0; x < width; x += L) {
+        // Box average, rows outer and columns inner like the shader
+        F a = zero, r = zero, g = zero, b = zero;
+        for (int j = 0; j < factor; ++j) {
+            for (int i = 0; i < factor; ++i) {
+                F pa, pr, pg, pb;
+                if (factor == 1 && x + L <= srcWidth) {
+                    Pixels::Load(PixelAt<Depth>(srcRows[j], x), pa, pr, pg, pb);
+                } else {
+                    const I idx = V::MinI(V::AddI(V::MulI(V::Ramp(x), factor), i), srcWidth - 1);
+                    Pixels::Gather(srcRows[j], idx, pa, pr, pg, pb);
+                }
+                if constexpr (Depth == DEPTH_FLOAT) {
+                    FiniteOrBlack<V>(pa, pr, pg, pb);
+                } else {
+                    pa = V::Mul(pa, toUnit);
+                    pr = V::Mul(pr, toUnit);
+                    pg = V::Mul(pg, toUnit);
+                    pb = V::Mul(pb, toUnit);
+                }
+                a = V::Add(a, pa);
+                r = V::Add(r, pr);
+                g = V::Add(g, pg);
+                b = V::Add(b, pb);
+            }
+        }
+        a = V::Mul(a, invCount);
+        r = V::Mul(r, invCount);
+        g = V::Mul(g, invCount);
+        b = V::Mul(b, invCount);
+        a = V::Select(V::CmpLE(V::Sub(a, a), zero), a, one);
+
+        const F luma = V::Add(V::Add(V::Mul(r, V::Set1(0.299f)), V::Mul(g, V::Set1(0.587f))),
+                              V::Mul(b, V::Set1(0.114f)));
+        const F excess = V::Sub(luma, threshold);
+        const F t = V::Div(V::Sub(luma, t0), kneeRange);
+        F contribution = V::Mul(V::Mul(V::Mul(t, t), V::Sub(three, V::Mul(two, t))), V::Max(excess, zero));
+        contribution = V::Select(V::CmpGE(luma, t1), excess, contribution);
+        contribution = V::Select(V::CmpGT(luma, t0), contribution, zero);
+
+        const typename V::M lit = V::CmpGT(contribution, zero);
+        const F scale = V::Mul(intensity, contribution);
+        StoreHlslPixels<V>(out, x, width, a, V::Select(lit, V::Mul(r, scale), zero),
+                           V::Select(lit, V::Mul(g, scale), zero), V::Select(lit, V::Mul(b, scale), zero));
+    }
+}
+
+// One float of a blurred row from its HLSL_BLUR_TAPS tap values.
+template <class V>
+inline typename V::F BlurTaps(const typename V::F (&taps)[HLSL_BLUR_TAPS])
+{
+    typename V::F sum = V::Mul(taps[0], V::Set1(HLSL_BLUR_WEIGHTS[0]));
+    for (int k = 1; k < HLSL_BLUR_TAPS; ++k) sum = V::Add(sum, V::Mul(taps[k], V::Set1(HLSL_BLUR_WEIGHTS[k])));
+    return sum;
+}
+
+// Horizontal blur of floats [i0, i1) of the row (4 per pixel), every tap
+// inside the row. Adds x - x of every result to `check` / `checkS`.
+template <class V>
+void HlslBlurSpanH(const float* in, float* out, const int i0, const int i1, const int step,
+                   typename V::F& check, float& checkS)
+{
+    typedef typename V::F F;
+    constexpr int L = V::LANES;
+    constexpr int kReach = HLSL_BLUR_TAPS / 2;
+    int i = i0;
+    for (; i + L <= i1; i += L) {
+        F taps[HLSL_BLUR_TAPS];
+        for (int k = 0; k < HLSL_BLUR_TAPS; ++k) taps[k] = V::Load(in + i + 4 * (std::ptrdiff_t)(k - kReach) * step);
+        const F sum = BlurTaps<V>(taps);
+        V::Store(out + i, sum);
+        check = V::Add(check, V::Sub(sum, sum));
+    }
+    for (; i < i1; ++i) {
+        float sum = in[i - 4 * (std::ptrdiff_t)kReach * step] * HLSL_BLUR_WEIGHTS[0];
+        for (int k = 1; k < HLSL_BLUR_TAPS; ++k) {
+            sum += in[i + 4 * (std::ptrdiff_t)(k - kReach) * step] * HLSL_BLUR_WEIGHTS[k];
+        }
+        out[i] = sum;
+        checkS += sum - sum;
+    }
+}
+
+// Pixel x of a blurred row, with its taps clamped to the row.
+inline void HlslBlurEdgePixelH(const float* in, float* out, const int x, const int width, const int step,
+                               float& checkS)
+{
+    constexpr int kReach = HLSL_BLUR_TAPS / 2;
+    for (int c = 0; c < 4; ++c) {
+        float sum = 0.0f;
+        for (int k = 0; k < HLSL_BLUR_TAPS; ++k) {
+            int sx = x + (k - kReach) * step;
+            sx = sx < 0 ? 0 : (sx > width - 1 ? width - 1 : sx);
+            const float tap = in[4 * (std::ptrdiff_t)sx + c] * HLSL_BLUR_WEIGHTS[k];
+            sum = k == 0 ? tap : sum + tap;
+        }
+        out[4 * (std::ptrdiff_t)x + c] = sum;
+        checkS += sum - sum;
+    }
+}
+
+template <class V>
+void HlslBlurRowH(const float* in, float* out, const int width, const int step)
+{
+    constexpr int kReach = HLSL_BLUR_TAPS / 2;
+    // Pixels whose taps all fall inside the row go through the vector loop
+    const int inner0 = kReach * step < width ? kReach * step : width;
+    const int inner1 = width - kReach * step > inner0 ? width - kReach * step : inner0;
+    typename V::F check = V::Set1(0.0f);
+    float checkS = 0.0f;
+    HlslBlurSpanH<V>(in, out, 4 * inner0, 4 * inner1, step, check, checkS);
+    for (int x = 0; x < inner0; ++x) HlslBlurEdgePixelH(in, out, x, width, step, checkS);
+    for (int x = inner1; x < width; ++x) HlslBlurEdgePixelH(in, out, x, width, step, checkS);
+    if (AnyNonFinite<V>(check) || !(checkS == 0.0f)) FixNonFinitePixels(out, width);
+}
+
+template <class V>
+void HlslBlurRowV(const float* const* inRows, float* out, const int width)
+{
+    typedef typename V::F F;
+    constexpr int L = V::LANES;
+    const int n = 4 * width;
+    F check = V::Set1(0.0f);
+    float checkS = 0.0f;
+    int i = 0;
+    for (; i + L <= n; i += L) {
+        F taps[HLSL_BLUR_TAPS];
+        for (int k = 0; k < HLSL_BLUR_TAPS; ++k) taps[k] = V::Load(inRows[k] + i);
+        const F sum = BlurTaps<V>(taps);
+        V::Store(out + i, sum);
+        check = V::Add(check, V::Sub(sum, sum));
+    }
+    for (; i < n; ++i) {
+        float sum = inRows[0][i] * HLSL_BLUR_WEIGHTS[0];
+        for (int k = 1; k < HLSL_BLUR_TAPS; ++k) sum += inRows[k][i] * HLSL_BLUR_WEIGHTS[k];
+        out[i] = sum;
+        checkS += sum - sum;
+    }
+    if (AnyNonFinite<V>(check) || !(checkS == 0.0f)) FixNonFinitePixels(out, width);
+}
+
+// e^x for x <= 0 (Cephes expf): x = n ln2 + r with |r| <= ln2 / 2, a
+// degree-7 polynomial for e^r, and 2^n built in the exponent bits. Below
+// -87 (where e^x leaves the normal range) it returns e^-87.
+template <class V>
+inline typename V::F ExpNonPositive(typename V::F x)
+{
+    typedef typename V::F F;
+    x = V::Max(x, V::Set1(-87.0f));
+    // Rounded to nearest: x * log2(e) is <= 0, and Truncate rounds toward zero
+    const typename V::I n = V::Truncate(V::Sub(V::Mul(x, V::Set1(1.44269504088896341f)), V::Set1(0.5f)));
+    const F nf = V::ToFloat(n);
+    const F r = V::Sub(V::Sub(x, V::Mul(nf, V::Set1(0.693359375f))), V::Mul(nf, V::Set1(-2.12194440e-4f)));
+    F p = V::Set1(1.9875691500e-4f);
+    p = V::Add(V::Mul(p, r), V::Set1(1.3981999507e-3f));
+    p = V::Add(V::Mul(p, r), V::Set1(8.3334519073e-3f));
+    p = V::Add(V::Mul(p, r), V::Set1(4.1665795894e-2f));
+    p = V::Add(V::Mul(p, r), V::Set1(1.6666665459e-1f));
+    p = V::Add(V::Mul(p, r), V::Set1(5.0000001201e-1f));
+    p = V::Add(V::Add(V::Mul(V::Mul(p, r), r), r), V::Set1(1.0f));
+    return V::Mul(p, V::Pow2(n));
+}
+
+// Linear interpolation as HLSL's lerp: a + t * (b - a).
+template <class V>
+inline typename V::F Lerp(const typename V::F a, const typename V::F b, const typename V::F t)
+{
+    return V::Add(a, V::Mul(t, V::Sub(b, a)));
+}
+
+template <class V, int Depth, int Layout, int Op>
+void HlslBlendRow(const void* inRow, void* outRow, const int x0, const int x1, const HlslGlowRows& glow,
+                  const BlendParams& params)
+{
+    typedef typename V::F F;
+    typedef typename V::I I;
+    constexpr int L = V::LANES;
+    constexpr int kPixelBytes = DepthTraits<Depth>::PIXEL_BYTES;
+    constexpr bool kIntegral = Depth != DEPTH_FLOAT;
+    typedef HostPixels<V, Depth, Layout> Pixels;
+
+    const F toUnit = V::Set1(1.0f / DepthTraits<Depth>::CHANNEL_MAX);
+    const F fromUnit = V::Set1(DepthTraits<Depth>::CHANNEL_MAX);
+    const F zero = V::Set1(0.0f);
+    const F one = V::Set1(1.0f);
+    const F half = V::Set1(0.5f);
+    const F factor = V::Set1((float)glow.factor);
+    const F fy = V::Set1(glow.fy);
+    const F strength = V::Set1(params.strength);
+    const F tintR = V::Set1(params.tintR);
+    const F tintG = V::Set1(params.tintG);
+    const F tintB = V::Set1(params.tintB);
+    const int lastColumn = glow.width - 1;
+
+    for (int x = x0; x < x1; x += L) {
+        // A short last run goes through a full-width copy. Unsigned and
+        // clamped to L, so the copy sizes below are provably in range.
+        const std::size_t n = std::min((std::size_t)(x1 - x), (std::size_t)L);
+        alignas(64) unsigned char tail[L * kPixelBytes];
+        const void* in = PixelAt<Depth>(inRow, x);
+        void* out = PixelAt<Depth>(outRow, x);
+        if (n < L) {
+            std::memcpy(tail, in, n * kPixelBytes);
+            std::memset(tail + n * kPixelBytes, 0, (L - n) * kPixelBytes);
+            in = out = tail;
+        }
+
+        F a, r, g, b;
+        Pixels::Load(in, a, r, g, b);
+        if (kIntegral) {
+            r = V::Mul(r, toUnit);
+            g = V::Mul(g, toUnit);
+            b = V::Mul(b, toUnit);
+        } else {
+            FiniteOrBlack<V>(a, r, g, b);
+        }
+
+        // Bilinear taps around the sample point, from the phase of the
+        // column in its glow pixel as the shader's GlowTap: the glow pixel
+        // at or left of the centre, clamped to the row, and the centre's
+        // offset past it (0 left of the first centre). Integers stay exact
+        // in floats here.
+        const F sx = V::ToFloat(V::Ramp(x + glow.offsetX));
+        const F cell = V::ToFloat(V::Truncate(V::Div(V::Add(sx, half), factor)));
+        const F p = V::Sub(V::Div(V::Add(V::Sub(sx, V::Mul(cell, factor)), half), factor), half);
+        const typename V::M before = V::CmpGT(zero, p);
+        const F left = V::Sub(cell, V::Select(before, one, zero));
+        const I c0 = V::MinI(V::Truncate(V::Max(left, zero)), lastColumn);
+        const I c1 = V::MinI(V::AddI(c0, 1), lastColumn);
+        const F fx = V::Select(V::CmpGE(left, zero), V::Min(one, V::Select(before, V::Add(p, one), p)), zero);
+        F a00, r00, g00, b00, a10, r10, g10, b10, a01, r01, g01, b01, a11, r11, g11, b11;
+        V::template GatherPixels<DEPTH_FLOAT>(glow.row0, c0, a00, r00, g00, b00);
+        V::template GatherPixels<DEPTH_FLOAT>(glow.row0, c1, a10, r10, g10, b10);
+        V::template GatherPixels<DEPTH_FLOAT>(glow.row1, c0, a01, r01, g01, b01);
+        V::template GatherPixels<DEPTH_FLOAT>(glow.row1, c1, a11, r11, g11, b11);
+        const F glowA = Lerp<V>(Lerp<V>(a00, a10, fx), Lerp<V>(a01, a11, fx), fy);
+        F glowR = Lerp<V>(Lerp<V>(r00, r10, fx), Lerp<V>(r01, r11, fx), fy);
+        F glowG = Lerp<V>(Lerp<V>(g00, g10, fx), Lerp<V>(g01, g11, fx), fy);
+        F glowB = Lerp<V>(Lerp<V>(b00, b10, fx), Lerp<V>(b01, b11, fx), fy);
+        const typename V::M glowFinite = AllFinite<V>(glowA, glowR, glowG, glowB);
+        glowR = V::Select(glowFinite, glowR, zero);
+        glowG = V::Select(glowFinite, glowG, zero);
+        glowB = V::Select(glowFinite, glowB, zero);
+
+        // g = (1 - exp(-max(0, glow * strength))) * tint
+        const F gR = V::Mul(V::Sub(one, ExpNonPositive<V>(V::Sub(zero, V::Max(V::Mul(glowR, strength), zero)))), tintR);
+        const F gG = V::Mul(V::Sub(one, ExpNonPositive<V>(V::Sub(zero, V::Max(V::Mul(glowG, strength), zero)))), tintG);
+        const F gB = V::Mul(V::Sub(one, ExpNonPositive<V>(V::Sub(zero, V::Max(V::Mul(glowB, strength), zero)))), tintB);
+        r = V::Min(one, V::Max(r, zero));
+        g = V::Min(one, V::Max(g, zero));
+        b = V::Min(one, V::Max(b, zero));
+
+        F oR, oG, oB;
+        if constexpr (Op == BLEND_SCREEN) {
+            oR = V::Sub(one, V::Mul(V::Sub(one, r), V::Sub(one, gR)));
+            oG = V::Sub(one, V::Mul(V::Sub(one, g), V::Sub(one, gG)));
+            oB = V::Sub(one, V::Mul(V::Sub(one, b), V::Sub(one, gB)));
+        } else if constexpr (Op == BLEND_ADD) {
+            oR = V::Add(r, gR);
+            oG = V::Add(g, gG);
+            oB = V::Add(b, gB);
+        } else {
+            const F keep = V::Sub(one, V::Min(one, V::Max(V::Max(gR, gG), gB)));
+            oR = V::Add(gR, V::Mul(r, keep));
+            oG = V::Add(gG, V::Mul(g, keep));
+            oB = V::Add(gB, V::Mul(b, keep));
+        }
+        const typename V::M outFinite = AllFinite<V>(zero, oR, oG, oB);
+        oR = V::Min(one, V::Max(V::Select(outFinite, oR, zero), zero));
+        oG = V::Min(one, V::Max(V::Select(outFinite, oG, zero), zero));
+        oB = V::Min(one, V::Max(V::Select(outFinite, oB, zero), zero));
+        if (kIntegral) {
+            // Integer alpha is in range already and passes through unscaled
+            oR = V::Mul(oR, fromUnit);
+            oG = V::Mul(oG, fromUnit);
+            oB = V::Mul(oB, fromUnit);
+        } else {
+            a = V::Min(one, V::Max(a, zero));
+        }
+        Pixels::Store(out, a, oR, oG, oB);
+
+        if (n < L) std::memcpy(PixelAt<Depth>(outRow, x), tail, n * kPixelBytes);
+    }
+}
+
+// =============================================================================
+// Kernel Table
+// =============================================================================
+
+template <class V, int Layout, int Op>
+constexpr void AddBlendKernels(PixelKernels& k) {
+    k.blend[Op][Layout][DEPTH_8] = BlendRow<V, DEPTH_8, Layout, Op>;
+    k.blend[Op][Layout][DEPTH_16] = BlendRow<V, DEPTH_16, Layout, Op>;
+    k.blend[Op][Layout][DEPTH_FLOAT] = BlendRow<V, DEPTH_FLOAT, Layout, Op>;
+    k.blendQ15[Op][Layout][DEPTH_8] = BlendRowQ15<V, DEPTH_8, Layout, Op>;
+    k.blendQ15[Op][Layout][DEPTH_16] = BlendRowQ15<V, DEPTH_16, Layout, Op>;
+    k.hlslBlend[Op][Layout][DEPTH_8] = HlslBlendRow<V, DEPTH_8, Layout, Op>;
+    k.hlslBlend[Op][Layout][DEPTH_16] = HlslBlendRow<V, DEPTH_16, Layout, Op>;
+    k.hlslBlend[Op][Layout][DEPTH_FLOAT] = HlslBlendRow<V, DEPTH_FLOAT, Layout, Op>;
+}
+
+template <class V, int Layout>
+constexpr void AddLayoutKernels(PixelKernels& k) {
+    k.bright[Layout][DEPTH_8] = BrightRowTable<V, DEPTH_8, Layout>;
+    k.bright[Layout][DEPTH_16] = BrightRowTable<V, DEPTH_16, Layout>;
+    k.bright[Layout][DEPTH_FLOAT] = BrightRow<V, Layout>;
+    k.brightQ15[Layout][DEPTH_8] = BrightRowQ15<V, DEPTH_8, Layout>;
+    k.brightQ15[Layout][DEPTH_16] = BrightRowQ15<V, DEPTH_16, Layout>;
+    k.hlslBright[Layout][DEPTH_8] = HlslBrightRow<V, DEPTH_8, Layout>;
+    k.hlslBright[Layout][DEPTH_16] = HlslBrightRow<V, DEPTH_16, Layout>;
+    k.hlslBright[Layout][DEPTH_FLOAT] = HlslBrightRow<V, DEPTH_FLOAT, Layout>;
+    AddBlendKernels<V, Layout, BLEND_SCREEN>(k);
+    AddBlendKernels<V, Layout, BLEND_ADD>(k);
+    AddBlendKernels<V, Layout, BLEND_NORMAL>(k);
+}
+
+// Every entry is an instantiation fixed at compile time, so the tables are
+// constant data with no initialization at load or first use.
+template <class V>
+constexpr PixelKernels MakeKernels(const Isa isa) {
+    PixelKernels k{};
+    k.isa = isa;
+    AddLayoutKernels<V, LAYOUT_ARGB>(k);
+    AddLayoutKernels<V, LAYOUT_BGRA>(k);
+    k.upsample = UpsampleRow<V>;
+    k.hlslBlurH = HlslBlurRowH<V>;
+    k.hlslBlurV = HlslBlurRowV<V>;
+    return k;
+}
+
+} // namespace
+} // namespace LiteGlowSimd
+
+#endif // LITEGLOW_SIMDKERNELS_H
@@ -0,0 +1,263 @@
+/*	LiteGlow_Simd_AVX2.cpp
+
+	Pixel kernels for AVX2, 8 pixels per step.
+	See LiteGlow_Simd.h for the model.
+
+*/
+
+#include "LiteGlow_Simd.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+// Only the code below may use AVX2; the rest of the plugin keeps the
+// project's baseline instruction set. MSVC accepts the intrinsics without a
+// per-file /arch switch.
+#if defined(__clang__)
+    #pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+    #pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx2")
+    #pragma GCC optimize("fp-contract=off")
+#endif
+
+#include "LiteGlow_SimdKernels.h"
+
+namespace LiteGlowSimd {
+namespace {
+
+struct Avx2Ops {
+    typedef __m256 F;
+    typedef __m256i I;
+    typedef __m256 M;
+    static constexpr int LANES = 8;
+
+    static F Set1(const float v) { return _mm256_set1_ps(v); }
+    static F Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, const F v) { _mm256_storeu_ps(p, v); }
+    static F Add(const F a, const F b) { return _mm256_add_ps(a, b); }
+    static F Sub(const F a, const F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(const F a, const F b) { return _mm256_mul_ps(a, b); }
+    static F Div(const F a, const F b) { return _mm256_div_ps(a, b); }
+    static F Min(const F a, const F b) { return _mm256_min_ps(a, b); }
+    static F Max(const F a, const F b) { return _mm256_max_ps(a, b); }
+    static M CmpLE(const F a, const F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static M CmpGE(const F a, const F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static M CmpGT(const F a, const F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static F Select(const M m, const F a, const F b) { return _mm256_blendv_ps(b, a, m); }
+
+    static I Ramp(const int start) {
+        return _mm256_add_epi32(_mm256_set1_epi32(start), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+    static I LoadI(const int* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static I AddI(const I a, const int b) { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+    static I MinI(const I a, const int b) { return _mm256_min_epi32(a, _mm256_set1_epi32(b)); }
+    static I MulI(const I a, const int b) { return _mm256_mullo_epi32(a, _mm256_set1_epi32(b)); }
+    static I ShrI(const I a, const int shift) { return _mm256_sra_epi32(a, _mm_cvtsi32_si128(shift)); }
+    static F ToFloat(const I a) { return _mm256_cvtepi32_ps(a); }
+    static I Truncate(const F a) { return _mm256_cvttps_epi32(a); }
+
+    static I Set1I(const int v) { return _mm256_set1_epi32(v); }
+    static I AddII(const I a, const I b) { return _mm256_add_epi32(a, b); }
+    static I SubII(const I a, const I b) { return _mm256_sub_epi32(a, b); }
+    static I MulII(const I a, const I b) { return _mm256_mullo_epi32(a, b); }
+    static I MaxII(const I a, const I b) { return _mm256_max_epi32(a, b); }
+    static F Pow2(const I n) {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+    }
+
+    // Eight packed 8-bit pixels (one per dword) to channels
+    static void Unpack8(const __m256i v, I& a, I& r, I& g, I& b) {
+        const __m256i mask = _mm256_set1_epi32(0xFF);
+        a = _mm256_and_si256(v, mask);
+        r = _mm256_and_si256(_mm256_srli_epi32(v, 8), mask);
+        g = _mm256_and_si256(_mm256_srli_epi32(v, 16), mask);
+        b = _mm256_srli_epi32(v, 24);
+    }
+
+    // Alpha/red (lo) and green/blue (hi) dwords of eight 16-bit pixels to channels
+    static void Unpack16(const __m256i lo, const __m256i hi, I& a, I& r, I& g, I& b) {
+        const __m256i mask = _mm256_set1_epi32(0xFFFF);
+        a = _mm256_and_si256(lo, mask);
+        r = _mm256_srli_epi32(lo, 16);
+        g = _mm256_and_si256(hi, mask);
+        b = _mm256_srli_epi32(hi, 16);
+    }
+
+    static void ChannelsToFloat(const I ia, const I ir, const I ig, const I ib, F& a, F& r, F& g, F& b) {
+        a = _mm256_cvtepi32_ps(ia);
+        r = _mm256_cvtepi32_ps(ir);
+        g = _mm256_cvtepi32_ps(ig);
+        b = _mm256_cvtepi32_ps(ib);
+    }
+
+    // In-lane 4x4 transposes between pixels {q0..q3 | q4..q7} and channels
+    static void Transpose(F& v0, F& v1, F& v2, F& v3) {
+        const __m256d t0 = _mm256_castps_pd(_mm256_unpacklo_ps(v0, v1));
+        const __m256d t1 = _mm256_castps_pd(_mm256_unpackhi_ps(v0, v1));
+        const __m256d t2 = _mm256_castps_pd(_mm256_unpacklo_ps(v2, v3));
+        const __m256d t3 = _mm256_castps_pd(_mm256_unpackhi_ps(v2, v3));
+        v0 = _mm256_castpd_ps(_mm256_unpacklo_pd(t0, t2));
+        v1 = _mm256_castpd_ps(_mm256_unpackhi_pd(t0, t2));
+        v2 = _mm256_castpd_ps(_mm256_unpacklo_pd(t1, t3));
+        v3 = _mm256_castpd_ps(_mm256_unpackhi_pd(t1, t3));
+    }
+
+    template <int Depth>
+    static void LoadPixelsI(const void* p, I& a, I& r, I& g, I& b) {
+        if constexpr (Depth == DEPTH_8) {
+            Unpack8(_mm256_loadu_si256((const __m256i*)p), a, r, g, b);
+        } else {
+            const __m256 v0 = _mm256_loadu_ps((const float*)p);
+            const __m256 v1 = _mm256_loadu_ps((const float*)p + 8);
+            // Per-lane shuffles leave pixel pairs in order 0,1,4,5,2,3,6,7
+            const __m256i lo = _mm256_permute4x64_epi64(
+                _mm256_castps_si256(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256i hi = _mm256_permute4x64_epi64(
+                _mm256_castps_si256(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0));
+            Unpack16(lo, hi, a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void LoadPixels(const void* p, F& a, F& r, F& g, F& b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            const float* f = static_cast<const float*>(p);
+            const __m256 m0 = _mm256_loadu_ps(f);
+            const __m256 m1 = _mm256_loadu_ps(f + 8);
+            const __m256 m2 = _mm256_loadu_ps(f + 16);
+            const __m256 m3 = _mm256_loadu_ps(f + 24);
+            a = _mm256_permute2f128_ps(m0, m2, 0x20);  // Pixels 0 | 4
+            r = _mm256_permute2f128_ps(m0, m2, 0x31);  // 1 | 5
+            g = _mm256_permute2f128_ps(m1, m3, 0x20);  // 2 | 6
+            b = _mm256_permute2f128_ps(m1, m3, 0x31);  // 3 | 7
+            Transpose(a, r, g, b);
+        } else {
+            I ia, ir, ig, ib;
+            LoadPixelsI<Depth>(p, ia, ir, ig, ib);
+            ChannelsToFloat(ia, ir, ig, ib, a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void GatherPixelsI(const void* row, const I idx, I& a, I& r, I& g, I& b) {
+        const int* words = static_cast<const int*>(row);
+        if constexpr (Depth == DEPTH_8) {
+            Unpack8(_mm256_i32gather_epi32(words, idx, 4), a, r, g, b);
+        } else {
+            const __m256i even = _mm256_slli_epi32(idx, 1);
+            Unpack16(_mm256_i32gather_epi32(words, even, 4),
+                     _mm256_i32gather_epi32(words, _mm256_add_epi32(even, _mm256_set1_epi32(1)), 4), a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void GatherPixels(const void* row, const I idx, F& a, F& r, F& g, F& b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            const float* f = static_cast<const float*>(row);
+            const __m256i first = _mm256_slli_epi32(idx, 2);
+            a = _mm256_i32gather_ps(f, first, 4);
+            r = _mm256_i32gather_ps(f, _mm256_add_epi32(first, _mm256_set1_epi32(1)), 4);
+            g = _mm256_i32gather_ps(f, _mm256_add_epi32(first, _mm256_set1_epi32(2)), 4);
+            b = _mm256_i32gather_ps(f, _mm256_add_epi32(first, _mm256_set1_epi32(3)), 4);
+        } else {
+            I ia, ir, ig, ib;
+            GatherPixelsI<Depth>(row, idx, ia, ir, ig, ib);
+            ChannelsToFloat(ia, ir, ig, ib, a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void StorePixelsI(void* p, const I a, const I r, const I g, const I b) {
+        if constexpr (Depth == DEPTH_8) {
+            __m256i v = a;
+            v = _mm256_or_si256(v, _mm256_slli_epi32(r, 8));
+            v = _mm256_or_si256(v, _mm256_slli_epi32(g, 16));
+            v = _mm256_or_si256(v, _mm256_slli_epi32(b, 24));
+            _mm256_storeu_si256((__m256i*)p, v);
+        } else {
+            // Pre-permute so the per-lane unpacks emit pixels 0-3, then 4-7
+            const __m256i lo = _mm256_permute4x64_epi64(_mm256_or_si256(a, _mm256_slli_epi32(r, 16)),
+                                                        _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256i hi = _mm256_permute4x64_epi64(_mm256_or_si256(g, _mm256_slli_epi32(b, 16)),
+                                                        _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256((__m256i*)p, _mm256_unpacklo_epi32(lo, hi));
+            _mm256_storeu_si256((__m256i*)p + 1, _mm256_unpackhi_epi32(lo, hi));
+        }
+    }
+
+    template <int Depth>
+    static void StorePixels(void* p, F a, F r, F g, F b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            Transpose(a, r, g, b);
+            float* f = static_cast<float*>(p);
+            _mm256_storeu_ps(f, _mm256_permute2f128_ps(a, r, 0x20));
+            _mm256_storeu_ps(f + 8, _mm256_permute2f128_ps(g, b, 0x20));
+            _mm256_storeu_ps(f + 16, _mm256_permute2f128_ps(a, r, 0x31));
+            _mm256_storeu_ps(f + 24, _mm256_permute2f128_ps(g, b, 0x31));
+        } else {
+            StorePixelsI<Depth>(p, _mm256_cvttps_epi32(a), _mm256_cvttps_epi32(r), _mm256_cvttps_epi32(g),
+                                _mm256_cvttps_epi32(b));
+        }
+    }
+
+    static F Gather(const float* base, const I idx, const int start, const bool window) {
+        if (window) {
+            return _mm256_permutevar8x32_ps(_mm256_loadu_ps(base + start),
+                                            _mm256_sub_epi32(idx, _mm256_set1_epi32(start)));
+        }
+        return _mm256_i32gather_ps(base, idx, 4);
+    }
+
+    static I GatherU16(const std::uint16_t* base, const I idx, const int start, const bool window) {
+        if (window) {
+            return _mm256_permutevar8x32_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(base + start))),
+                                               _mm256_sub_epi32(idx, _mm256_set1_epi32(start)));
+        }
+        // A dword gather would read past the last sample of the plane
+        alignas(32) int columns[LANES];
+        _mm256_store_si256((__m256i*)columns, idx);
+        for (int i = 0; i < LANES; ++i) columns[i] = base[columns[i]];
+        return _mm256_load_si256((const __m256i*)columns);
+    }
+
+    static I GatherI(const std::int32_t* table, const I idx) { return _mm256_i32gather_epi32(table, idx, 4); }
+
+    static void StoreU16(std::uint16_t* p, const I v) {
+        // Per-lane packs give samples 0-3 in qword 0 and 4-7 in qword 2
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(packed));
+    }
+};
+
+} // namespace
+
+const PixelKernels* GetKernelsAVX2() noexcept {
+    static constexpr PixelKernels kernels = MakeKernels<Avx2Ops>(Isa::AVX2);
+    return &kernels;
+}
+
+} // namespace LiteGlowSimd
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+#else
+
+namespace LiteGlowSimd {
+
+const PixelKernels* GetKernelsAVX2() noexcept {
+    return nullptr;
+}
+
+} // namespace LiteGlowSimd
+
+#endif
@@ -0,0 +1,273 @@
+/*	LiteGlow_Simd_AVX512.cpp
+
+	Pixel kernels for AVX-512F, 16 pixels per step.
+	See LiteGlow_Simd.h for the model.
+
+*/
+
+#include "LiteGlow_Simd.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+// Only the code below may use AVX-512F; the rest of the plugin keeps the
+// project's baseline instruction set. MSVC accepts the intrinsics without a
+// per-file /arch switch. AVX-512F implies FMA, so contraction is turned off
+// to keep the results identical to the scalar kernels.
+#if defined(__clang__)
+    #pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+    #pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx512f")
+    #pragma GCC optimize("fp-contract=off")
+    // GCC 12 flags the intrinsics' own _mm512_undefined_* placeholders (PR 105593),
+    // as -Wuninitialized when optimizing for size
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+#include "LiteGlow_SimdKernels.h"
+
+namespace LiteGlowSimd {
+namespace {
+
+struct Avx512Ops {
+    typedef __m512 F;
+    typedef __m512i I;
+    typedef __mmask16 M;
+    static constexpr int LANES = 16;
+
+    static F Set1(const float v) { return _mm512_set1_ps(v); }
+    static F Load(const float* p) { return _mm512_loadu_ps(p); }
+    static void Store(float* p, const F v) { _mm512_storeu_ps(p, v); }
+    static F Add(const F a, const F b) { return _mm512_add_ps(a, b); }
+    static F Sub(const F a, const F b) { return _mm512_sub_ps(a, b); }
+    static F Mul(const F a, const F b) { return _mm512_mul_ps(a, b); }
+    static F Div(const F a, const F b) { return _mm512_div_ps(a, b); }
+    static F Min(const F a, const F b) { return _mm512_min_ps(a, b); }
+    static F Max(const F a, const F b) { return _mm512_max_ps(a, b); }
+    static M CmpLE(const F a, const F b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static M CmpGE(const F a, const F b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static M CmpGT(const F a, const F b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static F Select(const M m, const F a, const F b) { return _mm512_mask_blend_ps(m, b, a); }
+
+    static I Ramp(const int start) {
+        return _mm512_add_epi32(_mm512_set1_epi32(start),
+                                _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+    static I LoadI(const int* p) { return _mm512_loadu_si512(p); }
+    static I AddI(const I a, const int b) { return _mm512_add_epi32(a, _mm512_set1_epi32(b)); }
+    static I MinI(const I a, const int b) { return _mm512_min_epi32(a, _mm512_set1_epi32(b)); }
+    static I MulI(const I a, const int b) { return _mm512_mullo_epi32(a, _mm512_set1_epi32(b)); }
+    static I ShrI(const I a, const int shift) { return _mm512_sra_epi32(a, _mm_cvtsi32_si128(shift)); }
+    static F ToFloat(const I a) { return _mm512_cvtepi32_ps(a); }
+    static I Truncate(const F a) { return _mm512_cvttps_epi32(a); }
+
+    static I Set1I(const int v) { return _mm512_set1_epi32(v); }
+    static I AddII(const I a, const I b) { return _mm512_add_epi32(a, b); }
+    static I SubII(const I a, const I b) { return _mm512_sub_epi32(a, b); }
+    static I MulII(const I a, const I b) { return _mm512_mullo_epi32(a, b); }
+    static I MaxII(const I a, const I b) { return _mm512_max_epi32(a, b); }
+    static F Pow2(const I n) {
+        return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(127)), 23));
+    }
+
+    // Sixteen packed 8-bit pixels (one per dword) to channels
+    static void Unpack8(const __m512i v, I& a, I& r, I& g, I& b) {
+        const __m512i mask = _mm512_set1_epi32(0xFF);
+        a = _mm512_and_si512(v, mask);
+        r = _mm512_and_si512(_mm512_srli_epi32(v, 8), mask);
+        g = _mm512_and_si512(_mm512_srli_epi32(v, 16), mask);
+        b = _mm512_srli_epi32(v, 24);
+    }
+
+    // Alpha/red (lo) and green/blue (hi) dwords of sixteen 16-bit pixels to channels
+    static void Unpack16(const __m512i lo, const __m512i hi, I& a, I& r, I& g, I& b) {
+        const __m512i mask = _mm512_set1_epi32(0xFFFF);
+        a = _mm512_and_si512(lo, mask);
+        r = _mm512_srli_epi32(lo, 16);
+        g = _mm512_and_si512(hi, mask);
+        b = _mm512_srli_epi32(hi, 16);
+    }
+
+    static void ChannelsToFloat(const I ia, const I ir, const I ig, const I ib, F& a, F& r, F& g, F& b) {
+        a = _mm512_cvtepi32_ps(ia);
+        r = _mm512_cvtepi32_ps(ir);
+        g = _mm512_cvtepi32_ps(ig);
+        b = _mm512_cvtepi32_ps(ib);
+    }
+
+    // Between pixels (four per register) and channels: an in-lane 4x4
+    // transpose leaves lane j holding pixels j, j+4, j+8, j+12, which one
+    // permutation (its own inverse) puts in order.
+    static void Transpose(F& v0, F& v1, F& v2, F& v3) {
+        const __m512d t0 = _mm512_castps_pd(_mm512_unpacklo_ps(v0, v1));
+        const __m512d t1 = _mm512_castps_pd(_mm512_unpackhi_ps(v0, v1));
+        const __m512d t2 = _mm512_castps_pd(_mm512_unpacklo_ps(v2, v3));
+        const __m512d t3 = _mm512_castps_pd(_mm512_unpackhi_ps(v2, v3));
+        v0 = _mm512_castpd_ps(_mm512_unpacklo_pd(t0, t2));
+        v1 = _mm512_castpd_ps(_mm512_unpackhi_pd(t0, t2));
+        v2 = _mm512_castpd_ps(_mm512_unpacklo_pd(t1, t3));
+        v3 = _mm512_castpd_ps(_mm512_unpackhi_pd(t1, t3));
+    }
+
+    static I LaneOrder() {
+        return _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    }
+
+    template <int Depth>
+    static void LoadPixelsI(const void* p, I& a, I& r, I& g, I& b) {
+        if constexpr (Depth == DEPTH_8) {
+            Unpack8(_mm512_loadu_si512(p), a, r, g, b);
+        } else {
+            const __m512i v0 = _mm512_loadu_si512(p);
+            const __m512i v1 = _mm512_loadu_si512((const __m512i*)p + 1);
+            const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+            const __m512i odd = _mm512_add_epi32(even, _mm512_set1_epi32(1));
+            Unpack16(_mm512_permutex2var_epi32(v0, even, v1), _mm512_permutex2var_epi32(v0, odd, v1), a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void LoadPixels(const void* p, F& a, F& r, F& g, F& b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            const float* f = static_cast<const float*>(p);
+            a = _mm512_loadu_ps(f);
+            r = _mm512_loadu_ps(f + 16);
+            g = _mm512_loadu_ps(f + 32);
+            b = _mm512_loadu_ps(f + 48);
+            Transpose(a, r, g, b);
+            const __m512i order = LaneOrder();
+            a = _mm512_permutexvar_ps(order, a);
+            r = _mm512_permutexvar_ps(order, r);
+            g = _mm512_permutexvar_ps(order, g);
+            b = _mm512_permutexvar_ps(order, b);
+        } else {
+            I ia, ir, ig, ib;
+            LoadPixelsI<Depth>(p, ia, ir, ig, ib);
+            ChannelsToFloat(ia, ir, ig, ib, a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void GatherPixelsI(const void* row, const I idx, I& a, I& r, I& g, I& b) {
+        if constexpr (Depth == DEPTH_8) {
+            Unpack8(_mm512_i32gather_epi32(idx, row, 4), a, r, g, b);
+        } else {
+            const __m512i even = _mm512_slli_epi32(idx, 1);
+            Unpack16(_mm512_i32gather_epi32(even, row, 4),
+                     _mm512_i32gather_epi32(_mm512_add_epi32(even, _mm512_set1_epi32(1)), row, 4), a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void GatherPixels(const void* row, const I idx, F& a, F& r, F& g, F& b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            const __m512i first = _mm512_slli_epi32(idx, 2);
+            a = _mm512_i32gather_ps(first, row, 4);
+            r = _mm512_i32gather_ps(_mm512_add_epi32(first, _mm512_set1_epi32(1)), row, 4);
+            g = _mm512_i32gather_ps(_mm512_add_epi32(first, _mm512_set1_epi32(2)), row, 4);
+            b = _mm512_i32gather_ps(_mm512_add_epi32(first, _mm512_set1_epi32(3)), row, 4);
+        } else {
+            I ia, ir, ig, ib;
+            GatherPixelsI<Depth>(row, idx, ia, ir, ig, ib);
+            ChannelsToFloat(ia, ir, ig, ib, a, r, g, b);
+        }
+    }
+
+    template <int Depth>
+    static void StorePixelsI(void* p, const I a, const I r, const I g, const I b) {
+        if constexpr (Depth == DEPTH_8) {
+            __m512i v = a;
+            v = _mm512_or_si512(v, _mm512_slli_epi32(r, 8));
+            v = _mm512_or_si512(v, _mm512_slli_epi32(g, 16));
+            v = _mm512_or_si512(v, _mm512_slli_epi32(b, 24));
+            _mm512_storeu_si512(p, v);
+        } else {
+            const __m512i lo = _mm512_or_si512(a, _mm512_slli_epi32(r, 16));
+            const __m512i hi = _mm512_or_si512(g, _mm512_slli_epi32(b, 16));
+            const __m512i first = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+            const __m512i second = _mm512_add_epi32(first, _mm512_set1_epi32(8));
+            _mm512_storeu_si512(p, _mm512_permutex2var_epi32(lo, first, hi));
+            _mm512_storeu_si512((__m512i*)p + 1, _mm512_permutex2var_epi32(lo, second, hi));
+        }
+    }
+
+    template <int Depth>
+    static void StorePixels(void* p, F a, F r, F g, F b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            const __m512i order = LaneOrder();
+            a = _mm512_permutexvar_ps(order, a);
+            r = _mm512_permutexvar_ps(order, r);
+            g = _mm512_permutexvar_ps(order, g);
+            b = _mm512_permutexvar_ps(order, b);
+            Transpose(a, r, g, b);
+            float* f = static_cast<float*>(p);
+            _mm512_storeu_ps(f, a);
+            _mm512_storeu_ps(f + 16, r);
+            _mm512_storeu_ps(f + 32, g);
+            _mm512_storeu_ps(f + 48, b);
+        } else {
+            StorePixelsI<Depth>(p, _mm512_cvttps_epi32(a), _mm512_cvttps_epi32(r), _mm512_cvttps_epi32(g),
+                                _mm512_cvttps_epi32(b));
+        }
+    }
+
+    static F Gather(const float* base, const I idx, const int start, const bool window) {
+        if (window) {
+            return _mm512_permutexvar_ps(_mm512_sub_epi32(idx, _mm512_set1_epi32(start)),
+                                         _mm512_loadu_ps(base + start));
+        }
+        return _mm512_i32gather_ps(idx, base, 4);
+    }
+
+    static I GatherU16(const std::uint16_t* base, const I idx, const int start, const bool window) {
+        if (window) {
+            return _mm512_permutexvar_epi32(_mm512_sub_epi32(idx, _mm512_set1_epi32(start)),
+                                            _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(base + start))));
+        }
+        // A dword gather would read past the last sample of the plane
+        alignas(64) int columns[LANES];
+        _mm512_store_si512(columns, idx);
+        for (int i = 0; i < LANES; ++i) columns[i] = base[columns[i]];
+        return _mm512_load_si512(columns);
+    }
+
+    static I GatherI(const std::int32_t* table, const I idx) { return _mm512_i32gather_epi32(idx, table, 4); }
+
+    static void StoreU16(std::uint16_t* p, const I v) {
+        _mm256_storeu_si256((__m256i*)p, _mm512_cvtepi32_epi16(v));
+    }
+};
+
+} // namespace
+
+const PixelKernels* GetKernelsAVX512() noexcept {
+    static constexpr PixelKernels kernels = MakeKernels<Avx512Ops>(Isa::AVX512);
+    return &kernels;
+}
+
+} // namespace LiteGlowSimd
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+#else
+
+namespace LiteGlowSimd {
+
+const PixelKernels* GetKernelsAVX512() noexcept {
+    return nullptr;
+}
+
+} // namespace LiteGlowSimd
+
+#endif
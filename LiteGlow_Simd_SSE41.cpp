@@ -0,0 +1,228 @@
+/*	LiteGlow_Simd_SSE41.cpp
+
+	Pixel kernels for SSE4.1, 4 pixels per step.
+	See LiteGlow_Simd.h for the model.
+
+*/
+
+#include "LiteGlow_Simd.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+// Only the code below may use SSE4.1; the rest of the plugin keeps the
+// project's baseline instruction set. MSVC accepts the intrinsics without a
+// per-file /arch switch.
+#if defined(__clang__)
+    #pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+    #pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("sse4.1")
+    #pragma GCC optimize("fp-contract=off")
+#endif
+
+#include "LiteGlow_SimdKernels.h"
+
+namespace LiteGlowSimd {
+namespace {
+
+struct Sse41Ops {
+    typedef __m128 F;
+    typedef __m128i I;
+    typedef __m128 M;
+    static constexpr int LANES = 4;
+
+    static F Set1(const float v) { return _mm_set1_ps(v); }
+    static F Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, const F v) { _mm_storeu_ps(p, v); }
+    static F Add(const F a, const F b) { return _mm_add_ps(a, b); }
+    static F Sub(const F a, const F b) { return _mm_sub_ps(a, b); }
+    static F Mul(const F a, const F b) { return _mm_mul_ps(a, b); }
+    static F Div(const F a, const F b) { return _mm_div_ps(a, b); }
+    static F Min(const F a, const F b) { return _mm_min_ps(a, b); }
+    static F Max(const F a, const F b) { return _mm_max_ps(a, b); }
+    static M CmpLE(const F a, const F b) { return _mm_cmple_ps(a, b); }
+    static M CmpGE(const F a, const F b) { return _mm_cmpge_ps(a, b); }
+    static M CmpGT(const F a, const F b) { return _mm_cmpgt_ps(a, b); }
+    static F Select(const M m, const F a, const F b) { return _mm_blendv_ps(b, a, m); }
+
+    static I Ramp(const int start) { return _mm_add_epi32(_mm_set1_epi32(start), _mm_setr_epi32(0, 1, 2, 3)); }
+    static I LoadI(const int* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static I AddI(const I a, const int b) { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+    static I MinI(const I a, const int b) { return _mm_min_epi32(a, _mm_set1_epi32(b)); }
+    static I MulI(const I a, const int b) { return _mm_mullo_epi32(a, _mm_set1_epi32(b)); }
+    static I ShrI(const I a, const int shift) { return _mm_sra_epi32(a, _mm_cvtsi32_si128(shift)); }
+    static F ToFloat(const I a) { return _mm_cvtepi32_ps(a); }
+    static I Truncate(const F a) { return _mm_cvttps_epi32(a); }
+
+    static I Set1I(const int v) { return _mm_set1_epi32(v); }
+    static I AddII(const I a, const I b) { return _mm_add_epi32(a, b); }
+    static I SubII(const I a, const I b) { return _mm_sub_epi32(a, b); }
+    static I MulII(const I a, const I b) { return _mm_mullo_epi32(a, b); }
+    static I MaxII(const I a, const I b) { return _mm_max_epi32(a, b); }
+    static F Pow2(const I n) {
+        return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    }
+
+    template <int Depth>
+    static void LoadPixelsI(const void* p, I& a, I& r, I& g, I& b) {
+        if constexpr (Depth == DEPTH_8) {
+            const __m128i v = _mm_loadu_si128((const __m128i*)p);
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            a = _mm_and_si128(v, mask);
+            r = _mm_and_si128(_mm_srli_epi32(v, 8), mask);
+            g = _mm_and_si128(_mm_srli_epi32(v, 16), mask);
+            b = _mm_srli_epi32(v, 24);
+        } else {
+            // Low dwords hold alpha/red, high dwords green/blue
+            const __m128 v0 = _mm_loadu_ps((const float*)p);
+            const __m128 v1 = _mm_loadu_ps((const float*)p + 4);
+            const __m128i lo = _mm_castps_si128(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+            const __m128i hi = _mm_castps_si128(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+            const __m128i mask = _mm_set1_epi32(0xFFFF);
+            a = _mm_and_si128(lo, mask);
+            r = _mm_srli_epi32(lo, 16);
+            g = _mm_and_si128(hi, mask);
+            b = _mm_srli_epi32(hi, 16);
+        }
+    }
+
+    template <int Depth>
+    static void LoadPixels(const void* p, F& a, F& r, F& g, F& b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            const float* f = static_cast<const float*>(p);
+            a = _mm_loadu_ps(f);
+            r = _mm_loadu_ps(f + 4);
+            g = _mm_loadu_ps(f + 8);
+            b = _mm_loadu_ps(f + 12);
+            _MM_TRANSPOSE4_PS(a, r, g, b);
+        } else {
+            I ia, ir, ig, ib;
+            LoadPixelsI<Depth>(p, ia, ir, ig, ib);
+            a = _mm_cvtepi32_ps(ia);
+            r = _mm_cvtepi32_ps(ir);
+            g = _mm_cvtepi32_ps(ig);
+            b = _mm_cvtepi32_ps(ib);
+        }
+    }
+
+    // Copies the pixels row[idx[i]] next to each other for a contiguous load
+    template <int Depth>
+    static const unsigned char* CollectPixels(const void* row, const I idx, unsigned char* pixels) {
+        constexpr int kPixelBytes = DepthTraits<Depth>::PIXEL_BYTES;
+        alignas(16) int columns[LANES];
+        _mm_store_si128((__m128i*)columns, idx);
+        for (int i = 0; i < LANES; ++i) {
+            std::memcpy(pixels + i * kPixelBytes, PixelAt<Depth>(row, columns[i]), kPixelBytes);
+        }
+        return pixels;
+    }
+
+    template <int Depth>
+    static void GatherPixels(const void* row, const I idx, F& a, F& r, F& g, F& b) {
+        alignas(16) unsigned char pixels[LANES * DepthTraits<Depth>::PIXEL_BYTES];
+        LoadPixels<Depth>(CollectPixels<Depth>(row, idx, pixels), a, r, g, b);
+    }
+
+    template <int Depth>
+    static void GatherPixelsI(const void* row, const I idx, I& a, I& r, I& g, I& b) {
+        alignas(16) unsigned char pixels[LANES * DepthTraits<Depth>::PIXEL_BYTES];
+        LoadPixelsI<Depth>(CollectPixels<Depth>(row, idx, pixels), a, r, g, b);
+    }
+
+    template <int Depth>
+    static void StorePixelsI(void* p, const I a, const I r, const I g, const I b) {
+        if constexpr (Depth == DEPTH_8) {
+            __m128i v = a;
+            v = _mm_or_si128(v, _mm_slli_epi32(r, 8));
+            v = _mm_or_si128(v, _mm_slli_epi32(g, 16));
+            v = _mm_or_si128(v, _mm_slli_epi32(b, 24));
+            _mm_storeu_si128((__m128i*)p, v);
+        } else {
+            const __m128i lo = _mm_or_si128(a, _mm_slli_epi32(r, 16));
+            const __m128i hi = _mm_or_si128(g, _mm_slli_epi32(b, 16));
+            _mm_storeu_si128((__m128i*)p, _mm_unpacklo_epi32(lo, hi));
+            _mm_storeu_si128((__m128i*)p + 1, _mm_unpackhi_epi32(lo, hi));
+        }
+    }
+
+    template <int Depth>
+    static void StorePixels(void* p, F a, F r, F g, F b) {
+        if constexpr (Depth == DEPTH_FLOAT) {
+            _MM_TRANSPOSE4_PS(a, r, g, b);
+            float* f = static_cast<float*>(p);
+            _mm_storeu_ps(f, a);
+            _mm_storeu_ps(f + 4, r);
+            _mm_storeu_ps(f + 8, g);
+            _mm_storeu_ps(f + 12, b);
+        } else {
+            StorePixelsI<Depth>(p, _mm_cvttps_epi32(a), _mm_cvttps_epi32(r), _mm_cvttps_epi32(g), _mm_cvttps_epi32(b));
+        }
+    }
+
+    // Byte shuffle control taking dword idx[i] - start of a register to lane i
+    static __m128i WindowControl(const I idx, const int start) {
+        const __m128i rel = _mm_sub_epi32(idx, _mm_set1_epi32(start));
+        return _mm_add_epi32(_mm_mullo_epi32(rel, _mm_set1_epi32(0x04040404)), _mm_set1_epi32(0x03020100));
+    }
+
+    static F Gather(const float* base, const I idx, const int start, const bool window) {
+        if (window) {
+            return _mm_castsi128_ps(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(base + start)),
+                                                     WindowControl(idx, start)));
+        }
+        alignas(16) int columns[LANES];
+        _mm_store_si128((__m128i*)columns, idx);
+        return _mm_setr_ps(base[columns[0]], base[columns[1]], base[columns[2]], base[columns[3]]);
+    }
+
+    static I GatherU16(const std::uint16_t* base, const I idx, const int start, const bool window) {
+        if (window) {
+            return _mm_shuffle_epi8(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(base + start))),
+                                    WindowControl(idx, start));
+        }
+        alignas(16) int columns[LANES];
+        _mm_store_si128((__m128i*)columns, idx);
+        return _mm_setr_epi32(base[columns[0]], base[columns[1]], base[columns[2]], base[columns[3]]);
+    }
+
+    static I GatherI(const std::int32_t* table, const I idx) {
+        alignas(16) int columns[LANES];
+        _mm_store_si128((__m128i*)columns, idx);
+        return _mm_setr_epi32(table[columns[0]], table[columns[1]], table[columns[2]], table[columns[3]]);
+    }
+
+    static void StoreU16(std::uint16_t* p, const I v) { _mm_storel_epi64((__m128i*)p, _mm_packus_epi32(v, v)); }
+};
+
+} // namespace
+
+const PixelKernels* GetKernelsSSE41() noexcept {
+    static constexpr PixelKernels kernels = MakeKernels<Sse41Ops>(Isa::SSE41);
+    return &kernels;
+}
+
+} // namespace LiteGlowSimd
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+#else
+
+namespace LiteGlowSimd {
+
+const PixelKernels* GetKernelsSSE41() noexcept {
+    return nullptr;
+}
+
+} // namespace LiteGlowSimd
+
+#endif
@@ -22,12 +22,15 @@ TableString g_strs[StrID_NUMTYPES] = {
     StrID_Radius_Param_Name,         "Radius",
     StrID_Threshold_Param_Name,      "Threshold",
     StrID_Quality_Param_Name,        "Quality",
-    StrID_Quality_Param_Choices,     "Low|Medium|High",
+    StrID_Quality_Param_Choices,     "Low|Medium|High|Pyramid|Adaptive|Auto (budget)",
     StrID_Bloom_Intensity_Param_Name, "Bloom Intensity",
     StrID_Knee_Param_Name,           "Threshold Softness",
     StrID_Blend_Mode_Param_Name,     "Blend Mode",
     StrID_Blend_Mode_Param_Choices,  "Screen|Add|Normal",
-    StrID_Tint_Color_Param_Name,     "Tint Color"
+    StrID_Tint_Color_Param_Name,     "Tint Color",
+    StrID_Blur_Mode_Param_Name,      "Blur Mode",
+    StrID_Blur_Mode_Param_Choices,   "Box|Gaussian",
+    StrID_Budget_Param_Name,         "Budget (ms)"
 };
 
 char* GetStringPtr(int strNum)
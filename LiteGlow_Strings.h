@@ -14,5 +14,8 @@ typedef enum {
     StrID_Blend_Mode_Param_Name,
     StrID_Blend_Mode_Param_Choices,
     StrID_Tint_Color_Param_Name,
+    StrID_Blur_Mode_Param_Name,
+    StrID_Blur_Mode_Param_Choices,
+    StrID_Budget_Param_Name,
     StrID_NUMTYPES
 } StrIDType;
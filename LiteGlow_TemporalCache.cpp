@@ -0,0 +1,78 @@
+/*	LiteGlow_TemporalCache.cpp
+
+	Per-instance frames of temporal renders.
+	See LiteGlow_TemporalCache.h for the model.
+
+*/
+
+#include "LiteGlow_TemporalCache.h"
+#include "LiteGlow_LruCache.h"
+
+#include <new>
+#include <utility>
+
+namespace LiteGlowTemporal {
+
+namespace {
+
+struct SlotKey {
+    std::uint64_t instance;
+    FrameKey layout;        // Only the layout fields are compared
+};
+
+struct SameSlot {
+    bool operator()(const SlotKey& a, const SlotKey& b) const noexcept {
+        return a.instance == b.instance && SameLayout(a.layout, b.layout);
+    }
+};
+
+typedef LiteGlowLru::LruCache<SlotKey, FrameRef, SameSlot> Cache;
+
+// Outlives every render, as the glow cache does; GlobalSetdown empties it.
+Cache* Instance() noexcept {
+    static Cache* cache = new (std::nothrow) Cache(TEMPORAL_CACHE_DEFAULT_LIMIT);
+    return cache;
+}
+
+} // namespace
+
+bool SameLayout(const FrameKey& a, const FrameKey& b) noexcept {
+    return a.format == b.format && a.srcWidth == b.srcWidth && a.srcHeight == b.srcHeight &&
+           a.factor == b.factor && a.width == b.width && a.height == b.height &&
+           a.fixedPoint == b.fixedPoint && a.boxPasses == b.boxPasses &&
+           a.outputX == b.outputX && a.outputY == b.outputY &&
+           a.outputWidth == b.outputWidth && a.outputHeight == b.outputHeight;
+}
+
+FrameRef Take(const std::uint64_t instance, const FrameKey& layout) noexcept {
+    Cache* cache = Instance();
+    return cache ? cache->Take(SlotKey{ instance, layout }) : nullptr;
+}
+
+void Put(const std::uint64_t instance, FrameRef&& frame) noexcept {
+    Cache* cache = Instance();
+    if (cache && frame) {
+        const SlotKey key{ instance, frame->key };
+        const std::size_t bytes = frame->storage.Size();
+        cache->Store(key, std::move(frame), bytes);
+    }
+}
+
+void Forget(const std::uint64_t instance) noexcept {
+    if (Cache* cache = Instance()) cache->RemoveIf([instance](const SlotKey& key) { return key.instance == instance; });
+}
+
+void Clear() noexcept {
+    if (Cache* cache = Instance()) cache->Clear();
+}
+
+void SetLimit(const std::size_t bytes) noexcept {
+    if (Cache* cache = Instance()) cache->SetLimit(bytes);
+}
+
+std::size_t Limit() noexcept {
+    Cache* cache = Instance();
+    return cache ? cache->Limit() : 0;
+}
+
+} // namespace LiteGlowTemporal
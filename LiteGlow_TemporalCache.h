@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef LITEGLOW_TEMPORALCACHE_H
+#define LITEGLOW_TEMPORALCACHE_H
+
+// =============================================================================
+// LiteGlow Temporal Cache
+// =============================================================================
+// Keeps, per effect instance, what its last CPU Box render computed: a hash
+// of every input tile, the bright planes, the output of every box pass with
+// its tile occupancy, and the output pixels. The next render of the instance
+// (LiteGlowCore::RenderGlowTemporal) diffs its input tiles against the
+// hashes and recomputes only the tiles the changes reach, so locked-off
+// footage with a few moving highlights copies most of the frame from the
+// last one.
+//
+// Frames are kept per instance and layout (FrameKey's layout fields), so an
+// instance rendered at two preview resolutions or output rects keeps a
+// frame for each. A render takes its frame out of the cache and puts it
+// back when it is done, so concurrent (MFR) renders of one instance never
+// share a frame: a render that finds none starts over, and the last one to
+// finish is kept. Least recently used frames are dropped above a byte limit;
+// a limit of 0 turns temporal renders off.
+//
+// Instance ids are the caller's. Effects duplicated or copied in After
+// Effects keep the id they were copied from, so two layers of one size
+// share a frame: each render then diffs against the other layer's input,
+// which is correct but recomputes most tiles. Nothing tells the cache that
+// an instance was deleted; its frames wait for eviction or Clear.
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include "LiteGlow_Blur.h"
+#include "LiteGlow_ScratchPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace LiteGlowTemporal {
+
+constexpr std::size_t TEMPORAL_CACHE_DEFAULT_LIMIT = (std::size_t)512 * 1024 * 1024;
+constexpr int TEMPORAL_PLANES = 5;  // Bright planes, then the output of up to four box passes
+
+// What a frame was rendered from. A frame whose layout differs from the next
+// render's is not reused at all; the other groups only decide which stages
+// rerun over the whole frame. Floats are compared bitwise.
+struct FrameKey {
+    // Layout
+    int format;             // Host pixel format
+    int srcWidth;
+    int srcHeight;
+    int factor;             // Downsample factor
+    int width;              // Size of the planes
+    int height;
+    bool fixedPoint;        // Q15 planes (fixed-point path) rather than float
+    int boxPasses;          // H+V pairs; planes 0 .. 2 * boxPasses are used
+    int outputX;            // Output rect inside the input
+    int outputY;
+    int outputWidth;
+    int outputHeight;
+    // Bright pass
+    float threshold;
+    float knee;
+    float intensity;
+    // Blur
+    int radiusH;
+    int radiusV;
+    // Blend
+    float strength;
+    float tintR;
+    float tintG;
+    float tintB;
+    int blendMode;
+};
+
+// The planes, maps and pixels of one frame, all in `storage`. Exactly one of
+// `planes` and `planesQ15` is set, as FrameKey::fixedPoint says.
+struct Frame {
+    LiteGlowMem::ScratchBuffer storage;
+    FrameKey key;
+    LiteGlowBlur::PlanarRGBF planes[TEMPORAL_PLANES];
+    LiteGlowBlur::PlanarRGB16 planesQ15[TEMPORAL_PLANES];
+    LiteGlowBlur::TileMap tiles[TEMPORAL_PLANES];  // Occupancy of each plane
+    std::uint64_t* tileHashes;                     // Input tiles, row by row
+    char* output;                                  // Output pixels, outputRowBytes apart
+    std::ptrdiff_t outputRowBytes;
+};
+
+typedef std::unique_ptr<Frame> FrameRef;
+
+// Whether frames of `a` and `b` hold planes and pixels of the same sizes
+// and places, i.e. whether one can be rendered on top of the other.
+bool SameLayout(const FrameKey& a, const FrameKey& b) noexcept;
+
+// Removes and returns the frame of `instance` with the layout of `layout`,
+// or null.
+FrameRef Take(std::uint64_t instance, const FrameKey& layout) noexcept;
+
+// Stores `frame` as the frame of `instance` at its layout (dropping one
+// stored meanwhile) and evicts down to the limit. Frames larger than the
+// limit are not kept.
+void Put(std::uint64_t instance, FrameRef&& frame) noexcept;
+
+// Drops the frames of one instance, or of all (GlobalSetdown).
+void Forget(std::uint64_t instance) noexcept;
+void Clear() noexcept;
+
+void SetLimit(std::size_t bytes) noexcept;
+std::size_t Limit() noexcept;
+
+} // namespace LiteGlowTemporal
+
+#endif // LITEGLOW_TEMPORALCACHE_H
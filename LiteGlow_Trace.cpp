@@ -0,0 +1,214 @@
+/*	LiteGlow_Trace.cpp
+
+	Per-thread event rings and their Chrome trace JSON export.
+	See LiteGlow_Trace.h for the model.
+
+*/
+
+#include "LiteGlow_Trace.h"
+
+#include "LiteGlow_ScratchPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace LiteGlowTrace {
+
+std::atomic<bool> gEnabled{ false };
+
+namespace {
+
+enum EventArgs {
+    ARGS_NONE,
+    ARGS_FRAME,
+    ARGS_COUNTS,
+    ARGS_PLAN,
+    ARGS_SCRATCH   // A counter event at `begin`
+};
+
+// The scratch pool's high-water marks and traffic (LiteGlowMem::ScratchStats).
+struct ScratchArgs {
+    std::uint64_t peakBytesInUse;
+    std::uint64_t peakBytesTotal;   // In use plus cached
+    std::uint64_t reuses;           // Acquires served from the cache
+    std::uint64_t systemAllocs;
+};
+
+struct Event {
+    const char* name;
+    std::uint64_t begin;   // Nanoseconds since Start
+    std::uint64_t end;
+    EventArgs args;
+    union {
+        FrameArgs frame;
+        LiteGlowPerf::Counts counts;
+        PlanArgs plan;
+        ScratchArgs scratch;
+    };
+};
+
+static_assert(sizeof(Event) < 100, "Trace events should stay small");
+
+// Written only by its thread; `head` (events ever recorded) publishes them.
+struct Ring {
+    int thread;                            // Trace thread id, 1-based
+    std::atomic<std::uint64_t> head{ 0 };
+    Event events[TRACE_RING_EVENTS];
+};
+
+std::mutex gMutex;                          // Guards gRings and gPath
+std::vector<std::unique_ptr<Ring>> gRings;  // Every ring ever created
+std::string gPath;
+std::chrono::steady_clock::time_point gStart = std::chrono::steady_clock::now();
+
+thread_local Ring* tRing = nullptr;
+
+// The calling thread's ring, created on first use; null if out of memory.
+Ring* ThreadRing() noexcept {
+    if (tRing) return tRing;
+    std::unique_ptr<Ring> ring(new (std::nothrow) Ring);
+    if (!ring) return nullptr;
+    std::lock_guard<std::mutex> lock(gMutex);
+    try {
+        ring->thread = (int)gRings.size() + 1;
+        gRings.push_back(std::move(ring));
+    } catch (...) {
+        return nullptr;
+    }
+    tRing = gRings.back().get();
+    return tRing;
+}
+
+void WriteEvent(std::FILE* f, const Ring& ring, const Event& e, bool& first) {
+    if (e.args == ARGS_SCRATCH) {
+        std::fprintf(f, "%s\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,"
+                        "\"args\":{\"peakBytesInUse\":%llu,\"peakBytesTotal\":%llu,\"reuses\":%llu,"
+                        "\"systemAllocs\":%llu}}",
+                     first ? "" : ",", e.name, ring.thread, e.begin / 1000.0,
+                     (unsigned long long)e.scratch.peakBytesInUse, (unsigned long long)e.scratch.peakBytesTotal,
+                     (unsigned long long)e.scratch.reuses, (unsigned long long)e.scratch.systemAllocs);
+        first = false;
+        return;
+    }
+    std::fprintf(f, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                 first ? "" : ",", e.name, ring.thread, e.begin / 1000.0, (e.end - e.begin) / 1000.0);
+    if (e.args == ARGS_FRAME) {
+        std::fprintf(f, ",\"args\":{\"time\":%.6f,\"width\":%d,\"height\":%d,\"factor\":%d,\"radiusH\":%d,\"radiusV\":%d}",
+                     e.frame.time, e.frame.width, e.frame.height, e.frame.factor, e.frame.radiusH, e.frame.radiusV);
+    } else if (e.args == ARGS_PLAN) {
+        std::fprintf(f, ",\"args\":{\"budgetMs\":%.3f,\"predictedMs\":%.3f,\"measuredMs\":%.3f,\"plan\":%d,"
+                        "\"factor\":%d,\"radiusV\":%d,\"passes\":%d}",
+                     e.plan.budgetMs, e.plan.predictedMs, e.plan.measuredMs, e.plan.plan, e.plan.factor,
+                     e.plan.radiusV, e.plan.passes);
+    } else if (e.args == ARGS_COUNTS && e.counts.available) {
+        const char* separator = "";
+        std::fprintf(f, ",\"args\":{");
+        for (int c = 0; c < LiteGlowPerf::COUNTERS; ++c) {
+            if (!(e.counts.available & (1u << c))) continue;
+            std::fprintf(f, "%s\"%s\":%llu", separator, LiteGlowPerf::CounterName((LiteGlowPerf::Counter)c),
+                         (unsigned long long)e.counts.value[c]);
+            separator = ",";
+        }
+        std::fprintf(f, "}");
+    }
+    std::fprintf(f, "}");
+    first = false;
+}
+
+} // namespace
+
+void Start(const char* path) noexcept {
+    if (!path || !path[0]) return;
+    std::lock_guard<std::mutex> lock(gMutex);
+    try {
+        gPath = path;
+    } catch (...) {
+        return;
+    }
+    gStart = std::chrono::steady_clock::now();
+    gEnabled.store(true, std::memory_order_release);
+}
+
+bool Flush() noexcept {
+    if (!gEnabled.exchange(false, std::memory_order_acq_rel)) return true;
+
+    std::lock_guard<std::mutex> lock(gMutex);
+    std::FILE* f = std::fopen(gPath.c_str(), "w");
+    if (f) {
+        std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        bool first = true;
+        for (const std::unique_ptr<Ring>& ring : gRings) {
+            const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+            if (head == 0) continue;
+            std::fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                            "\"args\":{\"name\":\"LiteGlow thread %d\"}}",
+                         first ? "" : ",", ring->thread, ring->thread);
+            first = false;
+            // Oldest surviving event first
+            const std::uint64_t count = head < (std::uint64_t)TRACE_RING_EVENTS ? head : TRACE_RING_EVENTS;
+            for (std::uint64_t i = head - count; i < head; ++i) {
+                WriteEvent(f, *ring, ring->events[i % TRACE_RING_EVENTS], first);
+            }
+        }
+        std::fprintf(f, "\n]}\n");
+    }
+    for (const std::unique_ptr<Ring>& ring : gRings) ring->head.store(0, std::memory_order_relaxed);
+    return f && std::fclose(f) == 0;
+}
+
+std::uint64_t Now() noexcept {
+    return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - gStart).count();
+}
+
+void Record(const char* name, std::uint64_t begin, std::uint64_t end, const FrameArgs* frame,
+            const LiteGlowPerf::Counts* counts) noexcept {
+    Ring* ring = ThreadRing();
+    if (!ring) return;
+    const std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    Event& e = ring->events[head % TRACE_RING_EVENTS];
+    e.name = name;
+    e.begin = begin;
+    e.end = end;
+    e.args = frame ? ARGS_FRAME : counts ? ARGS_COUNTS : ARGS_NONE;
+    if (frame) {
+        e.frame = *frame;
+    } else if (counts) {
+        e.counts = *counts;
+    }
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void RecordPlan(const char* name, std::uint64_t begin, std::uint64_t end, const PlanArgs& plan) noexcept {
+    Ring* ring = ThreadRing();
+    if (!ring) return;
+    const std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    Event& e = ring->events[head % TRACE_RING_EVENTS];
+    e.name = name;
+    e.begin = begin;
+    e.end = end;
+    e.args = ARGS_PLAN;
+    e.plan = plan;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void RecordScratch(const char* name) noexcept {
+    if (!Enabled()) return;
+    Ring* ring = ThreadRing();
+    if (!ring) return;
+    const LiteGlowMem::ScratchStats stats = LiteGlowMem::GetScratchStats();
+    const std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    Event& e = ring->events[head % TRACE_RING_EVENTS];
+    e.name = name;
+    e.begin = e.end = Now();
+    e.args = ARGS_SCRATCH;
+    e.scratch = ScratchArgs{ stats.peakBytesInUse, stats.peakBytesTotal, stats.reuses, stats.systemAllocs };
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace LiteGlowTrace
@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef LITEGLOW_TRACE_H
+#define LITEGLOW_TRACE_H
+
+// =============================================================================
+// LiteGlow Trace
+// =============================================================================
+// Hot-path instrumentation of the render passes. Compiled in everywhere, off
+// by default: the plugin turns it on when LITEGLOW_TRACE names an output file
+// (GlobalSetup) and writes the recorded events there as Chrome trace JSON at
+// GlobalSetdown, for chrome://tracing or ui.perfetto.dev.
+//
+// Every thread records into its own ring of TRACE_RING_EVENTS events, so
+// recording takes no lock and, once a ring is full, keeps the newest events.
+// A thread's ring is allocated on its first event and kept until the process
+// exits. While tracing is off, a Scope costs one relaxed atomic load.
+//
+// Events are complete spans ("ph": "X") with the recording thread; spans of
+// one thread nest by time, so the stages of a render appear under its frame
+// span. Frame spans also carry the frame's time, size, downsample factor
+// and blur radii, stage spans their hardware counts when stage counters are
+// on (LiteGlowCore::SetStageCounters), and the governor's spans of Auto
+// Quality renders the plan it chose (LiteGlow_Governor.h). GlobalSetdown
+// adds a counter event with the scratch pool's high-water marks
+// (LiteGlow_ScratchPool.h).
+//
+// No After Effects SDK dependency; nothing here throws.
+
+#include "LiteGlow_PerfCounters.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace LiteGlowTrace {
+
+constexpr int TRACE_RING_EVENTS = 16384;  // Per thread (under 100 bytes each)
+
+// What a frame span records about the frame.
+struct FrameArgs {
+    double time;       // Frame time in seconds
+    int width;         // Rendered input size in pixels
+    int height;
+    int factor;        // Internal downsample factor
+    int radiusH;       // Blur radii in downsampled pixels
+    int radiusV;
+};
+
+// What the frame-time governor chose for a frame.
+struct PlanArgs {
+    double budgetMs;
+    double predictedMs;   // Its cost model's estimate for the plan
+    double measuredMs;    // What the render took
+    int plan;             // LiteGlowCore::GetAutoPlan index
+    int factor;           // Internal downsample factor
+    int radiusV;          // Vertical blur radius in downsampled pixels
+    int passes;           // Box or HLSL H+V pairs; 0 for the Gaussian
+};
+
+extern std::atomic<bool> gEnabled;
+
+inline bool Enabled() noexcept { return gEnabled.load(std::memory_order_relaxed); }
+
+// Starts recording; Flush writes to `path` (copied). Call before rendering.
+void Start(const char* path) noexcept;
+
+// Stops recording and writes every recorded event to the Start path.
+// Call when no render is running (GlobalSetdown). Returns false if the file
+// could not be written; does nothing and returns true if tracing was off.
+bool Flush() noexcept;
+
+// Monotonic nanoseconds since Start.
+std::uint64_t Now() noexcept;
+
+// Records one span on the calling thread. `name` must be a string literal
+// (or otherwise outlive the trace). A span carries either `frame` or the
+// hardware `counts` of a stage (LiteGlow_PerfCounters.h) as arguments; both
+// may be null.
+void Record(const char* name, std::uint64_t begin, std::uint64_t end, const FrameArgs* frame,
+            const LiteGlowPerf::Counts* counts = nullptr) noexcept;
+
+// Records one governor span with the plan it chose.
+void RecordPlan(const char* name, std::uint64_t begin, std::uint64_t end, const PlanArgs& plan) noexcept;
+
+// Records the scratch pool's peak bytes, reuses and system allocations so far
+// (LiteGlowMem::GetScratchStats) as one counter event ("ph": "C") on the
+// calling thread. Does nothing while tracing is off.
+void RecordScratch(const char* name) noexcept;
+
+// Records its own lifetime as a span, if tracing was on when it was created.
+class Scope {
+public:
+    explicit Scope(const char* name, const FrameArgs* frame = nullptr) noexcept
+        : mName(Enabled() ? name : nullptr), mFrame(frame), mBegin(mName ? Now() : 0) {}
+    ~Scope() {
+        if (mName) Record(mName, mBegin, Now(), mFrame);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* mName;
+    const FrameArgs* mFrame;
+    std::uint64_t mBegin;
+};
+
+} // namespace LiteGlowTrace
+
+#endif // LITEGLOW_TRACE_H
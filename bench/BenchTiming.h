@@ -0,0 +1,38 @@
+#pragma once
+
+#ifndef LITEGLOW_BENCH_TIMING_H
+#define LITEGLOW_BENCH_TIMING_H
+
+// =============================================================================
+// BenchTiming - wall-clock timing shared by the benchmarks in bench/
+// =============================================================================
+// Header only, so BlurVBench still builds from its own .cpp without the core
+// library. Times are steady_clock milliseconds.
+
+#include <chrono>
+
+namespace LiteGlowBench {
+
+// Milliseconds one call of `fn` takes.
+template <typename Fn>
+inline double TimeMs(Fn&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    fn();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// Fastest of `repeats` calls of `fn`, in milliseconds.
+template <typename Fn>
+inline double BestMs(int repeats, Fn&& fn) {
+    double best = 1e30;
+    for (int i = 0; i < repeats; ++i) {
+        const double ms = TimeMs(fn);
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+} // namespace LiteGlowBench
+
+#endif // LITEGLOW_BENCH_TIMING_H
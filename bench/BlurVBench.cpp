@@ -0,0 +1,127 @@
+// =============================================================================
+// BlurVBench - vertical box blur: column walk vs. cache-blocked strips
+// =============================================================================
+// Standalone benchmark for the kernels in LiteGlow_Blur.h (no AE SDK needed).
+// Times one vertical pass per pixel format with
+//   - column walk: BoxBlurLine once per column (stride = rowbytes)
+//   - strips:      BoxBlurStripV over BLUR_V_STRIP_BYTES-wide column strips
+// and checks that both produce identical pixels. "Plane" is one float channel
+// of the planar RGB intermediates the plugin actually blurs.
+//
+// Build and run (from the repository root):
+//   c++ -O2 -std=c++20 -I. bench/BlurVBench.cpp -o BlurVBench
+//   ./BlurVBench [width] [height] [radius] [repeats]
+// Defaults: 3840 x 2160, radius 24, 5 repeats (best time is reported).
+
+#include "BenchTiming.h"
+#include "LiteGlow_Blur.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Same member layout as PF_Pixel8 / PF_Pixel16 / PF_PixelFloat (ARGB).
+struct BenchPixel8 { uint8_t alpha, red, green, blue; };
+struct BenchPixel16 { uint16_t alpha, red, green, blue; };
+struct BenchPixelF { float alpha, red, green, blue; };
+
+struct BenchImage {
+    std::vector<char> bytes;
+    std::ptrdiff_t rowbytes;
+    int width;
+    int height;
+};
+
+template <typename PixelT>
+static BenchImage MakeImage(int width, int height, bool fill) {
+    BenchImage img;
+    img.width = width;
+    img.height = height;
+    // Pad rows like AE does so the column stride is not a power of two.
+    img.rowbytes = (std::ptrdiff_t)width * sizeof(PixelT) + 64;
+    img.bytes.assign((size_t)img.rowbytes * height, 0);
+    if (fill) {
+        uint32_t seed = 12345u;
+        for (int y = 0; y < height; ++y) {
+            PixelT* row = reinterpret_cast<PixelT*>(img.bytes.data() + y * img.rowbytes);
+            for (int x = 0; x < width; ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                const float v = (float)(seed >> 8) / (float)(1u << 24);
+                if constexpr (std::is_arithmetic<PixelT>::value) {
+                    row[x] = v;
+                } else if constexpr (sizeof(PixelT) == sizeof(BenchPixelF)) {
+                    row[x].red = v; row[x].green = v * 0.5f; row[x].blue = 1.0f - v; row[x].alpha = 1.0f;
+                } else {
+                    const float maxV = sizeof(PixelT) == sizeof(BenchPixel8) ? 255.0f : 32768.0f;
+                    typedef decltype(row[x].red) ChannelT;
+                    row[x].red = (ChannelT)(v * maxV);
+                    row[x].green = (ChannelT)(v * 0.5f * maxV);
+                    row[x].blue = (ChannelT)((1.0f - v) * maxV);
+                    row[x].alpha = (ChannelT)maxV;
+                }
+            }
+        }
+    }
+    return img;
+}
+
+template <typename PixelT, typename SumT>
+static bool RunFormat(const char* name, int width, int height, int radius, int repeats) {
+    const BenchImage src = MakeImage<PixelT>(width, height, true);
+    BenchImage colOut = MakeImage<PixelT>(width, height, false);
+    BenchImage stripOut = MakeImage<PixelT>(width, height, false);
+
+    const double colMs = LiteGlowBench::BestMs(repeats, [&] {
+        for (int x = 0; x < width; ++x) {
+            LiteGlowBlur::BoxBlurLine<PixelT, SumT>(
+                src.bytes.data() + x * sizeof(PixelT), src.rowbytes,
+                colOut.bytes.data() + x * sizeof(PixelT), colOut.rowbytes, height, radius);
+        }
+    });
+
+    const int strips = LiteGlowBlur::BlurVStripCount<PixelT>(width);
+    const double stripMs = LiteGlowBench::BestMs(repeats, [&] {
+        for (int s = 0; s < strips; ++s) {
+            LiteGlowBlur::BoxBlurStripV<PixelT, SumT>(
+                src.bytes.data(), src.rowbytes, stripOut.bytes.data(), stripOut.rowbytes,
+                width, height, radius, s);
+        }
+    });
+
+    bool identical = true;
+    for (int y = 0; y < height && identical; ++y) {
+        identical = std::memcmp(colOut.bytes.data() + y * colOut.rowbytes,
+                                stripOut.bytes.data() + y * stripOut.rowbytes,
+                                (size_t)width * sizeof(PixelT)) == 0;
+    }
+
+    const double mpix = (double)width * height / 1.0e6;
+    std::printf("%-8s  column walk %8.2f ms (%7.1f MP/s)   strips %8.2f ms (%7.1f MP/s)   speedup %5.2fx   %s\n",
+                name, colMs, mpix / (colMs / 1000.0), stripMs, mpix / (stripMs / 1000.0),
+                colMs / stripMs, identical ? "identical" : "MISMATCH");
+    return identical;
+}
+
+int main(int argc, char** argv) {
+    const int width = argc > 1 ? std::atoi(argv[1]) : 3840;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 2160;
+    const int radius = argc > 3 ? std::atoi(argv[3]) : 24;
+    const int repeats = argc > 4 ? std::atoi(argv[4]) : 5;
+    if (width <= 0 || height <= 0 || radius < 0 || repeats <= 0) {
+        std::fprintf(stderr, "usage: %s [width] [height] [radius] [repeats]\n", argv[0]);
+        return 2;
+    }
+
+    std::printf("Vertical box blur, %d x %d, radius %d, strip %d bytes, best of %d\n",
+                width, height, radius, LiteGlowBlur::BLUR_V_STRIP_BYTES, repeats);
+
+    bool ok = true;
+    ok &= RunFormat<BenchPixel8, int>("ARGB32", width, height, radius, repeats);
+    ok &= RunFormat<BenchPixel16, int>("ARGB64", width, height, radius, repeats);
+    ok &= RunFormat<BenchPixelF, double>("ARGB128", width, height, radius, repeats);
+    ok &= RunFormat<float, double>("Plane", width, height, radius, repeats);
+    return ok ? 0 : 1;
+}
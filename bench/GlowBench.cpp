@@ -0,0 +1,1240 @@
+// =============================================================================
+// GlowBench - every glow stage over resolutions, radii, qualities and depths
+// =============================================================================
+// Standalone benchmark for the CPU pipeline in LiteGlow_Core.h (no AE SDK
+// needed). Each case renders one synthetic frame through RenderGlow, the same
+// call ProcessWorlds makes, and reports:
+//   - every stage on its own (StageTimes): the content hash of the cache
+//     lookup, the bright pass, each blur pass and the blend;
+//   - end_to_end: the whole render with the stages run as one task graph, as
+//     the plugin runs it.
+// The glow cache is cleared before every render, so every stage runs.
+// Throughput is in megapixels of the full frame per second for every stage,
+// including the blur passes that run on the downsampled planes, so the stages
+// of one case can be compared with each other and with end_to_end.
+// The scratch pool's peak bytes, reuses and system allocations over the
+// whole run are printed at the end.
+//
+// --counters adds the hardware counters of every stage (Linux perf events,
+// LiteGlow_PerfCounters.h), summed over the threads that ran it: IPC, L1D
+// and last-level misses per frame pixel, and the DRAM traffic the LLC misses
+// imply next to the least bytes per pixel the stage has to move
+// (LiteGlowCore::StageMinBytes). Bandwidths are per second of stage wall
+// time; with --peak-gbs, the minimum traffic is also shown as a share of
+// that memory bandwidth, i.e. how close the stage is to the memory roofline.
+//
+// The default matrix is HD/2K/4K/8K x radius 1..50 x every Quality
+// x 8/16/32 bpc x four content densities with the Box blur (several hours,
+// and 8K float frames need about 1 GB); the options below narrow it, and
+// --quick runs a 2K subset in well under a minute, plus small radii on
+// wide (3:1) pixels and a 1/4 x 1 preview at every Quality, which have to
+// render like any other (a failed render fails the run).
+//
+// Auto cases render through the frame-time governor (LiteGlow_Governor.h)
+// with the --budget-ms budget and a fresh model per case, which settles on a
+// plan over a few untimed renders first; the plan it ended on is printed
+// after the case.
+//
+// --preview half,quarter renders every case as After Effects previews at that
+// resolution: the frame is 1/2 or 1/4 the size and the settings carry the
+// preview scale, so the radius and the downsample follow (case names get
+// "@half" / "@quarter" after the size).
+//
+// --temporal renders every case through the temporal cache
+// (LiteGlow_TemporalCache.h) as one instance, as the plugin renders
+// successive frames: after a first untimed render, every timed one moves a
+// TEMPORAL_SPOT pixel highlight TEMPORAL_STEP pixels, so only the tiles
+// around it are recomputed (case names get "/temporal"; Auto cases and the
+// blurs the cache does not keep render as they would without it).
+//
+// --parity checks the temporal cache instead of timing anything: each case
+// renders a clip of moving, vanishing and edited frames both through the
+// cache and in full and compares every frame (see Parity below). The run
+// fails if any frame differs.
+//
+// --rect-parity checks the ROI renders the same way: each case renders random
+// output rects from only the input SmartPreRender would request for them and
+// compares them with a render of the whole frame, then streams the frame and
+// the rects if the blur can stream (see Parity below).
+//
+// --json writes the results (one case per line); --compare reads such a file
+// back and flags every stage that got slower by more than --threshold percent,
+// exiting with 1 if any did. Stages under --min-ms in both runs are too short
+// to compare and are skipped.
+//
+// Build and run (from the repository root):
+//   cmake -S . -B build && cmake --build build -j
+//   ./build/GlowBench [options]
+// Options (lists are comma-separated):
+//   --sizes HD,2K,4K,8K          --radii 1,5,10,25,50
+//   --quality low,medium,high,pyramid,adaptive,auto
+//   --budget-ms ms (Auto; default 30)
+//   --bpc 8,16,32                --content black,sparse,highlights,dense
+//   --blur box,gaussian          --repeats N (default 3, best time is reported)
+//   --preview full,half,quarter (default full)
+//   --isa scalar|sse4.1|avx2|avx512 (default: widest supported)
+//   --no-fixed-point             --quick
+//   --pipeline cpu|hlsl (default cpu; hlsl is the CPU emulation of the GPU shaders)
+//   --stream-mb MB (Box renders with more intermediates than this stream; default 256, 0 = all)
+//   --temporal                   --parity
+//   --rect-parity
+//   --counters                   --peak-gbs GB/s
+//   --json out.json              --compare baseline.json
+//   --threshold pct (default 10) --min-ms ms (default 0.1)
+
+#include "BenchTiming.h"
+#include "LiteGlow_Core.h"
+#include "LiteGlow_GlowCache.h"
+#include "LiteGlow_Governor.h"
+#include "LiteGlow_Scheduler.h"
+#include "LiteGlow_ScratchPool.h"
+#include "LiteGlow_Simd.h"
+#include "LiteGlow_TemporalCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using LiteGlowCore::ImageView;
+using LiteGlowCore::PixelFormat;
+using LiteGlowCore::Settings;
+using LiteGlowCore::StageTimes;
+
+// 2K frames should render in under this (docs/glow_quality.md).
+constexpr double TARGET_2K_MS = 30.0;
+
+// Governed renders before an Auto case is timed, for its model to settle.
+constexpr int AUTO_SETTLE_RENDERS = 8;
+
+// The highlight --temporal moves between frames, and how far.
+constexpr int TEMPORAL_SPOT = 32;
+constexpr int TEMPORAL_STEP = 8;
+
+struct FrameSize {
+    const char* name;
+    int width;
+    int height;
+};
+
+const FrameSize FRAME_SIZES[] = {
+    { "HD", 1920, 1080 },
+    { "2K", 2048, 1080 },
+    { "4K", 3840, 2160 },
+    { "8K", 7680, 4320 },
+};
+
+const char* const QUALITY_NAMES[] = { "low", "medium", "high", "pyramid", "adaptive", "auto" };  // QUALITY_LOW..QUALITY_AUTO
+const char* const BLUR_NAMES[] = { "box", "gaussian" };                      // BLUR_MODE_BOX..BLUR_MODE_GAUSSIAN
+
+// Synthetic content, from nothing over the threshold to everything over it.
+enum Content {
+    CONTENT_BLACK,        // Dark noise only: the bright pass finds nothing
+    CONTENT_SPARSE,       // Small hot spots on ~1% of the frame
+    CONTENT_HIGHLIGHTS,   // Larger highlights on ~15% of the frame
+    CONTENT_DENSE,        // Uniform noise over the whole range
+    CONTENTS
+};
+
+const char* const CONTENT_NAMES[] = { "black", "sparse", "highlights", "dense" };
+
+// Preview resolutions, as fractions of the frame.
+const char* const PREVIEW_NAMES[] = { "full", "half", "quarter" };
+const int PREVIEW_DIVISORS[] = { 1, 2, 4 };
+
+// Pixel shapes --quick also renders at small radii, where the horizontal
+// radius rounds below one grid pixel: wide pixels, and a custom preview
+// resolution that drops columns only.
+struct PixelShape {
+    const char* name;
+    int parNum;
+    int parDen;
+    int previewDivisorX;
+    int previewDivisorY;
+};
+
+const PixelShape PIXEL_SHAPES[] = {
+    { "par3", 3, 1, 1, 1 },
+    { "preview4x1", 1, 1, 4, 1 },
+};
+const int PIXEL_SHAPE_RADII[] = { 1, 3 };
+
+struct BenchOptions {
+    std::vector<int> sizes;      // FRAME_SIZES indices
+    std::vector<int> radii;
+    std::vector<int> qualities;
+    std::vector<int> bpcs;
+    std::vector<int> contents;
+    std::vector<int> blurs;      // BLUR_MODE_*
+    std::vector<int> previews;   // PREVIEW_NAMES indices
+    int repeats = 3;
+    double budgetMs = BUDGET_DFLT;
+    bool fixedPoint = true;
+    LiteGlowCore::Pipeline pipeline = LiteGlowCore::PIPELINE_CPU;
+    double streamMb = (double)(LiteGlowCore::STREAMING_DEFAULT_BYTES >> 20);
+    LiteGlowSimd::Isa isa = LiteGlowSimd::DetectIsa();
+    const char* jsonPath = nullptr;
+    const char* comparePath = nullptr;
+    double threshold = 10.0;
+    double minMs = 0.1;
+    bool counters = false;
+    double peakGBs = 0.0;
+    bool temporal = false;
+    bool parity = false;
+    bool rectParity = false;
+    bool pixelShapes = false;    // --quick
+};
+
+// =============================================================================
+// Frames
+// =============================================================================
+
+struct Frame {
+    std::vector<char> bytes;
+    ImageView view;
+};
+
+static PixelFormat FormatForBpc(int bpc) {
+    return bpc == 8 ? LiteGlowCore::FORMAT_ARGB32 : bpc == 16 ? LiteGlowCore::FORMAT_ARGB64 : LiteGlowCore::FORMAT_ARGB128;
+}
+
+// Rows padded like AE does.
+static Frame MakeFrame(int width, int height, PixelFormat format) {
+    Frame f;
+    const std::ptrdiff_t rowBytes = (std::ptrdiff_t)width * LiteGlowCore::PixelBytes(format) + 64;
+    f.bytes.assign((size_t)rowBytes * height, 0);
+    f.view = ImageView{ f.bytes.data(), rowBytes, width, height, format };
+    return f;
+}
+
+static void SetPixel(const ImageView& img, int x, int y, float r, float g, float b) {
+    char* p = static_cast<char*>(img.data) + y * img.rowBytes + (std::ptrdiff_t)x * LiteGlowCore::PixelBytes(img.format);
+    const float argb[4] = { 1.0f, r, g, b };
+    for (int c = 0; c < 4; ++c) {
+        const float v = argb[c];
+        if (img.format == LiteGlowCore::FORMAT_ARGB32) {
+            reinterpret_cast<uint8_t*>(p)[c] = (uint8_t)(std::min(1.0f, v) * 255.0f + 0.5f);
+        } else if (img.format == LiteGlowCore::FORMAT_ARGB64) {
+            reinterpret_cast<uint16_t*>(p)[c] = (uint16_t)(std::min(1.0f, v) * 32768.0f + 0.5f);
+        } else {
+            reinterpret_cast<float*>(p)[c] = v;  // HDR highlights stay over 1
+        }
+    }
+}
+
+static uint32_t NextRandom(uint32_t& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static float RandomUnit(uint32_t& seed) {
+    return (float)NextRandom(seed) / (float)(1u << 24);
+}
+
+// Fills `img` with `content`; the same arguments always give the same frame.
+static void FillFrame(const ImageView& img, Content content) {
+    uint32_t seed = 12345u + (uint32_t)content;
+    for (int y = 0; y < img.height; ++y) {
+        for (int x = 0; x < img.width; ++x) {
+            if (content == CONTENT_DENSE) {
+                SetPixel(img, x, y, RandomUnit(seed) * 1.5f, RandomUnit(seed) * 1.5f, RandomUnit(seed) * 1.5f);
+            } else {
+                const float v = RandomUnit(seed) * 0.15f;  // Well under the default threshold
+                SetPixel(img, x, y, v, v, v);
+            }
+        }
+    }
+    if (content != CONTENT_SPARSE && content != CONTENT_HIGHLIGHTS) return;
+
+    // Square spots until they cover the target share of the frame
+    const int spot = content == CONTENT_SPARSE ? 3 : 24;
+    const double coverage = content == CONTENT_SPARSE ? 0.01 : 0.15;
+    const long long spots = (long long)(coverage * img.width * img.height / (spot * spot));
+    for (long long i = 0; i < spots; ++i) {
+        const int x0 = (int)(NextRandom(seed) % (uint32_t)img.width);
+        const int y0 = (int)(NextRandom(seed) % (uint32_t)img.height);
+        const float r = 0.8f + RandomUnit(seed), g = 0.8f + RandomUnit(seed), b = 0.8f + RandomUnit(seed);
+        for (int y = y0; y < std::min(img.height, y0 + spot); ++y) {
+            for (int x = x0; x < std::min(img.width, x0 + spot); ++x) SetPixel(img, x, y, r, g, b);
+        }
+    }
+}
+
+// Frame `frame` of a --temporal case: `moving` is `still` with a white
+// highlight TEMPORAL_STEP * frame pixels right of where it started, or
+// without one if `frame` is negative. Only the rows of the spot are
+// rewritten.
+static void MoveSpot(const Frame& still, Frame& moving, int frame) {
+    const ImageView& img = moving.view;
+    const int size = std::min(TEMPORAL_SPOT, std::min(img.width, img.height));
+    const int travel = std::max(1, img.width - size);
+    const int x0 = (img.width / 4 + frame * TEMPORAL_STEP) % travel;
+    const int y0 = (img.height - size) / 2;
+    for (int y = y0; y < y0 + size; ++y) {
+        const std::ptrdiff_t row = y * img.rowBytes;
+        std::memcpy(moving.bytes.data() + row, still.bytes.data() + row, (size_t)img.rowBytes);
+        for (int x = x0; x < x0 + size && frame >= 0; ++x) SetPixel(img, x, y, 1.5f, 1.5f, 1.5f);
+    }
+}
+
+// =============================================================================
+// Cases
+// =============================================================================
+
+struct StageResult {
+    std::string name;
+    double ms;
+    double mpps;
+    double minBytes;               // LiteGlowCore::StageMinBytes (0 for end_to_end)
+    LiteGlowPerf::Counts counts;   // Of the best run, with --counters
+};
+
+struct CaseResult {
+    std::string id;         // "2K/8bpc/r10/medium/box/sparse"
+    int width;
+    int height;
+    int bpc;
+    int radius;
+    int quality;
+    int blur;
+    int content;
+    std::string plan;       // Auto: the plan the governor settled on
+    std::vector<StageResult> stages;
+};
+
+static Settings MakeSettings(int radius, int quality, int blur, int preview) {
+    Settings s = {};
+    s.strength = STRENGTH_DFLT;
+    s.radius = (float)radius;
+    s.threshold = THRESHOLD_DFLT;
+    s.quality = quality;
+    s.bloomIntensity = BLOOM_INTENSITY_DFLT;
+    s.knee = KNEE_DFLT;
+    s.blendMode = BLEND_MODE_SCREEN;
+    s.blurMode = blur;
+    s.tintR = s.tintG = s.tintB = 1.0f;
+    s.parNum = s.parDen = 1;
+    s.field = LiteGlowCore::FIELD_FRAME;
+    s.previewScaleX = s.previewScaleY = 1.0f / PREVIEW_DIVISORS[preview];
+    return s;
+}
+
+// Best time of every stage over `repeats` cold renders, with the counters
+// of that run. Auto cases render through the governor, with a model of
+// their own; temporal ones through the temporal cache, with a frame of
+// their own and the spot moved before every render. Returns false if a
+// render fails.
+static bool RunCase(const Frame& input, const Frame& output, const Settings& settings, int repeats,
+                    double budgetMs, bool temporal, CaseResult& result)
+{
+    static std::uint64_t nextInstance = 1;
+    const std::uint64_t instance = nextInstance++;
+    const bool governed = settings.quality == QUALITY_AUTO;
+    LiteGlowGovernor::Choice choice = {};
+    Frame moving;
+    if (temporal && !governed) {
+        moving = input;
+        moving.view.data = moving.bytes.data();
+    }
+    int frame = 0;
+    auto render = [&](StageTimes* t) {
+        if (governed) {
+            return LiteGlowGovernor::Render(instance, budgetMs, input.view, output.view, 0, 0, settings, &choice, t);
+        }
+        if (temporal) {
+            MoveSpot(input, moving, frame++);
+            return LiteGlowCore::RenderGlowTemporal(instance, moving.view, output.view, 0, 0, settings,
+                                                    LiteGlowCore::GetBlurSetup(settings), t);
+        }
+        return LiteGlowCore::RenderGlow(input.view, output.view, 0, 0, settings, t);
+    };
+    if (temporal && !governed && render(nullptr) != LiteGlowCore::STATUS_OK) return false;
+    for (int i = 0; governed && i < AUTO_SETTLE_RENDERS; ++i) {
+        LiteGlowCache::Clear();
+        if (render(nullptr) != LiteGlowCore::STATUS_OK) return false;
+    }
+
+    // The governor may change plans between renders, so every stage is named
+    // after the plan of the render its best time came from
+    StageTimes best = {};
+    const char* bestNames[LiteGlowCore::STAGES] = {};
+    double bestTotal = 1e30;
+    for (int i = 0; i < repeats; ++i) {
+        StageTimes t;
+        LiteGlowCache::Clear();
+        if (render(&t) != LiteGlowCore::STATUS_OK) return false;
+        const LiteGlowCore::BlurSetup timed = governed ? choice.blur : LiteGlowCore::GetBlurSetup(settings);
+        for (int stage = 0; stage < LiteGlowCore::STAGES; ++stage) {
+            if (i == 0 || t.ms[stage] < best.ms[stage]) {
+                best.ms[stage] = t.ms[stage];
+                best.counts[stage] = t.counts[stage];
+                bestNames[stage] = LiteGlowCore::StageName((LiteGlowCore::Stage)stage, timed);
+            }
+        }
+
+        LiteGlowCache::Clear();
+        LiteGlowCore::Status status = LiteGlowCore::STATUS_OK;
+        const double ms = LiteGlowBench::TimeMs([&] { status = render(nullptr); });
+        if (status != LiteGlowCore::STATUS_OK) return false;
+        bestTotal = std::min(bestTotal, ms);
+    }
+
+    const LiteGlowCore::BlurSetup setup = governed ? choice.blur : LiteGlowCore::GetBlurSetup(settings);
+    if (governed) {
+        const char* blur = setup.hlslIterations > 0 ? "hlsl" : setup.gaussian ? "gaussian" : "box";
+        const int pairs = setup.hlslIterations > 0 ? setup.hlslIterations : setup.boxPasses;
+        result.plan = "plan " + std::to_string(choice.plan) + ": " + std::to_string(setup.factor) + "x " + blur +
+                      (pairs ? " x" + std::to_string(pairs) : "") + ", predicted " +
+                      std::to_string((int)(choice.predictedMs + 0.5)) + " ms";
+        LiteGlowGovernor::Forget(instance);
+    }
+    LiteGlowTemporal::Forget(instance);
+    const double mp = (double)input.view.width * input.view.height / 1e6;
+    for (int i = 0; i < LiteGlowCore::STAGES; ++i) {
+        const LiteGlowCore::Stage stage = (LiteGlowCore::Stage)i;
+        const double ms = best.ms[stage];
+        if (ms <= 0.0 || !bestNames[stage]) continue;
+        // Auto plans vary with the model; their minimum traffic is not known here
+        const double minBytes = governed ? 0.0 : LiteGlowCore::StageMinBytes(stage, settings, input.view.format,
+                                                                             input.view.width, input.view.height);
+        result.stages.push_back(StageResult{ bestNames[stage], ms, mp / (ms / 1000.0),
+                                             minBytes, best.counts[stage] });
+    }
+    result.stages.push_back(StageResult{ "end_to_end", bestTotal, mp / (bestTotal / 1000.0), 0.0, {} });
+    LiteGlowCache::Clear();
+    return true;
+}
+
+static bool Has(const LiteGlowPerf::Counts& counts, LiteGlowPerf::Counter counter) {
+    return (counts.available & (1u << counter)) != 0;
+}
+
+// Counter table of one case (--counters); "-" where a counter is unavailable.
+static void PrintCounters(const CaseResult& c, const BenchOptions& opt) {
+    using namespace LiteGlowPerf;
+    const double pixels = (double)c.width * c.height;
+    std::printf("    %-10s %8s %6s %6s %9s %9s %9s %9s %9s", "stage", "ms", "cpu", "IPC", "L1D/px", "LLC/px",
+                "DRAM B/px", "min B/px", "DRAM GB/s");
+    std::printf(opt.peakGBs > 0.0 ? " %9s\n" : "\n", "roofline");
+    for (const StageResult& s : c.stages) {
+        if (s.name == "end_to_end") continue;
+        const Counts& k = s.counts;
+        char cpu[16] = "-", ipc[16] = "-", l1[16] = "-", llc[16] = "-", dram[16] = "-", gbs[16] = "-";
+        if (Has(k, COUNTER_CPU_NS)) std::snprintf(cpu, sizeof(cpu), "%.1fx", k.value[COUNTER_CPU_NS] / 1e6 / s.ms);
+        if (Has(k, COUNTER_CYCLES) && Has(k, COUNTER_INSTRUCTIONS) && k.value[COUNTER_CYCLES]) {
+            std::snprintf(ipc, sizeof(ipc), "%.2f", (double)k.value[COUNTER_INSTRUCTIONS] / k.value[COUNTER_CYCLES]);
+        }
+        if (Has(k, COUNTER_L1D_MISSES)) std::snprintf(l1, sizeof(l1), "%.3f", k.value[COUNTER_L1D_MISSES] / pixels);
+        if (Has(k, COUNTER_LLC_MISSES)) {
+            const double bytes = (double)k.value[COUNTER_LLC_MISSES] * CACHE_LINE_BYTES;
+            std::snprintf(llc, sizeof(llc), "%.3f", k.value[COUNTER_LLC_MISSES] / pixels);
+            std::snprintf(dram, sizeof(dram), "%.2f", bytes / pixels);
+            std::snprintf(gbs, sizeof(gbs), "%.2f", bytes / (s.ms * 1e6));
+        }
+        std::printf("    %-10s %8.3f %6s %6s %9s %9s %9s %9.2f %9s", s.name.c_str(), s.ms, cpu, ipc, l1, llc,
+                    dram, s.minBytes / pixels, gbs);
+        if (opt.peakGBs > 0.0) std::printf(" %8.1f%%", 100.0 * s.minBytes / (s.ms * 1e6) / opt.peakGBs);
+        std::printf("\n");
+    }
+}
+
+static const StageResult* FindStage(const CaseResult& c, const std::string& name) {
+    for (const StageResult& s : c.stages) {
+        if (s.name == name) return &s;
+    }
+    return nullptr;
+}
+
+// =============================================================================
+// Parity
+// =============================================================================
+// --parity checks instead of timing: every case renders a short clip through
+// the temporal cache (RenderGlowTemporal, one instance) and every frame is
+// compared with a full render (RenderGlowWithBlur). The clip moves the
+// spot, drops it and brings it back, and edits each setting group in turn,
+// including a frame with no glow at all (float input over 1 still has to
+// come out clamped, as under a glow); it runs once on the whole frame
+// and once on an output rect inside it. 8/16-bit output has to match
+// exactly, float within PARITY_FLOAT_TOLERANCE.
+
+constexpr double PARITY_FLOAT_TOLERANCE = 1e-5;
+
+// Output rect of the second run: inset from the input by these many pixels
+// (left, top, right, bottom), off the glow grid on purpose.
+constexpr int PARITY_INSET[4] = { 37, 21, 43, 29 };
+
+enum ParityEdit {
+    EDIT_NONE,
+    EDIT_STRENGTH,
+    EDIT_THRESHOLD,
+    EDIT_RADIUS,
+    EDIT_TINT,
+    EDIT_BLEND_MODE,
+    EDIT_NO_GLOW,         // Zero Bloom Intensity: the bright pass finds nothing
+    EDIT_GLOW_BACK,
+};
+
+// Frames of the clip: where the spot is (-1: gone) and the edit made to the
+// settings before it, on top of the earlier ones.
+struct ParityFrame {
+    int spot;
+    ParityEdit edit;
+};
+
+const ParityFrame PARITY_CLIP[] = {
+    { 0, EDIT_NONE },      { 1, EDIT_NONE },           { 3, EDIT_NONE },      { -1, EDIT_NONE },
+    { 4, EDIT_NONE },      { 4, EDIT_STRENGTH },       { 5, EDIT_THRESHOLD }, { 5, EDIT_RADIUS },
+    { 6, EDIT_TINT },      { 7, EDIT_BLEND_MODE },     { 7, EDIT_NO_GLOW },
+    { 8, EDIT_GLOW_BACK },
+};
+
+static void ApplyEdit(Settings& s, ParityEdit edit, const Settings& original) {
+    switch (edit) {
+    case EDIT_STRENGTH: s.strength *= 0.5f; break;
+    case EDIT_THRESHOLD: s.threshold = std::max((float)THRESHOLD_MIN, s.threshold - 20.0f); break;
+    case EDIT_RADIUS: s.radius = std::min((float)RADIUS_MAX, s.radius + 3.0f); break;
+    case EDIT_TINT: s.tintR = 0.8f; s.tintG = 0.6f; s.tintB = 1.0f; break;
+    case EDIT_BLEND_MODE: s.blendMode = s.blendMode == BLEND_MODE_ADD ? BLEND_MODE_SCREEN : BLEND_MODE_ADD; break;
+    case EDIT_NO_GLOW: s.bloomIntensity = (float)BLOOM_INTENSITY_MIN; break;
+    case EDIT_GLOW_BACK: s.bloomIntensity = original.bloomIntensity; break;
+    default: break;
+    }
+}
+
+// Largest difference between two images of one format and size, in codes
+// for 8/16-bit and in value for float (alpha included).
+static double MaxDifference(const ImageView& a, const ImageView& b) {
+    double worst = 0.0;
+    const int values = 4 * a.width;
+    for (int y = 0; y < a.height; ++y) {
+        const char* ra = static_cast<const char*>(a.data) + y * a.rowBytes;
+        const char* rb = static_cast<const char*>(b.data) + y * b.rowBytes;
+        for (int i = 0; i < values; ++i) {
+            double d;
+            if (a.format == LiteGlowCore::FORMAT_ARGB32) {
+                d = std::abs((int)reinterpret_cast<const uint8_t*>(ra)[i] - (int)reinterpret_cast<const uint8_t*>(rb)[i]);
+            } else if (a.format == LiteGlowCore::FORMAT_ARGB64) {
+                d = std::abs((int)reinterpret_cast<const uint16_t*>(ra)[i] - (int)reinterpret_cast<const uint16_t*>(rb)[i]);
+            } else {
+                d = std::fabs((double)reinterpret_cast<const float*>(ra)[i] - reinterpret_cast<const float*>(rb)[i]);
+            }
+            worst = std::max(worst, d);
+        }
+    }
+    return worst;
+}
+
+struct ParityResult {
+    int frames;             // Compared
+    int mismatches;         // Frames over the tolerance
+    double worst;           // Largest difference of any frame
+    int streamed;           // --rect-parity: of `frames`, rendered streaming
+};
+
+// Renders the clip over `input` both ways, on the whole frame and on the
+// inset rect. Returns false if a render fails.
+static bool RunParity(const Frame& input, const Settings& settings, ParityResult& result) {
+    static std::uint64_t nextInstance = 1u << 30;  // Apart from RunCase's
+    const ImageView& in = input.view;
+    const double tolerance = in.format == LiteGlowCore::FORMAT_ARGB128 ? PARITY_FLOAT_TOLERANCE : 0.0;
+    result = ParityResult{ 0, 0, 0.0, 0 };
+    Frame moving = input;
+    moving.view.data = moving.bytes.data();
+    for (int inset = 0; inset < 2; ++inset) {
+        const int x = inset ? PARITY_INSET[0] : 0;
+        const int y = inset ? PARITY_INSET[1] : 0;
+        const int width = inset ? in.width - PARITY_INSET[0] - PARITY_INSET[2] : in.width;
+        const int height = inset ? in.height - PARITY_INSET[1] - PARITY_INSET[3] : in.height;
+        if (width < 1 || height < 1) continue;
+        const Frame full = MakeFrame(width, height, in.format);
+        const Frame temporal = MakeFrame(width, height, in.format);
+        const std::uint64_t instance = nextInstance++;
+        Settings s = settings;
+        for (const ParityFrame& f : PARITY_CLIP) {
+            ApplyEdit(s, f.edit, settings);
+            MoveSpot(input, moving, f.spot);
+            const LiteGlowCore::BlurSetup blur = LiteGlowCore::GetBlurSetup(s);
+            LiteGlowCache::Clear();
+            if (LiteGlowCore::RenderGlowWithBlur(moving.view, full.view, x, y, s, blur) != LiteGlowCore::STATUS_OK ||
+                LiteGlowCore::RenderGlowTemporal(instance, moving.view, temporal.view, x, y, s, blur) !=
+                    LiteGlowCore::STATUS_OK) {
+                LiteGlowTemporal::Forget(instance);
+                return false;
+            }
+            const double d = MaxDifference(full.view, temporal.view);
+            ++result.frames;
+            result.mismatches += d > tolerance;
+            result.worst = std::max(result.worst, d);
+        }
+        LiteGlowTemporal::Forget(instance);
+    }
+    LiteGlowCache::Clear();
+    return true;
+}
+
+// --rect-parity checks the ROI renders instead: every case renders the whole
+// frame once, then RECT_PARITY_RECTS random output rects, each from only the
+// input SmartPreRender would check out for it (the rect grown by the glow
+// apron, its edges snapped outwards to the glow grid, clipped to the frame),
+// and compares them with the same pixels of the whole frame. Auto cases
+// render every plan the governor may pick. 8/16-bit output has to match
+// exactly, float within PARITY_FLOAT_TOLERANCE, with two exceptions:
+//   - blurs whose running sums are floats (Pyramid, Adaptive's resampled
+//     grid, Box without fixed point) start them at the input's edge, so the
+//     last bit of a sum, and now and then the rounding of an 8/16-bit code,
+//     depends on where the input starts: RECT_PARITY_ROUNDING_CODES;
+//   - the Gaussian's recursive filter does not stop at its apron (see
+//     BlurReach), so its output may differ by RECT_PARITY_GAUSSIAN_CODES
+//     codes of 8-bit output in any format (a 16-bit code is 1/128 of one).
+// Blurs that can stream (SetStreamingThreshold) then render the whole frame
+// and the same rects again with streaming forced, against the same
+// full-frame render. Past the matrix, --rect-parity also streams frames one
+// pixel wide or high at radii up to RADIUS_MAX (STREAM_EDGE_SIZES; Box
+// radii past RADIUS_SLIDER_MAX take the Pyramid, which does not stream), and
+// renders the frames just under and just over STREAMING_DEFAULT_BYTES with
+// the default threshold, which have to take the frame and streamed paths
+// respectively (CPU pipeline only). Its thresholds replace --stream-mb while
+// it runs.
+
+constexpr int RECT_PARITY_RECTS = 6;
+constexpr double RECT_PARITY_ROUNDING_CODES = 1.0;
+constexpr double RECT_PARITY_GAUSSIAN_CODES = 1.0;
+
+// Threshold that streams nothing.
+constexpr std::size_t NO_STREAMING = SIZE_MAX;
+
+// Frames of one pixel row or column (and a few), streamed at these radii.
+const FrameSize STREAM_EDGE_SIZES[] = {
+    { "1x517", 1, 517 },
+    { "517x1", 517, 1 },
+    { "3x260", 3, 260 },
+    { "260x3", 260, 3 },
+};
+const int STREAM_EDGE_RADII[] = { 1, 50, RADIUS_MAX };
+
+// Width of the frames around STREAMING_DEFAULT_BYTES; their height follows.
+constexpr int THRESHOLD_FRAME_WIDTH = 4096;
+
+struct Rect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// `img` cropped to `r`, sharing its pixels.
+static ImageView CropView(const ImageView& img, const Rect& r) {
+    char* data = static_cast<char*>(img.data) + r.y * img.rowBytes + (std::ptrdiff_t)r.x * LiteGlowCore::PixelBytes(img.format);
+    return ImageView{ data, img.rowBytes, r.width, r.height, img.format };
+}
+
+// Output rect `index` of a case: the first one is a single pixel, the second
+// touches the right and bottom edges, the others are anywhere. The same
+// arguments always give the same rect.
+static Rect RandomRect(int width, int height, int index) {
+    uint32_t seed = 777u + 7919u * (uint32_t)index;
+    Rect r;
+    r.width = index == 0 ? 1 : 1 + (int)(NextRandom(seed) % (uint32_t)width);
+    r.height = index == 0 ? 1 : 1 + (int)(NextRandom(seed) % (uint32_t)height);
+    r.x = (int)(NextRandom(seed) % (uint32_t)(width - r.width + 1));
+    r.y = (int)(NextRandom(seed) % (uint32_t)(height - r.height + 1));
+    if (index == 1) {
+        r.x = width - r.width;
+        r.y = height - r.height;
+    }
+    return r;
+}
+
+// The input SmartPreRender checks out for output rect `out` of a `width` x
+// `height` frame (GetGlowApron and GetGlowGridStep in LiteGlow.cpp, for the
+// blur that renders).
+static Rect InputRect(const Rect& out, int width, int height, const Settings& settings,
+                      const LiteGlowCore::BlurSetup& blur)
+{
+    const int apronX = (LiteGlowCore::BlurReach(blur, true) + 1) * blur.factor;
+    const int apronY = (LiteGlowCore::BlurReach(blur, false) + 1) * blur.factor;
+    const int grid = LiteGlowCore::GlowGridStep(settings);
+    const int left = std::max(0, out.x - apronX) / grid * grid;
+    const int top = std::max(0, out.y - apronY) / grid * grid;
+    const int right = std::min(width, (out.x + out.width + apronX + grid - 1) / grid * grid);
+    const int bottom = std::min(height, (out.y + out.height + apronY + grid - 1) / grid * grid);
+    return Rect{ left, top, right - left, bottom - top };
+}
+
+// Renders the whole frame and the random rects with `blur`, adding to
+// `result`. Returns false if a render fails.
+static bool RunRectParityWith(const Frame& input, const Settings& settings, const LiteGlowCore::BlurSetup& blur,
+                              bool fixedPoint, ParityResult& result)
+{
+    const ImageView& in = input.view;
+    // Largest code (or value) of the format
+    const double white = in.format == LiteGlowCore::FORMAT_ARGB32 ? 255.0
+                       : in.format == LiteGlowCore::FORMAT_ARGB64 ? 32768.0 : 1.0;
+    const bool floatSums = blur.hlslIterations == 0 && (blur.pyramid || blur.resample > 1.0f || !fixedPoint);
+    double tolerance = 0.0;
+    if (blur.gaussian) {
+        tolerance = RECT_PARITY_GAUSSIAN_CODES * white / 255.0;
+    } else if (in.format == LiteGlowCore::FORMAT_ARGB128) {
+        tolerance = PARITY_FLOAT_TOLERANCE;
+    } else if (floatSums) {
+        tolerance = RECT_PARITY_ROUNDING_CODES;
+    }
+    const Frame full = MakeFrame(in.width, in.height, in.format);
+    LiteGlowCore::SetStreamingThreshold(NO_STREAMING);
+    LiteGlowCache::Clear();
+    if (LiteGlowCore::RenderGlowWithBlur(in, full.view, 0, 0, settings, blur) != LiteGlowCore::STATUS_OK) return false;
+
+    // The rects on the frame path, then the whole frame (rect -1) and the
+    // rects streamed, if the blur streams at all
+    LiteGlowCore::SetStreamingThreshold(0);
+    const bool streams = LiteGlowCore::StreamsRender(blur, in.format, in.width, in.height);
+    for (int pass = 0; pass < (streams ? 2 : 1); ++pass) {
+        LiteGlowCore::SetStreamingThreshold(pass ? 0 : NO_STREAMING);
+        for (int i = pass ? -1 : 0; i < RECT_PARITY_RECTS; ++i) {
+            const Rect out = i < 0 ? Rect{ 0, 0, in.width, in.height } : RandomRect(in.width, in.height, i);
+            const Rect from = InputRect(out, in.width, in.height, settings, blur);
+            const Frame part = MakeFrame(out.width, out.height, in.format);
+            LiteGlowCache::Clear();
+            if (LiteGlowCore::RenderGlowWithBlur(CropView(in, from), part.view, out.x - from.x, out.y - from.y,
+                                                 settings, blur) != LiteGlowCore::STATUS_OK) {
+                return false;
+            }
+            const double d = MaxDifference(CropView(full.view, out), part.view);
+            ++result.frames;
+            result.streamed += pass;
+            result.mismatches += d > tolerance;
+            result.worst = std::max(result.worst, d);
+        }
+    }
+    return true;
+}
+
+// Sub-rect and streamed renders of one case against its full-frame render,
+// with `streamBytes` (--stream-mb) as the threshold again afterwards.
+// Returns false if a render fails.
+static bool RunRectParity(const Frame& input, const Settings& settings, bool fixedPoint, std::size_t streamBytes,
+                          ParityResult& result)
+{
+    result = ParityResult{ 0, 0, 0.0, 0 };
+    bool rendered = true;
+    if (settings.quality == QUALITY_AUTO) {
+        for (int plan = 0; plan < LiteGlowCore::AUTO_PLANS && rendered; ++plan) {
+            LiteGlowCore::BlurSetup blur;
+            if (LiteGlowCore::GetAutoPlan(settings, plan, blur)) {
+                rendered = RunRectParityWith(input, settings, blur, fixedPoint, result);
+            }
+        }
+    } else {
+        rendered = RunRectParityWith(input, settings, LiteGlowCore::GetBlurSetup(settings), fixedPoint, result);
+    }
+    LiteGlowCore::SetStreamingThreshold(streamBytes);
+    LiteGlowCache::Clear();
+    return rendered;
+}
+
+// Renders a `width` x `height` frame of Box High (factor 1, the smallest
+// frame for a given plane size) whose intermediates take just over
+// STREAMING_DEFAULT_BYTES if `over`, else just under it, with the default
+// threshold, and compares it with a render on the frame path. Sets `height`
+// and `streamed`. Returns false if a render fails.
+static bool RunThresholdParity(int bpc, bool over, bool fixedPoint, std::size_t streamBytes, int& height,
+                               bool& streamed, ParityResult& result)
+{
+    const PixelFormat format = FormatForBpc(bpc);
+    const Settings settings = MakeSettings(10, QUALITY_HIGH, BLUR_MODE_BOX, 0);
+    const LiteGlowCore::BlurSetup blur = LiteGlowCore::GetBlurSetup(settings);
+    // The first height that streams
+    LiteGlowCore::SetStreamingThreshold(LiteGlowCore::STREAMING_DEFAULT_BYTES);
+    int low = 1, high = 1 << 16;
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (LiteGlowCore::StreamsRender(blur, format, THRESHOLD_FRAME_WIDTH, mid)) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    height = over ? low : low - 1;
+
+    const Frame input = MakeFrame(THRESHOLD_FRAME_WIDTH, height, format);
+    const Frame full = MakeFrame(THRESHOLD_FRAME_WIDTH, height, format);
+    const Frame output = MakeFrame(THRESHOLD_FRAME_WIDTH, height, format);
+    FillFrame(input.view, CONTENT_SPARSE);
+    StageTimes times;
+    LiteGlowCore::SetStreamingThreshold(NO_STREAMING);
+    LiteGlowCache::Clear();
+    bool rendered = LiteGlowCore::RenderGlowWithBlur(input.view, full.view, 0, 0, settings, blur) ==
+                    LiteGlowCore::STATUS_OK;
+    LiteGlowCore::SetStreamingThreshold(LiteGlowCore::STREAMING_DEFAULT_BYTES);
+    LiteGlowCache::Clear();
+    rendered = rendered && LiteGlowCore::RenderGlowWithBlur(input.view, output.view, 0, 0, settings, blur, &times) ==
+                           LiteGlowCore::STATUS_OK;
+    LiteGlowCore::SetStreamingThreshold(streamBytes);
+    LiteGlowCache::Clear();
+    if (!rendered) return false;
+
+    const double tolerance = format == LiteGlowCore::FORMAT_ARGB128 ? PARITY_FLOAT_TOLERANCE
+                           : fixedPoint ? 0.0 : RECT_PARITY_ROUNDING_CODES;
+    const double d = MaxDifference(full.view, output.view);
+    streamed = times.ms[LiteGlowCore::STAGE_STREAM] > 0.0;
+    result = ParityResult{ 1, d > tolerance || streamed != over, d, streamed ? 1 : 0 };
+    return true;
+}
+
+// =============================================================================
+// JSON
+// =============================================================================
+// Written one case per line so --compare can read it back with a line scanner.
+
+static bool WriteJson(const char* path, const BenchOptions& opt, const std::vector<CaseResult>& results) {
+    FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+    std::fprintf(f, "{\n  \"benchmark\": \"GlowBench\",\n  \"version\": 1,\n");
+    std::fprintf(f, "  \"isa\": \"%s\",\n  \"workers\": %d,\n  \"fixed_point\": %s,\n  \"repeats\": %d,\n",
+                 LiteGlowSimd::IsaName(LiteGlowSimd::Kernels().isa), LiteGlowSched::WorkerCount(),
+                 opt.fixedPoint ? "true" : "false", opt.repeats);
+    std::fprintf(f, "  \"pipeline\": \"%s\",\n  \"stream_mb\": %g,\n", LiteGlowCore::PipelineName(opt.pipeline),
+                 opt.streamMb);
+    std::fprintf(f, "  \"unit\": \"megapixels of the full frame per second\",\n  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const CaseResult& c = results[i];
+        std::fprintf(f, "    {\"case\": \"%s\", \"width\": %d, \"height\": %d, \"bpc\": %d, \"radius\": %d, "
+                        "\"quality\": \"%s\", \"blur\": \"%s\", \"content\": \"%s\", \"stages\": {",
+                     c.id.c_str(), c.width, c.height, c.bpc, c.radius, QUALITY_NAMES[c.quality - QUALITY_LOW],
+                     BLUR_NAMES[c.blur - BLUR_MODE_BOX], CONTENT_NAMES[c.content]);
+        for (size_t s = 0; s < c.stages.size(); ++s) {
+            const StageResult& r = c.stages[s];
+            std::fprintf(f, "%s\"%s\": {\"ms\": %.4f, \"mpps\": %.2f", s ? ", " : "", r.name.c_str(), r.ms, r.mpps);
+            if (r.minBytes > 0.0) std::fprintf(f, ", \"min_bytes\": %.0f", r.minBytes);
+            for (int k = 0; k < LiteGlowPerf::COUNTERS; ++k) {
+                if (Has(r.counts, (LiteGlowPerf::Counter)k)) {
+                    std::fprintf(f, ", \"%s\": %llu", LiteGlowPerf::CounterName((LiteGlowPerf::Counter)k),
+                                 (unsigned long long)r.counts.value[k]);
+                }
+            }
+            std::fprintf(f, "}");
+        }
+        std::fprintf(f, "}}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    return std::fclose(f) == 0;
+}
+
+// Reads the cases of a file written by WriteJson (only id and stage times).
+static bool ReadJson(const char* path, std::vector<CaseResult>& results) {
+    FILE* f = std::fopen(path, "r");
+    if (!f) return false;
+    std::string line;
+    char buf[4096];
+    while (std::fgets(buf, sizeof(buf), f)) {
+        line += buf;
+        if (line.empty() || line.back() != '\n') continue;  // Longer than buf: keep reading
+
+        const char* caseKey = "{\"case\": \"";
+        const size_t at = line.find(caseKey);
+        if (at != std::string::npos) {
+            CaseResult c = {};
+            const size_t idBegin = at + std::strlen(caseKey);
+            c.id = line.substr(idBegin, line.find('"', idBegin) - idBegin);
+            // Every stage is "name": {"ms": x, "mpps": y}
+            const char* stageKey = "\": {\"ms\": ";
+            for (size_t pos = line.find(stageKey); pos != std::string::npos; pos = line.find(stageKey, pos + 1)) {
+                const size_t nameBegin = line.rfind('"', pos - 1) + 1;
+                StageResult s;
+                s.name = line.substr(nameBegin, pos - nameBegin);
+                if (std::sscanf(line.c_str() + pos + std::strlen(stageKey), "%lf, \"mpps\": %lf", &s.ms, &s.mpps) == 2) {
+                    c.stages.push_back(s);
+                }
+            }
+            results.push_back(c);
+        }
+        line.clear();
+    }
+    std::fclose(f);
+    return true;
+}
+
+// Prints every stage slower than the baseline by more than opt.threshold
+// percent. Returns the number of regressions.
+static int Compare(const BenchOptions& opt, const std::vector<CaseResult>& baseline,
+                   const std::vector<CaseResult>& results)
+{
+    int regressions = 0, compared = 0, missing = 0;
+    std::printf("\nCompared with %s (regression: more than %.1f%% slower)\n", opt.comparePath, opt.threshold);
+    for (const CaseResult& c : results) {
+        const CaseResult* base = nullptr;
+        for (const CaseResult& b : baseline) {
+            if (b.id == c.id) base = &b;
+        }
+        if (!base) {
+            ++missing;
+            continue;
+        }
+        for (const StageResult& s : c.stages) {
+            const StageResult* b = FindStage(*base, s.name);
+            if (!b || (s.ms < opt.minMs && b->ms < opt.minMs)) continue;
+            ++compared;
+            const double change = (s.mpps / b->mpps - 1.0) * 100.0;
+            if (change < -opt.threshold) {
+                ++regressions;
+                std::printf("  REGRESSION %-40s %-10s %10.1f -> %10.1f MP/s (%+.1f%%)\n",
+                            c.id.c_str(), s.name.c_str(), b->mpps, s.mpps, change);
+            }
+        }
+    }
+    std::printf("%d stages compared, %d regressions", compared, regressions);
+    if (missing) std::printf(", %d cases not in the baseline", missing);
+    std::printf("\n");
+    return regressions;
+}
+
+// =============================================================================
+// Command Line
+// =============================================================================
+
+// Parses a comma-separated list: numbers, or names from `names` (value =
+// index + base). Returns false on an unknown entry.
+static bool ParseList(const char* arg, const char* const* names, int nameCount, int base, std::vector<int>& out) {
+    out.clear();
+    std::string s(arg);
+    size_t begin = 0;
+    while (begin <= s.size()) {
+        size_t end = s.find(',', begin);
+        if (end == std::string::npos) end = s.size();
+        const std::string item = s.substr(begin, end - begin);
+        int value = -1;
+        for (int i = 0; i < nameCount; ++i) {
+            if (item == names[i]) value = base + i;
+        }
+        if (value < 0 && !names) {
+            char* rest = nullptr;
+            const long v = std::strtol(item.c_str(), &rest, 10);
+            if (!item.empty() && *rest == '\0') value = (int)v;
+        }
+        if (value < 0) return false;
+        out.push_back(value);
+        begin = end + 1;
+    }
+    return !out.empty();
+}
+
+static bool ParseSizes(const char* arg, std::vector<int>& out) {
+    const char* names[] = { FRAME_SIZES[0].name, FRAME_SIZES[1].name, FRAME_SIZES[2].name, FRAME_SIZES[3].name };
+    return ParseList(arg, names, 4, 0, out);
+}
+
+static bool ParseArgs(int argc, char** argv, BenchOptions& opt) {
+    opt.sizes = { 0, 1, 2, 3 };
+    opt.radii = { 1, 5, 10, 25, 50 };
+    opt.qualities = { QUALITY_LOW, QUALITY_MEDIUM, QUALITY_HIGH, QUALITY_PYRAMID, QUALITY_ADAPTIVE, QUALITY_AUTO };
+    opt.bpcs = { 8, 16, 32 };
+    opt.contents = { CONTENT_BLACK, CONTENT_SPARSE, CONTENT_HIGHLIGHTS, CONTENT_DENSE };
+    opt.blurs = { BLUR_MODE_BOX };
+    opt.previews = { 0 };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool ok = true;
+        if (a == "--quick") {
+            opt.sizes = { 1 };
+            opt.radii = { 5, 25 };
+            opt.contents = { CONTENT_SPARSE, CONTENT_DENSE };
+            opt.pixelShapes = true;
+            continue;
+        } else if (a == "--no-fixed-point") {
+            opt.fixedPoint = false;
+            continue;
+        } else if (a == "--counters") {
+            opt.counters = true;
+            continue;
+        } else if (a == "--temporal") {
+            opt.temporal = true;
+            continue;
+        } else if (a == "--parity") {
+            opt.parity = true;
+            continue;
+        } else if (a == "--rect-parity") {
+            opt.rectParity = true;
+            continue;
+        } else if (!v) {
+            ok = false;
+        } else if (a == "--sizes") {
+            ok = ParseSizes(v, opt.sizes);
+        } else if (a == "--radii") {
+            ok = ParseList(v, nullptr, 0, 0, opt.radii);
+            for (int r : opt.radii) ok &= r >= RADIUS_MIN && r <= RADIUS_MAX;
+        } else if (a == "--quality") {
+            ok = ParseList(v, QUALITY_NAMES, QUALITY_NUM_CHOICES, QUALITY_LOW, opt.qualities);
+        } else if (a == "--bpc") {
+            ok = ParseList(v, nullptr, 0, 0, opt.bpcs);
+            for (int b : opt.bpcs) ok &= b == 8 || b == 16 || b == 32;
+        } else if (a == "--content") {
+            ok = ParseList(v, CONTENT_NAMES, CONTENTS, 0, opt.contents);
+        } else if (a == "--blur") {
+            ok = ParseList(v, BLUR_NAMES, BLUR_MODE_NUM_CHOICES, BLUR_MODE_BOX, opt.blurs);
+        } else if (a == "--preview") {
+            ok = ParseList(v, PREVIEW_NAMES, 3, 0, opt.previews);
+        } else if (a == "--repeats") {
+            opt.repeats = std::atoi(v);
+            ok = opt.repeats > 0;
+        } else if (a == "--budget-ms") {
+            opt.budgetMs = std::atof(v);
+            ok = opt.budgetMs > 0.0;
+        } else if (a == "--isa") {
+            ok = LiteGlowSimd::ParseIsa(v, opt.isa);
+        } else if (a == "--pipeline") {
+            ok = LiteGlowCore::ParsePipeline(v, opt.pipeline);
+        } else if (a == "--stream-mb") {
+            opt.streamMb = std::atof(v);
+            ok = opt.streamMb >= 0.0;
+        } else if (a == "--json") {
+            opt.jsonPath = v;
+        } else if (a == "--compare") {
+            opt.comparePath = v;
+        } else if (a == "--threshold") {
+            opt.threshold = std::atof(v);
+            ok = opt.threshold >= 0.0;
+        } else if (a == "--min-ms") {
+            opt.minMs = std::atof(v);
+        } else if (a == "--peak-gbs") {
+            opt.peakGBs = std::atof(v);
+            ok = opt.peakGBs > 0.0;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "bad argument: %s%s%s\n", a.c_str(), v ? " " : "", v ? v : "");
+            return false;
+        }
+        ++i;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!ParseArgs(argc, argv, opt)) {
+        std::fprintf(stderr, "usage: %s [--quick] [--sizes HD,2K,4K,8K] [--radii 1,5,10,25,50]\n"
+                             "  [--quality low,medium,high,pyramid,adaptive,auto] [--budget-ms ms] [--bpc 8,16,32]\n"
+                             "  [--content black,sparse,highlights,dense] [--blur box,gaussian] [--preview full,half,quarter]\n"
+                             "  [--repeats N] [--isa name] [--no-fixed-point] [--counters] [--peak-gbs GB/s]\n"
+                             "  [--pipeline cpu|hlsl] [--stream-mb MB] [--temporal] [--parity] [--rect-parity] [--json out.json] [--compare baseline.json] [--threshold pct] [--min-ms ms]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::vector<CaseResult> baseline;
+    if (opt.comparePath && !ReadJson(opt.comparePath, baseline)) {
+        std::fprintf(stderr, "cannot read %s\n", opt.comparePath);
+        return 2;
+    }
+
+    LiteGlowSimd::SelectKernels(opt.isa);
+    LiteGlowCore::SetFixedPoint(opt.fixedPoint);
+    LiteGlowCore::SetPipeline(opt.pipeline);
+    const size_t streamBytes = (size_t)(opt.streamMb * (1 << 20));
+    LiteGlowCore::SetStreamingThreshold(streamBytes);
+    if (opt.counters) {
+        LiteGlowCore::SetStageCounters(true);
+        const unsigned available = LiteGlowPerf::Available();
+        std::printf("Counters:");
+        for (int k = 0; k < LiteGlowPerf::COUNTERS; ++k) {
+            std::printf(" %s%s", LiteGlowPerf::CounterName((LiteGlowPerf::Counter)k),
+                        available & (1u << k) ? "" : " (unavailable)");
+        }
+        std::printf("\n");
+    }
+    std::printf("Glow pipeline (%s), %s kernels, %d workers + caller, best of %d, fixed point %s, "
+                "streaming over %g MB\n",
+                LiteGlowCore::PipelineName(opt.pipeline), LiteGlowSimd::IsaName(LiteGlowSimd::Kernels().isa),
+                LiteGlowSched::WorkerCount(), opt.repeats, opt.fixedPoint ? "on" : "off", opt.streamMb);
+    if (opt.parity || opt.rectParity) {
+        std::printf("%-40s %s%s%s renders against full ones\n", "case", opt.parity ? "temporal" : "",
+                    opt.parity && opt.rectParity ? " and " : "", opt.rectParity ? "sub-rect" : "");
+    } else {
+        std::printf("%-40s %10s %10s  stages (MP/s)\n", "case", "total ms", "MP/s");
+    }
+
+    std::vector<CaseResult> results;
+    int targetCases = 0, targetMet = 0;
+    bool ok = true;
+    int parityCases = 0, parityFailed = 0;
+    auto reportParity = [&](const std::string& id, bool rendered, const ParityResult& parity, const char* unit) {
+        ++parityCases;
+        if (!rendered || parity.mismatches) {
+            ++parityFailed;
+            ok = false;
+        }
+        if (!rendered) {
+            std::printf("%-40s FAILED\n", id.c_str());
+            return;
+        }
+        std::printf("%-40s %2d %s", id.c_str(), parity.frames, unit);
+        if (parity.streamed) std::printf(" (%d streamed)", parity.streamed);
+        std::printf(", worst difference %g%s\n", parity.worst, parity.mismatches ? " MISMATCH" : "");
+    };
+    // Runs and prints one case; `targeted` cases count towards the 2K target
+    auto runCase = [&](const Frame& input, const Frame& output, const Settings& settings, CaseResult& c,
+                       bool targeted) {
+        if (opt.parity || opt.rectParity) {
+            for (int kind = 0; kind < 2; ++kind) {
+                if (!(kind ? opt.rectParity : opt.parity)) continue;
+                ParityResult parity;
+                const bool rendered = kind ? RunRectParity(input, settings, opt.fixedPoint, streamBytes, parity)
+                                           : RunParity(input, settings, parity);
+                reportParity(kind ? c.id + "/rects" : c.id, rendered, parity, kind ? "rects" : "frames");
+            }
+            return;
+        }
+        if (!RunCase(input, output, settings, opt.repeats, opt.budgetMs, opt.temporal, c)) {
+            std::printf("%-40s FAILED\n", c.id.c_str());
+            ok = false;
+            return;
+        }
+        const StageResult* total = FindStage(c, "end_to_end");
+        std::printf("%-40s %10.2f %10.1f ", c.id.c_str(), total->ms, total->mpps);
+        for (const StageResult& s : c.stages) {
+            if (&s != total) std::printf(" %s %.0f", s.name.c_str(), s.mpps);
+        }
+        if (!c.plan.empty()) std::printf(" (%s)", c.plan.c_str());
+        std::printf("\n");
+        if (opt.counters) PrintCounters(c, opt);
+        if (targeted) {
+            ++targetCases;
+            targetMet += total->ms < TARGET_2K_MS;
+        }
+        results.push_back(c);
+    };
+    // Every size at every preview resolution
+    for (size_t sp = 0; sp < opt.sizes.size() * opt.previews.size(); ++sp) {
+        const int preview = opt.previews[sp % opt.previews.size()];
+        const FrameSize& fs = FRAME_SIZES[opt.sizes[sp / opt.previews.size()]];
+        const int width = fs.width / PREVIEW_DIVISORS[preview];
+        const int height = fs.height / PREVIEW_DIVISORS[preview];
+        const std::string sizeName = preview ? std::string(fs.name) + "@" + PREVIEW_NAMES[preview] : fs.name;
+        for (int bpc : opt.bpcs) {
+            const PixelFormat format = FormatForBpc(bpc);
+            const Frame input = MakeFrame(width, height, format);
+            const Frame output = MakeFrame(width, height, format);
+            for (int content : opt.contents) {
+                FillFrame(input.view, (Content)content);
+                for (int radius : opt.radii) {
+                    for (int quality : opt.qualities) {
+                        for (int blur : opt.blurs) {
+                            // Pyramid has its own blur; run it once
+                            if (quality == QUALITY_PYRAMID && blur != opt.blurs.front()) continue;
+
+                            CaseResult c = {};
+                            c.width = width;
+                            c.height = height;
+                            c.bpc = bpc;
+                            c.radius = radius;
+                            c.quality = quality;
+                            c.blur = blur;
+                            c.content = content;
+                            c.id = sizeName + "/" + std::to_string(bpc) + "bpc/r" + std::to_string(radius) +
+                                   "/" + QUALITY_NAMES[quality - QUALITY_LOW] + "/" + BLUR_NAMES[blur - BLUR_MODE_BOX] +
+                                   "/" + CONTENT_NAMES[content] + (opt.temporal ? "/temporal" : "");
+                            runCase(input, output, MakeSettings(radius, quality, blur, preview), c,
+                                    std::strcmp(fs.name, "2K") == 0 && !preview);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Wide pixels and uneven previews at the first size: every Quality has
+    // to render them (case names get the shape after the content)
+    for (const PixelShape& shape : PIXEL_SHAPES) {
+        if (!opt.pixelShapes) break;
+        const FrameSize& fs = FRAME_SIZES[opt.sizes.front()];
+        const int width = fs.width / shape.previewDivisorX;
+        const int height = fs.height / shape.previewDivisorY;
+        const Frame input = MakeFrame(width, height, LiteGlowCore::FORMAT_ARGB32);
+        const Frame output = MakeFrame(width, height, LiteGlowCore::FORMAT_ARGB32);
+        FillFrame(input.view, CONTENT_SPARSE);
+        for (int radius : PIXEL_SHAPE_RADII) {
+            for (int quality : opt.qualities) {
+                Settings settings = MakeSettings(radius, quality, opt.blurs.front(), 0);
+                settings.parNum = shape.parNum;
+                settings.parDen = shape.parDen;
+                settings.previewScaleX = 1.0f / shape.previewDivisorX;
+                settings.previewScaleY = 1.0f / shape.previewDivisorY;
+                CaseResult c = {};
+                c.width = width;
+                c.height = height;
+                c.bpc = 8;
+                c.radius = radius;
+                c.quality = quality;
+                c.blur = opt.blurs.front();
+                c.content = CONTENT_SPARSE;
+                c.id = std::string(fs.name) + "/8bpc/r" + std::to_string(radius) + "/" +
+                       QUALITY_NAMES[quality - QUALITY_LOW] + "/" + BLUR_NAMES[c.blur - BLUR_MODE_BOX] +
+                       "/sparse/" + shape.name + (opt.temporal ? "/temporal" : "");
+                runCase(input, output, settings, c, false);
+            }
+        }
+    }
+
+    // --rect-parity: streamed frames one pixel wide or high at every Box
+    // Quality, and the frames around the default streaming threshold
+    for (const FrameSize& fs : STREAM_EDGE_SIZES) {
+        if (!opt.rectParity) break;
+        for (int bpc : opt.bpcs) {
+            const Frame input = MakeFrame(fs.width, fs.height, FormatForBpc(bpc));
+            FillFrame(input.view, CONTENT_DENSE);
+            for (int radius : STREAM_EDGE_RADII) {
+                for (int quality : { QUALITY_LOW, QUALITY_MEDIUM, QUALITY_HIGH }) {
+                    ParityResult parity;
+                    const bool rendered = RunRectParity(input, MakeSettings(radius, quality, BLUR_MODE_BOX, 0),
+                                                        opt.fixedPoint, streamBytes, parity);
+                    reportParity(std::string(fs.name) + "/" + std::to_string(bpc) + "bpc/r" + std::to_string(radius) +
+                                     "/" + QUALITY_NAMES[quality - QUALITY_LOW] + "/box/dense/rects",
+                                 rendered, parity, "rects");
+                }
+            }
+        }
+    }
+    // The HLSL emulation never streams, so no height would cross the threshold
+    const bool thresholdParity = opt.rectParity && opt.pipeline == LiteGlowCore::PIPELINE_CPU;
+    for (int bpc : opt.bpcs) {
+        for (int over = 0; over < 2 && thresholdParity; ++over) {
+            ParityResult parity;
+            int height = 0;
+            bool streamed = false;
+            const bool rendered = RunThresholdParity(bpc, over != 0, opt.fixedPoint, streamBytes, height, streamed,
+                                                     parity);
+            reportParity(std::to_string(THRESHOLD_FRAME_WIDTH) + "x" + std::to_string(height) + "/" +
+                             std::to_string(bpc) + "bpc/r10/high/box/sparse/" + (over ? "over" : "under") +
+                             (streamed ? "/streamed" : "/frame"),
+                         rendered, parity, "frames");
+        }
+    }
+
+    const LiteGlowMem::ScratchStats scratch = LiteGlowMem::GetScratchStats();
+    std::printf("\nScratch: peak %.1f MB in use, %.1f MB with the cache; %llu reuses, %llu system allocations\n",
+                scratch.peakBytesInUse / 1048576.0, scratch.peakBytesTotal / 1048576.0,
+                (unsigned long long)scratch.reuses, (unsigned long long)scratch.systemAllocs);
+    if (parityCases) {
+        std::printf("\nParity: %d of %d cases match full renders\n", parityCases - parityFailed, parityCases);
+    }
+    if (targetCases) {
+        std::printf("\n2K target (< %.0f ms end to end): met by %d of %d cases\n", TARGET_2K_MS, targetMet, targetCases);
+    }
+    if (opt.jsonPath) {
+        if (!WriteJson(opt.jsonPath, opt, results)) {
+            std::fprintf(stderr, "cannot write %s\n", opt.jsonPath);
+            ok = false;
+        } else {
+            std::printf("Results written to %s\n", opt.jsonPath);
+        }
+    }
+    if (opt.comparePath && Compare(opt, baseline, results) > 0) return 1;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,266 @@
+// =============================================================================
+// GlowReplay - renders captured production frames again
+// =============================================================================
+// Replays the capture files the plugin writes with LITEGLOW_CAPTURE set
+// (LiteGlow_Capture.h): each file is mapped read-only and its input pixels
+// are rendered in place, with the captured settings and output rect, through
+// the same calls ProcessWorlds makes: Quality Auto through the governor
+// with the captured Budget, the rest through the temporal cache under the
+// captured instance id. No AE SDK needed, so a slow shot can be profiled on
+// any machine (perf, VTune, LITEGLOW_TRACE-style traces with --trace).
+//
+// Every repeat renders the frame twice, as GlowBench does: once stage by
+// stage (StageTimes) and once as the plugin runs it (end_to_end). The best
+// and median of each are reported, in megapixels of the output per second.
+// The glow and temporal caches are cleared before every render unless
+// --cached is given; then they are kept across renders and files, to see
+// what hits save (repeats of one frame hit them fully, so the first render
+// is the cold one, and consecutive captures of an instance diff against
+// each other). The governor's cost models are always kept, as the plugin
+// keeps them, so Auto plans settle over the repeats and the captures of an
+// instance; the plan of each frame's last render is printed. The scratch
+// pool's peaks over the whole run end the output (and the --trace file).
+//
+// Build and run (from the repository root):
+//   cmake -S . -B build && cmake --build build -j
+//   ./build/GlowReplay [options] capture.lgcap...
+// Options:
+//   --repeats N (default 10)     --cached
+//   --isa scalar|sse4.1|avx2|avx512 (default: widest supported)
+//   --no-fixed-point             --counters
+//   --pipeline cpu|hlsl (default cpu; hlsl is the CPU emulation of the GPU shaders)
+//   --stream-mb MB (Box renders with more intermediates than this stream; default 256, 0 = all)
+//   --trace out.json
+
+#include "BenchTiming.h"
+#include "LiteGlow_Capture.h"
+#include "LiteGlow_Core.h"
+#include "LiteGlow_GlowCache.h"
+#include "LiteGlow_Governor.h"
+#include "LiteGlow_Scheduler.h"
+#include "LiteGlow_ScratchPool.h"
+#include "LiteGlow_Simd.h"
+#include "LiteGlow_TemporalCache.h"
+#include "LiteGlow_Trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using LiteGlowCore::StageTimes;
+
+struct ReplayOptions {
+    std::vector<const char*> paths;
+    int repeats = 10;
+    bool cached = false;
+    bool fixedPoint = true;
+    LiteGlowCore::Pipeline pipeline = LiteGlowCore::PIPELINE_CPU;
+    double streamMb = (double)(LiteGlowCore::STREAMING_DEFAULT_BYTES >> 20);
+    bool counters = false;
+    LiteGlowSimd::Isa isa = LiteGlowSimd::DetectIsa();
+    const char* tracePath = nullptr;
+};
+
+const char* const QUALITY_NAMES[] = { "low", "medium", "high", "pyramid", "adaptive", "auto" };  // 1-based Quality popup
+const char* const BLUR_NAMES[] = { "box", "gaussian" };                      // 1-based Blur Mode popup
+
+static const char* Name(const char* const* names, int count, int value) {
+    return value >= 1 && value <= count ? names[value - 1] : "?";
+}
+
+static int Bpc(LiteGlowCore::PixelFormat format) {
+    return LiteGlowCore::PixelBytes(format) * 2;
+}
+
+// Best and median of `ms`, which is reordered.
+static void BestMedian(std::vector<double>& ms, double& best, double& median) {
+    std::sort(ms.begin(), ms.end());
+    best = ms.front();
+    median = ms[ms.size() / 2];
+}
+
+// Renders `frame` as ProcessWorlds does.
+static LiteGlowCore::Status RenderAsPlugin(const LiteGlowCapture::Frame& frame, const LiteGlowCore::ImageView& output,
+                                           LiteGlowGovernor::Choice& choice, StageTimes* t) {
+    const LiteGlowCore::Settings& s = frame.settings;
+    if (s.quality == QUALITY_AUTO) {
+        return LiteGlowGovernor::Render(frame.instance, frame.budgetMs, frame.input, output, frame.outputX,
+                                        frame.outputY, s, &choice, t);
+    }
+    return LiteGlowCore::RenderGlowTemporal(frame.instance, frame.input, output, frame.outputX, frame.outputY, s,
+                                            LiteGlowCore::GetBlurSetup(s), t);
+}
+
+static void ClearCaches(const ReplayOptions& opt) {
+    if (opt.cached) return;
+    LiteGlowCache::Clear();
+    LiteGlowTemporal::Clear();
+}
+
+// Replays one mapped capture. Returns false if a render fails.
+static bool Replay(const char* path, const LiteGlowCapture::Frame& frame, const ReplayOptions& opt) {
+    const LiteGlowCore::Settings& s = frame.settings;
+    std::printf("%s: %dx%d %dbpc, output %dx%d at (%d,%d), t=%.3fs, instance %016llx\n", path, frame.input.width,
+                frame.input.height, Bpc(frame.input.format), frame.outputWidth, frame.outputHeight, frame.outputX,
+                frame.outputY, frame.time, (unsigned long long)frame.instance);
+    std::printf("  radius %.1f, quality %s, blur %s, strength %.1f, threshold %.1f, blend %d, par %d/%d, field %d, "
+                "preview %gx%g\n",
+                s.radius, Name(QUALITY_NAMES, 6, s.quality), Name(BLUR_NAMES, 2, s.blurMode), s.strength,
+                s.threshold, s.blendMode, s.parNum, s.parDen, (int)s.field, LiteGlowCore::PreviewScale(s.previewScaleX),
+                LiteGlowCore::PreviewScale(s.previewScaleY));
+
+    const LiteGlowCore::PixelFormat format = frame.input.format;
+    const std::ptrdiff_t rowBytes = (std::ptrdiff_t)frame.outputWidth * LiteGlowCore::PixelBytes(format);
+    std::vector<char> outputBytes((size_t)rowBytes * frame.outputHeight);
+    const LiteGlowCore::ImageView output{ outputBytes.data(), rowBytes, frame.outputWidth, frame.outputHeight, format };
+
+    std::vector<double> stageMs[LiteGlowCore::STAGES];
+    std::vector<double> totalMs;
+    double bestStageMs[LiteGlowCore::STAGES];
+    LiteGlowPerf::Counts counts[LiteGlowCore::STAGES] = {};  // Of the best run of each stage
+    std::fill(bestStageMs, bestStageMs + LiteGlowCore::STAGES, 1e30);
+    LiteGlowGovernor::Choice choice = {};
+    for (int i = 0; i < opt.repeats; ++i) {
+        StageTimes t;
+        ClearCaches(opt);
+        LiteGlowCore::Status status = RenderAsPlugin(frame, output, choice, &t);
+        if (status == LiteGlowCore::STATUS_OK) {
+            for (int stage = 0; stage < LiteGlowCore::STAGES; ++stage) {
+                stageMs[stage].push_back(t.ms[stage]);
+                if (t.ms[stage] < bestStageMs[stage]) {
+                    bestStageMs[stage] = t.ms[stage];
+                    counts[stage] = t.counts[stage];
+                }
+            }
+
+            ClearCaches(opt);
+            totalMs.push_back(LiteGlowBench::TimeMs([&] { status = RenderAsPlugin(frame, output, choice, nullptr); }));
+        }
+        if (status != LiteGlowCore::STATUS_OK) {
+            std::printf("  FAILED (status %d)\n", (int)status);
+            return false;
+        }
+    }
+
+    const bool governed = s.quality == QUALITY_AUTO;
+    const LiteGlowCore::BlurSetup setup = governed ? choice.blur : LiteGlowCore::GetBlurSetup(s);
+    if (governed) {
+        const char* blur = setup.hlslIterations > 0 ? "hlsl" : setup.gaussian ? "gaussian" : "box";
+        std::printf("  budget %.1f ms: plan %d, %dx %s, predicted %.1f ms, took %.1f ms\n", frame.budgetMs,
+                    choice.plan, setup.factor, blur, choice.predictedMs, choice.measuredMs);
+    }
+    const double mp = (double)frame.outputWidth * frame.outputHeight / 1e6;
+    std::printf("  %-10s %10s %10s %10s\n", "stage", "best ms", "median ms", "MP/s");
+    for (int i = 0; i < LiteGlowCore::STAGES; ++i) {
+        const LiteGlowCore::Stage stage = (LiteGlowCore::Stage)i;
+        const char* name = LiteGlowCore::StageName(stage, setup);
+        double best, median;
+        BestMedian(stageMs[stage], best, median);
+        if (!name || median <= 0.0) continue;
+        std::printf("  %-10s %10.3f %10.3f %10.1f", name, best, median, best > 0.0 ? mp / (best / 1000.0) : 0.0);
+        for (int k = 0; opt.counters && k < LiteGlowPerf::COUNTERS; ++k) {
+            if (counts[stage].available & (1u << k)) {
+                std::printf(" %s %llu", LiteGlowPerf::CounterName((LiteGlowPerf::Counter)k),
+                            (unsigned long long)counts[stage].value[k]);
+            }
+        }
+        std::printf("\n");
+    }
+    double best, median;
+    BestMedian(totalMs, best, median);
+    std::printf("  %-10s %10.3f %10.3f %10.1f\n", "end_to_end", best, median, mp / (best / 1000.0));
+    return true;
+}
+
+static bool ParseArgs(int argc, char** argv, ReplayOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool ok = true;
+        if (a.compare(0, 2, "--") != 0) {
+            opt.paths.push_back(argv[i]);
+            continue;
+        } else if (a == "--cached") {
+            opt.cached = true;
+            continue;
+        } else if (a == "--no-fixed-point") {
+            opt.fixedPoint = false;
+            continue;
+        } else if (a == "--counters") {
+            opt.counters = true;
+            continue;
+        } else if (!v) {
+            ok = false;
+        } else if (a == "--repeats") {
+            opt.repeats = std::atoi(v);
+            ok = opt.repeats > 0;
+        } else if (a == "--isa") {
+            ok = LiteGlowSimd::ParseIsa(v, opt.isa);
+        } else if (a == "--pipeline") {
+            ok = LiteGlowCore::ParsePipeline(v, opt.pipeline);
+        } else if (a == "--stream-mb") {
+            opt.streamMb = std::atof(v);
+            ok = opt.streamMb >= 0.0;
+        } else if (a == "--trace") {
+            opt.tracePath = v;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "bad argument: %s%s%s\n", a.c_str(), v ? " " : "", v ? v : "");
+            return false;
+        }
+        ++i;
+    }
+    return !opt.paths.empty();
+}
+
+int main(int argc, char** argv) {
+    ReplayOptions opt;
+    if (!ParseArgs(argc, argv, opt)) {
+        std::fprintf(stderr, "usage: %s [--repeats N] [--cached] [--isa name] [--no-fixed-point] [--counters]\n"
+                             "  [--pipeline cpu|hlsl] [--stream-mb MB] [--trace out.json] capture.lgcap...\n",
+                     argv[0]);
+        return 2;
+    }
+
+    LiteGlowSimd::SelectKernels(opt.isa);
+    LiteGlowCore::SetFixedPoint(opt.fixedPoint);
+    LiteGlowCore::SetPipeline(opt.pipeline);
+    LiteGlowCore::SetStreamingThreshold((size_t)(opt.streamMb * (1 << 20)));
+    LiteGlowCore::SetStageCounters(opt.counters);
+    LiteGlowTrace::Start(opt.tracePath);
+    std::printf("Replay (%s), %s kernels, %d workers + caller, %d repeats, fixed point %s, caches %s\n",
+                LiteGlowCore::PipelineName(opt.pipeline), LiteGlowSimd::IsaName(LiteGlowSimd::Kernels().isa), LiteGlowSched::WorkerCount(), opt.repeats,
+                opt.fixedPoint ? "on" : "off", opt.cached ? "kept" : "cleared");
+
+    bool ok = true;
+    LiteGlowCapture::MappedCapture capture;
+    for (const char* path : opt.paths) {
+        if (!capture.Open(path)) {
+            std::printf("%s: %s\n", path, capture.Error());
+            ok = false;
+            continue;
+        }
+        ok &= Replay(path, capture.Get(), opt);
+    }
+    capture.Close();
+
+    const LiteGlowMem::ScratchStats scratch = LiteGlowMem::GetScratchStats();
+    std::printf("Scratch: peak %.1f MB in use, %.1f MB with the cache; %llu reuses, %llu system allocations\n",
+                scratch.peakBytesInUse / 1048576.0, scratch.peakBytesTotal / 1048576.0,
+                (unsigned long long)scratch.reuses, (unsigned long long)scratch.systemAllocs);
+
+    LiteGlowTrace::RecordScratch("scratch");
+    if (opt.tracePath && !LiteGlowTrace::Flush()) {
+        std::fprintf(stderr, "cannot write %s\n", opt.tracePath);
+        ok = false;
+    }
+    LiteGlowCache::Clear();
+    LiteGlowTemporal::Clear();
+    LiteGlowGovernor::Clear();
+    LiteGlowSched::ShutdownPool();
+    return ok ? 0 : 1;
+}
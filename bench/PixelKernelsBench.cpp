@@ -0,0 +1,554 @@
+// =============================================================================
+// PixelKernelsBench - bright pass, blends, upsample and HLSL kernels per instruction set
+// =============================================================================
+// Standalone benchmark for the kernels in LiteGlow_Simd.h (no AE SDK needed).
+// Runs every instruction set this CPU supports over the same rows, checks each
+// against the scalar kernels (the documented tolerance: one code value for
+// 8/16-bit outputs, PIXEL_KERNEL_TOLERANCE_FLOAT for float; the fixed-point
+// kernels must match exactly), and reports throughput. Widths are odd and
+// factors include non-powers of two so the tails and gather paths are covered
+// as well as the contiguous loads. Every set's BGRA kernels must reproduce
+// its ARGB ones exactly on channel-reversed rows. The 8/16-bit bright rows also report how
+// far the response table is from the per-pixel knee (the float kernel on the
+// same pixels), and the fixed-point rows ("q15") how far they are from the
+// scalar float-plane kernels on the same input. The HLSL pipeline kernels
+// ("hlsl...") must match the scalar ones exactly.
+//
+// Build and run (from the repository root):
+//   c++ -O2 -std=c++20 -I. bench/PixelKernelsBench.cpp LiteGlow_Simd*.cpp -o PixelKernelsBench
+//   ./PixelKernelsBench [width] [height] [repeats]
+// Defaults: 3839 x 2160, 5 repeats (best time is reported).
+
+#include "BenchTiming.h"
+#include "LiteGlow_Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using LiteGlowSimd::Isa;
+using LiteGlowSimd::PixelKernels;
+
+// Host rows for one depth: ARGB pixels, rows padded like AE does.
+struct BenchRows {
+    std::vector<char> bytes;
+    std::ptrdiff_t rowbytes;
+    int width;
+    int height;
+    int depth;
+
+    void* Row(int y) { return bytes.data() + y * rowbytes; }
+    const void* Row(int y) const { return bytes.data() + y * rowbytes; }
+};
+
+static int PixelBytes(int depth) {
+    return depth == LiteGlowSimd::DEPTH_8 ? 4 : depth == LiteGlowSimd::DEPTH_16 ? 8 : 16;
+}
+
+static BenchRows MakeRows(int depth, int width, int height, uint32_t seed) {
+    BenchRows img;
+    img.width = width;
+    img.height = height;
+    img.depth = depth;
+    img.rowbytes = (std::ptrdiff_t)width * PixelBytes(depth) + 64;
+    img.bytes.assign((size_t)img.rowbytes * height, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            char* p = static_cast<char*>(img.Row(y)) + x * PixelBytes(depth);
+            for (int c = 0; c < 4; ++c) {
+                seed = seed * 1664525u + 1013904223u;
+                const float v = (float)(seed >> 8) / (float)(1u << 24);
+                if (depth == LiteGlowSimd::DEPTH_8) {
+                    reinterpret_cast<uint8_t*>(p)[c] = (uint8_t)(v * 255.0f + 0.5f);
+                } else if (depth == LiteGlowSimd::DEPTH_16) {
+                    reinterpret_cast<uint16_t*>(p)[c] = (uint16_t)(v * 32768.0f + 0.5f);
+                } else {
+                    // Include HDR and negative values to exercise the clamps
+                    reinterpret_cast<float*>(p)[c] = v * 1.5f - 0.1f;
+                }
+            }
+        }
+    }
+    return img;
+}
+
+// Largest difference between two host rows, in code values (float: absolute).
+static double MaxRowDiff(const BenchRows& a, const BenchRows& b) {
+    double worst = 0.0;
+    for (int y = 0; y < a.height; ++y) {
+        const char* pa = static_cast<const char*>(a.Row(y));
+        const char* pb = static_cast<const char*>(b.Row(y));
+        for (int i = 0; i < a.width * 4; ++i) {
+            double d;
+            if (a.depth == LiteGlowSimd::DEPTH_8) {
+                d = std::fabs((double)((const uint8_t*)pa)[i] - ((const uint8_t*)pb)[i]);
+            } else if (a.depth == LiteGlowSimd::DEPTH_16) {
+                d = std::fabs((double)((const uint16_t*)pa)[i] - ((const uint16_t*)pb)[i]);
+            } else {
+                d = std::fabs((double)((const float*)pa)[i] - ((const float*)pb)[i]);
+            }
+            if (d > worst) worst = d;
+        }
+    }
+    return worst;
+}
+
+static double MaxDiff(const std::vector<float>& a, const std::vector<float>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const double d = std::fabs((double)a[i] - b[i]);
+        if (d > worst) worst = d;
+    }
+    return worst;
+}
+
+static const char* DepthName(int depth) {
+    return depth == LiteGlowSimd::DEPTH_8 ? "ARGB32" : depth == LiteGlowSimd::DEPTH_16 ? "ARGB64" : "ARGB128";
+}
+
+static double Tolerance(int depth) {
+    return depth == LiteGlowSimd::DEPTH_FLOAT ? LiteGlowSimd::PIXEL_KERNEL_TOLERANCE_FLOAT : 1.0;
+}
+
+static const char* BlendName(int op) {
+    return op == LiteGlowSimd::BLEND_SCREEN ? "screen" : op == LiteGlowSimd::BLEND_ADD ? "add" : "normal";
+}
+
+static void Report(const char* stage, const char* format, const PixelKernels& k, double mpix, double ms,
+                   double diff, bool ok) {
+    std::printf("%-8s %-8s %-7s %8.2f ms (%8.1f MP/s)   max diff %-10.3g %s\n", stage, format,
+                LiteGlowSimd::IsaName(k.isa), ms, mpix / (ms / 1000.0), diff, ok ? "ok" : "OUT OF TOLERANCE");
+}
+
+// The same pixels as float rows (channel / white), for the per-pixel knee.
+static BenchRows ToFloatRows(const BenchRows& src) {
+    BenchRows img;
+    img.width = src.width;
+    img.height = src.height;
+    img.depth = LiteGlowSimd::DEPTH_FLOAT;
+    img.rowbytes = (std::ptrdiff_t)src.width * PixelBytes(img.depth);
+    img.bytes.assign((size_t)img.rowbytes * src.height, 0);
+    for (int y = 0; y < src.height; ++y) {
+        float* out = static_cast<float*>(img.Row(y));
+        for (int i = 0; i < src.width * 4; ++i) {
+            out[i] = src.depth == LiteGlowSimd::DEPTH_8 ? ((const uint8_t*)src.Row(y))[i] / 255.0f
+                                                        : ((const uint16_t*)src.Row(y))[i] / 32768.0f;
+        }
+    }
+    return img;
+}
+
+// Bright pass of every row at downsample factor `factor`.
+static bool RunBright(const PixelKernels& ref, const PixelKernels& k, const BenchRows& src, int factor,
+                      int repeats) {
+    const LiteGlowSimd::BrightParams params = { 0.45f, 0.1f, 1.3f };
+    const bool integral = src.depth != LiteGlowSimd::DEPTH_FLOAT;
+    LiteGlowSimd::BrightResponse response;
+    if (integral) LiteGlowSimd::BuildBrightResponse(params, (LiteGlowSimd::PixelDepth)src.depth, response);
+    const int width = (src.width + factor - 1) / factor;
+    const int height = (src.height + factor - 1) / factor;
+    const size_t plane = (size_t)width * height;
+    std::vector<float> expected(plane * 3), actual(plane * 3);
+
+    auto run = [&](const PixelKernels& kernels, const BenchRows& rows, std::vector<float>& out) {
+        for (int y = 0; y < height; ++y) {
+            const int sy = y * factor < rows.height ? y * factor : rows.height - 1;
+            float* row = out.data() + (size_t)y * width;
+            kernels.bright[LiteGlowSimd::LAYOUT_ARGB][rows.depth](rows.Row(sy), rows.width, factor, params, integral ? &response : nullptr,
+                                       row, row + plane, row + 2 * plane, width);
+        }
+    };
+    run(ref, src, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] { run(k, src, actual); });
+
+    const double diff = MaxDiff(expected, actual);
+    const bool ok = diff <= LiteGlowSimd::PIXEL_KERNEL_TOLERANCE_FLOAT;
+    char stage[32];
+    std::snprintf(stage, sizeof(stage), "bright/%d", factor);
+    Report(stage, DepthName(src.depth), k, (double)plane / 1.0e6, ms, diff, ok);
+    if (integral && k.isa == Isa::SCALAR) {
+        // Integer depths saturate at white; the float kernel does not
+        std::vector<float> knee(plane * 3);
+        run(ref, ToFloatRows(src), knee);
+        for (float& v : knee) v = std::fmin(v, 1.0f);
+        const double vsKnee = MaxDiff(knee, expected);
+        std::printf("%-8s %-8s %-7s   vs knee %.3g (%.2f 8-bit codes)\n", "", "", "", vsKnee, vsKnee * 255.0);
+    }
+    return ok;
+}
+
+// Blend `op` of every row against a glow `factor` times smaller, starting
+// `offset` pixels into the glow grid, over the columns [x0, width - x0).
+static bool RunBlend(const PixelKernels& ref, const PixelKernels& k, const BenchRows& src, int op, int factor,
+                     int offset, int x0, int repeats) {
+    const LiteGlowSimd::BlendParams params = { 1.7f, 1.0f, 0.8f, 0.6f };
+    const int glowWidth = (src.width + offset + factor - 1) / factor;
+    std::vector<float> glow((size_t)glowWidth * 3);
+    uint32_t seed = 777u;
+    for (float& v : glow) {
+        seed = seed * 1664525u + 1013904223u;
+        v = (float)(seed >> 8) / (float)(1u << 24) * 0.8f;
+    }
+    const LiteGlowSimd::GlowRow glowRow = { glow.data(), glow.data() + glowWidth, glow.data() + 2 * glowWidth,
+                                            glowWidth, factor, offset };
+    const int x1 = src.width - x0;
+    BenchRows expected = src, actual = src;
+
+    auto run = [&](const PixelKernels& kernels, BenchRows& out) {
+        for (int y = 0; y < src.height; ++y) {
+            kernels.blend[op][LiteGlowSimd::LAYOUT_ARGB][src.depth](src.Row(y), out.Row(y), x0, x1, glowRow, params);
+        }
+    };
+    run(ref, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] { run(k, actual); });
+
+    const double diff = MaxRowDiff(expected, actual);
+    const bool ok = diff <= Tolerance(src.depth);
+    char stage[32];
+    std::snprintf(stage, sizeof(stage), "%s/%d", BlendName(op), factor);
+    Report(stage, DepthName(src.depth), k, (double)(x1 - x0) * src.height / 1.0e6, ms, diff, ok);
+    return ok;
+}
+
+// Fixed-point bright pass into Q15 planes; `diff` vs float is in normalized units.
+static bool RunBrightQ15(const PixelKernels& ref, const PixelKernels& k, const BenchRows& src, int factor,
+                         int repeats) {
+    const LiteGlowSimd::BrightParams params = { 0.45f, 0.1f, 1.3f };
+    LiteGlowSimd::BrightResponse response;
+    LiteGlowSimd::BuildBrightResponse(params, (LiteGlowSimd::PixelDepth)src.depth, response);
+    const int width = (src.width + factor - 1) / factor;
+    const int height = (src.height + factor - 1) / factor;
+    const size_t plane = (size_t)width * height;
+    std::vector<uint16_t> expected(plane * 3), actual(plane * 3);
+    std::vector<float> reference(plane * 3);
+
+    auto run = [&](const PixelKernels& kernels, std::vector<uint16_t>& out) {
+        for (int y = 0; y < height; ++y) {
+            const int sy = y * factor < src.height ? y * factor : src.height - 1;
+            uint16_t* row = out.data() + (size_t)y * width;
+            kernels.brightQ15[LiteGlowSimd::LAYOUT_ARGB][src.depth](src.Row(sy), src.width, factor, response, row,
+                                                                    row + plane, row + 2 * plane, width);
+        }
+    };
+    run(ref, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] { run(k, actual); });
+    for (int y = 0; y < height; ++y) {
+        const int sy = y * factor < src.height ? y * factor : src.height - 1;
+        float* row = reference.data() + (size_t)y * width;
+        ref.bright[LiteGlowSimd::LAYOUT_ARGB][src.depth](src.Row(sy), src.width, factor, params, &response, row,
+                                                         row + plane, row + 2 * plane, width);
+    }
+
+    double diff = 0.0, vsFloat = 0.0;
+    for (size_t i = 0; i < actual.size(); ++i) {
+        diff = std::fmax(diff, std::fabs((double)actual[i] - expected[i]));
+        vsFloat = std::fmax(vsFloat, std::fabs(actual[i] / 32768.0 - reference[i]));
+    }
+    const bool ok = diff == 0.0;
+    char stage[32];
+    std::snprintf(stage, sizeof(stage), "q15br/%d", factor);
+    Report(stage, DepthName(src.depth), k, (double)plane / 1.0e6, ms, diff, ok);
+    std::printf("%-8s %-8s %-7s   vs float %.3g (%.2f 8-bit codes)\n", "", "", "", vsFloat, vsFloat * 255.0);
+    return ok;
+}
+
+// Fixed-point blend `op` over Q15 glow; `diff` vs float is in code values.
+static bool RunBlendQ15(const PixelKernels& ref, const PixelKernels& k, const BenchRows& src, int op, int factor,
+                        int offset, int x0, int repeats) {
+    const LiteGlowSimd::BlendParams params = { 1.7f, 1.0f, 0.8f, 0.6f };
+    const int glowWidth = (src.width + offset + factor - 1) / factor;
+    std::vector<uint16_t> glow((size_t)glowWidth * 3);
+    std::vector<float> glowF(glow.size());
+    uint32_t seed = 777u;
+    for (size_t i = 0; i < glow.size(); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        glow[i] = (uint16_t)((seed >> 8) % 26215u);  // Up to 0.8
+        glowF[i] = glow[i] / 32768.0f;
+    }
+    const LiteGlowSimd::GlowRowQ15 glowRow = { glow.data(), glow.data() + glowWidth, glow.data() + 2 * glowWidth,
+                                               glowWidth, factor, offset };
+    const LiteGlowSimd::GlowRow glowRowF = { glowF.data(), glowF.data() + glowWidth, glowF.data() + 2 * glowWidth,
+                                             glowWidth, factor, offset };
+    const int x1 = src.width - x0;
+    BenchRows expected = src, actual = src, reference = src;
+
+    auto run = [&](const PixelKernels& kernels, BenchRows& out) {
+        for (int y = 0; y < src.height; ++y) {
+            kernels.blendQ15[op][LiteGlowSimd::LAYOUT_ARGB][src.depth](src.Row(y), out.Row(y), x0, x1, glowRow,
+                                                                       params);
+        }
+    };
+    run(ref, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] { run(k, actual); });
+    for (int y = 0; y < src.height; ++y) {
+        ref.blend[op][LiteGlowSimd::LAYOUT_ARGB][src.depth](src.Row(y), reference.Row(y), x0, x1, glowRowF, params);
+    }
+
+    const double diff = MaxRowDiff(expected, actual);
+    const bool ok = diff == 0.0;
+    char stage[32];
+    std::snprintf(stage, sizeof(stage), "q15%.2s/%d", BlendName(op), factor);
+    Report(stage, DepthName(src.depth), k, (double)(x1 - x0) * src.height / 1.0e6, ms, diff, ok);
+    std::printf("%-8s %-8s %-7s   vs float %.3g code values\n", "", "", "", MaxRowDiff(reference, actual));
+    return ok;
+}
+
+// HLSL bright pass (LiteGlowCore::PIPELINE_HLSL) of every row into float
+// ARGB pixels at downsample factor `factor`; must match scalar exactly.
+static bool RunHlslBright(const PixelKernels& ref, const PixelKernels& k, const BenchRows& src, int factor,
+                          int repeats) {
+    const LiteGlowSimd::HlslBrightParams params = { 0.45f, 1.3f };
+    const int width = (src.width + factor - 1) / factor;
+    const int height = (src.height + factor - 1) / factor;
+    std::vector<float> expected((size_t)width * height * 4), actual(expected.size());
+
+    auto run = [&](const PixelKernels& kernels, std::vector<float>& out) {
+        const void* rows[LiteGlowSimd::HLSL_BLUR_TAPS];
+        for (int y = 0; y < height; ++y) {
+            for (int j = 0; j < factor; ++j) {
+                const int sy = y * factor + j < src.height ? y * factor + j : src.height - 1;
+                rows[j] = src.Row(sy);
+            }
+            kernels.hlslBright[LiteGlowSimd::LAYOUT_ARGB][src.depth](rows, src.width, factor, params,
+                                                                     out.data() + (size_t)y * width * 4, width);
+        }
+    };
+    run(ref, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] { run(k, actual); });
+
+    const double diff = MaxDiff(expected, actual);
+    const bool ok = diff == 0.0;
+    char stage[32];
+    std::snprintf(stage, sizeof(stage), "hlslbr/%d", factor);
+    Report(stage, DepthName(src.depth), k, (double)width * height / 1.0e6, ms, diff, ok);
+    return ok;
+}
+
+// HLSL blend `op` of every row against a float ARGB glow `factor` times
+// smaller, starting `offset` pixels into the glow grid, over the columns
+// [x0, width - x0); must match scalar exactly.
+static bool RunHlslBlend(const PixelKernels& ref, const PixelKernels& k, const BenchRows& src, int op,
+                         int factor, int offset, int x0, int repeats) {
+    const LiteGlowSimd::BlendParams params = { 1.7f, 1.0f, 0.8f, 0.6f };
+    const int glowWidth = (src.width + offset + factor - 1) / factor;
+    std::vector<float> glow((size_t)glowWidth * 4 * 2);
+    uint32_t seed = 777u;
+    for (float& v : glow) {
+        seed = seed * 1664525u + 1013904223u;
+        v = (float)(seed >> 8) / (float)(1u << 24) * 0.8f;
+    }
+    const int x1 = src.width - x0;
+    BenchRows expected = src, actual = src;
+
+    auto run = [&](const PixelKernels& kernels, BenchRows& out) {
+        for (int y = 0; y < src.height; ++y) {
+            const LiteGlowSimd::HlslGlowRows rows = { glow.data(), glow.data() + glowWidth * 4,
+                                                      (float)(y % factor) / factor, glowWidth, factor, offset };
+            kernels.hlslBlend[op][LiteGlowSimd::LAYOUT_ARGB][src.depth](src.Row(y), out.Row(y), x0, x1, rows,
+                                                                        params);
+        }
+    };
+    run(ref, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] { run(k, actual); });
+
+    const double diff = MaxRowDiff(expected, actual);
+    const bool ok = diff == 0.0;
+    char stage[32];
+    std::snprintf(stage, sizeof(stage), "hlsl%.2s/%d", BlendName(op), factor);
+    Report(stage, DepthName(src.depth), k, (double)(x1 - x0) * src.height / 1.0e6, ms, diff, ok);
+    return ok;
+}
+
+// HLSL 9-tap blur, both directions, over a float ARGB buffer with taps
+// `step` pixels apart; must match scalar exactly.
+static bool RunHlslBlur(const PixelKernels& ref, const PixelKernels& k, int width, int height, int step,
+                        int repeats) {
+    const size_t pitch = (size_t)width * 4;
+    std::vector<float> src(pitch * height);
+    uint32_t seed = 99u;
+    for (float& v : src) { seed = seed * 1664525u + 1013904223u; v = (float)(seed >> 8) / (float)(1u << 24); }
+    std::vector<float> tmp(src.size()), expected(src.size()), actual(src.size());
+
+    auto run = [&](const PixelKernels& kernels, std::vector<float>& out) {
+        for (int y = 0; y < height; ++y) kernels.hlslBlurH(src.data() + y * pitch, tmp.data() + y * pitch, width, step);
+        const float* rows[LiteGlowSimd::HLSL_BLUR_TAPS];
+        for (int y = 0; y < height; ++y) {
+            for (int t = 0; t < LiteGlowSimd::HLSL_BLUR_TAPS; ++t) {
+                const int sy = std::clamp(y + (t - LiteGlowSimd::HLSL_BLUR_TAPS / 2) * step, 0, height - 1);
+                rows[t] = tmp.data() + sy * pitch;
+            }
+            kernels.hlslBlurV(rows, out.data() + y * pitch, width);
+        }
+    };
+    run(ref, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] { run(k, actual); });
+
+    const double diff = MaxDiff(expected, actual);
+    const bool ok = diff == 0.0;
+    char stage[32];
+    std::snprintf(stage, sizeof(stage), "hlslbl/%d", step);
+    Report(stage, "ARGB128", k, (double)width * height / 1.0e6, ms, diff, ok);
+    return ok;
+}
+
+// The same rows with every pixel's channels in reverse order (ARGB <-> BGRA).
+static BenchRows ReverseChannels(const BenchRows& src) {
+    BenchRows img = src;
+    const int channelBytes = PixelBytes(src.depth) / 4;
+    for (int y = 0; y < src.height; ++y) {
+        char* row = static_cast<char*>(img.Row(y));
+        for (int x = 0; x < src.width; ++x) {
+            char* p = row + x * PixelBytes(src.depth);
+            for (int c = 0; c < 2; ++c) {
+                for (int i = 0; i < channelBytes; ++i) {
+                    std::swap(p[c * channelBytes + i], p[(3 - c) * channelBytes + i]);
+                }
+            }
+        }
+    }
+    return img;
+}
+
+// The BGRA kernels of `k` on reversed rows must reproduce its ARGB kernels
+// exactly: bright pass (factor 3) and every blend, float and fixed-point.
+static bool RunLayouts(const PixelKernels& k, const BenchRows& src) {
+    using LiteGlowSimd::LAYOUT_ARGB;
+    using LiteGlowSimd::LAYOUT_BGRA;
+    const BenchRows bgra = ReverseChannels(src);
+    const bool integral = src.depth != LiteGlowSimd::DEPTH_FLOAT;
+    const LiteGlowSimd::BrightParams brightParams = { 0.45f, 0.1f, 1.3f };
+    LiteGlowSimd::BrightResponse response;
+    if (integral) LiteGlowSimd::BuildBrightResponse(brightParams, (LiteGlowSimd::PixelDepth)src.depth, response);
+    const int factor = 3;
+    const int width = (src.width + factor - 1) / factor;
+    std::vector<float> argbRow(width * 3), bgraRow(width * 3);
+    std::vector<uint16_t> argbQ15(width * 3), bgraQ15(width * 3);
+    bool ok = true;
+    for (int y = 0; y < src.height; y += factor) {
+        float* a = argbRow.data();
+        float* b = bgraRow.data();
+        k.bright[LAYOUT_ARGB][src.depth](src.Row(y), src.width, factor, brightParams, &response, a, a + width,
+                                         a + 2 * width, width);
+        k.bright[LAYOUT_BGRA][src.depth](bgra.Row(y), src.width, factor, brightParams, &response, b, b + width,
+                                         b + 2 * width, width);
+        ok &= argbRow == bgraRow;
+        if (!integral) continue;
+        uint16_t* qa = argbQ15.data();
+        uint16_t* qb = bgraQ15.data();
+        k.brightQ15[LAYOUT_ARGB][src.depth](src.Row(y), src.width, factor, response, qa, qa + width,
+                                            qa + 2 * width, width);
+        k.brightQ15[LAYOUT_BGRA][src.depth](bgra.Row(y), src.width, factor, response, qb, qb + width,
+                                            qb + 2 * width, width);
+        ok &= argbQ15 == bgraQ15;
+    }
+
+    const LiteGlowSimd::BlendParams blendParams = { 1.7f, 1.0f, 0.8f, 0.6f };
+    for (size_t i = 0; i < argbRow.size(); ++i) argbQ15[i] = (uint16_t)(argbRow[i] * 26214.0f);
+    const LiteGlowSimd::GlowRow glow = { argbRow.data(), argbRow.data() + width, argbRow.data() + 2 * width,
+                                         width, factor, 0 };
+    const LiteGlowSimd::GlowRowQ15 glowQ15 = { argbQ15.data(), argbQ15.data() + width, argbQ15.data() + 2 * width,
+                                               width, factor, 0 };
+    for (int op = 0; op < LiteGlowSimd::BLEND_OPS; ++op) {
+        BenchRows argbOut = src, bgraOut = bgra;
+        for (int y = 0; y < src.height; ++y) {
+            k.blend[op][LAYOUT_ARGB][src.depth](src.Row(y), argbOut.Row(y), 1, src.width, glow, blendParams);
+            k.blend[op][LAYOUT_BGRA][src.depth](bgra.Row(y), bgraOut.Row(y), 1, src.width, glow, blendParams);
+        }
+        ok &= MaxRowDiff(argbOut, ReverseChannels(bgraOut)) == 0.0;
+        if (!integral) continue;
+        for (int y = 0; y < src.height; ++y) {
+            k.blendQ15[op][LAYOUT_ARGB][src.depth](src.Row(y), argbOut.Row(y), 1, src.width, glowQ15, blendParams);
+            k.blendQ15[op][LAYOUT_BGRA][src.depth](bgra.Row(y), bgraOut.Row(y), 1, src.width, glowQ15, blendParams);
+        }
+        ok &= MaxRowDiff(argbOut, ReverseChannels(bgraOut)) == 0.0;
+    }
+    std::printf("%-8s %-8s %-7s   BGRA matches ARGB: %s\n", "layout", DepthName(src.depth),
+                LiteGlowSimd::IsaName(k.isa), ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+// One pyramid step: a (width / 2) x (height / 2) level upsampled onto a full one.
+static bool RunUpsample(const PixelKernels& ref, const PixelKernels& k, int width, int height, int repeats) {
+    const int coarseW = (width + 1) / 2;
+    const int coarseH = (height + 1) / 2;
+    std::vector<float> coarse((size_t)coarseW * coarseH), base((size_t)width * height);
+    uint32_t seed = 4242u;
+    for (float& v : coarse) { seed = seed * 1664525u + 1013904223u; v = (float)(seed >> 8) / (float)(1u << 24); }
+    for (float& v : base) { seed = seed * 1664525u + 1013904223u; v = (float)(seed >> 8) / (float)(1u << 24); }
+    std::vector<float> expected = base, actual = base;
+    const LiteGlowBlur::PlaneF coarsePlane = { coarse.data(), coarseW, coarseH, coarseW };
+
+    auto run = [&](const PixelKernels& kernels, std::vector<float>& out) {
+        const LiteGlowBlur::PlaneF fine = { out.data(), width, height, width };
+        for (int y = 0; y < height; ++y) kernels.upsample(coarsePlane, 0.7f, fine, 0.9f, y);
+    };
+    run(ref, expected);
+    const double ms = LiteGlowBench::BestMs(repeats, [&] {
+        std::memcpy(actual.data(), base.data(), base.size() * sizeof(float));
+        run(k, actual);
+    });
+
+    const double diff = MaxDiff(expected, actual);
+    const bool ok = diff <= LiteGlowSimd::PIXEL_KERNEL_TOLERANCE_FLOAT;
+    Report("upsample", "Plane", k, (double)width * height / 1.0e6, ms, diff, ok);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const int width = argc > 1 ? std::atoi(argv[1]) : 3839;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 2160;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+    if (width <= 0 || height <= 0 || repeats <= 0) {
+        std::fprintf(stderr, "usage: %s [width] [height] [repeats]\n", argv[0]);
+        return 2;
+    }
+
+    const Isa widest = LiteGlowSimd::DetectIsa();
+    std::printf("Pixel kernels, %d x %d, best of %d, CPU supports up to %s\n",
+                width, height, repeats, LiteGlowSimd::IsaName(widest));
+
+    const PixelKernels& ref = *LiteGlowSimd::KernelsFor(Isa::SCALAR);
+    bool ok = true;
+    for (int depth = LiteGlowSimd::DEPTH_8; depth < LiteGlowSimd::PIXEL_DEPTHS; ++depth) {
+        const BenchRows src = MakeRows(depth, width, height, 12345u + depth);
+        for (int i = (int)Isa::SCALAR; i <= (int)widest; ++i) {
+            const PixelKernels* k = LiteGlowSimd::KernelsFor((Isa)i);
+            if (!k) continue;
+            ok &= RunLayouts(*k, src);
+            ok &= RunBright(ref, *k, src, 1, repeats);
+            ok &= RunBright(ref, *k, src, 3, repeats);
+            for (int op = 0; op < LiteGlowSimd::BLEND_OPS; ++op) {
+                ok &= RunBlend(ref, *k, src, op, 1, 0, 0, repeats);
+                ok &= RunBlend(ref, *k, src, op, 2, 5, 3, repeats);
+                ok &= RunBlend(ref, *k, src, op, 3, 7, 1, repeats);
+            }
+            ok &= RunHlslBright(ref, *k, src, 1, repeats);
+            ok &= RunHlslBright(ref, *k, src, 3, repeats);
+            for (int op = 0; op < LiteGlowSimd::BLEND_OPS; ++op) {
+                ok &= RunHlslBlend(ref, *k, src, op, 1, 0, 0, repeats);
+                ok &= RunHlslBlend(ref, *k, src, op, 3, 7, 1, repeats);
+            }
+            if (depth == LiteGlowSimd::DEPTH_FLOAT) continue;
+            ok &= RunBrightQ15(ref, *k, src, 1, repeats);
+            ok &= RunBrightQ15(ref, *k, src, 3, repeats);
+            for (int op = 0; op < LiteGlowSimd::BLEND_OPS; ++op) {
+                ok &= RunBlendQ15(ref, *k, src, op, 1, 0, 0, repeats);
+                ok &= RunBlendQ15(ref, *k, src, op, 2, 5, 3, repeats);
+                ok &= RunBlendQ15(ref, *k, src, op, 3, 7, 1, repeats);
+            }
+        }
+    }
+    for (int i = (int)Isa::SCALAR; i <= (int)widest; ++i) {
+        const PixelKernels* k = LiteGlowSimd::KernelsFor((Isa)i);
+        if (!k) continue;
+        ok &= RunUpsample(ref, *k, width, height, repeats);
+        ok &= RunHlslBlur(ref, *k, std::max(1, width / 4), std::max(1, height / 4), 1, repeats);
+        ok &= RunHlslBlur(ref, *k, std::max(1, width / 4), std::max(1, height / 4), 7, repeats);
+    }
+    return ok ? 0 : 1;
+}